@@ -23,19 +23,65 @@
 */
 
 #include <unordered_map>
+#include <atomic>
 #include <mutex>
-#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <cstddef>
 #include "vulkan/vk_icd.h"
 namespace vkmock {
 
 
 using mutex_t = std::mutex;
-using lock_guard_t = std::lock_guard<mutex_t>;
-using unique_lock_t = std::unique_lock<mutex_t>;
+
+// Opt-in call statistics, written to the file VK_MOCK_ICD_CALL_STATS names. See CallTimer.
+static const char* const call_stats_path = getenv("VK_MOCK_ICD_CALL_STATS");
+static const bool call_stats_enabled = call_stats_path && *call_stats_path;
+static void RecordLockWait(std::chrono::steady_clock::duration wait);
+
+// Locks of the ICD's internal mutexes. Acquisitions that have to wait are timed when call statistics are enabled, the
+// uncontended path costs the same as std::mutex::lock().
+static inline void AcquireLock(std::unique_lock<mutex_t>& lock) {
+    if (lock.try_lock()) return;
+    if (!call_stats_enabled) {
+        lock.lock();
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    RecordLockWait(std::chrono::steady_clock::now() - start);
+}
+class unique_lock_t : public std::unique_lock<mutex_t> {
+  public:
+    explicit unique_lock_t(mutex_t& mutex) : std::unique_lock<mutex_t>(mutex, std::defer_lock) { AcquireLock(*this); }
+};
+class lock_guard_t {
+  public:
+    explicit lock_guard_t(mutex_t& mutex) : lock_(mutex) {}
+
+  private:
+    unique_lock_t lock_;
+};
 
 static mutex_t global_lock;
-static uint64_t global_unique_handle = 1;
+static std::atomic<uint64_t> global_unique_handle{1};
+// Non-dispatchable handles are handed out from blocks reserved per thread, so creating an object
+// needs neither a lock nor a shared atomic increment except once every kHandleBlockSize handles.
+static constexpr uint64_t kHandleBlockSize = 256;
+static uint64_t NewHandle() {
+    struct HandleBlock {
+        uint64_t next;
+        uint64_t end;
+    };
+    static thread_local HandleBlock block = {0, 0};
+    if (block.next == block.end) {
+        block.next = global_unique_handle.fetch_add(kHandleBlockSize, std::memory_order_relaxed);
+        block.end = block.next + kHandleBlockSize;
+    }
+    return block.next++;
+}
 static const uint32_t SUPPORTED_LOADER_ICD_INTERFACE_VERSION = 5;
 static uint32_t loader_interface_version = 0;
 static bool negotiate_loader_icd_interface_called = false;
@@ -48,218 +94,259 @@ static void DestroyDispObjHandle(void* handle) {
     delete reinterpret_cast<VK_LOADER_DATA*>(handle);
 }
 
-// Map of instance extension name to version
-static const std::unordered_map<std::string, uint32_t> instance_extension_map = {
-    {"VK_KHR_surface", 25},
-    {"VK_KHR_display", 23},
-    {"VK_KHR_xlib_surface", 6},
-    {"VK_KHR_xcb_surface", 6},
-    {"VK_KHR_wayland_surface", 6},
-    {"VK_KHR_android_surface", 6},
-    {"VK_KHR_win32_surface", 6},
+// Entries of the name lookup tables generated below. The tables only hold string literals and function
+// addresses, so they are constant initialized at load time and can be searched without allocating.
+struct NameToFuncPtr {
+    const char* name;
+    void* funcptr;
+};
+struct ExtensionNameToVersion {
+    const char* name;
+    uint32_t spec_version;
+};
+template <typename Entry, size_t N>
+static constexpr uint32_t TableSize(const Entry (&)[N]) {
+    return (uint32_t)N;
+}
+// Binary search of a table that is sorted by name
+template <typename Entry, size_t N>
+static const Entry* FindByName(const Entry (&table)[N], const char* name) {
+    const auto entry = std::lower_bound(table, table + N, name,
+                                        [](const Entry& lhs, const char* rhs) { return std::strcmp(lhs.name, rhs) < 0; });
+    if (entry != table + N && std::strcmp(entry->name, name) == 0) return entry;
+    return nullptr;
+}
+// 32-bit FNV-1a, must match hash_name() in mock_icd_generator.py
+static inline uint32_t HashName(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; ++name) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash;
+}
+static constexpr uint16_t kEmptySlot = 0xFFFF;
+
+// Entries of the tables of struct members that device profiles can set, which are generated below
+enum class ProfileFieldType : uint32_t { Bool32, Uint32, Int32, Uint64, Size, Float };
+struct ProfileField {
+    const char* name;
+    uint32_t offset;
+    ProfileFieldType type;
+    uint32_t count;  // Of array elements, 1 for scalars
+};
+
+// Map of instance extension name to version, sorted by name
+static const ExtensionNameToVersion instance_extension_map[] = {
+    {"VK_EXT_acquire_xlib_display", 1},
     {"VK_EXT_debug_report", 9},
-    {"VK_GGP_stream_descriptor_surface", 1},
-    {"VK_NV_external_memory_capabilities", 1},
-    {"VK_KHR_get_physical_device_properties2", 2},
-    {"VK_EXT_validation_flags", 2},
-    {"VK_NN_vi_surface", 1},
-    {"VK_KHR_device_group_creation", 1},
-    {"VK_KHR_external_memory_capabilities", 1},
-    {"VK_KHR_external_semaphore_capabilities", 1},
+    {"VK_EXT_debug_utils", 2},
     {"VK_EXT_direct_mode_display", 1},
-    {"VK_EXT_acquire_xlib_display", 1},
+    {"VK_EXT_directfb_surface", 1},
     {"VK_EXT_display_surface_counter", 1},
+    {"VK_EXT_headless_surface", 1},
+    {"VK_EXT_metal_surface", 1},
     {"VK_EXT_swapchain_colorspace", 4},
+    {"VK_EXT_validation_features", 3},
+    {"VK_EXT_validation_flags", 2},
+    {"VK_FUCHSIA_imagepipe_surface", 1},
+    {"VK_GGP_stream_descriptor_surface", 1},
+    {"VK_KHR_android_surface", 6},
+    {"VK_KHR_device_group_creation", 1},
+    {"VK_KHR_display", 23},
     {"VK_KHR_external_fence_capabilities", 1},
-    {"VK_KHR_get_surface_capabilities2", 1},
+    {"VK_KHR_external_memory_capabilities", 1},
+    {"VK_KHR_external_semaphore_capabilities", 1},
     {"VK_KHR_get_display_properties2", 1},
+    {"VK_KHR_get_physical_device_properties2", 2},
+    {"VK_KHR_get_surface_capabilities2", 1},
+    {"VK_KHR_surface", 25},
+    {"VK_KHR_surface_protected_capabilities", 1},
+    {"VK_KHR_wayland_surface", 6},
+    {"VK_KHR_win32_surface", 6},
+    {"VK_KHR_xcb_surface", 6},
+    {"VK_KHR_xlib_surface", 6},
     {"VK_MVK_ios_surface", 2},
     {"VK_MVK_macos_surface", 2},
-    {"VK_EXT_debug_utils", 2},
-    {"VK_FUCHSIA_imagepipe_surface", 1},
-    {"VK_EXT_metal_surface", 1},
-    {"VK_KHR_surface_protected_capabilities", 1},
-    {"VK_EXT_validation_features", 3},
-    {"VK_EXT_headless_surface", 1},
-    {"VK_EXT_directfb_surface", 1},
+    {"VK_NN_vi_surface", 1},
+    {"VK_NV_external_memory_capabilities", 1},
 };
-// Map of device extension name to version
-static const std::unordered_map<std::string, uint32_t> device_extension_map = {
-    {"VK_KHR_swapchain", 70},
-    {"VK_KHR_display_swapchain", 10},
-    {"VK_NV_glsl_shader", 1},
-    {"VK_EXT_depth_range_unrestricted", 1},
-    {"VK_KHR_sampler_mirror_clamp_to_edge", 3},
-    {"VK_IMG_filter_cubic", 1},
-    {"VK_AMD_rasterization_order", 1},
-    {"VK_AMD_shader_trinary_minmax", 1},
-    {"VK_AMD_shader_explicit_vertex_parameter", 1},
-    {"VK_EXT_debug_marker", 4},
-    {"VK_AMD_gcn_shader", 1},
-    {"VK_NV_dedicated_allocation", 1},
-    {"VK_EXT_transform_feedback", 1},
-    {"VK_NVX_image_view_handle", 2},
+// Map of device extension name to version, sorted by name
+static const ExtensionNameToVersion device_extension_map[] = {
+    {"VK_AMD_buffer_marker", 1},
+    {"VK_AMD_device_coherent_memory", 1},
+    {"VK_AMD_display_native_hdr", 1},
     {"VK_AMD_draw_indirect_count", 2},
-    {"VK_AMD_negative_viewport_height", 1},
+    {"VK_AMD_gcn_shader", 1},
     {"VK_AMD_gpu_shader_half_float", 2},
+    {"VK_AMD_gpu_shader_int16", 2},
+    {"VK_AMD_memory_overallocation_behavior", 1},
+    {"VK_AMD_mixed_attachment_samples", 1},
+    {"VK_AMD_negative_viewport_height", 1},
+    {"VK_AMD_pipeline_compiler_control", 1},
+    {"VK_AMD_rasterization_order", 1},
     {"VK_AMD_shader_ballot", 1},
-    {"VK_AMD_texture_gather_bias_lod", 1},
-    {"VK_AMD_shader_info", 1},
+    {"VK_AMD_shader_core_properties", 2},
+    {"VK_AMD_shader_core_properties2", 1},
+    {"VK_AMD_shader_explicit_vertex_parameter", 1},
+    {"VK_AMD_shader_fragment_mask", 1},
     {"VK_AMD_shader_image_load_store_lod", 1},
-    {"VK_NV_corner_sampled_image", 2},
-    {"VK_KHR_multiview", 1},
-    {"VK_IMG_format_pvrtc", 1},
-    {"VK_NV_external_memory", 1},
-    {"VK_NV_external_memory_win32", 1},
-    {"VK_NV_win32_keyed_mutex", 2},
-    {"VK_KHR_device_group", 4},
-    {"VK_KHR_shader_draw_parameters", 1},
+    {"VK_AMD_shader_info", 1},
+    {"VK_AMD_shader_trinary_minmax", 1},
+    {"VK_AMD_texture_gather_bias_lod", 1},
+    {"VK_ANDROID_external_memory_android_hardware_buffer", 3},
+    {"VK_EXT_astc_decode_mode", 1},
+    {"VK_EXT_blend_operation_advanced", 2},
+    {"VK_EXT_buffer_device_address", 2},
+    {"VK_EXT_calibrated_timestamps", 1},
+    {"VK_EXT_conditional_rendering", 2},
+    {"VK_EXT_conservative_rasterization", 1},
+    {"VK_EXT_custom_border_color", 12},
+    {"VK_EXT_debug_marker", 4},
+    {"VK_EXT_depth_clip_enable", 1},
+    {"VK_EXT_depth_range_unrestricted", 1},
+    {"VK_EXT_descriptor_indexing", 2},
+    {"VK_EXT_discard_rectangles", 1},
+    {"VK_EXT_display_control", 1},
+    {"VK_EXT_extended_dynamic_state", 1},
+    {"VK_EXT_external_memory_dma_buf", 1},
+    {"VK_EXT_external_memory_host", 1},
+    {"VK_EXT_filter_cubic", 3},
+    {"VK_EXT_fragment_density_map", 1},
+    {"VK_EXT_fragment_density_map2", 1},
+    {"VK_EXT_fragment_shader_interlock", 1},
+    {"VK_EXT_full_screen_exclusive", 4},
+    {"VK_EXT_global_priority", 2},
+    {"VK_EXT_hdr_metadata", 2},
+    {"VK_EXT_host_query_reset", 1},
+    {"VK_EXT_image_drm_format_modifier", 1},
+    {"VK_EXT_index_type_uint8", 1},
+    {"VK_EXT_inline_uniform_block", 1},
+    {"VK_EXT_line_rasterization", 1},
+    {"VK_EXT_memory_budget", 1},
+    {"VK_EXT_memory_priority", 1},
+    {"VK_EXT_pci_bus_info", 2},
+    {"VK_EXT_pipeline_creation_cache_control", 3},
+    {"VK_EXT_pipeline_creation_feedback", 1},
+    {"VK_EXT_post_depth_coverage", 1},
+    {"VK_EXT_private_data", 1},
+    {"VK_EXT_queue_family_foreign", 1},
+    {"VK_EXT_robustness2", 1},
+    {"VK_EXT_sample_locations", 1},
+    {"VK_EXT_sampler_filter_minmax", 2},
+    {"VK_EXT_scalar_block_layout", 1},
+    {"VK_EXT_separate_stencil_usage", 1},
+    {"VK_EXT_shader_demote_to_helper_invocation", 1},
+    {"VK_EXT_shader_stencil_export", 1},
     {"VK_EXT_shader_subgroup_ballot", 1},
     {"VK_EXT_shader_subgroup_vote", 1},
+    {"VK_EXT_shader_viewport_index_layer", 1},
+    {"VK_EXT_subgroup_size_control", 2},
+    {"VK_EXT_texel_buffer_alignment", 1},
     {"VK_EXT_texture_compression_astc_hdr", 1},
-    {"VK_EXT_astc_decode_mode", 1},
-    {"VK_KHR_maintenance1", 2},
+    {"VK_EXT_tooling_info", 1},
+    {"VK_EXT_transform_feedback", 1},
+    {"VK_EXT_vertex_attribute_divisor", 3},
+    {"VK_EXT_ycbcr_image_arrays", 1},
+    {"VK_GGP_frame_token", 1},
+    {"VK_GOOGLE_decorate_string", 1},
+    {"VK_GOOGLE_display_timing", 1},
+    {"VK_GOOGLE_hlsl_functionality1", 1},
+    {"VK_GOOGLE_user_type", 1},
+    {"VK_IMG_filter_cubic", 1},
+    {"VK_IMG_format_pvrtc", 1},
+    {"VK_INTEL_performance_query", 2},
+    {"VK_INTEL_shader_integer_functions2", 1},
+    {"VK_KHR_16bit_storage", 1},
+    {"VK_KHR_8bit_storage", 1},
+    {"VK_KHR_bind_memory2", 1},
+    {"VK_KHR_buffer_device_address", 1},
+    {"VK_KHR_create_renderpass2", 1},
+    {"VK_KHR_dedicated_allocation", 3},
+    {"VK_KHR_deferred_host_operations", 3},
+    {"VK_KHR_depth_stencil_resolve", 1},
+    {"VK_KHR_descriptor_update_template", 1},
+    {"VK_KHR_device_group", 4},
+    {"VK_KHR_display_swapchain", 10},
+    {"VK_KHR_draw_indirect_count", 1},
+    {"VK_KHR_driver_properties", 1},
+    {"VK_KHR_external_fence", 1},
+    {"VK_KHR_external_fence_fd", 1},
+    {"VK_KHR_external_fence_win32", 1},
     {"VK_KHR_external_memory", 1},
-    {"VK_KHR_external_memory_win32", 1},
     {"VK_KHR_external_memory_fd", 1},
-    {"VK_KHR_win32_keyed_mutex", 1},
+    {"VK_KHR_external_memory_win32", 1},
     {"VK_KHR_external_semaphore", 1},
-    {"VK_KHR_external_semaphore_win32", 1},
     {"VK_KHR_external_semaphore_fd", 1},
+    {"VK_KHR_external_semaphore_win32", 1},
+    {"VK_KHR_get_memory_requirements2", 1},
+    {"VK_KHR_image_format_list", 1},
+    {"VK_KHR_imageless_framebuffer", 1},
+    {"VK_KHR_incremental_present", 1},
+    {"VK_KHR_maintenance1", 2},
+    {"VK_KHR_maintenance2", 1},
+    {"VK_KHR_maintenance3", 1},
+    {"VK_KHR_multiview", 1},
+    {"VK_KHR_performance_query", 1},
+    {"VK_KHR_pipeline_executable_properties", 1},
+    {"VK_KHR_pipeline_library", 1},
     {"VK_KHR_push_descriptor", 2},
-    {"VK_EXT_conditional_rendering", 2},
+    {"VK_KHR_ray_tracing", 8},
+    {"VK_KHR_relaxed_block_layout", 1},
+    {"VK_KHR_sampler_mirror_clamp_to_edge", 3},
+    {"VK_KHR_sampler_ycbcr_conversion", 14},
+    {"VK_KHR_separate_depth_stencil_layouts", 1},
+    {"VK_KHR_shader_atomic_int64", 1},
+    {"VK_KHR_shader_clock", 1},
+    {"VK_KHR_shader_draw_parameters", 1},
     {"VK_KHR_shader_float16_int8", 1},
-    {"VK_KHR_16bit_storage", 1},
-    {"VK_KHR_incremental_present", 1},
-    {"VK_KHR_descriptor_update_template", 1},
+    {"VK_KHR_shader_float_controls", 4},
+    {"VK_KHR_shader_non_semantic_info", 1},
+    {"VK_KHR_shader_subgroup_extended_types", 1},
+    {"VK_KHR_shared_presentable_image", 1},
+    {"VK_KHR_spirv_1_4", 1},
+    {"VK_KHR_storage_buffer_storage_class", 1},
+    {"VK_KHR_swapchain", 70},
+    {"VK_KHR_swapchain_mutable_format", 1},
+    {"VK_KHR_timeline_semaphore", 2},
+    {"VK_KHR_uniform_buffer_standard_layout", 1},
+    {"VK_KHR_variable_pointers", 1},
+    {"VK_KHR_vulkan_memory_model", 3},
+    {"VK_KHR_win32_keyed_mutex", 1},
+    {"VK_NVX_image_view_handle", 2},
+    {"VK_NVX_multiview_per_view_attributes", 1},
     {"VK_NV_clip_space_w_scaling", 1},
-    {"VK_EXT_display_control", 1},
-    {"VK_GOOGLE_display_timing", 1},
-    {"VK_NV_sample_mask_override_coverage", 1},
+    {"VK_NV_compute_shader_derivatives", 1},
+    {"VK_NV_cooperative_matrix", 1},
+    {"VK_NV_corner_sampled_image", 2},
+    {"VK_NV_coverage_reduction_mode", 1},
+    {"VK_NV_dedicated_allocation", 1},
+    {"VK_NV_dedicated_allocation_image_aliasing", 1},
+    {"VK_NV_device_diagnostic_checkpoints", 2},
+    {"VK_NV_device_diagnostics_config", 1},
+    {"VK_NV_device_generated_commands", 3},
+    {"VK_NV_external_memory", 1},
+    {"VK_NV_external_memory_win32", 1},
+    {"VK_NV_fill_rectangle", 1},
+    {"VK_NV_fragment_coverage_to_color", 1},
+    {"VK_NV_fragment_shader_barycentric", 1},
+    {"VK_NV_framebuffer_mixed_samples", 1},
     {"VK_NV_geometry_shader_passthrough", 1},
+    {"VK_NV_glsl_shader", 1},
+    {"VK_NV_mesh_shader", 1},
+    {"VK_NV_ray_tracing", 3},
+    {"VK_NV_representative_fragment_test", 2},
+    {"VK_NV_sample_mask_override_coverage", 1},
+    {"VK_NV_scissor_exclusive", 1},
+    {"VK_NV_shader_image_footprint", 2},
+    {"VK_NV_shader_sm_builtins", 1},
+    {"VK_NV_shader_subgroup_partitioned", 1},
+    {"VK_NV_shading_rate_image", 3},
     {"VK_NV_viewport_array2", 1},
-    {"VK_NVX_multiview_per_view_attributes", 1},
     {"VK_NV_viewport_swizzle", 1},
-    {"VK_EXT_discard_rectangles", 1},
-    {"VK_EXT_conservative_rasterization", 1},
-    {"VK_EXT_depth_clip_enable", 1},
-    {"VK_EXT_hdr_metadata", 2},
-    {"VK_KHR_imageless_framebuffer", 1},
-    {"VK_KHR_create_renderpass2", 1},
-    {"VK_KHR_shared_presentable_image", 1},
-    {"VK_KHR_external_fence", 1},
-    {"VK_KHR_external_fence_win32", 1},
-    {"VK_KHR_external_fence_fd", 1},
-    {"VK_KHR_performance_query", 1},
-    {"VK_KHR_maintenance2", 1},
-    {"VK_KHR_variable_pointers", 1},
-    {"VK_EXT_external_memory_dma_buf", 1},
-    {"VK_EXT_queue_family_foreign", 1},
-    {"VK_KHR_dedicated_allocation", 3},
-    {"VK_ANDROID_external_memory_android_hardware_buffer", 3},
-    {"VK_EXT_sampler_filter_minmax", 2},
-    {"VK_KHR_storage_buffer_storage_class", 1},
-    {"VK_AMD_gpu_shader_int16", 2},
-    {"VK_AMD_mixed_attachment_samples", 1},
-    {"VK_AMD_shader_fragment_mask", 1},
-    {"VK_EXT_inline_uniform_block", 1},
-    {"VK_EXT_shader_stencil_export", 1},
-    {"VK_EXT_sample_locations", 1},
-    {"VK_KHR_relaxed_block_layout", 1},
-    {"VK_KHR_get_memory_requirements2", 1},
-    {"VK_KHR_image_format_list", 1},
-    {"VK_EXT_blend_operation_advanced", 2},
-    {"VK_NV_fragment_coverage_to_color", 1},
-    {"VK_KHR_ray_tracing", 8},
-    {"VK_NV_framebuffer_mixed_samples", 1},
-    {"VK_NV_fill_rectangle", 1},
-    {"VK_NV_shader_sm_builtins", 1},
-    {"VK_EXT_post_depth_coverage", 1},
-    {"VK_KHR_sampler_ycbcr_conversion", 14},
-    {"VK_KHR_bind_memory2", 1},
-    {"VK_EXT_image_drm_format_modifier", 1},
-    {"VK_EXT_descriptor_indexing", 2},
-    {"VK_EXT_shader_viewport_index_layer", 1},
-    {"VK_NV_shading_rate_image", 3},
-    {"VK_NV_ray_tracing", 3},
-    {"VK_NV_representative_fragment_test", 2},
-    {"VK_KHR_maintenance3", 1},
-    {"VK_KHR_draw_indirect_count", 1},
-    {"VK_EXT_filter_cubic", 3},
+    {"VK_NV_win32_keyed_mutex", 2},
     {"VK_QCOM_render_pass_shader_resolve", 4},
-    {"VK_EXT_global_priority", 2},
-    {"VK_KHR_shader_subgroup_extended_types", 1},
-    {"VK_KHR_8bit_storage", 1},
-    {"VK_EXT_external_memory_host", 1},
-    {"VK_AMD_buffer_marker", 1},
-    {"VK_KHR_shader_atomic_int64", 1},
-    {"VK_KHR_shader_clock", 1},
-    {"VK_AMD_pipeline_compiler_control", 1},
-    {"VK_EXT_calibrated_timestamps", 1},
-    {"VK_AMD_shader_core_properties", 2},
-    {"VK_AMD_memory_overallocation_behavior", 1},
-    {"VK_EXT_vertex_attribute_divisor", 3},
-    {"VK_GGP_frame_token", 1},
-    {"VK_EXT_pipeline_creation_feedback", 1},
-    {"VK_KHR_driver_properties", 1},
-    {"VK_KHR_shader_float_controls", 4},
-    {"VK_NV_shader_subgroup_partitioned", 1},
-    {"VK_KHR_depth_stencil_resolve", 1},
-    {"VK_KHR_swapchain_mutable_format", 1},
-    {"VK_NV_compute_shader_derivatives", 1},
-    {"VK_NV_mesh_shader", 1},
-    {"VK_NV_fragment_shader_barycentric", 1},
-    {"VK_NV_shader_image_footprint", 2},
-    {"VK_NV_scissor_exclusive", 1},
-    {"VK_NV_device_diagnostic_checkpoints", 2},
-    {"VK_KHR_timeline_semaphore", 2},
-    {"VK_INTEL_shader_integer_functions2", 1},
-    {"VK_INTEL_performance_query", 2},
-    {"VK_KHR_vulkan_memory_model", 3},
-    {"VK_EXT_pci_bus_info", 2},
-    {"VK_AMD_display_native_hdr", 1},
-    {"VK_EXT_fragment_density_map", 1},
-    {"VK_EXT_scalar_block_layout", 1},
-    {"VK_GOOGLE_hlsl_functionality1", 1},
-    {"VK_GOOGLE_decorate_string", 1},
-    {"VK_EXT_subgroup_size_control", 2},
-    {"VK_AMD_shader_core_properties2", 1},
-    {"VK_AMD_device_coherent_memory", 1},
-    {"VK_KHR_spirv_1_4", 1},
-    {"VK_EXT_memory_budget", 1},
-    {"VK_EXT_memory_priority", 1},
-    {"VK_NV_dedicated_allocation_image_aliasing", 1},
-    {"VK_KHR_separate_depth_stencil_layouts", 1},
-    {"VK_EXT_buffer_device_address", 2},
-    {"VK_EXT_tooling_info", 1},
-    {"VK_EXT_separate_stencil_usage", 1},
-    {"VK_NV_cooperative_matrix", 1},
-    {"VK_NV_coverage_reduction_mode", 1},
-    {"VK_EXT_fragment_shader_interlock", 1},
-    {"VK_EXT_ycbcr_image_arrays", 1},
-    {"VK_KHR_uniform_buffer_standard_layout", 1},
-    {"VK_EXT_full_screen_exclusive", 4},
-    {"VK_KHR_buffer_device_address", 1},
-    {"VK_EXT_line_rasterization", 1},
-    {"VK_EXT_host_query_reset", 1},
-    {"VK_EXT_index_type_uint8", 1},
-    {"VK_EXT_extended_dynamic_state", 1},
-    {"VK_KHR_deferred_host_operations", 3},
-    {"VK_KHR_pipeline_executable_properties", 1},
-    {"VK_EXT_shader_demote_to_helper_invocation", 1},
-    {"VK_NV_device_generated_commands", 3},
-    {"VK_EXT_texel_buffer_alignment", 1},
-    {"VK_QCOM_render_pass_transform", 1},
-    {"VK_EXT_robustness2", 1},
-    {"VK_EXT_custom_border_color", 12},
-    {"VK_GOOGLE_user_type", 1},
-    {"VK_KHR_pipeline_library", 1},
-    {"VK_KHR_shader_non_semantic_info", 1},
-    {"VK_EXT_private_data", 1},
-    {"VK_EXT_pipeline_creation_cache_control", 3},
-    {"VK_NV_device_diagnostics_config", 1},
     {"VK_QCOM_render_pass_store_ops", 2},
-    {"VK_EXT_fragment_density_map2", 1},
+    {"VK_QCOM_render_pass_transform", 1},
 };
 
 
@@ -2948,553 +3035,2020 @@ static VKAPI_ATTR VkResult VKAPI_CALL GetDeviceAccelerationStructureCompatibilit
     const VkAccelerationStructureVersionKHR*    version);
 #endif /* VK_ENABLE_BETA_EXTENSIONS */
 
-// Map of all APIs to be intercepted by this layer
-static const std::unordered_map<std::string, void*> name_to_funcptr_map = {
-    {"vkCreateInstance", (void*)CreateInstance},
-    {"vkDestroyInstance", (void*)DestroyInstance},
-    {"vkEnumeratePhysicalDevices", (void*)EnumeratePhysicalDevices},
-    {"vkGetPhysicalDeviceFeatures", (void*)GetPhysicalDeviceFeatures},
-    {"vkGetPhysicalDeviceFormatProperties", (void*)GetPhysicalDeviceFormatProperties},
-    {"vkGetPhysicalDeviceImageFormatProperties", (void*)GetPhysicalDeviceImageFormatProperties},
-    {"vkGetPhysicalDeviceProperties", (void*)GetPhysicalDeviceProperties},
-    {"vkGetPhysicalDeviceQueueFamilyProperties", (void*)GetPhysicalDeviceQueueFamilyProperties},
-    {"vkGetPhysicalDeviceMemoryProperties", (void*)GetPhysicalDeviceMemoryProperties},
-    {"vkGetInstanceProcAddr", (void*)GetInstanceProcAddr},
-    {"vkGetDeviceProcAddr", (void*)GetDeviceProcAddr},
-    {"vkCreateDevice", (void*)CreateDevice},
-    {"vkDestroyDevice", (void*)DestroyDevice},
-    {"vkEnumerateInstanceExtensionProperties", (void*)EnumerateInstanceExtensionProperties},
-    {"vkEnumerateDeviceExtensionProperties", (void*)EnumerateDeviceExtensionProperties},
-    {"vkEnumerateInstanceLayerProperties", (void*)EnumerateInstanceLayerProperties},
-    {"vkEnumerateDeviceLayerProperties", (void*)EnumerateDeviceLayerProperties},
-    {"vkGetDeviceQueue", (void*)GetDeviceQueue},
-    {"vkQueueSubmit", (void*)QueueSubmit},
-    {"vkQueueWaitIdle", (void*)QueueWaitIdle},
-    {"vkDeviceWaitIdle", (void*)DeviceWaitIdle},
+// Identifiers of the vkCmd* commands recorded into command buffers
+enum class CommandId : uint32_t {
+    CmdBeginConditionalRenderingEXT,
+    CmdBeginDebugUtilsLabelEXT,
+    CmdBeginQuery,
+    CmdBeginQueryIndexedEXT,
+    CmdBeginRenderPass,
+    CmdBeginRenderPass2,
+    CmdBeginRenderPass2KHR,
+    CmdBeginTransformFeedbackEXT,
+    CmdBindDescriptorSets,
+    CmdBindIndexBuffer,
+    CmdBindPipeline,
+    CmdBindPipelineShaderGroupNV,
+    CmdBindShadingRateImageNV,
+    CmdBindTransformFeedbackBuffersEXT,
+    CmdBindVertexBuffers,
+    CmdBindVertexBuffers2EXT,
+    CmdBlitImage,
+    CmdBuildAccelerationStructureIndirectKHR,
+    CmdBuildAccelerationStructureKHR,
+    CmdBuildAccelerationStructureNV,
+    CmdClearAttachments,
+    CmdClearColorImage,
+    CmdClearDepthStencilImage,
+    CmdCopyAccelerationStructureKHR,
+    CmdCopyAccelerationStructureNV,
+    CmdCopyAccelerationStructureToMemoryKHR,
+    CmdCopyBuffer,
+    CmdCopyBufferToImage,
+    CmdCopyImage,
+    CmdCopyImageToBuffer,
+    CmdCopyMemoryToAccelerationStructureKHR,
+    CmdCopyQueryPoolResults,
+    CmdDebugMarkerBeginEXT,
+    CmdDebugMarkerEndEXT,
+    CmdDebugMarkerInsertEXT,
+    CmdDispatch,
+    CmdDispatchBase,
+    CmdDispatchBaseKHR,
+    CmdDispatchIndirect,
+    CmdDraw,
+    CmdDrawIndexed,
+    CmdDrawIndexedIndirect,
+    CmdDrawIndexedIndirectCount,
+    CmdDrawIndexedIndirectCountAMD,
+    CmdDrawIndexedIndirectCountKHR,
+    CmdDrawIndirect,
+    CmdDrawIndirectByteCountEXT,
+    CmdDrawIndirectCount,
+    CmdDrawIndirectCountAMD,
+    CmdDrawIndirectCountKHR,
+    CmdDrawMeshTasksIndirectCountNV,
+    CmdDrawMeshTasksIndirectNV,
+    CmdDrawMeshTasksNV,
+    CmdEndConditionalRenderingEXT,
+    CmdEndDebugUtilsLabelEXT,
+    CmdEndQuery,
+    CmdEndQueryIndexedEXT,
+    CmdEndRenderPass,
+    CmdEndRenderPass2,
+    CmdEndRenderPass2KHR,
+    CmdEndTransformFeedbackEXT,
+    CmdExecuteCommands,
+    CmdExecuteGeneratedCommandsNV,
+    CmdFillBuffer,
+    CmdInsertDebugUtilsLabelEXT,
+    CmdNextSubpass,
+    CmdNextSubpass2,
+    CmdNextSubpass2KHR,
+    CmdPipelineBarrier,
+    CmdPreprocessGeneratedCommandsNV,
+    CmdPushConstants,
+    CmdPushDescriptorSetKHR,
+    CmdPushDescriptorSetWithTemplateKHR,
+    CmdResetEvent,
+    CmdResetQueryPool,
+    CmdResolveImage,
+    CmdSetBlendConstants,
+    CmdSetCheckpointNV,
+    CmdSetCoarseSampleOrderNV,
+    CmdSetCullModeEXT,
+    CmdSetDepthBias,
+    CmdSetDepthBounds,
+    CmdSetDepthBoundsTestEnableEXT,
+    CmdSetDepthCompareOpEXT,
+    CmdSetDepthTestEnableEXT,
+    CmdSetDepthWriteEnableEXT,
+    CmdSetDeviceMask,
+    CmdSetDeviceMaskKHR,
+    CmdSetDiscardRectangleEXT,
+    CmdSetEvent,
+    CmdSetExclusiveScissorNV,
+    CmdSetFrontFaceEXT,
+    CmdSetLineStippleEXT,
+    CmdSetLineWidth,
+    CmdSetPerformanceMarkerINTEL,
+    CmdSetPerformanceOverrideINTEL,
+    CmdSetPerformanceStreamMarkerINTEL,
+    CmdSetPrimitiveTopologyEXT,
+    CmdSetSampleLocationsEXT,
+    CmdSetScissor,
+    CmdSetScissorWithCountEXT,
+    CmdSetStencilCompareMask,
+    CmdSetStencilOpEXT,
+    CmdSetStencilReference,
+    CmdSetStencilTestEnableEXT,
+    CmdSetStencilWriteMask,
+    CmdSetViewport,
+    CmdSetViewportShadingRatePaletteNV,
+    CmdSetViewportWScalingNV,
+    CmdSetViewportWithCountEXT,
+    CmdTraceRaysIndirectKHR,
+    CmdTraceRaysKHR,
+    CmdTraceRaysNV,
+    CmdUpdateBuffer,
+    CmdWaitEvents,
+    CmdWriteAccelerationStructuresPropertiesKHR,
+    CmdWriteAccelerationStructuresPropertiesNV,
+    CmdWriteBufferMarkerAMD,
+    CmdWriteTimestamp,
+};
+static const char* const command_names[] = {
+    "vkCmdBeginConditionalRenderingEXT",
+    "vkCmdBeginDebugUtilsLabelEXT",
+    "vkCmdBeginQuery",
+    "vkCmdBeginQueryIndexedEXT",
+    "vkCmdBeginRenderPass",
+    "vkCmdBeginRenderPass2",
+    "vkCmdBeginRenderPass2KHR",
+    "vkCmdBeginTransformFeedbackEXT",
+    "vkCmdBindDescriptorSets",
+    "vkCmdBindIndexBuffer",
+    "vkCmdBindPipeline",
+    "vkCmdBindPipelineShaderGroupNV",
+    "vkCmdBindShadingRateImageNV",
+    "vkCmdBindTransformFeedbackBuffersEXT",
+    "vkCmdBindVertexBuffers",
+    "vkCmdBindVertexBuffers2EXT",
+    "vkCmdBlitImage",
+    "vkCmdBuildAccelerationStructureIndirectKHR",
+    "vkCmdBuildAccelerationStructureKHR",
+    "vkCmdBuildAccelerationStructureNV",
+    "vkCmdClearAttachments",
+    "vkCmdClearColorImage",
+    "vkCmdClearDepthStencilImage",
+    "vkCmdCopyAccelerationStructureKHR",
+    "vkCmdCopyAccelerationStructureNV",
+    "vkCmdCopyAccelerationStructureToMemoryKHR",
+    "vkCmdCopyBuffer",
+    "vkCmdCopyBufferToImage",
+    "vkCmdCopyImage",
+    "vkCmdCopyImageToBuffer",
+    "vkCmdCopyMemoryToAccelerationStructureKHR",
+    "vkCmdCopyQueryPoolResults",
+    "vkCmdDebugMarkerBeginEXT",
+    "vkCmdDebugMarkerEndEXT",
+    "vkCmdDebugMarkerInsertEXT",
+    "vkCmdDispatch",
+    "vkCmdDispatchBase",
+    "vkCmdDispatchBaseKHR",
+    "vkCmdDispatchIndirect",
+    "vkCmdDraw",
+    "vkCmdDrawIndexed",
+    "vkCmdDrawIndexedIndirect",
+    "vkCmdDrawIndexedIndirectCount",
+    "vkCmdDrawIndexedIndirectCountAMD",
+    "vkCmdDrawIndexedIndirectCountKHR",
+    "vkCmdDrawIndirect",
+    "vkCmdDrawIndirectByteCountEXT",
+    "vkCmdDrawIndirectCount",
+    "vkCmdDrawIndirectCountAMD",
+    "vkCmdDrawIndirectCountKHR",
+    "vkCmdDrawMeshTasksIndirectCountNV",
+    "vkCmdDrawMeshTasksIndirectNV",
+    "vkCmdDrawMeshTasksNV",
+    "vkCmdEndConditionalRenderingEXT",
+    "vkCmdEndDebugUtilsLabelEXT",
+    "vkCmdEndQuery",
+    "vkCmdEndQueryIndexedEXT",
+    "vkCmdEndRenderPass",
+    "vkCmdEndRenderPass2",
+    "vkCmdEndRenderPass2KHR",
+    "vkCmdEndTransformFeedbackEXT",
+    "vkCmdExecuteCommands",
+    "vkCmdExecuteGeneratedCommandsNV",
+    "vkCmdFillBuffer",
+    "vkCmdInsertDebugUtilsLabelEXT",
+    "vkCmdNextSubpass",
+    "vkCmdNextSubpass2",
+    "vkCmdNextSubpass2KHR",
+    "vkCmdPipelineBarrier",
+    "vkCmdPreprocessGeneratedCommandsNV",
+    "vkCmdPushConstants",
+    "vkCmdPushDescriptorSetKHR",
+    "vkCmdPushDescriptorSetWithTemplateKHR",
+    "vkCmdResetEvent",
+    "vkCmdResetQueryPool",
+    "vkCmdResolveImage",
+    "vkCmdSetBlendConstants",
+    "vkCmdSetCheckpointNV",
+    "vkCmdSetCoarseSampleOrderNV",
+    "vkCmdSetCullModeEXT",
+    "vkCmdSetDepthBias",
+    "vkCmdSetDepthBounds",
+    "vkCmdSetDepthBoundsTestEnableEXT",
+    "vkCmdSetDepthCompareOpEXT",
+    "vkCmdSetDepthTestEnableEXT",
+    "vkCmdSetDepthWriteEnableEXT",
+    "vkCmdSetDeviceMask",
+    "vkCmdSetDeviceMaskKHR",
+    "vkCmdSetDiscardRectangleEXT",
+    "vkCmdSetEvent",
+    "vkCmdSetExclusiveScissorNV",
+    "vkCmdSetFrontFaceEXT",
+    "vkCmdSetLineStippleEXT",
+    "vkCmdSetLineWidth",
+    "vkCmdSetPerformanceMarkerINTEL",
+    "vkCmdSetPerformanceOverrideINTEL",
+    "vkCmdSetPerformanceStreamMarkerINTEL",
+    "vkCmdSetPrimitiveTopologyEXT",
+    "vkCmdSetSampleLocationsEXT",
+    "vkCmdSetScissor",
+    "vkCmdSetScissorWithCountEXT",
+    "vkCmdSetStencilCompareMask",
+    "vkCmdSetStencilOpEXT",
+    "vkCmdSetStencilReference",
+    "vkCmdSetStencilTestEnableEXT",
+    "vkCmdSetStencilWriteMask",
+    "vkCmdSetViewport",
+    "vkCmdSetViewportShadingRatePaletteNV",
+    "vkCmdSetViewportWScalingNV",
+    "vkCmdSetViewportWithCountEXT",
+    "vkCmdTraceRaysIndirectKHR",
+    "vkCmdTraceRaysKHR",
+    "vkCmdTraceRaysNV",
+    "vkCmdUpdateBuffer",
+    "vkCmdWaitEvents",
+    "vkCmdWriteAccelerationStructuresPropertiesKHR",
+    "vkCmdWriteAccelerationStructuresPropertiesNV",
+    "vkCmdWriteBufferMarkerAMD",
+    "vkCmdWriteTimestamp",
+};
+
+// Members of VkPhysicalDeviceFeatures that device profiles can set, sorted by name
+static const ProfileField physical_device_features_fields[] = {
+    {"alphaToOne", offsetof(VkPhysicalDeviceFeatures, alphaToOne), ProfileFieldType::Bool32, 1},
+    {"depthBiasClamp", offsetof(VkPhysicalDeviceFeatures, depthBiasClamp), ProfileFieldType::Bool32, 1},
+    {"depthBounds", offsetof(VkPhysicalDeviceFeatures, depthBounds), ProfileFieldType::Bool32, 1},
+    {"depthClamp", offsetof(VkPhysicalDeviceFeatures, depthClamp), ProfileFieldType::Bool32, 1},
+    {"drawIndirectFirstInstance", offsetof(VkPhysicalDeviceFeatures, drawIndirectFirstInstance), ProfileFieldType::Bool32, 1},
+    {"dualSrcBlend", offsetof(VkPhysicalDeviceFeatures, dualSrcBlend), ProfileFieldType::Bool32, 1},
+    {"fillModeNonSolid", offsetof(VkPhysicalDeviceFeatures, fillModeNonSolid), ProfileFieldType::Bool32, 1},
+    {"fragmentStoresAndAtomics", offsetof(VkPhysicalDeviceFeatures, fragmentStoresAndAtomics), ProfileFieldType::Bool32, 1},
+    {"fullDrawIndexUint32", offsetof(VkPhysicalDeviceFeatures, fullDrawIndexUint32), ProfileFieldType::Bool32, 1},
+    {"geometryShader", offsetof(VkPhysicalDeviceFeatures, geometryShader), ProfileFieldType::Bool32, 1},
+    {"imageCubeArray", offsetof(VkPhysicalDeviceFeatures, imageCubeArray), ProfileFieldType::Bool32, 1},
+    {"independentBlend", offsetof(VkPhysicalDeviceFeatures, independentBlend), ProfileFieldType::Bool32, 1},
+    {"inheritedQueries", offsetof(VkPhysicalDeviceFeatures, inheritedQueries), ProfileFieldType::Bool32, 1},
+    {"largePoints", offsetof(VkPhysicalDeviceFeatures, largePoints), ProfileFieldType::Bool32, 1},
+    {"logicOp", offsetof(VkPhysicalDeviceFeatures, logicOp), ProfileFieldType::Bool32, 1},
+    {"multiDrawIndirect", offsetof(VkPhysicalDeviceFeatures, multiDrawIndirect), ProfileFieldType::Bool32, 1},
+    {"multiViewport", offsetof(VkPhysicalDeviceFeatures, multiViewport), ProfileFieldType::Bool32, 1},
+    {"occlusionQueryPrecise", offsetof(VkPhysicalDeviceFeatures, occlusionQueryPrecise), ProfileFieldType::Bool32, 1},
+    {"pipelineStatisticsQuery", offsetof(VkPhysicalDeviceFeatures, pipelineStatisticsQuery), ProfileFieldType::Bool32, 1},
+    {"robustBufferAccess", offsetof(VkPhysicalDeviceFeatures, robustBufferAccess), ProfileFieldType::Bool32, 1},
+    {"sampleRateShading", offsetof(VkPhysicalDeviceFeatures, sampleRateShading), ProfileFieldType::Bool32, 1},
+    {"samplerAnisotropy", offsetof(VkPhysicalDeviceFeatures, samplerAnisotropy), ProfileFieldType::Bool32, 1},
+    {"shaderClipDistance", offsetof(VkPhysicalDeviceFeatures, shaderClipDistance), ProfileFieldType::Bool32, 1},
+    {"shaderCullDistance", offsetof(VkPhysicalDeviceFeatures, shaderCullDistance), ProfileFieldType::Bool32, 1},
+    {"shaderFloat64", offsetof(VkPhysicalDeviceFeatures, shaderFloat64), ProfileFieldType::Bool32, 1},
+    {"shaderImageGatherExtended", offsetof(VkPhysicalDeviceFeatures, shaderImageGatherExtended), ProfileFieldType::Bool32, 1},
+    {"shaderInt16", offsetof(VkPhysicalDeviceFeatures, shaderInt16), ProfileFieldType::Bool32, 1},
+    {"shaderInt64", offsetof(VkPhysicalDeviceFeatures, shaderInt64), ProfileFieldType::Bool32, 1},
+    {"shaderResourceMinLod", offsetof(VkPhysicalDeviceFeatures, shaderResourceMinLod), ProfileFieldType::Bool32, 1},
+    {"shaderResourceResidency", offsetof(VkPhysicalDeviceFeatures, shaderResourceResidency), ProfileFieldType::Bool32, 1},
+    {"shaderSampledImageArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderSampledImageArrayDynamicIndexing), ProfileFieldType::Bool32, 1},
+    {"shaderStorageBufferArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderStorageBufferArrayDynamicIndexing), ProfileFieldType::Bool32, 1},
+    {"shaderStorageImageArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageArrayDynamicIndexing), ProfileFieldType::Bool32, 1},
+    {"shaderStorageImageExtendedFormats", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageExtendedFormats), ProfileFieldType::Bool32, 1},
+    {"shaderStorageImageMultisample", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageMultisample), ProfileFieldType::Bool32, 1},
+    {"shaderStorageImageReadWithoutFormat", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageReadWithoutFormat), ProfileFieldType::Bool32, 1},
+    {"shaderStorageImageWriteWithoutFormat", offsetof(VkPhysicalDeviceFeatures, shaderStorageImageWriteWithoutFormat), ProfileFieldType::Bool32, 1},
+    {"shaderTessellationAndGeometryPointSize", offsetof(VkPhysicalDeviceFeatures, shaderTessellationAndGeometryPointSize), ProfileFieldType::Bool32, 1},
+    {"shaderUniformBufferArrayDynamicIndexing", offsetof(VkPhysicalDeviceFeatures, shaderUniformBufferArrayDynamicIndexing), ProfileFieldType::Bool32, 1},
+    {"sparseBinding", offsetof(VkPhysicalDeviceFeatures, sparseBinding), ProfileFieldType::Bool32, 1},
+    {"sparseResidency16Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency16Samples), ProfileFieldType::Bool32, 1},
+    {"sparseResidency2Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency2Samples), ProfileFieldType::Bool32, 1},
+    {"sparseResidency4Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency4Samples), ProfileFieldType::Bool32, 1},
+    {"sparseResidency8Samples", offsetof(VkPhysicalDeviceFeatures, sparseResidency8Samples), ProfileFieldType::Bool32, 1},
+    {"sparseResidencyAliased", offsetof(VkPhysicalDeviceFeatures, sparseResidencyAliased), ProfileFieldType::Bool32, 1},
+    {"sparseResidencyBuffer", offsetof(VkPhysicalDeviceFeatures, sparseResidencyBuffer), ProfileFieldType::Bool32, 1},
+    {"sparseResidencyImage2D", offsetof(VkPhysicalDeviceFeatures, sparseResidencyImage2D), ProfileFieldType::Bool32, 1},
+    {"sparseResidencyImage3D", offsetof(VkPhysicalDeviceFeatures, sparseResidencyImage3D), ProfileFieldType::Bool32, 1},
+    {"tessellationShader", offsetof(VkPhysicalDeviceFeatures, tessellationShader), ProfileFieldType::Bool32, 1},
+    {"textureCompressionASTC_LDR", offsetof(VkPhysicalDeviceFeatures, textureCompressionASTC_LDR), ProfileFieldType::Bool32, 1},
+    {"textureCompressionBC", offsetof(VkPhysicalDeviceFeatures, textureCompressionBC), ProfileFieldType::Bool32, 1},
+    {"textureCompressionETC2", offsetof(VkPhysicalDeviceFeatures, textureCompressionETC2), ProfileFieldType::Bool32, 1},
+    {"variableMultisampleRate", offsetof(VkPhysicalDeviceFeatures, variableMultisampleRate), ProfileFieldType::Bool32, 1},
+    {"vertexPipelineStoresAndAtomics", offsetof(VkPhysicalDeviceFeatures, vertexPipelineStoresAndAtomics), ProfileFieldType::Bool32, 1},
+    {"wideLines", offsetof(VkPhysicalDeviceFeatures, wideLines), ProfileFieldType::Bool32, 1},
+};
+
+// Members of VkPhysicalDeviceLimits that device profiles can set, sorted by name
+static const ProfileField physical_device_limits_fields[] = {
+    {"bufferImageGranularity", offsetof(VkPhysicalDeviceLimits, bufferImageGranularity), ProfileFieldType::Uint64, 1},
+    {"discreteQueuePriorities", offsetof(VkPhysicalDeviceLimits, discreteQueuePriorities), ProfileFieldType::Uint32, 1},
+    {"framebufferColorSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferColorSampleCounts), ProfileFieldType::Uint32, 1},
+    {"framebufferDepthSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferDepthSampleCounts), ProfileFieldType::Uint32, 1},
+    {"framebufferNoAttachmentsSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferNoAttachmentsSampleCounts), ProfileFieldType::Uint32, 1},
+    {"framebufferStencilSampleCounts", offsetof(VkPhysicalDeviceLimits, framebufferStencilSampleCounts), ProfileFieldType::Uint32, 1},
+    {"lineWidthGranularity", offsetof(VkPhysicalDeviceLimits, lineWidthGranularity), ProfileFieldType::Float, 1},
+    {"lineWidthRange", offsetof(VkPhysicalDeviceLimits, lineWidthRange), ProfileFieldType::Float, 2},
+    {"maxBoundDescriptorSets", offsetof(VkPhysicalDeviceLimits, maxBoundDescriptorSets), ProfileFieldType::Uint32, 1},
+    {"maxClipDistances", offsetof(VkPhysicalDeviceLimits, maxClipDistances), ProfileFieldType::Uint32, 1},
+    {"maxColorAttachments", offsetof(VkPhysicalDeviceLimits, maxColorAttachments), ProfileFieldType::Uint32, 1},
+    {"maxCombinedClipAndCullDistances", offsetof(VkPhysicalDeviceLimits, maxCombinedClipAndCullDistances), ProfileFieldType::Uint32, 1},
+    {"maxComputeSharedMemorySize", offsetof(VkPhysicalDeviceLimits, maxComputeSharedMemorySize), ProfileFieldType::Uint32, 1},
+    {"maxComputeWorkGroupCount", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupCount), ProfileFieldType::Uint32, 3},
+    {"maxComputeWorkGroupInvocations", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupInvocations), ProfileFieldType::Uint32, 1},
+    {"maxComputeWorkGroupSize", offsetof(VkPhysicalDeviceLimits, maxComputeWorkGroupSize), ProfileFieldType::Uint32, 3},
+    {"maxCullDistances", offsetof(VkPhysicalDeviceLimits, maxCullDistances), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetInputAttachments", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetInputAttachments), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetSampledImages", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetSampledImages), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetSamplers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetSamplers), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetStorageBuffers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffers), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetStorageBuffersDynamic", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageBuffersDynamic), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetStorageImages", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetStorageImages), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetUniformBuffers", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffers), ProfileFieldType::Uint32, 1},
+    {"maxDescriptorSetUniformBuffersDynamic", offsetof(VkPhysicalDeviceLimits, maxDescriptorSetUniformBuffersDynamic), ProfileFieldType::Uint32, 1},
+    {"maxDrawIndexedIndexValue", offsetof(VkPhysicalDeviceLimits, maxDrawIndexedIndexValue), ProfileFieldType::Uint32, 1},
+    {"maxDrawIndirectCount", offsetof(VkPhysicalDeviceLimits, maxDrawIndirectCount), ProfileFieldType::Uint32, 1},
+    {"maxFragmentCombinedOutputResources", offsetof(VkPhysicalDeviceLimits, maxFragmentCombinedOutputResources), ProfileFieldType::Uint32, 1},
+    {"maxFragmentDualSrcAttachments", offsetof(VkPhysicalDeviceLimits, maxFragmentDualSrcAttachments), ProfileFieldType::Uint32, 1},
+    {"maxFragmentInputComponents", offsetof(VkPhysicalDeviceLimits, maxFragmentInputComponents), ProfileFieldType::Uint32, 1},
+    {"maxFragmentOutputAttachments", offsetof(VkPhysicalDeviceLimits, maxFragmentOutputAttachments), ProfileFieldType::Uint32, 1},
+    {"maxFramebufferHeight", offsetof(VkPhysicalDeviceLimits, maxFramebufferHeight), ProfileFieldType::Uint32, 1},
+    {"maxFramebufferLayers", offsetof(VkPhysicalDeviceLimits, maxFramebufferLayers), ProfileFieldType::Uint32, 1},
+    {"maxFramebufferWidth", offsetof(VkPhysicalDeviceLimits, maxFramebufferWidth), ProfileFieldType::Uint32, 1},
+    {"maxGeometryInputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryInputComponents), ProfileFieldType::Uint32, 1},
+    {"maxGeometryOutputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxGeometryOutputVertices", offsetof(VkPhysicalDeviceLimits, maxGeometryOutputVertices), ProfileFieldType::Uint32, 1},
+    {"maxGeometryShaderInvocations", offsetof(VkPhysicalDeviceLimits, maxGeometryShaderInvocations), ProfileFieldType::Uint32, 1},
+    {"maxGeometryTotalOutputComponents", offsetof(VkPhysicalDeviceLimits, maxGeometryTotalOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxImageArrayLayers", offsetof(VkPhysicalDeviceLimits, maxImageArrayLayers), ProfileFieldType::Uint32, 1},
+    {"maxImageDimension1D", offsetof(VkPhysicalDeviceLimits, maxImageDimension1D), ProfileFieldType::Uint32, 1},
+    {"maxImageDimension2D", offsetof(VkPhysicalDeviceLimits, maxImageDimension2D), ProfileFieldType::Uint32, 1},
+    {"maxImageDimension3D", offsetof(VkPhysicalDeviceLimits, maxImageDimension3D), ProfileFieldType::Uint32, 1},
+    {"maxImageDimensionCube", offsetof(VkPhysicalDeviceLimits, maxImageDimensionCube), ProfileFieldType::Uint32, 1},
+    {"maxInterpolationOffset", offsetof(VkPhysicalDeviceLimits, maxInterpolationOffset), ProfileFieldType::Float, 1},
+    {"maxMemoryAllocationCount", offsetof(VkPhysicalDeviceLimits, maxMemoryAllocationCount), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorInputAttachments", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorInputAttachments), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorSampledImages", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorSampledImages), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorSamplers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorSamplers), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorStorageBuffers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageBuffers), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorStorageImages", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorStorageImages), ProfileFieldType::Uint32, 1},
+    {"maxPerStageDescriptorUniformBuffers", offsetof(VkPhysicalDeviceLimits, maxPerStageDescriptorUniformBuffers), ProfileFieldType::Uint32, 1},
+    {"maxPerStageResources", offsetof(VkPhysicalDeviceLimits, maxPerStageResources), ProfileFieldType::Uint32, 1},
+    {"maxPushConstantsSize", offsetof(VkPhysicalDeviceLimits, maxPushConstantsSize), ProfileFieldType::Uint32, 1},
+    {"maxSampleMaskWords", offsetof(VkPhysicalDeviceLimits, maxSampleMaskWords), ProfileFieldType::Uint32, 1},
+    {"maxSamplerAllocationCount", offsetof(VkPhysicalDeviceLimits, maxSamplerAllocationCount), ProfileFieldType::Uint32, 1},
+    {"maxSamplerAnisotropy", offsetof(VkPhysicalDeviceLimits, maxSamplerAnisotropy), ProfileFieldType::Float, 1},
+    {"maxSamplerLodBias", offsetof(VkPhysicalDeviceLimits, maxSamplerLodBias), ProfileFieldType::Float, 1},
+    {"maxStorageBufferRange", offsetof(VkPhysicalDeviceLimits, maxStorageBufferRange), ProfileFieldType::Uint32, 1},
+    {"maxTessellationControlPerPatchOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerPatchOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationControlPerVertexInputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerVertexInputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationControlPerVertexOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlPerVertexOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationControlTotalOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationControlTotalOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationEvaluationInputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationEvaluationInputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationEvaluationOutputComponents", offsetof(VkPhysicalDeviceLimits, maxTessellationEvaluationOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxTessellationGenerationLevel", offsetof(VkPhysicalDeviceLimits, maxTessellationGenerationLevel), ProfileFieldType::Uint32, 1},
+    {"maxTessellationPatchSize", offsetof(VkPhysicalDeviceLimits, maxTessellationPatchSize), ProfileFieldType::Uint32, 1},
+    {"maxTexelBufferElements", offsetof(VkPhysicalDeviceLimits, maxTexelBufferElements), ProfileFieldType::Uint32, 1},
+    {"maxTexelGatherOffset", offsetof(VkPhysicalDeviceLimits, maxTexelGatherOffset), ProfileFieldType::Uint32, 1},
+    {"maxTexelOffset", offsetof(VkPhysicalDeviceLimits, maxTexelOffset), ProfileFieldType::Uint32, 1},
+    {"maxUniformBufferRange", offsetof(VkPhysicalDeviceLimits, maxUniformBufferRange), ProfileFieldType::Uint32, 1},
+    {"maxVertexInputAttributeOffset", offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributeOffset), ProfileFieldType::Uint32, 1},
+    {"maxVertexInputAttributes", offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributes), ProfileFieldType::Uint32, 1},
+    {"maxVertexInputBindingStride", offsetof(VkPhysicalDeviceLimits, maxVertexInputBindingStride), ProfileFieldType::Uint32, 1},
+    {"maxVertexInputBindings", offsetof(VkPhysicalDeviceLimits, maxVertexInputBindings), ProfileFieldType::Uint32, 1},
+    {"maxVertexOutputComponents", offsetof(VkPhysicalDeviceLimits, maxVertexOutputComponents), ProfileFieldType::Uint32, 1},
+    {"maxViewportDimensions", offsetof(VkPhysicalDeviceLimits, maxViewportDimensions), ProfileFieldType::Uint32, 2},
+    {"maxViewports", offsetof(VkPhysicalDeviceLimits, maxViewports), ProfileFieldType::Uint32, 1},
+    {"minInterpolationOffset", offsetof(VkPhysicalDeviceLimits, minInterpolationOffset), ProfileFieldType::Float, 1},
+    {"minMemoryMapAlignment", offsetof(VkPhysicalDeviceLimits, minMemoryMapAlignment), ProfileFieldType::Size, 1},
+    {"minStorageBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minStorageBufferOffsetAlignment), ProfileFieldType::Uint64, 1},
+    {"minTexelBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minTexelBufferOffsetAlignment), ProfileFieldType::Uint64, 1},
+    {"minTexelGatherOffset", offsetof(VkPhysicalDeviceLimits, minTexelGatherOffset), ProfileFieldType::Int32, 1},
+    {"minTexelOffset", offsetof(VkPhysicalDeviceLimits, minTexelOffset), ProfileFieldType::Int32, 1},
+    {"minUniformBufferOffsetAlignment", offsetof(VkPhysicalDeviceLimits, minUniformBufferOffsetAlignment), ProfileFieldType::Uint64, 1},
+    {"mipmapPrecisionBits", offsetof(VkPhysicalDeviceLimits, mipmapPrecisionBits), ProfileFieldType::Uint32, 1},
+    {"nonCoherentAtomSize", offsetof(VkPhysicalDeviceLimits, nonCoherentAtomSize), ProfileFieldType::Uint64, 1},
+    {"optimalBufferCopyOffsetAlignment", offsetof(VkPhysicalDeviceLimits, optimalBufferCopyOffsetAlignment), ProfileFieldType::Uint64, 1},
+    {"optimalBufferCopyRowPitchAlignment", offsetof(VkPhysicalDeviceLimits, optimalBufferCopyRowPitchAlignment), ProfileFieldType::Uint64, 1},
+    {"pointSizeGranularity", offsetof(VkPhysicalDeviceLimits, pointSizeGranularity), ProfileFieldType::Float, 1},
+    {"pointSizeRange", offsetof(VkPhysicalDeviceLimits, pointSizeRange), ProfileFieldType::Float, 2},
+    {"sampledImageColorSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageColorSampleCounts), ProfileFieldType::Uint32, 1},
+    {"sampledImageDepthSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageDepthSampleCounts), ProfileFieldType::Uint32, 1},
+    {"sampledImageIntegerSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageIntegerSampleCounts), ProfileFieldType::Uint32, 1},
+    {"sampledImageStencilSampleCounts", offsetof(VkPhysicalDeviceLimits, sampledImageStencilSampleCounts), ProfileFieldType::Uint32, 1},
+    {"sparseAddressSpaceSize", offsetof(VkPhysicalDeviceLimits, sparseAddressSpaceSize), ProfileFieldType::Uint64, 1},
+    {"standardSampleLocations", offsetof(VkPhysicalDeviceLimits, standardSampleLocations), ProfileFieldType::Bool32, 1},
+    {"storageImageSampleCounts", offsetof(VkPhysicalDeviceLimits, storageImageSampleCounts), ProfileFieldType::Uint32, 1},
+    {"strictLines", offsetof(VkPhysicalDeviceLimits, strictLines), ProfileFieldType::Bool32, 1},
+    {"subPixelInterpolationOffsetBits", offsetof(VkPhysicalDeviceLimits, subPixelInterpolationOffsetBits), ProfileFieldType::Uint32, 1},
+    {"subPixelPrecisionBits", offsetof(VkPhysicalDeviceLimits, subPixelPrecisionBits), ProfileFieldType::Uint32, 1},
+    {"subTexelPrecisionBits", offsetof(VkPhysicalDeviceLimits, subTexelPrecisionBits), ProfileFieldType::Uint32, 1},
+    {"timestampComputeAndGraphics", offsetof(VkPhysicalDeviceLimits, timestampComputeAndGraphics), ProfileFieldType::Bool32, 1},
+    {"timestampPeriod", offsetof(VkPhysicalDeviceLimits, timestampPeriod), ProfileFieldType::Float, 1},
+    {"viewportBoundsRange", offsetof(VkPhysicalDeviceLimits, viewportBoundsRange), ProfileFieldType::Float, 2},
+    {"viewportSubPixelBits", offsetof(VkPhysicalDeviceLimits, viewportSubPixelBits), ProfileFieldType::Uint32, 1},
+};
+
+// Identifiers of all intercepts, in the order of name_to_funcptr_map
+enum class EntryPoint : uint32_t {
+    AcquireFullScreenExclusiveModeEXT,
+    AcquireNextImage2KHR,
+    AcquireNextImageKHR,
+    AcquirePerformanceConfigurationINTEL,
+    AcquireProfilingLockKHR,
+    AcquireXlibDisplayEXT,
+    AllocateCommandBuffers,
+    AllocateDescriptorSets,
+    AllocateMemory,
+    BeginCommandBuffer,
+    BindAccelerationStructureMemoryKHR,
+    BindAccelerationStructureMemoryNV,
+    BindBufferMemory,
+    BindBufferMemory2,
+    BindBufferMemory2KHR,
+    BindImageMemory,
+    BindImageMemory2,
+    BindImageMemory2KHR,
+    BuildAccelerationStructureKHR,
+    CmdBeginConditionalRenderingEXT,
+    CmdBeginDebugUtilsLabelEXT,
+    CmdBeginQuery,
+    CmdBeginQueryIndexedEXT,
+    CmdBeginRenderPass,
+    CmdBeginRenderPass2,
+    CmdBeginRenderPass2KHR,
+    CmdBeginTransformFeedbackEXT,
+    CmdBindDescriptorSets,
+    CmdBindIndexBuffer,
+    CmdBindPipeline,
+    CmdBindPipelineShaderGroupNV,
+    CmdBindShadingRateImageNV,
+    CmdBindTransformFeedbackBuffersEXT,
+    CmdBindVertexBuffers,
+    CmdBindVertexBuffers2EXT,
+    CmdBlitImage,
+    CmdBuildAccelerationStructureIndirectKHR,
+    CmdBuildAccelerationStructureKHR,
+    CmdBuildAccelerationStructureNV,
+    CmdClearAttachments,
+    CmdClearColorImage,
+    CmdClearDepthStencilImage,
+    CmdCopyAccelerationStructureKHR,
+    CmdCopyAccelerationStructureNV,
+    CmdCopyAccelerationStructureToMemoryKHR,
+    CmdCopyBuffer,
+    CmdCopyBufferToImage,
+    CmdCopyImage,
+    CmdCopyImageToBuffer,
+    CmdCopyMemoryToAccelerationStructureKHR,
+    CmdCopyQueryPoolResults,
+    CmdDebugMarkerBeginEXT,
+    CmdDebugMarkerEndEXT,
+    CmdDebugMarkerInsertEXT,
+    CmdDispatch,
+    CmdDispatchBase,
+    CmdDispatchBaseKHR,
+    CmdDispatchIndirect,
+    CmdDraw,
+    CmdDrawIndexed,
+    CmdDrawIndexedIndirect,
+    CmdDrawIndexedIndirectCount,
+    CmdDrawIndexedIndirectCountAMD,
+    CmdDrawIndexedIndirectCountKHR,
+    CmdDrawIndirect,
+    CmdDrawIndirectByteCountEXT,
+    CmdDrawIndirectCount,
+    CmdDrawIndirectCountAMD,
+    CmdDrawIndirectCountKHR,
+    CmdDrawMeshTasksIndirectCountNV,
+    CmdDrawMeshTasksIndirectNV,
+    CmdDrawMeshTasksNV,
+    CmdEndConditionalRenderingEXT,
+    CmdEndDebugUtilsLabelEXT,
+    CmdEndQuery,
+    CmdEndQueryIndexedEXT,
+    CmdEndRenderPass,
+    CmdEndRenderPass2,
+    CmdEndRenderPass2KHR,
+    CmdEndTransformFeedbackEXT,
+    CmdExecuteCommands,
+    CmdExecuteGeneratedCommandsNV,
+    CmdFillBuffer,
+    CmdInsertDebugUtilsLabelEXT,
+    CmdNextSubpass,
+    CmdNextSubpass2,
+    CmdNextSubpass2KHR,
+    CmdPipelineBarrier,
+    CmdPreprocessGeneratedCommandsNV,
+    CmdPushConstants,
+    CmdPushDescriptorSetKHR,
+    CmdPushDescriptorSetWithTemplateKHR,
+    CmdResetEvent,
+    CmdResetQueryPool,
+    CmdResolveImage,
+    CmdSetBlendConstants,
+    CmdSetCheckpointNV,
+    CmdSetCoarseSampleOrderNV,
+    CmdSetCullModeEXT,
+    CmdSetDepthBias,
+    CmdSetDepthBounds,
+    CmdSetDepthBoundsTestEnableEXT,
+    CmdSetDepthCompareOpEXT,
+    CmdSetDepthTestEnableEXT,
+    CmdSetDepthWriteEnableEXT,
+    CmdSetDeviceMask,
+    CmdSetDeviceMaskKHR,
+    CmdSetDiscardRectangleEXT,
+    CmdSetEvent,
+    CmdSetExclusiveScissorNV,
+    CmdSetFrontFaceEXT,
+    CmdSetLineStippleEXT,
+    CmdSetLineWidth,
+    CmdSetPerformanceMarkerINTEL,
+    CmdSetPerformanceOverrideINTEL,
+    CmdSetPerformanceStreamMarkerINTEL,
+    CmdSetPrimitiveTopologyEXT,
+    CmdSetSampleLocationsEXT,
+    CmdSetScissor,
+    CmdSetScissorWithCountEXT,
+    CmdSetStencilCompareMask,
+    CmdSetStencilOpEXT,
+    CmdSetStencilReference,
+    CmdSetStencilTestEnableEXT,
+    CmdSetStencilWriteMask,
+    CmdSetViewport,
+    CmdSetViewportShadingRatePaletteNV,
+    CmdSetViewportWScalingNV,
+    CmdSetViewportWithCountEXT,
+    CmdTraceRaysIndirectKHR,
+    CmdTraceRaysKHR,
+    CmdTraceRaysNV,
+    CmdUpdateBuffer,
+    CmdWaitEvents,
+    CmdWriteAccelerationStructuresPropertiesKHR,
+    CmdWriteAccelerationStructuresPropertiesNV,
+    CmdWriteBufferMarkerAMD,
+    CmdWriteTimestamp,
+    CompileDeferredNV,
+    CopyAccelerationStructureKHR,
+    CopyAccelerationStructureToMemoryKHR,
+    CopyMemoryToAccelerationStructureKHR,
+    CreateAccelerationStructureKHR,
+    CreateAccelerationStructureNV,
+    CreateAndroidSurfaceKHR,
+    CreateBuffer,
+    CreateBufferView,
+    CreateCommandPool,
+    CreateComputePipelines,
+    CreateDebugReportCallbackEXT,
+    CreateDebugUtilsMessengerEXT,
+    CreateDeferredOperationKHR,
+    CreateDescriptorPool,
+    CreateDescriptorSetLayout,
+    CreateDescriptorUpdateTemplate,
+    CreateDescriptorUpdateTemplateKHR,
+    CreateDevice,
+    CreateDirectFBSurfaceEXT,
+    CreateDisplayModeKHR,
+    CreateDisplayPlaneSurfaceKHR,
+    CreateEvent,
+    CreateFence,
+    CreateFramebuffer,
+    CreateGraphicsPipelines,
+    CreateHeadlessSurfaceEXT,
+    CreateIOSSurfaceMVK,
+    CreateImage,
+    CreateImagePipeSurfaceFUCHSIA,
+    CreateImageView,
+    CreateIndirectCommandsLayoutNV,
+    CreateInstance,
+    CreateMacOSSurfaceMVK,
+    CreateMetalSurfaceEXT,
+    CreatePipelineCache,
+    CreatePipelineLayout,
+    CreatePrivateDataSlotEXT,
+    CreateQueryPool,
+    CreateRayTracingPipelinesKHR,
+    CreateRayTracingPipelinesNV,
+    CreateRenderPass,
+    CreateRenderPass2,
+    CreateRenderPass2KHR,
+    CreateSampler,
+    CreateSamplerYcbcrConversion,
+    CreateSamplerYcbcrConversionKHR,
+    CreateSemaphore,
+    CreateShaderModule,
+    CreateSharedSwapchainsKHR,
+    CreateStreamDescriptorSurfaceGGP,
+    CreateSwapchainKHR,
+    CreateValidationCacheEXT,
+    CreateViSurfaceNN,
+    CreateWaylandSurfaceKHR,
+    CreateWin32SurfaceKHR,
+    CreateXcbSurfaceKHR,
+    CreateXlibSurfaceKHR,
+    DebugMarkerSetObjectNameEXT,
+    DebugMarkerSetObjectTagEXT,
+    DebugReportMessageEXT,
+    DeferredOperationJoinKHR,
+    DestroyAccelerationStructureKHR,
+    DestroyAccelerationStructureNV,
+    DestroyBuffer,
+    DestroyBufferView,
+    DestroyCommandPool,
+    DestroyDebugReportCallbackEXT,
+    DestroyDebugUtilsMessengerEXT,
+    DestroyDeferredOperationKHR,
+    DestroyDescriptorPool,
+    DestroyDescriptorSetLayout,
+    DestroyDescriptorUpdateTemplate,
+    DestroyDescriptorUpdateTemplateKHR,
+    DestroyDevice,
+    DestroyEvent,
+    DestroyFence,
+    DestroyFramebuffer,
+    DestroyImage,
+    DestroyImageView,
+    DestroyIndirectCommandsLayoutNV,
+    DestroyInstance,
+    DestroyPipeline,
+    DestroyPipelineCache,
+    DestroyPipelineLayout,
+    DestroyPrivateDataSlotEXT,
+    DestroyQueryPool,
+    DestroyRenderPass,
+    DestroySampler,
+    DestroySamplerYcbcrConversion,
+    DestroySamplerYcbcrConversionKHR,
+    DestroySemaphore,
+    DestroyShaderModule,
+    DestroySurfaceKHR,
+    DestroySwapchainKHR,
+    DestroyValidationCacheEXT,
+    DeviceWaitIdle,
+    DisplayPowerControlEXT,
+    EndCommandBuffer,
+    EnumerateDeviceExtensionProperties,
+    EnumerateDeviceLayerProperties,
+    EnumerateInstanceExtensionProperties,
+    EnumerateInstanceLayerProperties,
+    EnumerateInstanceVersion,
+    EnumeratePhysicalDeviceGroups,
+    EnumeratePhysicalDeviceGroupsKHR,
+    EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR,
+    EnumeratePhysicalDevices,
+    FlushMappedMemoryRanges,
+    FreeCommandBuffers,
+    FreeDescriptorSets,
+    FreeMemory,
+    GetAccelerationStructureDeviceAddressKHR,
+    GetAccelerationStructureHandleNV,
+    GetAccelerationStructureMemoryRequirementsKHR,
+    GetAccelerationStructureMemoryRequirementsNV,
+    GetAndroidHardwareBufferPropertiesANDROID,
+    GetBufferDeviceAddress,
+    GetBufferDeviceAddressEXT,
+    GetBufferDeviceAddressKHR,
+    GetBufferMemoryRequirements,
+    GetBufferMemoryRequirements2,
+    GetBufferMemoryRequirements2KHR,
+    GetBufferOpaqueCaptureAddress,
+    GetBufferOpaqueCaptureAddressKHR,
+    GetCalibratedTimestampsEXT,
+    GetDeferredOperationMaxConcurrencyKHR,
+    GetDeferredOperationResultKHR,
+    GetDescriptorSetLayoutSupport,
+    GetDescriptorSetLayoutSupportKHR,
+    GetDeviceAccelerationStructureCompatibilityKHR,
+    GetDeviceGroupPeerMemoryFeatures,
+    GetDeviceGroupPeerMemoryFeaturesKHR,
+    GetDeviceGroupPresentCapabilitiesKHR,
+    GetDeviceGroupSurfacePresentModes2EXT,
+    GetDeviceGroupSurfacePresentModesKHR,
+    GetDeviceMemoryCommitment,
+    GetDeviceMemoryOpaqueCaptureAddress,
+    GetDeviceMemoryOpaqueCaptureAddressKHR,
+    GetDeviceProcAddr,
+    GetDeviceQueue,
+    GetDeviceQueue2,
+    GetDisplayModeProperties2KHR,
+    GetDisplayModePropertiesKHR,
+    GetDisplayPlaneCapabilities2KHR,
+    GetDisplayPlaneCapabilitiesKHR,
+    GetDisplayPlaneSupportedDisplaysKHR,
+    GetEventStatus,
+    GetFenceFdKHR,
+    GetFenceStatus,
+    GetFenceWin32HandleKHR,
+    GetGeneratedCommandsMemoryRequirementsNV,
+    GetImageDrmFormatModifierPropertiesEXT,
+    GetImageMemoryRequirements,
+    GetImageMemoryRequirements2,
+    GetImageMemoryRequirements2KHR,
+    GetImageSparseMemoryRequirements,
+    GetImageSparseMemoryRequirements2,
+    GetImageSparseMemoryRequirements2KHR,
+    GetImageSubresourceLayout,
+    GetImageViewAddressNVX,
+    GetImageViewHandleNVX,
+    GetInstanceProcAddr,
+    GetMemoryAndroidHardwareBufferANDROID,
+    GetMemoryFdKHR,
+    GetMemoryFdPropertiesKHR,
+    GetMemoryHostPointerPropertiesEXT,
+    GetMemoryWin32HandleKHR,
+    GetMemoryWin32HandleNV,
+    GetMemoryWin32HandlePropertiesKHR,
+    GetPastPresentationTimingGOOGLE,
+    GetPerformanceParameterINTEL,
+    GetPhysicalDeviceCalibrateableTimeDomainsEXT,
+    GetPhysicalDeviceCooperativeMatrixPropertiesNV,
+    GetPhysicalDeviceDirectFBPresentationSupportEXT,
+    GetPhysicalDeviceDisplayPlaneProperties2KHR,
+    GetPhysicalDeviceDisplayPlanePropertiesKHR,
+    GetPhysicalDeviceDisplayProperties2KHR,
+    GetPhysicalDeviceDisplayPropertiesKHR,
+    GetPhysicalDeviceExternalBufferProperties,
+    GetPhysicalDeviceExternalBufferPropertiesKHR,
+    GetPhysicalDeviceExternalFenceProperties,
+    GetPhysicalDeviceExternalFencePropertiesKHR,
+    GetPhysicalDeviceExternalImageFormatPropertiesNV,
+    GetPhysicalDeviceExternalSemaphoreProperties,
+    GetPhysicalDeviceExternalSemaphorePropertiesKHR,
+    GetPhysicalDeviceFeatures,
+    GetPhysicalDeviceFeatures2,
+    GetPhysicalDeviceFeatures2KHR,
+    GetPhysicalDeviceFormatProperties,
+    GetPhysicalDeviceFormatProperties2,
+    GetPhysicalDeviceFormatProperties2KHR,
+    GetPhysicalDeviceImageFormatProperties,
+    GetPhysicalDeviceImageFormatProperties2,
+    GetPhysicalDeviceImageFormatProperties2KHR,
+    GetPhysicalDeviceMemoryProperties,
+    GetPhysicalDeviceMemoryProperties2,
+    GetPhysicalDeviceMemoryProperties2KHR,
+    GetPhysicalDeviceMultisamplePropertiesEXT,
+    GetPhysicalDevicePresentRectanglesKHR,
+    GetPhysicalDeviceProperties,
+    GetPhysicalDeviceProperties2,
+    GetPhysicalDeviceProperties2KHR,
+    GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR,
+    GetPhysicalDeviceQueueFamilyProperties,
+    GetPhysicalDeviceQueueFamilyProperties2,
+    GetPhysicalDeviceQueueFamilyProperties2KHR,
+    GetPhysicalDeviceSparseImageFormatProperties,
+    GetPhysicalDeviceSparseImageFormatProperties2,
+    GetPhysicalDeviceSparseImageFormatProperties2KHR,
+    GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV,
+    GetPhysicalDeviceSurfaceCapabilities2EXT,
+    GetPhysicalDeviceSurfaceCapabilities2KHR,
+    GetPhysicalDeviceSurfaceCapabilitiesKHR,
+    GetPhysicalDeviceSurfaceFormats2KHR,
+    GetPhysicalDeviceSurfaceFormatsKHR,
+    GetPhysicalDeviceSurfacePresentModes2EXT,
+    GetPhysicalDeviceSurfacePresentModesKHR,
+    GetPhysicalDeviceSurfaceSupportKHR,
+    GetPhysicalDeviceToolPropertiesEXT,
+    GetPhysicalDeviceWaylandPresentationSupportKHR,
+    GetPhysicalDeviceWin32PresentationSupportKHR,
+    GetPhysicalDeviceXcbPresentationSupportKHR,
+    GetPhysicalDeviceXlibPresentationSupportKHR,
+    GetPipelineCacheData,
+    GetPipelineExecutableInternalRepresentationsKHR,
+    GetPipelineExecutablePropertiesKHR,
+    GetPipelineExecutableStatisticsKHR,
+    GetPrivateDataEXT,
+    GetQueryPoolResults,
+    GetQueueCheckpointDataNV,
+    GetRandROutputDisplayEXT,
+    GetRayTracingCaptureReplayShaderGroupHandlesKHR,
+    GetRayTracingShaderGroupHandlesKHR,
+    GetRayTracingShaderGroupHandlesNV,
+    GetRefreshCycleDurationGOOGLE,
+    GetRenderAreaGranularity,
+    GetSemaphoreCounterValue,
+    GetSemaphoreCounterValueKHR,
+    GetSemaphoreFdKHR,
+    GetSemaphoreWin32HandleKHR,
+    GetShaderInfoAMD,
+    GetSwapchainCounterEXT,
+    GetSwapchainImagesKHR,
+    GetSwapchainStatusKHR,
+    GetValidationCacheDataEXT,
+    ImportFenceFdKHR,
+    ImportFenceWin32HandleKHR,
+    ImportSemaphoreFdKHR,
+    ImportSemaphoreWin32HandleKHR,
+    InitializePerformanceApiINTEL,
+    InvalidateMappedMemoryRanges,
+    MapMemory,
+    MergePipelineCaches,
+    MergeValidationCachesEXT,
+    QueueBeginDebugUtilsLabelEXT,
+    QueueBindSparse,
+    QueueEndDebugUtilsLabelEXT,
+    QueueInsertDebugUtilsLabelEXT,
+    QueuePresentKHR,
+    QueueSetPerformanceConfigurationINTEL,
+    QueueSubmit,
+    QueueWaitIdle,
+    RegisterDeviceEventEXT,
+    RegisterDisplayEventEXT,
+    ReleaseDisplayEXT,
+    ReleaseFullScreenExclusiveModeEXT,
+    ReleasePerformanceConfigurationINTEL,
+    ReleaseProfilingLockKHR,
+    ResetCommandBuffer,
+    ResetCommandPool,
+    ResetDescriptorPool,
+    ResetEvent,
+    ResetFences,
+    ResetQueryPool,
+    ResetQueryPoolEXT,
+    SetDebugUtilsObjectNameEXT,
+    SetDebugUtilsObjectTagEXT,
+    SetEvent,
+    SetHdrMetadataEXT,
+    SetLocalDimmingAMD,
+    SetPrivateDataEXT,
+    SignalSemaphore,
+    SignalSemaphoreKHR,
+    SubmitDebugUtilsMessageEXT,
+    TrimCommandPool,
+    TrimCommandPoolKHR,
+    UninitializePerformanceApiINTEL,
+    UnmapMemory,
+    UpdateDescriptorSetWithTemplate,
+    UpdateDescriptorSetWithTemplateKHR,
+    UpdateDescriptorSets,
+    WaitForFences,
+    WaitSemaphores,
+    WaitSemaphoresKHR,
+    WriteAccelerationStructuresPropertiesKHR,
+};
+static constexpr uint32_t kEntryPointCount = 434;
+// Names of the parameters of each intercept that API traces record
+static const char* const entry_point_trace_args[] = {
+    "device,swapchain",
+    "device",
+    "device,swapchain,timeout,semaphore,fence",
+    "device",
+    "device",
+    "physicalDevice,display",
+    "device",
+    "device",
+    "device",
+    "commandBuffer",
+    "device,bindInfoCount",
+    "device,bindInfoCount",
+    "device,buffer,memory,memoryOffset",
+    "device,bindInfoCount",
+    "device,bindInfoCount",
+    "device,image,memory,memoryOffset",
+    "device,bindInfoCount",
+    "device,bindInfoCount",
+    "device,infoCount",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,queryPool,query,flags",
+    "commandBuffer,queryPool,query,flags,index",
+    "commandBuffer,contents",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,firstCounterBuffer,counterBufferCount",
+    "commandBuffer,pipelineBindPoint,layout,firstSet,descriptorSetCount,dynamicOffsetCount",
+    "commandBuffer,buffer,offset,indexType",
+    "commandBuffer,pipelineBindPoint,pipeline",
+    "commandBuffer,pipelineBindPoint,pipeline,groupIndex",
+    "commandBuffer,imageView,imageLayout",
+    "commandBuffer,firstBinding,bindingCount",
+    "commandBuffer,firstBinding,bindingCount",
+    "commandBuffer,firstBinding,bindingCount",
+    "commandBuffer,srcImage,srcImageLayout,dstImage,dstImageLayout,regionCount,filter",
+    "commandBuffer,indirectBuffer,indirectOffset,indirectStride",
+    "commandBuffer,infoCount",
+    "commandBuffer,instanceData,instanceOffset,update,dst,src,scratch,scratchOffset",
+    "commandBuffer,attachmentCount,rectCount",
+    "commandBuffer,image,imageLayout,rangeCount",
+    "commandBuffer,image,imageLayout,rangeCount",
+    "commandBuffer",
+    "commandBuffer,dst,src,mode",
+    "commandBuffer",
+    "commandBuffer,srcBuffer,dstBuffer,regionCount",
+    "commandBuffer,srcBuffer,dstImage,dstImageLayout,regionCount",
+    "commandBuffer,srcImage,srcImageLayout,dstImage,dstImageLayout,regionCount",
+    "commandBuffer,srcImage,srcImageLayout,dstBuffer,regionCount",
+    "commandBuffer",
+    "commandBuffer,queryPool,firstQuery,queryCount,dstBuffer,dstOffset,stride,flags",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,groupCountX,groupCountY,groupCountZ",
+    "commandBuffer,baseGroupX,baseGroupY,baseGroupZ,groupCountX,groupCountY,groupCountZ",
+    "commandBuffer,baseGroupX,baseGroupY,baseGroupZ,groupCountX,groupCountY,groupCountZ",
+    "commandBuffer,buffer,offset",
+    "commandBuffer,vertexCount,instanceCount,firstVertex,firstInstance",
+    "commandBuffer,indexCount,instanceCount,firstIndex,vertexOffset,firstInstance",
+    "commandBuffer,buffer,offset,drawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,drawCount,stride",
+    "commandBuffer,instanceCount,firstInstance,counterBuffer,counterBufferOffset,counterOffset,vertexStride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,countBuffer,countBufferOffset,maxDrawCount,stride",
+    "commandBuffer,buffer,offset,drawCount,stride",
+    "commandBuffer,taskCount,firstTask",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,queryPool,query",
+    "commandBuffer,queryPool,query,index",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,firstCounterBuffer,counterBufferCount",
+    "commandBuffer,commandBufferCount",
+    "commandBuffer,isPreprocessed",
+    "commandBuffer,dstBuffer,dstOffset,size,data",
+    "commandBuffer",
+    "commandBuffer,contents",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,srcStageMask,dstStageMask,dependencyFlags,memoryBarrierCount,bufferMemoryBarrierCount,imageMemoryBarrierCount",
+    "commandBuffer",
+    "commandBuffer,layout,stageFlags,offset,size",
+    "commandBuffer,pipelineBindPoint,layout,set,descriptorWriteCount",
+    "commandBuffer,descriptorUpdateTemplate,layout,set",
+    "commandBuffer,event,stageMask",
+    "commandBuffer,queryPool,firstQuery,queryCount",
+    "commandBuffer,srcImage,srcImageLayout,dstImage,dstImageLayout,regionCount",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,sampleOrderType,customSampleOrderCount",
+    "commandBuffer,cullMode",
+    "commandBuffer,depthBiasConstantFactor,depthBiasClamp,depthBiasSlopeFactor",
+    "commandBuffer,minDepthBounds,maxDepthBounds",
+    "commandBuffer,depthBoundsTestEnable",
+    "commandBuffer,depthCompareOp",
+    "commandBuffer,depthTestEnable",
+    "commandBuffer,depthWriteEnable",
+    "commandBuffer,deviceMask",
+    "commandBuffer,deviceMask",
+    "commandBuffer,firstDiscardRectangle,discardRectangleCount",
+    "commandBuffer,event,stageMask",
+    "commandBuffer,firstExclusiveScissor,exclusiveScissorCount",
+    "commandBuffer,frontFace",
+    "commandBuffer,lineStippleFactor,lineStipplePattern",
+    "commandBuffer,lineWidth",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer",
+    "commandBuffer,primitiveTopology",
+    "commandBuffer",
+    "commandBuffer,firstScissor,scissorCount",
+    "commandBuffer,scissorCount",
+    "commandBuffer,faceMask,compareMask",
+    "commandBuffer,faceMask,failOp,passOp,depthFailOp,compareOp",
+    "commandBuffer,faceMask,reference",
+    "commandBuffer,stencilTestEnable",
+    "commandBuffer,faceMask,writeMask",
+    "commandBuffer,firstViewport,viewportCount",
+    "commandBuffer,firstViewport,viewportCount",
+    "commandBuffer,firstViewport,viewportCount",
+    "commandBuffer,viewportCount",
+    "commandBuffer,buffer,offset",
+    "commandBuffer,width,height,depth",
+    "commandBuffer,raygenShaderBindingTableBuffer,raygenShaderBindingOffset,missShaderBindingTableBuffer,missShaderBindingOffset,missShaderBindingStride,hitShaderBindingTableBuffer,hitShaderBindingOffset",
+    "commandBuffer,dstBuffer,dstOffset,dataSize",
+    "commandBuffer,eventCount,srcStageMask,dstStageMask,memoryBarrierCount,bufferMemoryBarrierCount,imageMemoryBarrierCount",
+    "commandBuffer,accelerationStructureCount,queryType,queryPool,firstQuery",
+    "commandBuffer,accelerationStructureCount,queryType,queryPool,firstQuery",
+    "commandBuffer,pipelineStage,dstBuffer,dstOffset,marker",
+    "commandBuffer,pipelineStage,queryPool,query",
+    "device,pipeline,shader",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "instance",
+    "device",
+    "device",
+    "device",
+    "device,pipelineCache,createInfoCount",
+    "instance",
+    "instance",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "physicalDevice",
+    "instance",
+    "physicalDevice,display",
+    "instance",
+    "device",
+    "device",
+    "device",
+    "device,pipelineCache,createInfoCount",
+    "instance",
+    "instance",
+    "device",
+    "instance",
+    "device",
+    "device",
+    "",
+    "instance",
+    "instance",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device,pipelineCache,createInfoCount",
+    "device,pipelineCache,createInfoCount",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device,swapchainCount",
+    "instance",
+    "device",
+    "device",
+    "instance",
+    "instance",
+    "instance",
+    "instance",
+    "instance",
+    "device",
+    "device",
+    "instance,flags,objectType,object,location,messageCode",
+    "device,operation",
+    "device,accelerationStructure",
+    "device,accelerationStructure",
+    "device,buffer",
+    "device,bufferView",
+    "device,commandPool",
+    "instance,callback",
+    "instance,messenger",
+    "device,operation",
+    "device,descriptorPool",
+    "device,descriptorSetLayout",
+    "device,descriptorUpdateTemplate",
+    "device,descriptorUpdateTemplate",
+    "device",
+    "device,event",
+    "device,fence",
+    "device,framebuffer",
+    "device,image",
+    "device,imageView",
+    "device,indirectCommandsLayout",
+    "instance",
+    "device,pipeline",
+    "device,pipelineCache",
+    "device,pipelineLayout",
+    "device,privateDataSlot",
+    "device,queryPool",
+    "device,renderPass",
+    "device,sampler",
+    "device,ycbcrConversion",
+    "device,ycbcrConversion",
+    "device,semaphore",
+    "device,shaderModule",
+    "instance,surface",
+    "device,swapchain",
+    "device,validationCache",
+    "device",
+    "device,display",
+    "commandBuffer",
+    "physicalDevice",
+    "physicalDevice",
+    "",
+    "",
+    "",
+    "instance",
+    "instance",
+    "physicalDevice,queueFamilyIndex",
+    "instance",
+    "device,memoryRangeCount",
+    "device,commandPool,commandBufferCount",
+    "device,descriptorPool,descriptorSetCount",
+    "device,memory",
+    "device",
+    "device,accelerationStructure,dataSize",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device,buffer",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device,timestampCount",
+    "device,operation",
+    "device,operation",
+    "device",
+    "device",
+    "device",
+    "device,heapIndex,localDeviceIndex,remoteDeviceIndex",
+    "device,heapIndex,localDeviceIndex,remoteDeviceIndex",
+    "device",
+    "device",
+    "device,surface",
+    "device,memory",
+    "device",
+    "device",
+    "device",
+    "device,queueFamilyIndex,queueIndex",
+    "device",
+    "physicalDevice,display",
+    "physicalDevice,display",
+    "physicalDevice",
+    "physicalDevice,mode,planeIndex",
+    "physicalDevice,planeIndex",
+    "device,event",
+    "device",
+    "device,fence",
+    "device",
+    "device",
+    "device,image",
+    "device,image",
+    "device",
+    "device",
+    "device,image",
+    "device",
+    "device",
+    "device,image",
+    "device,imageView",
+    "device",
+    "instance",
+    "device",
+    "device",
+    "device,handleType,fd",
+    "device,handleType",
+    "device",
+    "device,memory,handleType",
+    "device,handleType,handle",
+    "device,swapchain",
+    "device,parameter",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,queueFamilyIndex",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,format,type,tiling,usage,flags,externalHandleType",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,format",
+    "physicalDevice,format",
+    "physicalDevice,format",
+    "physicalDevice,format,type,tiling,usage,flags",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,samples",
+    "physicalDevice,surface",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,format,type,samples,usage,tiling",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice",
+    "physicalDevice,surface",
+    "physicalDevice",
+    "physicalDevice,surface",
+    "physicalDevice",
+    "physicalDevice,surface",
+    "physicalDevice",
+    "physicalDevice,surface",
+    "physicalDevice,queueFamilyIndex,surface",
+    "physicalDevice",
+    "physicalDevice,queueFamilyIndex",
+    "physicalDevice,queueFamilyIndex",
+    "physicalDevice,queueFamilyIndex,visual_id",
+    "physicalDevice,queueFamilyIndex,visualID",
+    "device,pipelineCache",
+    "device",
+    "device",
+    "device",
+    "device,objectType,objectHandle,privateDataSlot",
+    "device,queryPool,firstQuery,queryCount,dataSize,stride,flags",
+    "queue",
+    "physicalDevice,rrOutput",
+    "device,pipeline,firstGroup,groupCount,dataSize",
+    "device,pipeline,firstGroup,groupCount,dataSize",
+    "device,pipeline,firstGroup,groupCount,dataSize",
+    "device,swapchain",
+    "device,renderPass",
+    "device,semaphore",
+    "device,semaphore",
+    "device",
+    "device",
+    "device,pipeline,shaderStage,infoType",
+    "device,swapchain,counter",
+    "device,swapchain",
+    "device,swapchain",
+    "device,validationCache",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device",
+    "device,memoryRangeCount",
+    "device,memory,offset,size,flags",
+    "device,dstCache,srcCacheCount",
+    "device,dstCache,srcCacheCount",
+    "queue",
+    "queue,bindInfoCount,fence",
+    "queue",
+    "queue",
+    "queue",
+    "queue,configuration",
+    "queue,submitCount,fence",
+    "queue",
+    "device",
+    "device,display",
+    "physicalDevice,display",
+    "device,swapchain",
+    "device,configuration",
+    "device",
+    "commandBuffer,flags",
+    "device,commandPool,flags",
+    "device,descriptorPool,flags",
+    "device,event",
+    "device,fenceCount",
+    "device,queryPool,firstQuery,queryCount",
+    "device,queryPool,firstQuery,queryCount",
+    "device",
+    "device",
+    "device,event",
+    "device,swapchainCount",
+    "device,swapChain,localDimmingEnable",
+    "device,objectType,objectHandle,privateDataSlot,data",
+    "device",
+    "device",
+    "instance,messageSeverity,messageTypes",
+    "device,commandPool,flags",
+    "device,commandPool,flags",
+    "device",
+    "device,memory",
+    "device,descriptorSet,descriptorUpdateTemplate",
+    "device,descriptorSet,descriptorUpdateTemplate",
+    "device,descriptorWriteCount,descriptorCopyCount",
+    "device,fenceCount,waitAll,timeout",
+    "device,timeout",
+    "device,timeout",
+    "device,accelerationStructureCount,queryType,dataSize,stride",
+};
+
+// Map of all APIs to be intercepted by this layer, sorted by name. Entries of functions that
+// are compiled out keep their index with an empty name so that the hash table below stays valid.
+static const NameToFuncPtr name_to_funcptr_map[] = {
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkAcquireFullScreenExclusiveModeEXT", (void*)AcquireFullScreenExclusiveModeEXT},
+#else
+    {"", nullptr},
+#endif
+    {"vkAcquireNextImage2KHR", (void*)AcquireNextImage2KHR},
+    {"vkAcquireNextImageKHR", (void*)AcquireNextImageKHR},
+    {"vkAcquirePerformanceConfigurationINTEL", (void*)AcquirePerformanceConfigurationINTEL},
+    {"vkAcquireProfilingLockKHR", (void*)AcquireProfilingLockKHR},
+#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
+    {"vkAcquireXlibDisplayEXT", (void*)AcquireXlibDisplayEXT},
+#else
+    {"", nullptr},
+#endif
+    {"vkAllocateCommandBuffers", (void*)AllocateCommandBuffers},
+    {"vkAllocateDescriptorSets", (void*)AllocateDescriptorSets},
     {"vkAllocateMemory", (void*)AllocateMemory},
-    {"vkFreeMemory", (void*)FreeMemory},
-    {"vkMapMemory", (void*)MapMemory},
-    {"vkUnmapMemory", (void*)UnmapMemory},
-    {"vkFlushMappedMemoryRanges", (void*)FlushMappedMemoryRanges},
-    {"vkInvalidateMappedMemoryRanges", (void*)InvalidateMappedMemoryRanges},
-    {"vkGetDeviceMemoryCommitment", (void*)GetDeviceMemoryCommitment},
+    {"vkBeginCommandBuffer", (void*)BeginCommandBuffer},
+    {"vkBindAccelerationStructureMemoryKHR", (void*)BindAccelerationStructureMemoryKHR},
+    {"vkBindAccelerationStructureMemoryNV", (void*)BindAccelerationStructureMemoryNV},
     {"vkBindBufferMemory", (void*)BindBufferMemory},
+    {"vkBindBufferMemory2", (void*)BindBufferMemory2},
+    {"vkBindBufferMemory2KHR", (void*)BindBufferMemory2KHR},
     {"vkBindImageMemory", (void*)BindImageMemory},
-    {"vkGetBufferMemoryRequirements", (void*)GetBufferMemoryRequirements},
-    {"vkGetImageMemoryRequirements", (void*)GetImageMemoryRequirements},
-    {"vkGetImageSparseMemoryRequirements", (void*)GetImageSparseMemoryRequirements},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties", (void*)GetPhysicalDeviceSparseImageFormatProperties},
-    {"vkQueueBindSparse", (void*)QueueBindSparse},
-    {"vkCreateFence", (void*)CreateFence},
-    {"vkDestroyFence", (void*)DestroyFence},
-    {"vkResetFences", (void*)ResetFences},
-    {"vkGetFenceStatus", (void*)GetFenceStatus},
-    {"vkWaitForFences", (void*)WaitForFences},
-    {"vkCreateSemaphore", (void*)CreateSemaphore},
-    {"vkDestroySemaphore", (void*)DestroySemaphore},
-    {"vkCreateEvent", (void*)CreateEvent},
-    {"vkDestroyEvent", (void*)DestroyEvent},
-    {"vkGetEventStatus", (void*)GetEventStatus},
-    {"vkSetEvent", (void*)SetEvent},
-    {"vkResetEvent", (void*)ResetEvent},
-    {"vkCreateQueryPool", (void*)CreateQueryPool},
-    {"vkDestroyQueryPool", (void*)DestroyQueryPool},
-    {"vkGetQueryPoolResults", (void*)GetQueryPoolResults},
-    {"vkCreateBuffer", (void*)CreateBuffer},
-    {"vkDestroyBuffer", (void*)DestroyBuffer},
-    {"vkCreateBufferView", (void*)CreateBufferView},
-    {"vkDestroyBufferView", (void*)DestroyBufferView},
-    {"vkCreateImage", (void*)CreateImage},
-    {"vkDestroyImage", (void*)DestroyImage},
-    {"vkGetImageSubresourceLayout", (void*)GetImageSubresourceLayout},
-    {"vkCreateImageView", (void*)CreateImageView},
-    {"vkDestroyImageView", (void*)DestroyImageView},
-    {"vkCreateShaderModule", (void*)CreateShaderModule},
-    {"vkDestroyShaderModule", (void*)DestroyShaderModule},
-    {"vkCreatePipelineCache", (void*)CreatePipelineCache},
-    {"vkDestroyPipelineCache", (void*)DestroyPipelineCache},
-    {"vkGetPipelineCacheData", (void*)GetPipelineCacheData},
-    {"vkMergePipelineCaches", (void*)MergePipelineCaches},
-    {"vkCreateGraphicsPipelines", (void*)CreateGraphicsPipelines},
-    {"vkCreateComputePipelines", (void*)CreateComputePipelines},
-    {"vkDestroyPipeline", (void*)DestroyPipeline},
-    {"vkCreatePipelineLayout", (void*)CreatePipelineLayout},
-    {"vkDestroyPipelineLayout", (void*)DestroyPipelineLayout},
-    {"vkCreateSampler", (void*)CreateSampler},
-    {"vkDestroySampler", (void*)DestroySampler},
-    {"vkCreateDescriptorSetLayout", (void*)CreateDescriptorSetLayout},
-    {"vkDestroyDescriptorSetLayout", (void*)DestroyDescriptorSetLayout},
-    {"vkCreateDescriptorPool", (void*)CreateDescriptorPool},
-    {"vkDestroyDescriptorPool", (void*)DestroyDescriptorPool},
-    {"vkResetDescriptorPool", (void*)ResetDescriptorPool},
-    {"vkAllocateDescriptorSets", (void*)AllocateDescriptorSets},
-    {"vkFreeDescriptorSets", (void*)FreeDescriptorSets},
-    {"vkUpdateDescriptorSets", (void*)UpdateDescriptorSets},
-    {"vkCreateFramebuffer", (void*)CreateFramebuffer},
-    {"vkDestroyFramebuffer", (void*)DestroyFramebuffer},
-    {"vkCreateRenderPass", (void*)CreateRenderPass},
-    {"vkDestroyRenderPass", (void*)DestroyRenderPass},
-    {"vkGetRenderAreaGranularity", (void*)GetRenderAreaGranularity},
-    {"vkCreateCommandPool", (void*)CreateCommandPool},
-    {"vkDestroyCommandPool", (void*)DestroyCommandPool},
-    {"vkResetCommandPool", (void*)ResetCommandPool},
-    {"vkAllocateCommandBuffers", (void*)AllocateCommandBuffers},
-    {"vkFreeCommandBuffers", (void*)FreeCommandBuffers},
-    {"vkBeginCommandBuffer", (void*)BeginCommandBuffer},
-    {"vkEndCommandBuffer", (void*)EndCommandBuffer},
-    {"vkResetCommandBuffer", (void*)ResetCommandBuffer},
+    {"vkBindImageMemory2", (void*)BindImageMemory2},
+    {"vkBindImageMemory2KHR", (void*)BindImageMemory2KHR},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkBuildAccelerationStructureKHR", (void*)BuildAccelerationStructureKHR},
+#else
+    {"", nullptr},
+#endif
+    {"vkCmdBeginConditionalRenderingEXT", (void*)CmdBeginConditionalRenderingEXT},
+    {"vkCmdBeginDebugUtilsLabelEXT", (void*)CmdBeginDebugUtilsLabelEXT},
+    {"vkCmdBeginQuery", (void*)CmdBeginQuery},
+    {"vkCmdBeginQueryIndexedEXT", (void*)CmdBeginQueryIndexedEXT},
+    {"vkCmdBeginRenderPass", (void*)CmdBeginRenderPass},
+    {"vkCmdBeginRenderPass2", (void*)CmdBeginRenderPass2},
+    {"vkCmdBeginRenderPass2KHR", (void*)CmdBeginRenderPass2KHR},
+    {"vkCmdBeginTransformFeedbackEXT", (void*)CmdBeginTransformFeedbackEXT},
+    {"vkCmdBindDescriptorSets", (void*)CmdBindDescriptorSets},
+    {"vkCmdBindIndexBuffer", (void*)CmdBindIndexBuffer},
     {"vkCmdBindPipeline", (void*)CmdBindPipeline},
-    {"vkCmdSetViewport", (void*)CmdSetViewport},
-    {"vkCmdSetScissor", (void*)CmdSetScissor},
-    {"vkCmdSetLineWidth", (void*)CmdSetLineWidth},
-    {"vkCmdSetDepthBias", (void*)CmdSetDepthBias},
-    {"vkCmdSetBlendConstants", (void*)CmdSetBlendConstants},
-    {"vkCmdSetDepthBounds", (void*)CmdSetDepthBounds},
-    {"vkCmdSetStencilCompareMask", (void*)CmdSetStencilCompareMask},
-    {"vkCmdSetStencilWriteMask", (void*)CmdSetStencilWriteMask},
-    {"vkCmdSetStencilReference", (void*)CmdSetStencilReference},
-    {"vkCmdBindDescriptorSets", (void*)CmdBindDescriptorSets},
-    {"vkCmdBindIndexBuffer", (void*)CmdBindIndexBuffer},
+    {"vkCmdBindPipelineShaderGroupNV", (void*)CmdBindPipelineShaderGroupNV},
+    {"vkCmdBindShadingRateImageNV", (void*)CmdBindShadingRateImageNV},
+    {"vkCmdBindTransformFeedbackBuffersEXT", (void*)CmdBindTransformFeedbackBuffersEXT},
     {"vkCmdBindVertexBuffers", (void*)CmdBindVertexBuffers},
-    {"vkCmdDraw", (void*)CmdDraw},
-    {"vkCmdDrawIndexed", (void*)CmdDrawIndexed},
-    {"vkCmdDrawIndirect", (void*)CmdDrawIndirect},
-    {"vkCmdDrawIndexedIndirect", (void*)CmdDrawIndexedIndirect},
-    {"vkCmdDispatch", (void*)CmdDispatch},
-    {"vkCmdDispatchIndirect", (void*)CmdDispatchIndirect},
-    {"vkCmdCopyBuffer", (void*)CmdCopyBuffer},
-    {"vkCmdCopyImage", (void*)CmdCopyImage},
+    {"vkCmdBindVertexBuffers2EXT", (void*)CmdBindVertexBuffers2EXT},
     {"vkCmdBlitImage", (void*)CmdBlitImage},
-    {"vkCmdCopyBufferToImage", (void*)CmdCopyBufferToImage},
-    {"vkCmdCopyImageToBuffer", (void*)CmdCopyImageToBuffer},
-    {"vkCmdUpdateBuffer", (void*)CmdUpdateBuffer},
-    {"vkCmdFillBuffer", (void*)CmdFillBuffer},
-    {"vkCmdClearColorImage", (void*)CmdClearColorImage},
-    {"vkCmdClearDepthStencilImage", (void*)CmdClearDepthStencilImage},
-    {"vkCmdClearAttachments", (void*)CmdClearAttachments},
-    {"vkCmdResolveImage", (void*)CmdResolveImage},
-    {"vkCmdSetEvent", (void*)CmdSetEvent},
-    {"vkCmdResetEvent", (void*)CmdResetEvent},
-    {"vkCmdWaitEvents", (void*)CmdWaitEvents},
-    {"vkCmdPipelineBarrier", (void*)CmdPipelineBarrier},
-    {"vkCmdBeginQuery", (void*)CmdBeginQuery},
-    {"vkCmdEndQuery", (void*)CmdEndQuery},
-    {"vkCmdResetQueryPool", (void*)CmdResetQueryPool},
-    {"vkCmdWriteTimestamp", (void*)CmdWriteTimestamp},
-    {"vkCmdCopyQueryPoolResults", (void*)CmdCopyQueryPoolResults},
-    {"vkCmdPushConstants", (void*)CmdPushConstants},
-    {"vkCmdBeginRenderPass", (void*)CmdBeginRenderPass},
-    {"vkCmdNextSubpass", (void*)CmdNextSubpass},
-    {"vkCmdEndRenderPass", (void*)CmdEndRenderPass},
-    {"vkCmdExecuteCommands", (void*)CmdExecuteCommands},
-    {"vkEnumerateInstanceVersion", (void*)EnumerateInstanceVersion},
-    {"vkBindBufferMemory2", (void*)BindBufferMemory2},
-    {"vkBindImageMemory2", (void*)BindImageMemory2},
-    {"vkGetDeviceGroupPeerMemoryFeatures", (void*)GetDeviceGroupPeerMemoryFeatures},
-    {"vkCmdSetDeviceMask", (void*)CmdSetDeviceMask},
-    {"vkCmdDispatchBase", (void*)CmdDispatchBase},
-    {"vkEnumeratePhysicalDeviceGroups", (void*)EnumeratePhysicalDeviceGroups},
-    {"vkGetImageMemoryRequirements2", (void*)GetImageMemoryRequirements2},
-    {"vkGetBufferMemoryRequirements2", (void*)GetBufferMemoryRequirements2},
-    {"vkGetImageSparseMemoryRequirements2", (void*)GetImageSparseMemoryRequirements2},
-    {"vkGetPhysicalDeviceFeatures2", (void*)GetPhysicalDeviceFeatures2},
-    {"vkGetPhysicalDeviceProperties2", (void*)GetPhysicalDeviceProperties2},
-    {"vkGetPhysicalDeviceFormatProperties2", (void*)GetPhysicalDeviceFormatProperties2},
-    {"vkGetPhysicalDeviceImageFormatProperties2", (void*)GetPhysicalDeviceImageFormatProperties2},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2", (void*)GetPhysicalDeviceQueueFamilyProperties2},
-    {"vkGetPhysicalDeviceMemoryProperties2", (void*)GetPhysicalDeviceMemoryProperties2},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties2", (void*)GetPhysicalDeviceSparseImageFormatProperties2},
-    {"vkTrimCommandPool", (void*)TrimCommandPool},
-    {"vkGetDeviceQueue2", (void*)GetDeviceQueue2},
-    {"vkCreateSamplerYcbcrConversion", (void*)CreateSamplerYcbcrConversion},
-    {"vkDestroySamplerYcbcrConversion", (void*)DestroySamplerYcbcrConversion},
-    {"vkCreateDescriptorUpdateTemplate", (void*)CreateDescriptorUpdateTemplate},
-    {"vkDestroyDescriptorUpdateTemplate", (void*)DestroyDescriptorUpdateTemplate},
-    {"vkUpdateDescriptorSetWithTemplate", (void*)UpdateDescriptorSetWithTemplate},
-    {"vkGetPhysicalDeviceExternalBufferProperties", (void*)GetPhysicalDeviceExternalBufferProperties},
-    {"vkGetPhysicalDeviceExternalFenceProperties", (void*)GetPhysicalDeviceExternalFenceProperties},
-    {"vkGetPhysicalDeviceExternalSemaphoreProperties", (void*)GetPhysicalDeviceExternalSemaphoreProperties},
-    {"vkGetDescriptorSetLayoutSupport", (void*)GetDescriptorSetLayoutSupport},
-    {"vkCmdDrawIndirectCount", (void*)CmdDrawIndirectCount},
-    {"vkCmdDrawIndexedIndirectCount", (void*)CmdDrawIndexedIndirectCount},
-    {"vkCreateRenderPass2", (void*)CreateRenderPass2},
-    {"vkCmdBeginRenderPass2", (void*)CmdBeginRenderPass2},
-    {"vkCmdNextSubpass2", (void*)CmdNextSubpass2},
-    {"vkCmdEndRenderPass2", (void*)CmdEndRenderPass2},
-    {"vkResetQueryPool", (void*)ResetQueryPool},
-    {"vkGetSemaphoreCounterValue", (void*)GetSemaphoreCounterValue},
-    {"vkWaitSemaphores", (void*)WaitSemaphores},
-    {"vkSignalSemaphore", (void*)SignalSemaphore},
-    {"vkGetBufferDeviceAddress", (void*)GetBufferDeviceAddress},
-    {"vkGetBufferOpaqueCaptureAddress", (void*)GetBufferOpaqueCaptureAddress},
-    {"vkGetDeviceMemoryOpaqueCaptureAddress", (void*)GetDeviceMemoryOpaqueCaptureAddress},
-    {"vkDestroySurfaceKHR", (void*)DestroySurfaceKHR},
-    {"vkGetPhysicalDeviceSurfaceSupportKHR", (void*)GetPhysicalDeviceSurfaceSupportKHR},
-    {"vkGetPhysicalDeviceSurfaceCapabilitiesKHR", (void*)GetPhysicalDeviceSurfaceCapabilitiesKHR},
-    {"vkGetPhysicalDeviceSurfaceFormatsKHR", (void*)GetPhysicalDeviceSurfaceFormatsKHR},
-    {"vkGetPhysicalDeviceSurfacePresentModesKHR", (void*)GetPhysicalDeviceSurfacePresentModesKHR},
-    {"vkCreateSwapchainKHR", (void*)CreateSwapchainKHR},
-    {"vkDestroySwapchainKHR", (void*)DestroySwapchainKHR},
-    {"vkGetSwapchainImagesKHR", (void*)GetSwapchainImagesKHR},
-    {"vkAcquireNextImageKHR", (void*)AcquireNextImageKHR},
-    {"vkQueuePresentKHR", (void*)QueuePresentKHR},
-    {"vkGetDeviceGroupPresentCapabilitiesKHR", (void*)GetDeviceGroupPresentCapabilitiesKHR},
-    {"vkGetDeviceGroupSurfacePresentModesKHR", (void*)GetDeviceGroupSurfacePresentModesKHR},
-    {"vkGetPhysicalDevicePresentRectanglesKHR", (void*)GetPhysicalDevicePresentRectanglesKHR},
-    {"vkAcquireNextImage2KHR", (void*)AcquireNextImage2KHR},
-    {"vkGetPhysicalDeviceDisplayPropertiesKHR", (void*)GetPhysicalDeviceDisplayPropertiesKHR},
-    {"vkGetPhysicalDeviceDisplayPlanePropertiesKHR", (void*)GetPhysicalDeviceDisplayPlanePropertiesKHR},
-    {"vkGetDisplayPlaneSupportedDisplaysKHR", (void*)GetDisplayPlaneSupportedDisplaysKHR},
-    {"vkGetDisplayModePropertiesKHR", (void*)GetDisplayModePropertiesKHR},
-    {"vkCreateDisplayModeKHR", (void*)CreateDisplayModeKHR},
-    {"vkGetDisplayPlaneCapabilitiesKHR", (void*)GetDisplayPlaneCapabilitiesKHR},
-    {"vkCreateDisplayPlaneSurfaceKHR", (void*)CreateDisplayPlaneSurfaceKHR},
-    {"vkCreateSharedSwapchainsKHR", (void*)CreateSharedSwapchainsKHR},
-#ifdef VK_USE_PLATFORM_XLIB_KHR
-    {"vkCreateXlibSurfaceKHR", (void*)CreateXlibSurfaceKHR},
-#endif
-#ifdef VK_USE_PLATFORM_XLIB_KHR
-    {"vkGetPhysicalDeviceXlibPresentationSupportKHR", (void*)GetPhysicalDeviceXlibPresentationSupportKHR},
-#endif
-#ifdef VK_USE_PLATFORM_XCB_KHR
-    {"vkCreateXcbSurfaceKHR", (void*)CreateXcbSurfaceKHR},
-#endif
-#ifdef VK_USE_PLATFORM_XCB_KHR
-    {"vkGetPhysicalDeviceXcbPresentationSupportKHR", (void*)GetPhysicalDeviceXcbPresentationSupportKHR},
-#endif
-#ifdef VK_USE_PLATFORM_WAYLAND_KHR
-    {"vkCreateWaylandSurfaceKHR", (void*)CreateWaylandSurfaceKHR},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdBuildAccelerationStructureIndirectKHR", (void*)CmdBuildAccelerationStructureIndirectKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WAYLAND_KHR
-    {"vkGetPhysicalDeviceWaylandPresentationSupportKHR", (void*)GetPhysicalDeviceWaylandPresentationSupportKHR},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdBuildAccelerationStructureKHR", (void*)CmdBuildAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkCreateAndroidSurfaceKHR", (void*)CreateAndroidSurfaceKHR},
+    {"vkCmdBuildAccelerationStructureNV", (void*)CmdBuildAccelerationStructureNV},
+    {"vkCmdClearAttachments", (void*)CmdClearAttachments},
+    {"vkCmdClearColorImage", (void*)CmdClearColorImage},
+    {"vkCmdClearDepthStencilImage", (void*)CmdClearDepthStencilImage},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdCopyAccelerationStructureKHR", (void*)CmdCopyAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkCreateWin32SurfaceKHR", (void*)CreateWin32SurfaceKHR},
+    {"vkCmdCopyAccelerationStructureNV", (void*)CmdCopyAccelerationStructureNV},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdCopyAccelerationStructureToMemoryKHR", (void*)CmdCopyAccelerationStructureToMemoryKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetPhysicalDeviceWin32PresentationSupportKHR", (void*)GetPhysicalDeviceWin32PresentationSupportKHR},
+    {"vkCmdCopyBuffer", (void*)CmdCopyBuffer},
+    {"vkCmdCopyBufferToImage", (void*)CmdCopyBufferToImage},
+    {"vkCmdCopyImage", (void*)CmdCopyImage},
+    {"vkCmdCopyImageToBuffer", (void*)CmdCopyImageToBuffer},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdCopyMemoryToAccelerationStructureKHR", (void*)CmdCopyMemoryToAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
-    {"vkGetPhysicalDeviceFeatures2KHR", (void*)GetPhysicalDeviceFeatures2KHR},
-    {"vkGetPhysicalDeviceProperties2KHR", (void*)GetPhysicalDeviceProperties2KHR},
-    {"vkGetPhysicalDeviceFormatProperties2KHR", (void*)GetPhysicalDeviceFormatProperties2KHR},
-    {"vkGetPhysicalDeviceImageFormatProperties2KHR", (void*)GetPhysicalDeviceImageFormatProperties2KHR},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2KHR", (void*)GetPhysicalDeviceQueueFamilyProperties2KHR},
-    {"vkGetPhysicalDeviceMemoryProperties2KHR", (void*)GetPhysicalDeviceMemoryProperties2KHR},
-    {"vkGetPhysicalDeviceSparseImageFormatProperties2KHR", (void*)GetPhysicalDeviceSparseImageFormatProperties2KHR},
-    {"vkGetDeviceGroupPeerMemoryFeaturesKHR", (void*)GetDeviceGroupPeerMemoryFeaturesKHR},
-    {"vkCmdSetDeviceMaskKHR", (void*)CmdSetDeviceMaskKHR},
+    {"vkCmdCopyQueryPoolResults", (void*)CmdCopyQueryPoolResults},
+    {"vkCmdDebugMarkerBeginEXT", (void*)CmdDebugMarkerBeginEXT},
+    {"vkCmdDebugMarkerEndEXT", (void*)CmdDebugMarkerEndEXT},
+    {"vkCmdDebugMarkerInsertEXT", (void*)CmdDebugMarkerInsertEXT},
+    {"vkCmdDispatch", (void*)CmdDispatch},
+    {"vkCmdDispatchBase", (void*)CmdDispatchBase},
     {"vkCmdDispatchBaseKHR", (void*)CmdDispatchBaseKHR},
-    {"vkTrimCommandPoolKHR", (void*)TrimCommandPoolKHR},
-    {"vkEnumeratePhysicalDeviceGroupsKHR", (void*)EnumeratePhysicalDeviceGroupsKHR},
-    {"vkGetPhysicalDeviceExternalBufferPropertiesKHR", (void*)GetPhysicalDeviceExternalBufferPropertiesKHR},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandleKHR", (void*)GetMemoryWin32HandleKHR},
-#endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandlePropertiesKHR", (void*)GetMemoryWin32HandlePropertiesKHR},
-#endif
-    {"vkGetMemoryFdKHR", (void*)GetMemoryFdKHR},
-    {"vkGetMemoryFdPropertiesKHR", (void*)GetMemoryFdPropertiesKHR},
-    {"vkGetPhysicalDeviceExternalSemaphorePropertiesKHR", (void*)GetPhysicalDeviceExternalSemaphorePropertiesKHR},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkImportSemaphoreWin32HandleKHR", (void*)ImportSemaphoreWin32HandleKHR},
-#endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetSemaphoreWin32HandleKHR", (void*)GetSemaphoreWin32HandleKHR},
-#endif
-    {"vkImportSemaphoreFdKHR", (void*)ImportSemaphoreFdKHR},
-    {"vkGetSemaphoreFdKHR", (void*)GetSemaphoreFdKHR},
+    {"vkCmdDispatchIndirect", (void*)CmdDispatchIndirect},
+    {"vkCmdDraw", (void*)CmdDraw},
+    {"vkCmdDrawIndexed", (void*)CmdDrawIndexed},
+    {"vkCmdDrawIndexedIndirect", (void*)CmdDrawIndexedIndirect},
+    {"vkCmdDrawIndexedIndirectCount", (void*)CmdDrawIndexedIndirectCount},
+    {"vkCmdDrawIndexedIndirectCountAMD", (void*)CmdDrawIndexedIndirectCountAMD},
+    {"vkCmdDrawIndexedIndirectCountKHR", (void*)CmdDrawIndexedIndirectCountKHR},
+    {"vkCmdDrawIndirect", (void*)CmdDrawIndirect},
+    {"vkCmdDrawIndirectByteCountEXT", (void*)CmdDrawIndirectByteCountEXT},
+    {"vkCmdDrawIndirectCount", (void*)CmdDrawIndirectCount},
+    {"vkCmdDrawIndirectCountAMD", (void*)CmdDrawIndirectCountAMD},
+    {"vkCmdDrawIndirectCountKHR", (void*)CmdDrawIndirectCountKHR},
+    {"vkCmdDrawMeshTasksIndirectCountNV", (void*)CmdDrawMeshTasksIndirectCountNV},
+    {"vkCmdDrawMeshTasksIndirectNV", (void*)CmdDrawMeshTasksIndirectNV},
+    {"vkCmdDrawMeshTasksNV", (void*)CmdDrawMeshTasksNV},
+    {"vkCmdEndConditionalRenderingEXT", (void*)CmdEndConditionalRenderingEXT},
+    {"vkCmdEndDebugUtilsLabelEXT", (void*)CmdEndDebugUtilsLabelEXT},
+    {"vkCmdEndQuery", (void*)CmdEndQuery},
+    {"vkCmdEndQueryIndexedEXT", (void*)CmdEndQueryIndexedEXT},
+    {"vkCmdEndRenderPass", (void*)CmdEndRenderPass},
+    {"vkCmdEndRenderPass2", (void*)CmdEndRenderPass2},
+    {"vkCmdEndRenderPass2KHR", (void*)CmdEndRenderPass2KHR},
+    {"vkCmdEndTransformFeedbackEXT", (void*)CmdEndTransformFeedbackEXT},
+    {"vkCmdExecuteCommands", (void*)CmdExecuteCommands},
+    {"vkCmdExecuteGeneratedCommandsNV", (void*)CmdExecuteGeneratedCommandsNV},
+    {"vkCmdFillBuffer", (void*)CmdFillBuffer},
+    {"vkCmdInsertDebugUtilsLabelEXT", (void*)CmdInsertDebugUtilsLabelEXT},
+    {"vkCmdNextSubpass", (void*)CmdNextSubpass},
+    {"vkCmdNextSubpass2", (void*)CmdNextSubpass2},
+    {"vkCmdNextSubpass2KHR", (void*)CmdNextSubpass2KHR},
+    {"vkCmdPipelineBarrier", (void*)CmdPipelineBarrier},
+    {"vkCmdPreprocessGeneratedCommandsNV", (void*)CmdPreprocessGeneratedCommandsNV},
+    {"vkCmdPushConstants", (void*)CmdPushConstants},
     {"vkCmdPushDescriptorSetKHR", (void*)CmdPushDescriptorSetKHR},
     {"vkCmdPushDescriptorSetWithTemplateKHR", (void*)CmdPushDescriptorSetWithTemplateKHR},
-    {"vkCreateDescriptorUpdateTemplateKHR", (void*)CreateDescriptorUpdateTemplateKHR},
-    {"vkDestroyDescriptorUpdateTemplateKHR", (void*)DestroyDescriptorUpdateTemplateKHR},
-    {"vkUpdateDescriptorSetWithTemplateKHR", (void*)UpdateDescriptorSetWithTemplateKHR},
-    {"vkCreateRenderPass2KHR", (void*)CreateRenderPass2KHR},
-    {"vkCmdBeginRenderPass2KHR", (void*)CmdBeginRenderPass2KHR},
-    {"vkCmdNextSubpass2KHR", (void*)CmdNextSubpass2KHR},
-    {"vkCmdEndRenderPass2KHR", (void*)CmdEndRenderPass2KHR},
-    {"vkGetSwapchainStatusKHR", (void*)GetSwapchainStatusKHR},
-    {"vkGetPhysicalDeviceExternalFencePropertiesKHR", (void*)GetPhysicalDeviceExternalFencePropertiesKHR},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkImportFenceWin32HandleKHR", (void*)ImportFenceWin32HandleKHR},
+    {"vkCmdResetEvent", (void*)CmdResetEvent},
+    {"vkCmdResetQueryPool", (void*)CmdResetQueryPool},
+    {"vkCmdResolveImage", (void*)CmdResolveImage},
+    {"vkCmdSetBlendConstants", (void*)CmdSetBlendConstants},
+    {"vkCmdSetCheckpointNV", (void*)CmdSetCheckpointNV},
+    {"vkCmdSetCoarseSampleOrderNV", (void*)CmdSetCoarseSampleOrderNV},
+    {"vkCmdSetCullModeEXT", (void*)CmdSetCullModeEXT},
+    {"vkCmdSetDepthBias", (void*)CmdSetDepthBias},
+    {"vkCmdSetDepthBounds", (void*)CmdSetDepthBounds},
+    {"vkCmdSetDepthBoundsTestEnableEXT", (void*)CmdSetDepthBoundsTestEnableEXT},
+    {"vkCmdSetDepthCompareOpEXT", (void*)CmdSetDepthCompareOpEXT},
+    {"vkCmdSetDepthTestEnableEXT", (void*)CmdSetDepthTestEnableEXT},
+    {"vkCmdSetDepthWriteEnableEXT", (void*)CmdSetDepthWriteEnableEXT},
+    {"vkCmdSetDeviceMask", (void*)CmdSetDeviceMask},
+    {"vkCmdSetDeviceMaskKHR", (void*)CmdSetDeviceMaskKHR},
+    {"vkCmdSetDiscardRectangleEXT", (void*)CmdSetDiscardRectangleEXT},
+    {"vkCmdSetEvent", (void*)CmdSetEvent},
+    {"vkCmdSetExclusiveScissorNV", (void*)CmdSetExclusiveScissorNV},
+    {"vkCmdSetFrontFaceEXT", (void*)CmdSetFrontFaceEXT},
+    {"vkCmdSetLineStippleEXT", (void*)CmdSetLineStippleEXT},
+    {"vkCmdSetLineWidth", (void*)CmdSetLineWidth},
+    {"vkCmdSetPerformanceMarkerINTEL", (void*)CmdSetPerformanceMarkerINTEL},
+    {"vkCmdSetPerformanceOverrideINTEL", (void*)CmdSetPerformanceOverrideINTEL},
+    {"vkCmdSetPerformanceStreamMarkerINTEL", (void*)CmdSetPerformanceStreamMarkerINTEL},
+    {"vkCmdSetPrimitiveTopologyEXT", (void*)CmdSetPrimitiveTopologyEXT},
+    {"vkCmdSetSampleLocationsEXT", (void*)CmdSetSampleLocationsEXT},
+    {"vkCmdSetScissor", (void*)CmdSetScissor},
+    {"vkCmdSetScissorWithCountEXT", (void*)CmdSetScissorWithCountEXT},
+    {"vkCmdSetStencilCompareMask", (void*)CmdSetStencilCompareMask},
+    {"vkCmdSetStencilOpEXT", (void*)CmdSetStencilOpEXT},
+    {"vkCmdSetStencilReference", (void*)CmdSetStencilReference},
+    {"vkCmdSetStencilTestEnableEXT", (void*)CmdSetStencilTestEnableEXT},
+    {"vkCmdSetStencilWriteMask", (void*)CmdSetStencilWriteMask},
+    {"vkCmdSetViewport", (void*)CmdSetViewport},
+    {"vkCmdSetViewportShadingRatePaletteNV", (void*)CmdSetViewportShadingRatePaletteNV},
+    {"vkCmdSetViewportWScalingNV", (void*)CmdSetViewportWScalingNV},
+    {"vkCmdSetViewportWithCountEXT", (void*)CmdSetViewportWithCountEXT},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdTraceRaysIndirectKHR", (void*)CmdTraceRaysIndirectKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetFenceWin32HandleKHR", (void*)GetFenceWin32HandleKHR},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCmdTraceRaysKHR", (void*)CmdTraceRaysKHR},
+#else
+    {"", nullptr},
 #endif
-    {"vkImportFenceFdKHR", (void*)ImportFenceFdKHR},
-    {"vkGetFenceFdKHR", (void*)GetFenceFdKHR},
-    {"vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR", (void*)EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR},
-    {"vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR", (void*)GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR},
-    {"vkAcquireProfilingLockKHR", (void*)AcquireProfilingLockKHR},
-    {"vkReleaseProfilingLockKHR", (void*)ReleaseProfilingLockKHR},
-    {"vkGetPhysicalDeviceSurfaceCapabilities2KHR", (void*)GetPhysicalDeviceSurfaceCapabilities2KHR},
-    {"vkGetPhysicalDeviceSurfaceFormats2KHR", (void*)GetPhysicalDeviceSurfaceFormats2KHR},
-    {"vkGetPhysicalDeviceDisplayProperties2KHR", (void*)GetPhysicalDeviceDisplayProperties2KHR},
-    {"vkGetPhysicalDeviceDisplayPlaneProperties2KHR", (void*)GetPhysicalDeviceDisplayPlaneProperties2KHR},
-    {"vkGetDisplayModeProperties2KHR", (void*)GetDisplayModeProperties2KHR},
-    {"vkGetDisplayPlaneCapabilities2KHR", (void*)GetDisplayPlaneCapabilities2KHR},
-    {"vkGetImageMemoryRequirements2KHR", (void*)GetImageMemoryRequirements2KHR},
-    {"vkGetBufferMemoryRequirements2KHR", (void*)GetBufferMemoryRequirements2KHR},
-    {"vkGetImageSparseMemoryRequirements2KHR", (void*)GetImageSparseMemoryRequirements2KHR},
-    {"vkCreateSamplerYcbcrConversionKHR", (void*)CreateSamplerYcbcrConversionKHR},
-    {"vkDestroySamplerYcbcrConversionKHR", (void*)DestroySamplerYcbcrConversionKHR},
-    {"vkBindBufferMemory2KHR", (void*)BindBufferMemory2KHR},
-    {"vkBindImageMemory2KHR", (void*)BindImageMemory2KHR},
-    {"vkGetDescriptorSetLayoutSupportKHR", (void*)GetDescriptorSetLayoutSupportKHR},
-    {"vkCmdDrawIndirectCountKHR", (void*)CmdDrawIndirectCountKHR},
-    {"vkCmdDrawIndexedIndirectCountKHR", (void*)CmdDrawIndexedIndirectCountKHR},
-    {"vkGetSemaphoreCounterValueKHR", (void*)GetSemaphoreCounterValueKHR},
-    {"vkWaitSemaphoresKHR", (void*)WaitSemaphoresKHR},
-    {"vkSignalSemaphoreKHR", (void*)SignalSemaphoreKHR},
-    {"vkGetBufferDeviceAddressKHR", (void*)GetBufferDeviceAddressKHR},
-    {"vkGetBufferOpaqueCaptureAddressKHR", (void*)GetBufferOpaqueCaptureAddressKHR},
-    {"vkGetDeviceMemoryOpaqueCaptureAddressKHR", (void*)GetDeviceMemoryOpaqueCaptureAddressKHR},
+    {"vkCmdTraceRaysNV", (void*)CmdTraceRaysNV},
+    {"vkCmdUpdateBuffer", (void*)CmdUpdateBuffer},
+    {"vkCmdWaitEvents", (void*)CmdWaitEvents},
+    {"vkCmdWriteAccelerationStructuresPropertiesKHR", (void*)CmdWriteAccelerationStructuresPropertiesKHR},
+    {"vkCmdWriteAccelerationStructuresPropertiesNV", (void*)CmdWriteAccelerationStructuresPropertiesNV},
+    {"vkCmdWriteBufferMarkerAMD", (void*)CmdWriteBufferMarkerAMD},
+    {"vkCmdWriteTimestamp", (void*)CmdWriteTimestamp},
+    {"vkCompileDeferredNV", (void*)CompileDeferredNV},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCreateDeferredOperationKHR", (void*)CreateDeferredOperationKHR},
+    {"vkCopyAccelerationStructureKHR", (void*)CopyAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkDestroyDeferredOperationKHR", (void*)DestroyDeferredOperationKHR},
+    {"vkCopyAccelerationStructureToMemoryKHR", (void*)CopyAccelerationStructureToMemoryKHR},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkGetDeferredOperationMaxConcurrencyKHR", (void*)GetDeferredOperationMaxConcurrencyKHR},
+    {"vkCopyMemoryToAccelerationStructureKHR", (void*)CopyMemoryToAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkGetDeferredOperationResultKHR", (void*)GetDeferredOperationResultKHR},
+    {"vkCreateAccelerationStructureKHR", (void*)CreateAccelerationStructureKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkDeferredOperationJoinKHR", (void*)DeferredOperationJoinKHR},
+    {"vkCreateAccelerationStructureNV", (void*)CreateAccelerationStructureNV},
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    {"vkCreateAndroidSurfaceKHR", (void*)CreateAndroidSurfaceKHR},
+#else
+    {"", nullptr},
 #endif
-    {"vkGetPipelineExecutablePropertiesKHR", (void*)GetPipelineExecutablePropertiesKHR},
-    {"vkGetPipelineExecutableStatisticsKHR", (void*)GetPipelineExecutableStatisticsKHR},
-    {"vkGetPipelineExecutableInternalRepresentationsKHR", (void*)GetPipelineExecutableInternalRepresentationsKHR},
+    {"vkCreateBuffer", (void*)CreateBuffer},
+    {"vkCreateBufferView", (void*)CreateBufferView},
+    {"vkCreateCommandPool", (void*)CreateCommandPool},
+    {"vkCreateComputePipelines", (void*)CreateComputePipelines},
     {"vkCreateDebugReportCallbackEXT", (void*)CreateDebugReportCallbackEXT},
-    {"vkDestroyDebugReportCallbackEXT", (void*)DestroyDebugReportCallbackEXT},
-    {"vkDebugReportMessageEXT", (void*)DebugReportMessageEXT},
-    {"vkDebugMarkerSetObjectTagEXT", (void*)DebugMarkerSetObjectTagEXT},
-    {"vkDebugMarkerSetObjectNameEXT", (void*)DebugMarkerSetObjectNameEXT},
-    {"vkCmdDebugMarkerBeginEXT", (void*)CmdDebugMarkerBeginEXT},
-    {"vkCmdDebugMarkerEndEXT", (void*)CmdDebugMarkerEndEXT},
-    {"vkCmdDebugMarkerInsertEXT", (void*)CmdDebugMarkerInsertEXT},
-    {"vkCmdBindTransformFeedbackBuffersEXT", (void*)CmdBindTransformFeedbackBuffersEXT},
-    {"vkCmdBeginTransformFeedbackEXT", (void*)CmdBeginTransformFeedbackEXT},
-    {"vkCmdEndTransformFeedbackEXT", (void*)CmdEndTransformFeedbackEXT},
-    {"vkCmdBeginQueryIndexedEXT", (void*)CmdBeginQueryIndexedEXT},
-    {"vkCmdEndQueryIndexedEXT", (void*)CmdEndQueryIndexedEXT},
-    {"vkCmdDrawIndirectByteCountEXT", (void*)CmdDrawIndirectByteCountEXT},
-    {"vkGetImageViewHandleNVX", (void*)GetImageViewHandleNVX},
-    {"vkGetImageViewAddressNVX", (void*)GetImageViewAddressNVX},
-    {"vkCmdDrawIndirectCountAMD", (void*)CmdDrawIndirectCountAMD},
-    {"vkCmdDrawIndexedIndirectCountAMD", (void*)CmdDrawIndexedIndirectCountAMD},
-    {"vkGetShaderInfoAMD", (void*)GetShaderInfoAMD},
-#ifdef VK_USE_PLATFORM_GGP
-    {"vkCreateStreamDescriptorSurfaceGGP", (void*)CreateStreamDescriptorSurfaceGGP},
-#endif
-    {"vkGetPhysicalDeviceExternalImageFormatPropertiesNV", (void*)GetPhysicalDeviceExternalImageFormatPropertiesNV},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetMemoryWin32HandleNV", (void*)GetMemoryWin32HandleNV},
-#endif
-#ifdef VK_USE_PLATFORM_VI_NN
-    {"vkCreateViSurfaceNN", (void*)CreateViSurfaceNN},
-#endif
-    {"vkCmdBeginConditionalRenderingEXT", (void*)CmdBeginConditionalRenderingEXT},
-    {"vkCmdEndConditionalRenderingEXT", (void*)CmdEndConditionalRenderingEXT},
-    {"vkCmdSetViewportWScalingNV", (void*)CmdSetViewportWScalingNV},
-    {"vkReleaseDisplayEXT", (void*)ReleaseDisplayEXT},
-#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
-    {"vkAcquireXlibDisplayEXT", (void*)AcquireXlibDisplayEXT},
+    {"vkCreateDebugUtilsMessengerEXT", (void*)CreateDebugUtilsMessengerEXT},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCreateDeferredOperationKHR", (void*)CreateDeferredOperationKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
-    {"vkGetRandROutputDisplayEXT", (void*)GetRandROutputDisplayEXT},
+    {"vkCreateDescriptorPool", (void*)CreateDescriptorPool},
+    {"vkCreateDescriptorSetLayout", (void*)CreateDescriptorSetLayout},
+    {"vkCreateDescriptorUpdateTemplate", (void*)CreateDescriptorUpdateTemplate},
+    {"vkCreateDescriptorUpdateTemplateKHR", (void*)CreateDescriptorUpdateTemplateKHR},
+    {"vkCreateDevice", (void*)CreateDevice},
+#ifdef VK_USE_PLATFORM_DIRECTFB_EXT
+    {"vkCreateDirectFBSurfaceEXT", (void*)CreateDirectFBSurfaceEXT},
+#else
+    {"", nullptr},
 #endif
-    {"vkGetPhysicalDeviceSurfaceCapabilities2EXT", (void*)GetPhysicalDeviceSurfaceCapabilities2EXT},
-    {"vkDisplayPowerControlEXT", (void*)DisplayPowerControlEXT},
-    {"vkRegisterDeviceEventEXT", (void*)RegisterDeviceEventEXT},
-    {"vkRegisterDisplayEventEXT", (void*)RegisterDisplayEventEXT},
-    {"vkGetSwapchainCounterEXT", (void*)GetSwapchainCounterEXT},
-    {"vkGetRefreshCycleDurationGOOGLE", (void*)GetRefreshCycleDurationGOOGLE},
-    {"vkGetPastPresentationTimingGOOGLE", (void*)GetPastPresentationTimingGOOGLE},
-    {"vkCmdSetDiscardRectangleEXT", (void*)CmdSetDiscardRectangleEXT},
-    {"vkSetHdrMetadataEXT", (void*)SetHdrMetadataEXT},
+    {"vkCreateDisplayModeKHR", (void*)CreateDisplayModeKHR},
+    {"vkCreateDisplayPlaneSurfaceKHR", (void*)CreateDisplayPlaneSurfaceKHR},
+    {"vkCreateEvent", (void*)CreateEvent},
+    {"vkCreateFence", (void*)CreateFence},
+    {"vkCreateFramebuffer", (void*)CreateFramebuffer},
+    {"vkCreateGraphicsPipelines", (void*)CreateGraphicsPipelines},
+    {"vkCreateHeadlessSurfaceEXT", (void*)CreateHeadlessSurfaceEXT},
 #ifdef VK_USE_PLATFORM_IOS_MVK
     {"vkCreateIOSSurfaceMVK", (void*)CreateIOSSurfaceMVK},
+#else
+    {"", nullptr},
 #endif
+    {"vkCreateImage", (void*)CreateImage},
+#ifdef VK_USE_PLATFORM_FUCHSIA
+    {"vkCreateImagePipeSurfaceFUCHSIA", (void*)CreateImagePipeSurfaceFUCHSIA},
+#else
+    {"", nullptr},
+#endif
+    {"vkCreateImageView", (void*)CreateImageView},
+    {"vkCreateIndirectCommandsLayoutNV", (void*)CreateIndirectCommandsLayoutNV},
+    {"vkCreateInstance", (void*)CreateInstance},
 #ifdef VK_USE_PLATFORM_MACOS_MVK
     {"vkCreateMacOSSurfaceMVK", (void*)CreateMacOSSurfaceMVK},
+#else
+    {"", nullptr},
 #endif
-    {"vkSetDebugUtilsObjectNameEXT", (void*)SetDebugUtilsObjectNameEXT},
-    {"vkSetDebugUtilsObjectTagEXT", (void*)SetDebugUtilsObjectTagEXT},
-    {"vkQueueBeginDebugUtilsLabelEXT", (void*)QueueBeginDebugUtilsLabelEXT},
-    {"vkQueueEndDebugUtilsLabelEXT", (void*)QueueEndDebugUtilsLabelEXT},
-    {"vkQueueInsertDebugUtilsLabelEXT", (void*)QueueInsertDebugUtilsLabelEXT},
-    {"vkCmdBeginDebugUtilsLabelEXT", (void*)CmdBeginDebugUtilsLabelEXT},
-    {"vkCmdEndDebugUtilsLabelEXT", (void*)CmdEndDebugUtilsLabelEXT},
-    {"vkCmdInsertDebugUtilsLabelEXT", (void*)CmdInsertDebugUtilsLabelEXT},
-    {"vkCreateDebugUtilsMessengerEXT", (void*)CreateDebugUtilsMessengerEXT},
-    {"vkDestroyDebugUtilsMessengerEXT", (void*)DestroyDebugUtilsMessengerEXT},
-    {"vkSubmitDebugUtilsMessageEXT", (void*)SubmitDebugUtilsMessageEXT},
-#ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkGetAndroidHardwareBufferPropertiesANDROID", (void*)GetAndroidHardwareBufferPropertiesANDROID},
+#ifdef VK_USE_PLATFORM_METAL_EXT
+    {"vkCreateMetalSurfaceEXT", (void*)CreateMetalSurfaceEXT},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_ANDROID_KHR
-    {"vkGetMemoryAndroidHardwareBufferANDROID", (void*)GetMemoryAndroidHardwareBufferANDROID},
+    {"vkCreatePipelineCache", (void*)CreatePipelineCache},
+    {"vkCreatePipelineLayout", (void*)CreatePipelineLayout},
+    {"vkCreatePrivateDataSlotEXT", (void*)CreatePrivateDataSlotEXT},
+    {"vkCreateQueryPool", (void*)CreateQueryPool},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkCreateRayTracingPipelinesKHR", (void*)CreateRayTracingPipelinesKHR},
+#else
+    {"", nullptr},
 #endif
-    {"vkCmdSetSampleLocationsEXT", (void*)CmdSetSampleLocationsEXT},
-    {"vkGetPhysicalDeviceMultisamplePropertiesEXT", (void*)GetPhysicalDeviceMultisamplePropertiesEXT},
-    {"vkGetImageDrmFormatModifierPropertiesEXT", (void*)GetImageDrmFormatModifierPropertiesEXT},
-    {"vkCreateValidationCacheEXT", (void*)CreateValidationCacheEXT},
-    {"vkDestroyValidationCacheEXT", (void*)DestroyValidationCacheEXT},
-    {"vkMergeValidationCachesEXT", (void*)MergeValidationCachesEXT},
-    {"vkGetValidationCacheDataEXT", (void*)GetValidationCacheDataEXT},
-    {"vkCmdBindShadingRateImageNV", (void*)CmdBindShadingRateImageNV},
-    {"vkCmdSetViewportShadingRatePaletteNV", (void*)CmdSetViewportShadingRatePaletteNV},
-    {"vkCmdSetCoarseSampleOrderNV", (void*)CmdSetCoarseSampleOrderNV},
-    {"vkCreateAccelerationStructureNV", (void*)CreateAccelerationStructureNV},
-    {"vkDestroyAccelerationStructureKHR", (void*)DestroyAccelerationStructureKHR},
-    {"vkDestroyAccelerationStructureNV", (void*)DestroyAccelerationStructureNV},
-    {"vkGetAccelerationStructureMemoryRequirementsNV", (void*)GetAccelerationStructureMemoryRequirementsNV},
-    {"vkBindAccelerationStructureMemoryKHR", (void*)BindAccelerationStructureMemoryKHR},
-    {"vkBindAccelerationStructureMemoryNV", (void*)BindAccelerationStructureMemoryNV},
-    {"vkCmdBuildAccelerationStructureNV", (void*)CmdBuildAccelerationStructureNV},
-    {"vkCmdCopyAccelerationStructureNV", (void*)CmdCopyAccelerationStructureNV},
-    {"vkCmdTraceRaysNV", (void*)CmdTraceRaysNV},
     {"vkCreateRayTracingPipelinesNV", (void*)CreateRayTracingPipelinesNV},
-    {"vkGetRayTracingShaderGroupHandlesKHR", (void*)GetRayTracingShaderGroupHandlesKHR},
-    {"vkGetRayTracingShaderGroupHandlesNV", (void*)GetRayTracingShaderGroupHandlesNV},
-    {"vkGetAccelerationStructureHandleNV", (void*)GetAccelerationStructureHandleNV},
-    {"vkCmdWriteAccelerationStructuresPropertiesKHR", (void*)CmdWriteAccelerationStructuresPropertiesKHR},
-    {"vkCmdWriteAccelerationStructuresPropertiesNV", (void*)CmdWriteAccelerationStructuresPropertiesNV},
-    {"vkCompileDeferredNV", (void*)CompileDeferredNV},
-    {"vkGetMemoryHostPointerPropertiesEXT", (void*)GetMemoryHostPointerPropertiesEXT},
-    {"vkCmdWriteBufferMarkerAMD", (void*)CmdWriteBufferMarkerAMD},
-    {"vkGetPhysicalDeviceCalibrateableTimeDomainsEXT", (void*)GetPhysicalDeviceCalibrateableTimeDomainsEXT},
-    {"vkGetCalibratedTimestampsEXT", (void*)GetCalibratedTimestampsEXT},
-    {"vkCmdDrawMeshTasksNV", (void*)CmdDrawMeshTasksNV},
-    {"vkCmdDrawMeshTasksIndirectNV", (void*)CmdDrawMeshTasksIndirectNV},
-    {"vkCmdDrawMeshTasksIndirectCountNV", (void*)CmdDrawMeshTasksIndirectCountNV},
-    {"vkCmdSetExclusiveScissorNV", (void*)CmdSetExclusiveScissorNV},
-    {"vkCmdSetCheckpointNV", (void*)CmdSetCheckpointNV},
-    {"vkGetQueueCheckpointDataNV", (void*)GetQueueCheckpointDataNV},
-    {"vkInitializePerformanceApiINTEL", (void*)InitializePerformanceApiINTEL},
-    {"vkUninitializePerformanceApiINTEL", (void*)UninitializePerformanceApiINTEL},
-    {"vkCmdSetPerformanceMarkerINTEL", (void*)CmdSetPerformanceMarkerINTEL},
-    {"vkCmdSetPerformanceStreamMarkerINTEL", (void*)CmdSetPerformanceStreamMarkerINTEL},
-    {"vkCmdSetPerformanceOverrideINTEL", (void*)CmdSetPerformanceOverrideINTEL},
-    {"vkAcquirePerformanceConfigurationINTEL", (void*)AcquirePerformanceConfigurationINTEL},
-    {"vkReleasePerformanceConfigurationINTEL", (void*)ReleasePerformanceConfigurationINTEL},
-    {"vkQueueSetPerformanceConfigurationINTEL", (void*)QueueSetPerformanceConfigurationINTEL},
-    {"vkGetPerformanceParameterINTEL", (void*)GetPerformanceParameterINTEL},
-    {"vkSetLocalDimmingAMD", (void*)SetLocalDimmingAMD},
-#ifdef VK_USE_PLATFORM_FUCHSIA
-    {"vkCreateImagePipeSurfaceFUCHSIA", (void*)CreateImagePipeSurfaceFUCHSIA},
+    {"vkCreateRenderPass", (void*)CreateRenderPass},
+    {"vkCreateRenderPass2", (void*)CreateRenderPass2},
+    {"vkCreateRenderPass2KHR", (void*)CreateRenderPass2KHR},
+    {"vkCreateSampler", (void*)CreateSampler},
+    {"vkCreateSamplerYcbcrConversion", (void*)CreateSamplerYcbcrConversion},
+    {"vkCreateSamplerYcbcrConversionKHR", (void*)CreateSamplerYcbcrConversionKHR},
+    {"vkCreateSemaphore", (void*)CreateSemaphore},
+    {"vkCreateShaderModule", (void*)CreateShaderModule},
+    {"vkCreateSharedSwapchainsKHR", (void*)CreateSharedSwapchainsKHR},
+#ifdef VK_USE_PLATFORM_GGP
+    {"vkCreateStreamDescriptorSurfaceGGP", (void*)CreateStreamDescriptorSurfaceGGP},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_METAL_EXT
-    {"vkCreateMetalSurfaceEXT", (void*)CreateMetalSurfaceEXT},
+    {"vkCreateSwapchainKHR", (void*)CreateSwapchainKHR},
+    {"vkCreateValidationCacheEXT", (void*)CreateValidationCacheEXT},
+#ifdef VK_USE_PLATFORM_VI_NN
+    {"vkCreateViSurfaceNN", (void*)CreateViSurfaceNN},
+#else
+    {"", nullptr},
 #endif
-    {"vkGetBufferDeviceAddressEXT", (void*)GetBufferDeviceAddressEXT},
-    {"vkGetPhysicalDeviceToolPropertiesEXT", (void*)GetPhysicalDeviceToolPropertiesEXT},
-    {"vkGetPhysicalDeviceCooperativeMatrixPropertiesNV", (void*)GetPhysicalDeviceCooperativeMatrixPropertiesNV},
-    {"vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV", (void*)GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV},
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetPhysicalDeviceSurfacePresentModes2EXT", (void*)GetPhysicalDeviceSurfacePresentModes2EXT},
+#ifdef VK_USE_PLATFORM_WAYLAND_KHR
+    {"vkCreateWaylandSurfaceKHR", (void*)CreateWaylandSurfaceKHR},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkAcquireFullScreenExclusiveModeEXT", (void*)AcquireFullScreenExclusiveModeEXT},
+    {"vkCreateWin32SurfaceKHR", (void*)CreateWin32SurfaceKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkReleaseFullScreenExclusiveModeEXT", (void*)ReleaseFullScreenExclusiveModeEXT},
+#ifdef VK_USE_PLATFORM_XCB_KHR
+    {"vkCreateXcbSurfaceKHR", (void*)CreateXcbSurfaceKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_WIN32_KHR
-    {"vkGetDeviceGroupSurfacePresentModes2EXT", (void*)GetDeviceGroupSurfacePresentModes2EXT},
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+    {"vkCreateXlibSurfaceKHR", (void*)CreateXlibSurfaceKHR},
+#else
+    {"", nullptr},
 #endif
-    {"vkCreateHeadlessSurfaceEXT", (void*)CreateHeadlessSurfaceEXT},
-    {"vkCmdSetLineStippleEXT", (void*)CmdSetLineStippleEXT},
-    {"vkResetQueryPoolEXT", (void*)ResetQueryPoolEXT},
-    {"vkCmdSetCullModeEXT", (void*)CmdSetCullModeEXT},
-    {"vkCmdSetFrontFaceEXT", (void*)CmdSetFrontFaceEXT},
-    {"vkCmdSetPrimitiveTopologyEXT", (void*)CmdSetPrimitiveTopologyEXT},
-    {"vkCmdSetViewportWithCountEXT", (void*)CmdSetViewportWithCountEXT},
-    {"vkCmdSetScissorWithCountEXT", (void*)CmdSetScissorWithCountEXT},
-    {"vkCmdBindVertexBuffers2EXT", (void*)CmdBindVertexBuffers2EXT},
-    {"vkCmdSetDepthTestEnableEXT", (void*)CmdSetDepthTestEnableEXT},
-    {"vkCmdSetDepthWriteEnableEXT", (void*)CmdSetDepthWriteEnableEXT},
-    {"vkCmdSetDepthCompareOpEXT", (void*)CmdSetDepthCompareOpEXT},
-    {"vkCmdSetDepthBoundsTestEnableEXT", (void*)CmdSetDepthBoundsTestEnableEXT},
-    {"vkCmdSetStencilTestEnableEXT", (void*)CmdSetStencilTestEnableEXT},
-    {"vkCmdSetStencilOpEXT", (void*)CmdSetStencilOpEXT},
-    {"vkGetGeneratedCommandsMemoryRequirementsNV", (void*)GetGeneratedCommandsMemoryRequirementsNV},
-    {"vkCmdPreprocessGeneratedCommandsNV", (void*)CmdPreprocessGeneratedCommandsNV},
-    {"vkCmdExecuteGeneratedCommandsNV", (void*)CmdExecuteGeneratedCommandsNV},
-    {"vkCmdBindPipelineShaderGroupNV", (void*)CmdBindPipelineShaderGroupNV},
-    {"vkCreateIndirectCommandsLayoutNV", (void*)CreateIndirectCommandsLayoutNV},
-    {"vkDestroyIndirectCommandsLayoutNV", (void*)DestroyIndirectCommandsLayoutNV},
-    {"vkCreatePrivateDataSlotEXT", (void*)CreatePrivateDataSlotEXT},
-    {"vkDestroyPrivateDataSlotEXT", (void*)DestroyPrivateDataSlotEXT},
-    {"vkSetPrivateDataEXT", (void*)SetPrivateDataEXT},
-    {"vkGetPrivateDataEXT", (void*)GetPrivateDataEXT},
-#ifdef VK_USE_PLATFORM_DIRECTFB_EXT
-    {"vkCreateDirectFBSurfaceEXT", (void*)CreateDirectFBSurfaceEXT},
+    {"vkDebugMarkerSetObjectNameEXT", (void*)DebugMarkerSetObjectNameEXT},
+    {"vkDebugMarkerSetObjectTagEXT", (void*)DebugMarkerSetObjectTagEXT},
+    {"vkDebugReportMessageEXT", (void*)DebugReportMessageEXT},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkDeferredOperationJoinKHR", (void*)DeferredOperationJoinKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_USE_PLATFORM_DIRECTFB_EXT
-    {"vkGetPhysicalDeviceDirectFBPresentationSupportEXT", (void*)GetPhysicalDeviceDirectFBPresentationSupportEXT},
+    {"vkDestroyAccelerationStructureKHR", (void*)DestroyAccelerationStructureKHR},
+    {"vkDestroyAccelerationStructureNV", (void*)DestroyAccelerationStructureNV},
+    {"vkDestroyBuffer", (void*)DestroyBuffer},
+    {"vkDestroyBufferView", (void*)DestroyBufferView},
+    {"vkDestroyCommandPool", (void*)DestroyCommandPool},
+    {"vkDestroyDebugReportCallbackEXT", (void*)DestroyDebugReportCallbackEXT},
+    {"vkDestroyDebugUtilsMessengerEXT", (void*)DestroyDebugUtilsMessengerEXT},
+#ifdef VK_ENABLE_BETA_EXTENSIONS
+    {"vkDestroyDeferredOperationKHR", (void*)DestroyDeferredOperationKHR},
+#else
+    {"", nullptr},
 #endif
+    {"vkDestroyDescriptorPool", (void*)DestroyDescriptorPool},
+    {"vkDestroyDescriptorSetLayout", (void*)DestroyDescriptorSetLayout},
+    {"vkDestroyDescriptorUpdateTemplate", (void*)DestroyDescriptorUpdateTemplate},
+    {"vkDestroyDescriptorUpdateTemplateKHR", (void*)DestroyDescriptorUpdateTemplateKHR},
+    {"vkDestroyDevice", (void*)DestroyDevice},
+    {"vkDestroyEvent", (void*)DestroyEvent},
+    {"vkDestroyFence", (void*)DestroyFence},
+    {"vkDestroyFramebuffer", (void*)DestroyFramebuffer},
+    {"vkDestroyImage", (void*)DestroyImage},
+    {"vkDestroyImageView", (void*)DestroyImageView},
+    {"vkDestroyIndirectCommandsLayoutNV", (void*)DestroyIndirectCommandsLayoutNV},
+    {"vkDestroyInstance", (void*)DestroyInstance},
+    {"vkDestroyPipeline", (void*)DestroyPipeline},
+    {"vkDestroyPipelineCache", (void*)DestroyPipelineCache},
+    {"vkDestroyPipelineLayout", (void*)DestroyPipelineLayout},
+    {"vkDestroyPrivateDataSlotEXT", (void*)DestroyPrivateDataSlotEXT},
+    {"vkDestroyQueryPool", (void*)DestroyQueryPool},
+    {"vkDestroyRenderPass", (void*)DestroyRenderPass},
+    {"vkDestroySampler", (void*)DestroySampler},
+    {"vkDestroySamplerYcbcrConversion", (void*)DestroySamplerYcbcrConversion},
+    {"vkDestroySamplerYcbcrConversionKHR", (void*)DestroySamplerYcbcrConversionKHR},
+    {"vkDestroySemaphore", (void*)DestroySemaphore},
+    {"vkDestroyShaderModule", (void*)DestroyShaderModule},
+    {"vkDestroySurfaceKHR", (void*)DestroySurfaceKHR},
+    {"vkDestroySwapchainKHR", (void*)DestroySwapchainKHR},
+    {"vkDestroyValidationCacheEXT", (void*)DestroyValidationCacheEXT},
+    {"vkDeviceWaitIdle", (void*)DeviceWaitIdle},
+    {"vkDisplayPowerControlEXT", (void*)DisplayPowerControlEXT},
+    {"vkEndCommandBuffer", (void*)EndCommandBuffer},
+    {"vkEnumerateDeviceExtensionProperties", (void*)EnumerateDeviceExtensionProperties},
+    {"vkEnumerateDeviceLayerProperties", (void*)EnumerateDeviceLayerProperties},
+    {"vkEnumerateInstanceExtensionProperties", (void*)EnumerateInstanceExtensionProperties},
+    {"vkEnumerateInstanceLayerProperties", (void*)EnumerateInstanceLayerProperties},
+    {"vkEnumerateInstanceVersion", (void*)EnumerateInstanceVersion},
+    {"vkEnumeratePhysicalDeviceGroups", (void*)EnumeratePhysicalDeviceGroups},
+    {"vkEnumeratePhysicalDeviceGroupsKHR", (void*)EnumeratePhysicalDeviceGroupsKHR},
+    {"vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR", (void*)EnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR},
+    {"vkEnumeratePhysicalDevices", (void*)EnumeratePhysicalDevices},
+    {"vkFlushMappedMemoryRanges", (void*)FlushMappedMemoryRanges},
+    {"vkFreeCommandBuffers", (void*)FreeCommandBuffers},
+    {"vkFreeDescriptorSets", (void*)FreeDescriptorSets},
+    {"vkFreeMemory", (void*)FreeMemory},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCreateAccelerationStructureKHR", (void*)CreateAccelerationStructureKHR},
+    {"vkGetAccelerationStructureDeviceAddressKHR", (void*)GetAccelerationStructureDeviceAddressKHR},
+#else
+    {"", nullptr},
 #endif
+    {"vkGetAccelerationStructureHandleNV", (void*)GetAccelerationStructureHandleNV},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
     {"vkGetAccelerationStructureMemoryRequirementsKHR", (void*)GetAccelerationStructureMemoryRequirementsKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdBuildAccelerationStructureKHR", (void*)CmdBuildAccelerationStructureKHR},
+    {"vkGetAccelerationStructureMemoryRequirementsNV", (void*)GetAccelerationStructureMemoryRequirementsNV},
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    {"vkGetAndroidHardwareBufferPropertiesANDROID", (void*)GetAndroidHardwareBufferPropertiesANDROID},
+#else
+    {"", nullptr},
 #endif
+    {"vkGetBufferDeviceAddress", (void*)GetBufferDeviceAddress},
+    {"vkGetBufferDeviceAddressEXT", (void*)GetBufferDeviceAddressEXT},
+    {"vkGetBufferDeviceAddressKHR", (void*)GetBufferDeviceAddressKHR},
+    {"vkGetBufferMemoryRequirements", (void*)GetBufferMemoryRequirements},
+    {"vkGetBufferMemoryRequirements2", (void*)GetBufferMemoryRequirements2},
+    {"vkGetBufferMemoryRequirements2KHR", (void*)GetBufferMemoryRequirements2KHR},
+    {"vkGetBufferOpaqueCaptureAddress", (void*)GetBufferOpaqueCaptureAddress},
+    {"vkGetBufferOpaqueCaptureAddressKHR", (void*)GetBufferOpaqueCaptureAddressKHR},
+    {"vkGetCalibratedTimestampsEXT", (void*)GetCalibratedTimestampsEXT},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdBuildAccelerationStructureIndirectKHR", (void*)CmdBuildAccelerationStructureIndirectKHR},
+    {"vkGetDeferredOperationMaxConcurrencyKHR", (void*)GetDeferredOperationMaxConcurrencyKHR},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkBuildAccelerationStructureKHR", (void*)BuildAccelerationStructureKHR},
+    {"vkGetDeferredOperationResultKHR", (void*)GetDeferredOperationResultKHR},
+#else
+    {"", nullptr},
 #endif
+    {"vkGetDescriptorSetLayoutSupport", (void*)GetDescriptorSetLayoutSupport},
+    {"vkGetDescriptorSetLayoutSupportKHR", (void*)GetDescriptorSetLayoutSupportKHR},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCopyAccelerationStructureKHR", (void*)CopyAccelerationStructureKHR},
+    {"vkGetDeviceAccelerationStructureCompatibilityKHR", (void*)GetDeviceAccelerationStructureCompatibilityKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCopyAccelerationStructureToMemoryKHR", (void*)CopyAccelerationStructureToMemoryKHR},
+    {"vkGetDeviceGroupPeerMemoryFeatures", (void*)GetDeviceGroupPeerMemoryFeatures},
+    {"vkGetDeviceGroupPeerMemoryFeaturesKHR", (void*)GetDeviceGroupPeerMemoryFeaturesKHR},
+    {"vkGetDeviceGroupPresentCapabilitiesKHR", (void*)GetDeviceGroupPresentCapabilitiesKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetDeviceGroupSurfacePresentModes2EXT", (void*)GetDeviceGroupSurfacePresentModes2EXT},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCopyMemoryToAccelerationStructureKHR", (void*)CopyMemoryToAccelerationStructureKHR},
+    {"vkGetDeviceGroupSurfacePresentModesKHR", (void*)GetDeviceGroupSurfacePresentModesKHR},
+    {"vkGetDeviceMemoryCommitment", (void*)GetDeviceMemoryCommitment},
+    {"vkGetDeviceMemoryOpaqueCaptureAddress", (void*)GetDeviceMemoryOpaqueCaptureAddress},
+    {"vkGetDeviceMemoryOpaqueCaptureAddressKHR", (void*)GetDeviceMemoryOpaqueCaptureAddressKHR},
+    {"vkGetDeviceProcAddr", (void*)GetDeviceProcAddr},
+    {"vkGetDeviceQueue", (void*)GetDeviceQueue},
+    {"vkGetDeviceQueue2", (void*)GetDeviceQueue2},
+    {"vkGetDisplayModeProperties2KHR", (void*)GetDisplayModeProperties2KHR},
+    {"vkGetDisplayModePropertiesKHR", (void*)GetDisplayModePropertiesKHR},
+    {"vkGetDisplayPlaneCapabilities2KHR", (void*)GetDisplayPlaneCapabilities2KHR},
+    {"vkGetDisplayPlaneCapabilitiesKHR", (void*)GetDisplayPlaneCapabilitiesKHR},
+    {"vkGetDisplayPlaneSupportedDisplaysKHR", (void*)GetDisplayPlaneSupportedDisplaysKHR},
+    {"vkGetEventStatus", (void*)GetEventStatus},
+    {"vkGetFenceFdKHR", (void*)GetFenceFdKHR},
+    {"vkGetFenceStatus", (void*)GetFenceStatus},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetFenceWin32HandleKHR", (void*)GetFenceWin32HandleKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkWriteAccelerationStructuresPropertiesKHR", (void*)WriteAccelerationStructuresPropertiesKHR},
+    {"vkGetGeneratedCommandsMemoryRequirementsNV", (void*)GetGeneratedCommandsMemoryRequirementsNV},
+    {"vkGetImageDrmFormatModifierPropertiesEXT", (void*)GetImageDrmFormatModifierPropertiesEXT},
+    {"vkGetImageMemoryRequirements", (void*)GetImageMemoryRequirements},
+    {"vkGetImageMemoryRequirements2", (void*)GetImageMemoryRequirements2},
+    {"vkGetImageMemoryRequirements2KHR", (void*)GetImageMemoryRequirements2KHR},
+    {"vkGetImageSparseMemoryRequirements", (void*)GetImageSparseMemoryRequirements},
+    {"vkGetImageSparseMemoryRequirements2", (void*)GetImageSparseMemoryRequirements2},
+    {"vkGetImageSparseMemoryRequirements2KHR", (void*)GetImageSparseMemoryRequirements2KHR},
+    {"vkGetImageSubresourceLayout", (void*)GetImageSubresourceLayout},
+    {"vkGetImageViewAddressNVX", (void*)GetImageViewAddressNVX},
+    {"vkGetImageViewHandleNVX", (void*)GetImageViewHandleNVX},
+    {"vkGetInstanceProcAddr", (void*)GetInstanceProcAddr},
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    {"vkGetMemoryAndroidHardwareBufferANDROID", (void*)GetMemoryAndroidHardwareBufferANDROID},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdCopyAccelerationStructureKHR", (void*)CmdCopyAccelerationStructureKHR},
+    {"vkGetMemoryFdKHR", (void*)GetMemoryFdKHR},
+    {"vkGetMemoryFdPropertiesKHR", (void*)GetMemoryFdPropertiesKHR},
+    {"vkGetMemoryHostPointerPropertiesEXT", (void*)GetMemoryHostPointerPropertiesEXT},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetMemoryWin32HandleKHR", (void*)GetMemoryWin32HandleKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdCopyAccelerationStructureToMemoryKHR", (void*)CmdCopyAccelerationStructureToMemoryKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetMemoryWin32HandleNV", (void*)GetMemoryWin32HandleNV},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdCopyMemoryToAccelerationStructureKHR", (void*)CmdCopyMemoryToAccelerationStructureKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetMemoryWin32HandlePropertiesKHR", (void*)GetMemoryWin32HandlePropertiesKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdTraceRaysKHR", (void*)CmdTraceRaysKHR},
+    {"vkGetPastPresentationTimingGOOGLE", (void*)GetPastPresentationTimingGOOGLE},
+    {"vkGetPerformanceParameterINTEL", (void*)GetPerformanceParameterINTEL},
+    {"vkGetPhysicalDeviceCalibrateableTimeDomainsEXT", (void*)GetPhysicalDeviceCalibrateableTimeDomainsEXT},
+    {"vkGetPhysicalDeviceCooperativeMatrixPropertiesNV", (void*)GetPhysicalDeviceCooperativeMatrixPropertiesNV},
+#ifdef VK_USE_PLATFORM_DIRECTFB_EXT
+    {"vkGetPhysicalDeviceDirectFBPresentationSupportEXT", (void*)GetPhysicalDeviceDirectFBPresentationSupportEXT},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCreateRayTracingPipelinesKHR", (void*)CreateRayTracingPipelinesKHR},
+    {"vkGetPhysicalDeviceDisplayPlaneProperties2KHR", (void*)GetPhysicalDeviceDisplayPlaneProperties2KHR},
+    {"vkGetPhysicalDeviceDisplayPlanePropertiesKHR", (void*)GetPhysicalDeviceDisplayPlanePropertiesKHR},
+    {"vkGetPhysicalDeviceDisplayProperties2KHR", (void*)GetPhysicalDeviceDisplayProperties2KHR},
+    {"vkGetPhysicalDeviceDisplayPropertiesKHR", (void*)GetPhysicalDeviceDisplayPropertiesKHR},
+    {"vkGetPhysicalDeviceExternalBufferProperties", (void*)GetPhysicalDeviceExternalBufferProperties},
+    {"vkGetPhysicalDeviceExternalBufferPropertiesKHR", (void*)GetPhysicalDeviceExternalBufferPropertiesKHR},
+    {"vkGetPhysicalDeviceExternalFenceProperties", (void*)GetPhysicalDeviceExternalFenceProperties},
+    {"vkGetPhysicalDeviceExternalFencePropertiesKHR", (void*)GetPhysicalDeviceExternalFencePropertiesKHR},
+    {"vkGetPhysicalDeviceExternalImageFormatPropertiesNV", (void*)GetPhysicalDeviceExternalImageFormatPropertiesNV},
+    {"vkGetPhysicalDeviceExternalSemaphoreProperties", (void*)GetPhysicalDeviceExternalSemaphoreProperties},
+    {"vkGetPhysicalDeviceExternalSemaphorePropertiesKHR", (void*)GetPhysicalDeviceExternalSemaphorePropertiesKHR},
+    {"vkGetPhysicalDeviceFeatures", (void*)GetPhysicalDeviceFeatures},
+    {"vkGetPhysicalDeviceFeatures2", (void*)GetPhysicalDeviceFeatures2},
+    {"vkGetPhysicalDeviceFeatures2KHR", (void*)GetPhysicalDeviceFeatures2KHR},
+    {"vkGetPhysicalDeviceFormatProperties", (void*)GetPhysicalDeviceFormatProperties},
+    {"vkGetPhysicalDeviceFormatProperties2", (void*)GetPhysicalDeviceFormatProperties2},
+    {"vkGetPhysicalDeviceFormatProperties2KHR", (void*)GetPhysicalDeviceFormatProperties2KHR},
+    {"vkGetPhysicalDeviceImageFormatProperties", (void*)GetPhysicalDeviceImageFormatProperties},
+    {"vkGetPhysicalDeviceImageFormatProperties2", (void*)GetPhysicalDeviceImageFormatProperties2},
+    {"vkGetPhysicalDeviceImageFormatProperties2KHR", (void*)GetPhysicalDeviceImageFormatProperties2KHR},
+    {"vkGetPhysicalDeviceMemoryProperties", (void*)GetPhysicalDeviceMemoryProperties},
+    {"vkGetPhysicalDeviceMemoryProperties2", (void*)GetPhysicalDeviceMemoryProperties2},
+    {"vkGetPhysicalDeviceMemoryProperties2KHR", (void*)GetPhysicalDeviceMemoryProperties2KHR},
+    {"vkGetPhysicalDeviceMultisamplePropertiesEXT", (void*)GetPhysicalDeviceMultisamplePropertiesEXT},
+    {"vkGetPhysicalDevicePresentRectanglesKHR", (void*)GetPhysicalDevicePresentRectanglesKHR},
+    {"vkGetPhysicalDeviceProperties", (void*)GetPhysicalDeviceProperties},
+    {"vkGetPhysicalDeviceProperties2", (void*)GetPhysicalDeviceProperties2},
+    {"vkGetPhysicalDeviceProperties2KHR", (void*)GetPhysicalDeviceProperties2KHR},
+    {"vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR", (void*)GetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR},
+    {"vkGetPhysicalDeviceQueueFamilyProperties", (void*)GetPhysicalDeviceQueueFamilyProperties},
+    {"vkGetPhysicalDeviceQueueFamilyProperties2", (void*)GetPhysicalDeviceQueueFamilyProperties2},
+    {"vkGetPhysicalDeviceQueueFamilyProperties2KHR", (void*)GetPhysicalDeviceQueueFamilyProperties2KHR},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties", (void*)GetPhysicalDeviceSparseImageFormatProperties},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties2", (void*)GetPhysicalDeviceSparseImageFormatProperties2},
+    {"vkGetPhysicalDeviceSparseImageFormatProperties2KHR", (void*)GetPhysicalDeviceSparseImageFormatProperties2KHR},
+    {"vkGetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV", (void*)GetPhysicalDeviceSupportedFramebufferMixedSamplesCombinationsNV},
+    {"vkGetPhysicalDeviceSurfaceCapabilities2EXT", (void*)GetPhysicalDeviceSurfaceCapabilities2EXT},
+    {"vkGetPhysicalDeviceSurfaceCapabilities2KHR", (void*)GetPhysicalDeviceSurfaceCapabilities2KHR},
+    {"vkGetPhysicalDeviceSurfaceCapabilitiesKHR", (void*)GetPhysicalDeviceSurfaceCapabilitiesKHR},
+    {"vkGetPhysicalDeviceSurfaceFormats2KHR", (void*)GetPhysicalDeviceSurfaceFormats2KHR},
+    {"vkGetPhysicalDeviceSurfaceFormatsKHR", (void*)GetPhysicalDeviceSurfaceFormatsKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetPhysicalDeviceSurfacePresentModes2EXT", (void*)GetPhysicalDeviceSurfacePresentModes2EXT},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkGetAccelerationStructureDeviceAddressKHR", (void*)GetAccelerationStructureDeviceAddressKHR},
+    {"vkGetPhysicalDeviceSurfacePresentModesKHR", (void*)GetPhysicalDeviceSurfacePresentModesKHR},
+    {"vkGetPhysicalDeviceSurfaceSupportKHR", (void*)GetPhysicalDeviceSurfaceSupportKHR},
+    {"vkGetPhysicalDeviceToolPropertiesEXT", (void*)GetPhysicalDeviceToolPropertiesEXT},
+#ifdef VK_USE_PLATFORM_WAYLAND_KHR
+    {"vkGetPhysicalDeviceWaylandPresentationSupportKHR", (void*)GetPhysicalDeviceWaylandPresentationSupportKHR},
+#else
+    {"", nullptr},
+#endif
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetPhysicalDeviceWin32PresentationSupportKHR", (void*)GetPhysicalDeviceWin32PresentationSupportKHR},
+#else
+    {"", nullptr},
+#endif
+#ifdef VK_USE_PLATFORM_XCB_KHR
+    {"vkGetPhysicalDeviceXcbPresentationSupportKHR", (void*)GetPhysicalDeviceXcbPresentationSupportKHR},
+#else
+    {"", nullptr},
+#endif
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+    {"vkGetPhysicalDeviceXlibPresentationSupportKHR", (void*)GetPhysicalDeviceXlibPresentationSupportKHR},
+#else
+    {"", nullptr},
+#endif
+    {"vkGetPipelineCacheData", (void*)GetPipelineCacheData},
+    {"vkGetPipelineExecutableInternalRepresentationsKHR", (void*)GetPipelineExecutableInternalRepresentationsKHR},
+    {"vkGetPipelineExecutablePropertiesKHR", (void*)GetPipelineExecutablePropertiesKHR},
+    {"vkGetPipelineExecutableStatisticsKHR", (void*)GetPipelineExecutableStatisticsKHR},
+    {"vkGetPrivateDataEXT", (void*)GetPrivateDataEXT},
+    {"vkGetQueryPoolResults", (void*)GetQueryPoolResults},
+    {"vkGetQueueCheckpointDataNV", (void*)GetQueueCheckpointDataNV},
+#ifdef VK_USE_PLATFORM_XLIB_XRANDR_EXT
+    {"vkGetRandROutputDisplayEXT", (void*)GetRandROutputDisplayEXT},
+#else
+    {"", nullptr},
 #endif
 #ifdef VK_ENABLE_BETA_EXTENSIONS
     {"vkGetRayTracingCaptureReplayShaderGroupHandlesKHR", (void*)GetRayTracingCaptureReplayShaderGroupHandlesKHR},
+#else
+    {"", nullptr},
 #endif
-#ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkCmdTraceRaysIndirectKHR", (void*)CmdTraceRaysIndirectKHR},
+    {"vkGetRayTracingShaderGroupHandlesKHR", (void*)GetRayTracingShaderGroupHandlesKHR},
+    {"vkGetRayTracingShaderGroupHandlesNV", (void*)GetRayTracingShaderGroupHandlesNV},
+    {"vkGetRefreshCycleDurationGOOGLE", (void*)GetRefreshCycleDurationGOOGLE},
+    {"vkGetRenderAreaGranularity", (void*)GetRenderAreaGranularity},
+    {"vkGetSemaphoreCounterValue", (void*)GetSemaphoreCounterValue},
+    {"vkGetSemaphoreCounterValueKHR", (void*)GetSemaphoreCounterValueKHR},
+    {"vkGetSemaphoreFdKHR", (void*)GetSemaphoreFdKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkGetSemaphoreWin32HandleKHR", (void*)GetSemaphoreWin32HandleKHR},
+#else
+    {"", nullptr},
+#endif
+    {"vkGetShaderInfoAMD", (void*)GetShaderInfoAMD},
+    {"vkGetSwapchainCounterEXT", (void*)GetSwapchainCounterEXT},
+    {"vkGetSwapchainImagesKHR", (void*)GetSwapchainImagesKHR},
+    {"vkGetSwapchainStatusKHR", (void*)GetSwapchainStatusKHR},
+    {"vkGetValidationCacheDataEXT", (void*)GetValidationCacheDataEXT},
+    {"vkImportFenceFdKHR", (void*)ImportFenceFdKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkImportFenceWin32HandleKHR", (void*)ImportFenceWin32HandleKHR},
+#else
+    {"", nullptr},
+#endif
+    {"vkImportSemaphoreFdKHR", (void*)ImportSemaphoreFdKHR},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkImportSemaphoreWin32HandleKHR", (void*)ImportSemaphoreWin32HandleKHR},
+#else
+    {"", nullptr},
+#endif
+    {"vkInitializePerformanceApiINTEL", (void*)InitializePerformanceApiINTEL},
+    {"vkInvalidateMappedMemoryRanges", (void*)InvalidateMappedMemoryRanges},
+    {"vkMapMemory", (void*)MapMemory},
+    {"vkMergePipelineCaches", (void*)MergePipelineCaches},
+    {"vkMergeValidationCachesEXT", (void*)MergeValidationCachesEXT},
+    {"vkQueueBeginDebugUtilsLabelEXT", (void*)QueueBeginDebugUtilsLabelEXT},
+    {"vkQueueBindSparse", (void*)QueueBindSparse},
+    {"vkQueueEndDebugUtilsLabelEXT", (void*)QueueEndDebugUtilsLabelEXT},
+    {"vkQueueInsertDebugUtilsLabelEXT", (void*)QueueInsertDebugUtilsLabelEXT},
+    {"vkQueuePresentKHR", (void*)QueuePresentKHR},
+    {"vkQueueSetPerformanceConfigurationINTEL", (void*)QueueSetPerformanceConfigurationINTEL},
+    {"vkQueueSubmit", (void*)QueueSubmit},
+    {"vkQueueWaitIdle", (void*)QueueWaitIdle},
+    {"vkRegisterDeviceEventEXT", (void*)RegisterDeviceEventEXT},
+    {"vkRegisterDisplayEventEXT", (void*)RegisterDisplayEventEXT},
+    {"vkReleaseDisplayEXT", (void*)ReleaseDisplayEXT},
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+    {"vkReleaseFullScreenExclusiveModeEXT", (void*)ReleaseFullScreenExclusiveModeEXT},
+#else
+    {"", nullptr},
 #endif
+    {"vkReleasePerformanceConfigurationINTEL", (void*)ReleasePerformanceConfigurationINTEL},
+    {"vkReleaseProfilingLockKHR", (void*)ReleaseProfilingLockKHR},
+    {"vkResetCommandBuffer", (void*)ResetCommandBuffer},
+    {"vkResetCommandPool", (void*)ResetCommandPool},
+    {"vkResetDescriptorPool", (void*)ResetDescriptorPool},
+    {"vkResetEvent", (void*)ResetEvent},
+    {"vkResetFences", (void*)ResetFences},
+    {"vkResetQueryPool", (void*)ResetQueryPool},
+    {"vkResetQueryPoolEXT", (void*)ResetQueryPoolEXT},
+    {"vkSetDebugUtilsObjectNameEXT", (void*)SetDebugUtilsObjectNameEXT},
+    {"vkSetDebugUtilsObjectTagEXT", (void*)SetDebugUtilsObjectTagEXT},
+    {"vkSetEvent", (void*)SetEvent},
+    {"vkSetHdrMetadataEXT", (void*)SetHdrMetadataEXT},
+    {"vkSetLocalDimmingAMD", (void*)SetLocalDimmingAMD},
+    {"vkSetPrivateDataEXT", (void*)SetPrivateDataEXT},
+    {"vkSignalSemaphore", (void*)SignalSemaphore},
+    {"vkSignalSemaphoreKHR", (void*)SignalSemaphoreKHR},
+    {"vkSubmitDebugUtilsMessageEXT", (void*)SubmitDebugUtilsMessageEXT},
+    {"vkTrimCommandPool", (void*)TrimCommandPool},
+    {"vkTrimCommandPoolKHR", (void*)TrimCommandPoolKHR},
+    {"vkUninitializePerformanceApiINTEL", (void*)UninitializePerformanceApiINTEL},
+    {"vkUnmapMemory", (void*)UnmapMemory},
+    {"vkUpdateDescriptorSetWithTemplate", (void*)UpdateDescriptorSetWithTemplate},
+    {"vkUpdateDescriptorSetWithTemplateKHR", (void*)UpdateDescriptorSetWithTemplateKHR},
+    {"vkUpdateDescriptorSets", (void*)UpdateDescriptorSets},
+    {"vkWaitForFences", (void*)WaitForFences},
+    {"vkWaitSemaphores", (void*)WaitSemaphores},
+    {"vkWaitSemaphoresKHR", (void*)WaitSemaphoresKHR},
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-    {"vkGetDeviceAccelerationStructureCompatibilityKHR", (void*)GetDeviceAccelerationStructureCompatibilityKHR},
+    {"vkWriteAccelerationStructuresPropertiesKHR", (void*)WriteAccelerationStructuresPropertiesKHR},
+#else
+    {"", nullptr},
 #endif
 };
+// Hash table of name_to_funcptr_map indices, keyed by HashName()
+static const uint16_t name_to_funcptr_hash_table[1024] = {
+    kEmptySlot, kEmptySlot, 298, kEmptySlot, kEmptySlot, 15, kEmptySlot, kEmptySlot, 169, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 301, 309, kEmptySlot,
+    kEmptySlot, 134, 13, 73, 115, 267, 270, kEmptySlot, 291, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 357, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 326, 175, 377, kEmptySlot, kEmptySlot, 109, kEmptySlot, kEmptySlot, 278, 404, 71, 276, kEmptySlot,
+    184, 26, kEmptySlot, kEmptySlot, kEmptySlot, 75, 389, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 349, kEmptySlot, 347, 265, 180,
+    kEmptySlot, 305, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 32, 263, 366, kEmptySlot, kEmptySlot, 143, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    188, 201, 18, 211, kEmptySlot, kEmptySlot, 289, 195, 31, 21, 20, 34, 373, 170, kEmptySlot, 234,
+    112, 316, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 192, 252, 154, 162, 308, 392, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 2, 80, kEmptySlot, 220, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 297, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 382, 81, kEmptySlot, 275, 227, kEmptySlot, 27, 339, kEmptySlot, 385, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 245, 417, kEmptySlot, kEmptySlot, 318, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 127, 70,
+    242, 345, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 97, 368, kEmptySlot, 426, kEmptySlot, kEmptySlot, 303, kEmptySlot, kEmptySlot,
+    354, 230, kEmptySlot, kEmptySlot, kEmptySlot, 1, 67, 406, kEmptySlot, kEmptySlot, kEmptySlot, 203, kEmptySlot, 197, 332, kEmptySlot,
+    kEmptySlot, 151, 401, kEmptySlot, kEmptySlot, kEmptySlot, 173, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 98, 152, 418, kEmptySlot,
+    kEmptySlot, kEmptySlot, 229, kEmptySlot, kEmptySlot, 146, 64, 359, 364, 369, 33, 25, 95, 258, kEmptySlot, kEmptySlot,
+    54, 124, kEmptySlot, kEmptySlot, 156, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 236, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 137,
+    47, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 399, 348, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 155, 387, 257, 163, 306, kEmptySlot, kEmptySlot, 3, kEmptySlot, kEmptySlot, 343, 4, 126,
+    kEmptySlot, kEmptySlot, kEmptySlot, 92, 262, 337, kEmptySlot, kEmptySlot, 190, 205, kEmptySlot, 88, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    330, 14, 37, 113, 138, kEmptySlot, kEmptySlot, 428, 102, kEmptySlot, 409, kEmptySlot, kEmptySlot, kEmptySlot, 133, 149,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 268, 204, kEmptySlot, 414, kEmptySlot, kEmptySlot, 378, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, 183, 281, kEmptySlot, kEmptySlot, 370, kEmptySlot, kEmptySlot, 101, 53, 307, 94, 367, 261, 119, 158,
+    383, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 388, kEmptySlot, kEmptySlot, 322, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 160, 327,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 120, 61, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 255, kEmptySlot,
+    kEmptySlot, 82, 225, 379, kEmptySlot, 136, 135, 287, 293, 396, kEmptySlot, 288, kEmptySlot, kEmptySlot, 218, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 96, 424, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 394, kEmptySlot,
+    5, kEmptySlot, 284, 29, 432, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 223, 40, 68, kEmptySlot, 65, kEmptySlot,
+    kEmptySlot, 30, 174, 106, 178, 93, 294, 166, 300, 310, 324, 340, 362, 198, 390, kEmptySlot,
+    376, 199, kEmptySlot, 395, kEmptySlot, kEmptySlot, 290, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 333, kEmptySlot, 141, 171, 60,
+    kEmptySlot, 375, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 191, 38, 164, 313, kEmptySlot, kEmptySlot, kEmptySlot, 22, kEmptySlot, kEmptySlot,
+    222, 407, kEmptySlot, 411, 344, kEmptySlot, 341, 346, kEmptySlot, kEmptySlot, kEmptySlot, 86, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    213, kEmptySlot, kEmptySlot, kEmptySlot, 402, 380, kEmptySlot, kEmptySlot, 299, 79, kEmptySlot, kEmptySlot, 419, kEmptySlot, kEmptySlot, kEmptySlot,
+    200, kEmptySlot, kEmptySlot, kEmptySlot, 62, kEmptySlot, kEmptySlot, kEmptySlot, 159, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, 35, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 283, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 36, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 39, kEmptySlot, kEmptySlot, kEmptySlot, 179, 123, 125, kEmptySlot, kEmptySlot, kEmptySlot, 321, 292, kEmptySlot,
+    285, 45, 23, 420, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 114, 254, kEmptySlot, 280, kEmptySlot, kEmptySlot, kEmptySlot, 429,
+    85, 286, 329, kEmptySlot, 221, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 99, 260,
+    kEmptySlot, kEmptySlot, kEmptySlot, 172, 360, kEmptySlot, kEmptySlot, 129, 325, 11, kEmptySlot, kEmptySlot, kEmptySlot, 256, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, 372, kEmptySlot, kEmptySlot, kEmptySlot, 103, kEmptySlot, 41, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 237, kEmptySlot,
+    kEmptySlot, kEmptySlot, 228, 365, 121, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 416, 232, 185, kEmptySlot, kEmptySlot, 48,
+    90, 28, 9, 78, 147, 208, 350, kEmptySlot, 226, 157, kEmptySlot, kEmptySlot, kEmptySlot, 239, kEmptySlot, kEmptySlot,
+    111, kEmptySlot, kEmptySlot, kEmptySlot, 413, 44, 66, kEmptySlot, kEmptySlot, 116, 250, kEmptySlot, kEmptySlot, 251, kEmptySlot, 167,
+    43, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 16, kEmptySlot, 328, kEmptySlot, 315, 351, kEmptySlot, kEmptySlot, kEmptySlot, 142, kEmptySlot,
+    kEmptySlot, 352, kEmptySlot, 161, 410, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 165, 334, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, 282, 320, kEmptySlot, kEmptySlot, 384, 57, 269, kEmptySlot, kEmptySlot, 69, 397, 244, 423, 8, kEmptySlot,
+    58, kEmptySlot, kEmptySlot, 52, 427, kEmptySlot, kEmptySlot, 186, 105, kEmptySlot, kEmptySlot, 259, kEmptySlot, 59, 273, kEmptySlot,
+    kEmptySlot, kEmptySlot, 206, kEmptySlot, 12, 118, 140, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 144, 336, 358, kEmptySlot, kEmptySlot,
+    355, 130, 319, 110, kEmptySlot, 240, 272, 277, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 6, 342, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 361, 317, 19, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, 433, 72, kEmptySlot, 150, 55, kEmptySlot, kEmptySlot, kEmptySlot, 7, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, 212, kEmptySlot, kEmptySlot, kEmptySlot, 400, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 56, kEmptySlot, 182, kEmptySlot,
+    kEmptySlot, 74, 84, 295, 415, 235, 371, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 408, 189, 91, 89,
+    24, 104, 363, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 431, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 274, 42,
+    50, kEmptySlot, 128, 224, 381, 0, 216, kEmptySlot, kEmptySlot, kEmptySlot, 238, 271, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, 214, kEmptySlot, 87, kEmptySlot, 412, 331, kEmptySlot, kEmptySlot, kEmptySlot, 403, 279, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 131, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 207, 107, 311, 312, kEmptySlot,
+    kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 231, 353, kEmptySlot, kEmptySlot, 302, kEmptySlot, kEmptySlot, 46, kEmptySlot, 425,
+    248, kEmptySlot, 168, 266, kEmptySlot, 398, kEmptySlot, 122, 249, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, 233, kEmptySlot, kEmptySlot, 132, kEmptySlot, 393, 217, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot,
+    304, kEmptySlot, kEmptySlot, kEmptySlot, 176, kEmptySlot, 83, 153, 356, kEmptySlot, 181, kEmptySlot, kEmptySlot, 49, kEmptySlot, 139,
+    kEmptySlot, kEmptySlot, 202, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 323, kEmptySlot, kEmptySlot, 117, 338, kEmptySlot, kEmptySlot, kEmptySlot,
+    kEmptySlot, kEmptySlot, 100, 210, 219, kEmptySlot, 148, kEmptySlot, 10, 194, 243, 421, 196, 63, kEmptySlot, 51,
+    247, 241, 314, kEmptySlot, kEmptySlot, kEmptySlot, 177, kEmptySlot, 77, 386, kEmptySlot, 215, 430, 405, 246, 193,
+    335, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 187, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, kEmptySlot, 391, 17, 145, kEmptySlot, kEmptySlot,
+    kEmptySlot, 296, 374, kEmptySlot, kEmptySlot, 209, kEmptySlot, kEmptySlot, 253, 422, 76, 108, kEmptySlot, kEmptySlot, 264, kEmptySlot,
+};
 
 
 } // namespace vkmock
@@ -0,0 +1,545 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput and latency benchmark for the mock ICD.
+//
+// The ICD library is loaded directly and driven through vk_icdGetInstanceProcAddr, so neither the loader nor any
+// layers are involved and the numbers only reflect the ICD's own overhead. Each workload runs the same loop of object
+// create/destroy or allocate/map/free calls on every thread against a single shared VkDevice, for an increasing number
+// of threads. For every thread count it reports the aggregate calls per second, and the median and 99th percentile
+// latency of the individual calls measured in a second run, which include the time it takes to read the clock.
+//
+// Usage: mock_icd_benchmark [path to ICD library] [iterations per thread] [max thread count] [workload]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <vulkan/vulkan.h>
+
+#ifndef MOCK_ICD_LIBRARY
+#ifdef _WIN32
+#define MOCK_ICD_LIBRARY "VkICD_mock_icd.dll"
+#elif defined(__APPLE__)
+#define MOCK_ICD_LIBRARY "./libVkICD_mock_icd.dylib"
+#else
+#define MOCK_ICD_LIBRARY "./libVkICD_mock_icd.so"
+#endif
+#endif
+
+typedef VkResult(VKAPI_PTR *PFN_NegotiateLoaderICDInterfaceVersion)(uint32_t *pVersion);
+
+struct IcdFunctions {
+    PFN_vkGetInstanceProcAddr GetInstanceProcAddr;
+    PFN_vkCreateInstance CreateInstance;
+    PFN_vkDestroyInstance DestroyInstance;
+    PFN_vkEnumeratePhysicalDevices EnumeratePhysicalDevices;
+    PFN_vkCreateDevice CreateDevice;
+    PFN_vkDestroyDevice DestroyDevice;
+    PFN_vkCreateBuffer CreateBuffer;
+    PFN_vkDestroyBuffer DestroyBuffer;
+    PFN_vkGetBufferMemoryRequirements GetBufferMemoryRequirements;
+    PFN_vkCreateImage CreateImage;
+    PFN_vkDestroyImage DestroyImage;
+    PFN_vkGetImageMemoryRequirements GetImageMemoryRequirements;
+    PFN_vkAllocateMemory AllocateMemory;
+    PFN_vkFreeMemory FreeMemory;
+    PFN_vkBindBufferMemory BindBufferMemory;
+    PFN_vkMapMemory MapMemory;
+    PFN_vkUnmapMemory UnmapMemory;
+    PFN_vkCreateFence CreateFence;
+    PFN_vkDestroyFence DestroyFence;
+    PFN_vkCreateSemaphore CreateSemaphore;
+    PFN_vkDestroySemaphore DestroySemaphore;
+    PFN_vkCreateDescriptorSetLayout CreateDescriptorSetLayout;
+    PFN_vkDestroyDescriptorSetLayout DestroyDescriptorSetLayout;
+    PFN_vkCreateDescriptorPool CreateDescriptorPool;
+    PFN_vkDestroyDescriptorPool DestroyDescriptorPool;
+    PFN_vkAllocateDescriptorSets AllocateDescriptorSets;
+    PFN_vkFreeDescriptorSets FreeDescriptorSets;
+    PFN_vkUpdateDescriptorSets UpdateDescriptorSets;
+    PFN_vkCreateDescriptorUpdateTemplate CreateDescriptorUpdateTemplate;
+    PFN_vkDestroyDescriptorUpdateTemplate DestroyDescriptorUpdateTemplate;
+    PFN_vkUpdateDescriptorSetWithTemplate UpdateDescriptorSetWithTemplate;
+    PFN_vkCreateCommandPool CreateCommandPool;
+    PFN_vkDestroyCommandPool DestroyCommandPool;
+    PFN_vkAllocateCommandBuffers AllocateCommandBuffers;
+    PFN_vkFreeCommandBuffers FreeCommandBuffers;
+    PFN_vkBeginCommandBuffer BeginCommandBuffer;
+    PFN_vkEndCommandBuffer EndCommandBuffer;
+};
+
+static void *LoadIcd(const char *path, IcdFunctions *fns) {
+#ifdef _WIN32
+    HMODULE library = LoadLibraryA(path);
+    auto get_symbol = [library](const char *name) { return (void *)GetProcAddress(library, name); };
+#else
+    void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    auto get_symbol = [library](const char *name) { return dlsym(library, name); };
+#endif
+    if (!library) return nullptr;
+    auto negotiate = (PFN_NegotiateLoaderICDInterfaceVersion)get_symbol("vk_icdNegotiateLoaderICDInterfaceVersion");
+    fns->GetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)get_symbol("vk_icdGetInstanceProcAddr");
+    if (!negotiate || !fns->GetInstanceProcAddr) return nullptr;
+    // The mock ICD refuses to create instances unless the loader interface version has been negotiated
+    uint32_t interface_version = 5;
+    negotiate(&interface_version);
+    return (void *)library;
+}
+
+#define GET_PROC(fns, instance, name) fns.name = (PFN_vk##name)fns.GetInstanceProcAddr(instance, "vk" #name)
+
+static void LoadFunctions(VkInstance instance, IcdFunctions &fns) {
+    GET_PROC(fns, instance, DestroyInstance);
+    GET_PROC(fns, instance, EnumeratePhysicalDevices);
+    GET_PROC(fns, instance, CreateDevice);
+    GET_PROC(fns, instance, DestroyDevice);
+    GET_PROC(fns, instance, CreateBuffer);
+    GET_PROC(fns, instance, DestroyBuffer);
+    GET_PROC(fns, instance, GetBufferMemoryRequirements);
+    GET_PROC(fns, instance, CreateImage);
+    GET_PROC(fns, instance, DestroyImage);
+    GET_PROC(fns, instance, GetImageMemoryRequirements);
+    GET_PROC(fns, instance, AllocateMemory);
+    GET_PROC(fns, instance, FreeMemory);
+    GET_PROC(fns, instance, BindBufferMemory);
+    GET_PROC(fns, instance, MapMemory);
+    GET_PROC(fns, instance, UnmapMemory);
+    GET_PROC(fns, instance, CreateFence);
+    GET_PROC(fns, instance, DestroyFence);
+    GET_PROC(fns, instance, CreateSemaphore);
+    GET_PROC(fns, instance, DestroySemaphore);
+    GET_PROC(fns, instance, CreateDescriptorSetLayout);
+    GET_PROC(fns, instance, DestroyDescriptorSetLayout);
+    GET_PROC(fns, instance, CreateDescriptorPool);
+    GET_PROC(fns, instance, DestroyDescriptorPool);
+    GET_PROC(fns, instance, AllocateDescriptorSets);
+    GET_PROC(fns, instance, FreeDescriptorSets);
+    GET_PROC(fns, instance, UpdateDescriptorSets);
+    GET_PROC(fns, instance, CreateDescriptorUpdateTemplate);
+    GET_PROC(fns, instance, DestroyDescriptorUpdateTemplate);
+    GET_PROC(fns, instance, UpdateDescriptorSetWithTemplate);
+    GET_PROC(fns, instance, CreateCommandPool);
+    GET_PROC(fns, instance, DestroyCommandPool);
+    GET_PROC(fns, instance, AllocateCommandBuffers);
+    GET_PROC(fns, instance, FreeCommandBuffers);
+    GET_PROC(fns, instance, BeginCommandBuffer);
+    GET_PROC(fns, instance, EndCommandBuffer);
+}
+
+// Counts the ICD calls a thread makes and, when asked to, records the latency of each of them
+class CallRecorder {
+  public:
+    CallRecorder(bool record_latencies, size_t expected_calls) : record_latencies_(record_latencies) {
+        if (record_latencies_) latencies_.reserve(expected_calls);
+    }
+    template <typename Call>
+    void operator()(Call call) {
+        ++call_count_;
+        if (!record_latencies_) {
+            call();
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        call();
+        const auto end = std::chrono::steady_clock::now();
+        latencies_.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    uint64_t call_count() const { return call_count_; }
+    std::vector<uint32_t> &latencies() { return latencies_; }
+
+  private:
+    bool record_latencies_;
+    uint64_t call_count_ = 0;
+    std::vector<uint32_t> latencies_;
+};
+
+// Object templates shared by the workloads
+struct ObjectInfos {
+    VkBufferCreateInfo buffer_ci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    VkImageCreateInfo image_ci = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    VkMemoryAllocateInfo memory_ai = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    VkFenceCreateInfo fence_ci = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    VkSemaphoreCreateInfo semaphore_ci = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+
+    ObjectInfos() {
+        buffer_ci.size = 65536;
+        buffer_ci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        image_ci.imageType = VK_IMAGE_TYPE_2D;
+        image_ci.format = VK_FORMAT_R8G8B8A8_UNORM;
+        image_ci.extent = {256, 256, 1};
+        image_ci.mipLevels = 1;
+        image_ci.arrayLayers = 1;
+        image_ci.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_ci.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+        memory_ai.allocationSize = 65536;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    }
+};
+
+static const uint32_t kCommandBuffersPerIteration = 4;
+static const uint32_t kDescriptorSetsPerIteration = 4;
+static const uint32_t kImagesPerDescriptorSet = 4;
+
+// Descriptors of a set of the layout the workloads use, in the layout an application would keep them in for
+// vkUpdateDescriptorSetWithTemplate
+struct DescriptorUpdateData {
+    VkDescriptorBufferInfo uniform_buffer;
+    VkDescriptorImageInfo images[kImagesPerDescriptorSet];
+};
+
+// Per-thread objects that the workloads allocate from
+struct ThreadObjects {
+    VkCommandPool command_pool;
+    VkDescriptorSetLayout set_layout;
+    VkDescriptorPool descriptor_pool;
+    // A set that the update workloads write to, and a template that writes all of its descriptors
+    VkDescriptorPool update_pool;
+    VkDescriptorSet update_set;
+    VkDescriptorUpdateTemplate update_template;
+    DescriptorUpdateData update_data;
+    VkWriteDescriptorSet update_writes[2];
+};
+
+static void CreateThreadObjects(const IcdFunctions &fns, VkDevice device, ThreadObjects *objects) {
+    VkCommandPoolCreateInfo pool_ci = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    fns.CreateCommandPool(device, &pool_ci, nullptr, &objects->command_pool);
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = kImagesPerDescriptorSet;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+    VkDescriptorSetLayoutCreateInfo layout_ci = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    layout_ci.bindingCount = 2;
+    layout_ci.pBindings = bindings;
+    fns.CreateDescriptorSetLayout(device, &layout_ci, nullptr, &objects->set_layout);
+    VkDescriptorPoolSize pool_sizes[2] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kDescriptorSetsPerIteration},
+                                          {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, kImagesPerDescriptorSet * kDescriptorSetsPerIteration}};
+    VkDescriptorPoolCreateInfo descriptor_pool_ci = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    descriptor_pool_ci.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    descriptor_pool_ci.maxSets = kDescriptorSetsPerIteration;
+    descriptor_pool_ci.poolSizeCount = 2;
+    descriptor_pool_ci.pPoolSizes = pool_sizes;
+    fns.CreateDescriptorPool(device, &descriptor_pool_ci, nullptr, &objects->descriptor_pool);
+
+    pool_sizes[0].descriptorCount = 1;
+    pool_sizes[1].descriptorCount = kImagesPerDescriptorSet;
+    descriptor_pool_ci.flags = 0;
+    descriptor_pool_ci.maxSets = 1;
+    fns.CreateDescriptorPool(device, &descriptor_pool_ci, nullptr, &objects->update_pool);
+    VkDescriptorSetAllocateInfo set_ai = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    set_ai.descriptorPool = objects->update_pool;
+    set_ai.descriptorSetCount = 1;
+    set_ai.pSetLayouts = &objects->set_layout;
+    fns.AllocateDescriptorSets(device, &set_ai, &objects->update_set);
+    auto &data = objects->update_data;
+    data.uniform_buffer = {VK_NULL_HANDLE, 0, VK_WHOLE_SIZE};
+    for (auto &image : data.images) image = {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkDescriptorUpdateTemplateEntry entries[2] = {
+        {0, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, offsetof(DescriptorUpdateData, uniform_buffer), 0},
+        {1, 0, kImagesPerDescriptorSet, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(DescriptorUpdateData, images),
+         sizeof(VkDescriptorImageInfo)}};
+    VkDescriptorUpdateTemplateCreateInfo template_ci = {VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+    template_ci.descriptorUpdateEntryCount = 2;
+    template_ci.pDescriptorUpdateEntries = entries;
+    template_ci.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    template_ci.descriptorSetLayout = objects->set_layout;
+    fns.CreateDescriptorUpdateTemplate(device, &template_ci, nullptr, &objects->update_template);
+    // The same descriptors as vkUpdateDescriptorSets writes
+    for (auto &write : objects->update_writes) {
+        write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = objects->update_set;
+    }
+    objects->update_writes[0].dstBinding = 0;
+    objects->update_writes[0].descriptorCount = 1;
+    objects->update_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    objects->update_writes[0].pBufferInfo = &data.uniform_buffer;
+    objects->update_writes[1].dstBinding = 1;
+    objects->update_writes[1].descriptorCount = kImagesPerDescriptorSet;
+    objects->update_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    objects->update_writes[1].pImageInfo = data.images;
+}
+
+static void DestroyThreadObjects(const IcdFunctions &fns, VkDevice device, const ThreadObjects &objects) {
+    fns.DestroyDescriptorUpdateTemplate(device, objects.update_template, nullptr);
+    fns.DestroyDescriptorPool(device, objects.update_pool, nullptr);
+    fns.DestroyDescriptorPool(device, objects.descriptor_pool, nullptr);
+    fns.DestroyDescriptorSetLayout(device, objects.set_layout, nullptr);
+    fns.DestroyCommandPool(device, objects.command_pool, nullptr);
+}
+
+// The workloads, each runs one iteration of its loop
+typedef void (*WorkloadFunc)(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos,
+                             const ThreadObjects &objects, CallRecorder &call);
+
+static void BufferWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &,
+                           CallRecorder &call) {
+    VkBuffer buffer;
+    VkMemoryRequirements reqs;
+    call([&] { fns.CreateBuffer(device, &infos.buffer_ci, nullptr, &buffer); });
+    call([&] { fns.GetBufferMemoryRequirements(device, buffer, &reqs); });
+    call([&] { fns.DestroyBuffer(device, buffer, nullptr); });
+}
+
+static void ImageWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &,
+                          CallRecorder &call) {
+    VkImage image;
+    VkMemoryRequirements reqs;
+    call([&] { fns.CreateImage(device, &infos.image_ci, nullptr, &image); });
+    call([&] { fns.GetImageMemoryRequirements(device, image, &reqs); });
+    call([&] { fns.DestroyImage(device, image, nullptr); });
+}
+
+static void MemoryWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &,
+                           CallRecorder &call) {
+    VkDeviceMemory memory;
+    void *data;
+    call([&] { fns.AllocateMemory(device, &infos.memory_ai, nullptr, &memory); });
+    call([&] { fns.MapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data); });
+    call([&] { fns.UnmapMemory(device, memory); });
+    call([&] { fns.FreeMemory(device, memory, nullptr); });
+}
+
+static void BoundBufferWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &,
+                                CallRecorder &call) {
+    VkBuffer buffer;
+    VkMemoryRequirements reqs;
+    VkDeviceMemory memory;
+    void *data;
+    call([&] { fns.CreateBuffer(device, &infos.buffer_ci, nullptr, &buffer); });
+    call([&] { fns.GetBufferMemoryRequirements(device, buffer, &reqs); });
+    VkMemoryAllocateInfo memory_ai = infos.memory_ai;
+    memory_ai.allocationSize = reqs.size;
+    call([&] { fns.AllocateMemory(device, &memory_ai, nullptr, &memory); });
+    call([&] { fns.BindBufferMemory(device, buffer, memory, 0); });
+    call([&] { fns.MapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data); });
+    call([&] { fns.UnmapMemory(device, memory); });
+    call([&] { fns.DestroyBuffer(device, buffer, nullptr); });
+    call([&] { fns.FreeMemory(device, memory, nullptr); });
+}
+
+static void SyncWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &,
+                         CallRecorder &call) {
+    VkFence fence;
+    VkSemaphore semaphore;
+    call([&] { fns.CreateFence(device, &infos.fence_ci, nullptr, &fence); });
+    call([&] { fns.DestroyFence(device, fence, nullptr); });
+    call([&] { fns.CreateSemaphore(device, &infos.semaphore_ci, nullptr, &semaphore); });
+    call([&] { fns.DestroySemaphore(device, semaphore, nullptr); });
+}
+
+static void DescriptorSetWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &, const ThreadObjects &objects,
+                                  CallRecorder &call) {
+    VkDescriptorSetLayout layouts[kDescriptorSetsPerIteration];
+    std::fill(layouts, layouts + kDescriptorSetsPerIteration, objects.set_layout);
+    VkDescriptorSetAllocateInfo set_ai = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    set_ai.descriptorPool = objects.descriptor_pool;
+    set_ai.descriptorSetCount = kDescriptorSetsPerIteration;
+    set_ai.pSetLayouts = layouts;
+    VkDescriptorSet sets[kDescriptorSetsPerIteration];
+    call([&] { fns.AllocateDescriptorSets(device, &set_ai, sets); });
+    call([&] { fns.FreeDescriptorSets(device, objects.descriptor_pool, kDescriptorSetsPerIteration, sets); });
+}
+
+// Both update all descriptors of a set with the same data, so the cost of a call is the cost of each path
+static void DescriptorWriteWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &, const ThreadObjects &objects,
+                                    CallRecorder &call) {
+    call([&] { fns.UpdateDescriptorSets(device, 2, objects.update_writes, 0, nullptr); });
+}
+
+static void DescriptorTemplateWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &,
+                                       const ThreadObjects &objects, CallRecorder &call) {
+    call([&] { fns.UpdateDescriptorSetWithTemplate(device, objects.update_set, objects.update_template, &objects.update_data); });
+}
+
+static void CommandBufferWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos,
+                                  const ThreadObjects &objects, CallRecorder &call) {
+    VkCommandBufferAllocateInfo command_buffer_ai = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    command_buffer_ai.commandPool = objects.command_pool;
+    command_buffer_ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_ai.commandBufferCount = kCommandBuffersPerIteration;
+    VkCommandBuffer command_buffers[kCommandBuffersPerIteration];
+    call([&] { fns.AllocateCommandBuffers(device, &command_buffer_ai, command_buffers); });
+    for (auto command_buffer : command_buffers) {
+        call([&] { fns.BeginCommandBuffer(command_buffer, &infos.begin_info); });
+        call([&] { fns.EndCommandBuffer(command_buffer); });
+    }
+    call([&] { fns.FreeCommandBuffers(device, objects.command_pool, kCommandBuffersPerIteration, command_buffers); });
+}
+
+// A typical streaming pattern: buffers and images with backing memory, the sync objects used to track them, and
+// descriptor sets and command buffers recycled through per-thread pools.
+static void MixedWorkload(const IcdFunctions &fns, VkDevice device, const ObjectInfos &infos, const ThreadObjects &objects,
+                          CallRecorder &call) {
+    BoundBufferWorkload(fns, device, infos, objects, call);
+    ImageWorkload(fns, device, infos, objects, call);
+    SyncWorkload(fns, device, infos, objects, call);
+    DescriptorSetWorkload(fns, device, infos, objects, call);
+    CommandBufferWorkload(fns, device, infos, objects, call);
+}
+
+struct Workload {
+    const char *name;
+    WorkloadFunc func;
+};
+static const Workload kWorkloads[] = {
+    {"buffer", BufferWorkload},
+    {"image", ImageWorkload},
+    {"memory", MemoryWorkload},
+    {"bound_buffer", BoundBufferWorkload},
+    {"sync", SyncWorkload},
+    {"descriptor_set", DescriptorSetWorkload},
+    {"descriptor_write", DescriptorWriteWorkload},
+    {"descriptor_template", DescriptorTemplateWorkload},
+    {"command_buffer", CommandBufferWorkload},
+    {"mixed", MixedWorkload},
+};
+
+struct RunResult {
+    double calls_per_second;
+    std::vector<uint32_t> latencies;  // Of all calls of all threads, when recorded
+};
+
+// Run iterations of the workload on thread_count threads at once
+static RunResult RunThreads(const IcdFunctions &fns, VkDevice device, const Workload &workload, uint32_t thread_count,
+                            uint32_t iterations, bool record_latencies) {
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> call_counts(thread_count);
+    std::vector<std::vector<uint32_t>> latencies(thread_count);
+    const ObjectInfos infos;
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            ThreadObjects objects;
+            CreateThreadObjects(fns, device, &objects);
+            CallRecorder call(record_latencies, 0);
+            // Size the latency buffer from one iteration so that recording doesn't reallocate
+            workload.func(fns, device, infos, objects, call);
+            call = CallRecorder(record_latencies, (size_t)call.call_count() * iterations);
+            ready++;
+            while (!go) std::this_thread::yield();
+            for (uint32_t i = 0; i < iterations; ++i) workload.func(fns, device, infos, objects, call);
+            call_counts[t] = call.call_count();
+            latencies[t] = std::move(call.latencies());
+            DestroyThreadObjects(fns, device, objects);
+        });
+    }
+    while (ready != thread_count) std::this_thread::yield();
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &thread : threads) thread.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    RunResult result;
+    uint64_t call_count = 0;
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        call_count += call_counts[t];
+        result.latencies.insert(result.latencies.end(), latencies[t].begin(), latencies[t].end());
+    }
+    result.calls_per_second = (double)call_count / elapsed.count();
+    return result;
+}
+
+static uint32_t Percentile(std::vector<uint32_t> &values, double fraction) {
+    if (values.empty()) return 0;
+    auto nth = values.begin() + (size_t)(fraction * (values.size() - 1));
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+int main(int argc, char **argv) {
+    const char *library_path = argc > 1 ? argv[1] : MOCK_ICD_LIBRARY;
+    const uint32_t iterations = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : 20000;
+    const char *workload_name = argc > 4 ? argv[4] : nullptr;
+
+    IcdFunctions fns = {};
+    if (!LoadIcd(library_path, &fns)) {
+        fprintf(stderr, "Failed to load mock ICD from %s\n", library_path);
+        return EXIT_FAILURE;
+    }
+    fns.CreateInstance = (PFN_vkCreateInstance)fns.GetInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance");
+    VkInstanceCreateInfo instance_ci = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    VkInstance instance;
+    if (!fns.CreateInstance || fns.CreateInstance(&instance_ci, nullptr, &instance) != VK_SUCCESS) {
+        fprintf(stderr, "vkCreateInstance failed\n");
+        return EXIT_FAILURE;
+    }
+    LoadFunctions(instance, fns);
+    uint32_t gpu_count = 1;
+    VkPhysicalDevice gpu;
+    fns.EnumeratePhysicalDevices(instance, &gpu_count, &gpu);
+    const float priority = 1.0f;
+    VkDeviceQueueCreateInfo queue_ci = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+    queue_ci.queueCount = 1;
+    queue_ci.pQueuePriorities = &priority;
+    VkDeviceCreateInfo device_ci = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    device_ci.queueCreateInfoCount = 1;
+    device_ci.pQueueCreateInfos = &queue_ci;
+    VkDevice device;
+    fns.CreateDevice(gpu, &device_ci, nullptr, &device);
+
+    std::vector<uint32_t> thread_counts;
+    const uint32_t max_threads =
+        (std::max)(1u, argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency());
+    for (uint32_t count = 1; count < max_threads; count *= 2) thread_counts.push_back(count);
+    thread_counts.push_back(max_threads);
+
+    bool found = false;
+    printf("%-20s %8s %14s %9s %9s %9s\n", "workload", "threads", "calls/sec", "speedup", "p50 ns", "p99 ns");
+    for (const auto &workload : kWorkloads) {
+        if (workload_name && strcmp(workload_name, workload.name) != 0) continue;
+        found = true;
+        // Warm up the ICD's internal tables before measuring
+        RunThreads(fns, device, workload, max_threads, iterations / 10 + 1, false);
+        double baseline = 0.0;
+        for (auto thread_count : thread_counts) {
+            // Timing every call slows the calls down, so throughput and latencies are measured in separate runs
+            const double rate = RunThreads(fns, device, workload, thread_count, iterations, false).calls_per_second;
+            auto latencies = RunThreads(fns, device, workload, thread_count, iterations, true).latencies;
+            if (thread_count == 1) baseline = rate;
+            const double speedup = baseline > 0.0 ? rate / baseline : 0.0;
+            printf("%-20s %8u %14.0f %8.2fx %9u %9u\n", workload.name, thread_count, rate, speedup,
+                   Percentile(latencies, 0.5), Percentile(latencies, 0.99));
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "Unknown workload %s, the workloads are:", workload_name);
+        for (const auto &workload : kWorkloads) fprintf(stderr, " %s", workload.name);
+        fprintf(stderr, "\n");
+    }
+
+    fns.DestroyDevice(device, nullptr);
+    fns.DestroyInstance(instance, nullptr);
+    return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
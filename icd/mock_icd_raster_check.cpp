@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Correctness and throughput check of the rasterizer of the mock ICD.
+//
+// The rasterizer in mock_icd_shader.cpp is driven directly, without the ICD, the loader or a VkDevice. The check
+// compiles a vertex and a fragment shader, renders a textured cube with back face culling and depth testing, and then
+// a 1024x1024 grid of 80000 small triangles. Triangles that share an edge must not both cover the pixels on it, so the
+// grid has to produce exactly one fragment per pixel. It prints the throughput of the grid draws and exits with a
+// nonzero status when a check fails.
+//
+// Usage: mock_icd_raster_check [thread count]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mock_icd_shader.h"
+
+using namespace vkmock;
+
+// Vertex shader, equivalent to:
+//     layout(location = 0) in vec3 position;
+//     layout(location = 1) in vec3 color;
+//     layout(location = 2) in vec2 uv;
+//     layout(location = 0) out vec3 out_color;
+//     layout(location = 1) out vec2 out_uv;
+//     layout(binding = 0) uniform Transform { mat4 mvp; };
+//     void main() { gl_Position = mvp * vec4(position, 1.0); out_color = color; out_uv = uv; }
+static const uint32_t kVertexShader[] = {
+    0x07230203, 0x00010300, 0x00000000, 0x0000002b, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+    0x00000000, 0x00000001, 0x000c000f, 0x00000000, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+    0x00000003, 0x00000004, 0x00000005, 0x00000006, 0x00000007, 0x00000008, 0x00040047, 0x00000002,
+    0x0000001e, 0x00000000, 0x00040047, 0x00000003, 0x0000001e, 0x00000001, 0x00040047, 0x00000004,
+    0x0000001e, 0x00000002, 0x00040047, 0x00000005, 0x0000001e, 0x00000000, 0x00040047, 0x00000006,
+    0x0000001e, 0x00000001, 0x00040047, 0x00000008, 0x0000000b, 0x0000002a, 0x00050048, 0x00000009,
+    0x00000000, 0x0000000b, 0x00000000, 0x00050048, 0x00000009, 0x00000001, 0x0000000b, 0x00000001,
+    0x00030047, 0x00000009, 0x00000002, 0x00050048, 0x0000000a, 0x00000000, 0x00000023, 0x00000000,
+    0x00040048, 0x0000000a, 0x00000000, 0x00000005, 0x00050048, 0x0000000a, 0x00000000, 0x00000007,
+    0x00000010, 0x00030047, 0x0000000a, 0x00000002, 0x00040047, 0x0000000b, 0x00000022, 0x00000000,
+    0x00040047, 0x0000000b, 0x00000021, 0x00000000, 0x00020013, 0x0000000c, 0x00030021, 0x0000000d,
+    0x0000000c, 0x00030016, 0x0000000e, 0x00000020, 0x00040017, 0x0000000f, 0x0000000e, 0x00000002,
+    0x00040017, 0x00000010, 0x0000000e, 0x00000003, 0x00040017, 0x00000011, 0x0000000e, 0x00000004,
+    0x00040018, 0x00000012, 0x00000011, 0x00000004, 0x00040015, 0x00000013, 0x00000020, 0x00000001,
+    0x0004001e, 0x00000009, 0x00000011, 0x0000000e, 0x0003001e, 0x0000000a, 0x00000012, 0x00040020,
+    0x00000014, 0x00000001, 0x00000010, 0x00040020, 0x00000015, 0x00000001, 0x0000000f, 0x00040020,
+    0x00000016, 0x00000001, 0x00000013, 0x00040020, 0x00000017, 0x00000003, 0x00000010, 0x00040020,
+    0x00000018, 0x00000003, 0x0000000f, 0x00040020, 0x00000019, 0x00000003, 0x00000009, 0x00040020,
+    0x0000001a, 0x00000003, 0x00000011, 0x00040020, 0x0000001b, 0x00000002, 0x0000000a, 0x00040020,
+    0x0000001c, 0x00000002, 0x00000012, 0x0004003b, 0x00000014, 0x00000002, 0x00000001, 0x0004003b,
+    0x00000014, 0x00000003, 0x00000001, 0x0004003b, 0x00000015, 0x00000004, 0x00000001, 0x0004003b,
+    0x00000016, 0x00000008, 0x00000001, 0x0004003b, 0x00000017, 0x00000005, 0x00000003, 0x0004003b,
+    0x00000018, 0x00000006, 0x00000003, 0x0004003b, 0x00000019, 0x00000007, 0x00000003, 0x0004003b,
+    0x0000001b, 0x0000000b, 0x00000002, 0x0004002b, 0x00000013, 0x0000001d, 0x00000000, 0x0004002b,
+    0x0000000e, 0x0000001e, 0x3f800000, 0x00050036, 0x0000000c, 0x00000001, 0x00000000, 0x0000000d,
+    0x000200f8, 0x0000001f, 0x0004003d, 0x00000010, 0x00000020, 0x00000002, 0x00050051, 0x0000000e,
+    0x00000021, 0x00000020, 0x00000000, 0x00050051, 0x0000000e, 0x00000022, 0x00000020, 0x00000001,
+    0x00050051, 0x0000000e, 0x00000023, 0x00000020, 0x00000002, 0x00070050, 0x00000011, 0x00000024,
+    0x00000021, 0x00000022, 0x00000023, 0x0000001e, 0x00050041, 0x0000001c, 0x00000025, 0x0000000b,
+    0x0000001d, 0x0004003d, 0x00000012, 0x00000026, 0x00000025, 0x00050091, 0x00000011, 0x00000027,
+    0x00000026, 0x00000024, 0x00050041, 0x0000001a, 0x00000028, 0x00000007, 0x0000001d, 0x0003003e,
+    0x00000028, 0x00000027, 0x0004003d, 0x00000010, 0x00000029, 0x00000003, 0x0003003e, 0x00000005,
+    0x00000029, 0x0004003d, 0x0000000f, 0x0000002a, 0x00000004, 0x0003003e, 0x00000006, 0x0000002a,
+    0x000100fd, 0x00010038,
+};
+
+// Fragment shader, equivalent to:
+//     layout(location = 0) in vec3 color;
+//     layout(location = 1) in vec2 uv;
+//     layout(location = 0) out vec4 out_color;
+//     layout(binding = 1) uniform sampler2D tex;
+//     void main() { out_color = vec4(color * texture(tex, uv).rgb, 1.0); }
+static const uint32_t kFragmentShader[] = {
+    0x07230203, 0x00010300, 0x00000000, 0x0000001e, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+    0x00000000, 0x00000001, 0x0008000f, 0x00000004, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+    0x00000003, 0x00000004, 0x00030010, 0x00000001, 0x00000007, 0x00040047, 0x00000002, 0x0000001e,
+    0x00000000, 0x00040047, 0x00000003, 0x0000001e, 0x00000001, 0x00040047, 0x00000004, 0x0000001e,
+    0x00000000, 0x00040047, 0x00000005, 0x00000022, 0x00000000, 0x00040047, 0x00000005, 0x00000021,
+    0x00000001, 0x00020013, 0x00000006, 0x00030021, 0x00000007, 0x00000006, 0x00030016, 0x00000008,
+    0x00000020, 0x00040017, 0x00000009, 0x00000008, 0x00000002, 0x00040017, 0x0000000a, 0x00000008,
+    0x00000003, 0x00040017, 0x0000000b, 0x00000008, 0x00000004, 0x00090019, 0x0000000c, 0x00000008,
+    0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x0003001b, 0x0000000d,
+    0x0000000c, 0x00040020, 0x0000000e, 0x00000000, 0x0000000d, 0x0004003b, 0x0000000e, 0x00000005,
+    0x00000000, 0x00040020, 0x0000000f, 0x00000001, 0x0000000a, 0x00040020, 0x00000010, 0x00000001,
+    0x00000009, 0x00040020, 0x00000011, 0x00000003, 0x0000000b, 0x0004003b, 0x0000000f, 0x00000002,
+    0x00000001, 0x0004003b, 0x00000010, 0x00000003, 0x00000001, 0x0004003b, 0x00000011, 0x00000004,
+    0x00000003, 0x0004002b, 0x00000008, 0x00000012, 0x3f800000, 0x00050036, 0x00000006, 0x00000001,
+    0x00000000, 0x00000007, 0x000200f8, 0x00000013, 0x0004003d, 0x0000000d, 0x00000014, 0x00000005,
+    0x0004003d, 0x00000009, 0x00000015, 0x00000003, 0x00050057, 0x0000000b, 0x00000016, 0x00000014,
+    0x00000015, 0x0004003d, 0x0000000a, 0x00000017, 0x00000002, 0x0008004f, 0x0000000a, 0x00000018,
+    0x00000016, 0x00000016, 0x00000000, 0x00000001, 0x00000002, 0x00050085, 0x0000000a, 0x00000019,
+    0x00000017, 0x00000018, 0x00050051, 0x00000008, 0x0000001a, 0x00000019, 0x00000000, 0x00050051,
+    0x00000008, 0x0000001b, 0x00000019, 0x00000001, 0x00050051, 0x00000008, 0x0000001c, 0x00000019,
+    0x00000002, 0x00070050, 0x0000000b, 0x0000001d, 0x0000001a, 0x0000001b, 0x0000001c, 0x00000012,
+    0x0003003e, 0x00000004, 0x0000001d, 0x000100fd, 0x00010038,
+};
+
+// Vertices are a position, a color and texture coordinates
+static const uint32_t kVertexStride = 8 * sizeof(float);
+
+static const uint32_t kCubeSize = 256;
+static const uint32_t kGridSize = 1024;
+static const uint32_t kGridCells = 200;
+static const uint32_t kGridRuns = 4;
+static const uint32_t kClearColor = 0xff202020;
+
+// Runs the indices of a ParallelFor on threads started for the call and on the calling thread
+class ThreadExecutor final : public ParallelExecutor {
+  public:
+    explicit ThreadExecutor(uint32_t thread_count) : thread_count_(thread_count) {}
+
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func) override {
+        std::atomic<uint32_t> next_index(0);
+        auto run = [&]() {
+            for (uint32_t i = next_index++; i < count; i = next_index++) func(i);
+        };
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < thread_count_ && i < count; ++i) threads.emplace_back(run);
+        run();
+        for (auto &thread : threads) thread.join();
+    }
+
+  private:
+    uint32_t thread_count_;
+};
+
+static bool CreatePipeline(GraphicsPipeline *pipeline) {
+    pipeline->vertex.reset(CompileShader(kVertexShader, sizeof(kVertexShader) / sizeof(uint32_t), "main",
+                                         kSpvExecutionModelVertex, nullptr)
+                               .release());
+    pipeline->fragment.reset(CompileShader(kFragmentShader, sizeof(kFragmentShader) / sizeof(uint32_t), "main",
+                                           kSpvExecutionModelFragment, nullptr)
+                                 .release());
+    if (!pipeline->vertex || !pipeline->fragment) return false;
+    LinkGraphicsShaders(pipeline);
+
+    static const struct {
+        uint32_t offset;
+        VkFormat format;
+        uint32_t size;
+    } kAttributes[] = {{0, VK_FORMAT_R32G32B32_SFLOAT, 12}, {12, VK_FORMAT_R32G32B32_SFLOAT, 12}, {24, VK_FORMAT_R32G32_SFLOAT, 8}};
+    pipeline->bindings[0] = {kVertexStride, false};
+    for (const auto &input : pipeline->vertex->inputs) {
+        if (input.location >= 3) return false;
+        const auto &attribute = kAttributes[input.location];
+        pipeline->attributes.push_back({0, attribute.offset, GetTexelFormat(attribute.format), attribute.size, input.offset,
+                                        input.component, input.components});
+    }
+    pipeline->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    pipeline->cull_mode = VK_CULL_MODE_BACK_BIT;
+    pipeline->front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    pipeline->depth_test = true;
+    pipeline->depth_write = true;
+    pipeline->depth_compare = VK_COMPARE_OP_LESS;
+    pipeline->blends[0].write_mask = 0xf;
+    return true;
+}
+
+static RenderTarget GetRenderTarget(void *pixels, VkFormat format, uint32_t size) {
+    RenderTarget target;
+    target.base = static_cast<uint8_t *>(pixels);
+    target.format = GetTexelFormat(format);
+    target.texel_size = 4;
+    target.width = size;
+    target.height = size;
+    target.row_pitch = size * 4;
+    return target;
+}
+
+// A 64x64 checkerboard with all its mip levels, sampled trilinearly
+static ShaderTexture GetCheckerTexture(std::vector<uint32_t> *texels) {
+    ShaderTexture texture;
+    std::vector<size_t> offsets;
+    for (uint32_t size = 64; size; size /= 2) {
+        offsets.push_back(texels->size());
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                bool light = ((x * 8 / size + y * 8 / size) & 1) || size < 8;
+                texels->push_back(light ? 0xffffffff : 0xff404040);
+            }
+        }
+    }
+    for (uint32_t level = 0, size = 64; level < offsets.size(); ++level, size /= 2) {
+        texture.levels[level] = {reinterpret_cast<const uint8_t *>(texels->data() + offsets[level]), size, size, size * 4, 0};
+    }
+    texture.level_count = (uint32_t)offsets.size();
+    texture.layer_count = 1;
+    texture.dimensions = 2;
+    texture.format = GetTexelFormat(VK_FORMAT_R8G8B8A8_UNORM);
+    texture.texel_size = 4;
+    for (uint8_t i = 0; i < 4; ++i) texture.swizzle[i] = i;
+    texture.mag_linear = true;
+    texture.min_linear = true;
+    texture.mip_linear = true;
+    texture.address_modes[0] = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    texture.address_modes[1] = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    texture.max_lod = 16.0f;
+    return texture;
+}
+
+// Column-major projection * view * model matrix of the cube, turned by angle around two axes
+static void GetCubeTransform(float angle, float *transform) {
+    auto multiply = [](const float *a, const float *b, float *result) {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) sum += a[k * 4 + row] * b[column * 4 + k];
+                result[column * 4 + row] = sum;
+            }
+        }
+    };
+    float ca = cosf(angle), sa = sinf(angle), cb = cosf(angle * 0.7f), sb = sinf(angle * 0.7f);
+    const float rotate_y[16] = {ca, 0, -sa, 0, 0, 1, 0, 0, sa, 0, ca, 0, 0, 0, 0, 1};
+    const float rotate_x[16] = {1, 0, 0, 0, 0, cb, sb, 0, 0, -sb, cb, 0, 0, 0, 0, 1};
+    const float translate[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, -3, 1};
+    const float f = 1.0f / tanf(0.5f), near_z = 0.1f, far_z = 100.0f;
+    const float depth_scale = far_z / (near_z - far_z);
+    const float project[16] = {f, 0, 0, 0, 0, -f, 0, 0, 0, 0, depth_scale, -1, 0, 0, near_z * depth_scale, 0};
+    float rotate[16], model_view[16];
+    multiply(rotate_y, rotate_x, rotate);
+    multiply(translate, rotate, model_view);
+    multiply(project, model_view, transform);
+}
+
+// Six faces of four vertices, each face shaded by its normal and textured across
+static void GetCube(std::vector<float> *vertices, std::vector<uint16_t> *indices) {
+    static const float kNormals[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (const auto &n : kNormals) {
+        const float u[3] = {n[1], n[2], n[0]};
+        const float v[3] = {n[1] * u[2] - n[2] * u[1], n[2] * u[0] - n[0] * u[2], n[0] * u[1] - n[1] * u[0]};
+        uint16_t base = (uint16_t)(vertices->size() / 8);
+        for (int corner = 0; corner < 4; ++corner) {
+            float su = (corner == 1 || corner == 2) ? 1.0f : -1.0f, sv = corner >= 2 ? 1.0f : -1.0f;
+            for (int i = 0; i < 3; ++i) vertices->push_back((n[i] + su * u[i] + sv * v[i]) * 0.8f);
+            for (int i = 0; i < 3; ++i) vertices->push_back(0.4f + 0.6f * fabsf(n[i]));
+            vertices->push_back(su > 0 ? 1.0f : 0.0f);
+            vertices->push_back(sv > 0 ? 1.0f : 0.0f);
+        }
+        for (uint16_t index : {0, 1, 2, 0, 2, 3}) indices->push_back(base + index);
+    }
+}
+
+// Two triangles per cell of a grid that covers the viewport, all at the same depth
+static void GetGrid(std::vector<float> *vertices, std::vector<uint32_t> *indices) {
+    const float cells = (float)kGridCells;
+    for (uint32_t y = 0; y <= kGridCells; ++y) {
+        for (uint32_t x = 0; x <= kGridCells; ++x) {
+            vertices->insert(vertices->end(), {x * 2.0f / cells - 1.0f, y * 2.0f / cells - 1.0f, 0.5f, 1.0f, 1.0f, 1.0f,
+                                               x / cells, y / cells});
+        }
+    }
+    for (uint32_t y = 0; y < kGridCells; ++y) {
+        for (uint32_t x = 0; x < kGridCells; ++x) {
+            uint32_t a = y * (kGridCells + 1) + x;
+            indices->insert(indices->end(), {a, a + kGridCells + 2, a + 1, a, a + kGridCells + 1, a + kGridCells + 2});
+        }
+    }
+}
+
+static bool Check(bool condition, const char *what) {
+    printf("%-56s %s\n", what, condition ? "ok" : "FAILED");
+    return condition;
+}
+
+int main(int argc, char **argv) {
+    uint32_t thread_count = argc > 1 ? (uint32_t)atoi(argv[1]) : std::thread::hardware_concurrency();
+    ThreadExecutor executor(std::max(thread_count, 1u));
+
+    GraphicsPipeline pipeline = {};
+    if (!CreatePipeline(&pipeline)) {
+        fprintf(stderr, "Failed to compile the shaders\n");
+        return 1;
+    }
+    std::vector<uint32_t> texels;
+    ShaderTexture texture = GetCheckerTexture(&texels);
+    float transform[16];
+    GetCubeTransform(0.6f, transform);
+
+    GraphicsDraw draw = {};
+    draw.pipeline = &pipeline;
+    for (const auto &variable : pipeline.vertex->variables) {
+        ShaderMemoryRange range = {};
+        if (variable.memory == ShaderMemory::Buffer) range = {reinterpret_cast<uint8_t *>(transform), sizeof(transform), 0};
+        draw.vertex_memory.push_back(range);
+    }
+    draw.fragment_memory.resize(pipeline.fragment->variables.size());
+    draw.fragment_textures.assign(pipeline.fragment->textures.size(), texture);
+    draw.instance_count = 1;
+    bool passed = true;
+
+    // The cube is convex and its back faces are culled, so no pixel is shaded twice, and drawing it again at the same
+    // depth passes no fragments
+    {
+        std::vector<float> vertices;
+        std::vector<uint16_t> indices;
+        GetCube(&vertices, &indices);
+        std::vector<uint32_t> color(kCubeSize * kCubeSize, kClearColor);
+        std::vector<float> depth(kCubeSize * kCubeSize, 1.0f);
+        draw.vertex_buffers[0] = {reinterpret_cast<uint8_t *>(vertices.data()), vertices.size() * sizeof(float), 0};
+        draw.index_buffer = {reinterpret_cast<uint8_t *>(indices.data()), indices.size() * sizeof(uint16_t), 0};
+        draw.index_size = sizeof(uint16_t);
+        draw.count = (uint32_t)indices.size();
+        draw.viewport = {0.0f, 0.0f, (float)kCubeSize, (float)kCubeSize, 0.0f, 1.0f};
+        draw.rect = {{0, 0}, {kCubeSize, kCubeSize}};
+        draw.colors[0] = GetRenderTarget(color.data(), VK_FORMAT_R8G8B8A8_UNORM, kCubeSize);
+        draw.depth = GetRenderTarget(depth.data(), VK_FORMAT_D32_SFLOAT, kCubeSize);
+
+        GraphicsDrawCounts counts = RunGraphicsDraw(&executor, draw);
+        uint64_t covered = (uint64_t)std::count_if(color.begin(), color.end(), [](uint32_t c) { return c != kClearColor; });
+        passed &= Check(counts.vertices == 36 && counts.primitives == 12, "cube: 36 vertices and 12 triangles drawn");
+        passed &= Check(covered > 0 && counts.fragments == covered, "cube: one fragment per covered pixel");
+        passed &= Check(color[kCubeSize / 2 * kCubeSize + kCubeSize / 2] != kClearColor, "cube: center pixel covered");
+        counts = RunGraphicsDraw(&executor, draw);
+        passed &= Check(counts.fragments == 0, "cube: depth test rejects a second draw");
+    }
+
+    // Grid cells are a few pixels wide, so most of the time goes to setting up and binning the triangles
+    {
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        GetGrid(&vertices, &indices);
+        std::vector<uint32_t> color(kGridSize * kGridSize);
+        std::vector<float> depth(kGridSize * kGridSize);
+        float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        memcpy(transform, identity, sizeof(transform));
+        pipeline.cull_mode = VK_CULL_MODE_NONE;
+        pipeline.depth_compare = VK_COMPARE_OP_LESS_OR_EQUAL;
+        draw.vertex_buffers[0] = {reinterpret_cast<uint8_t *>(vertices.data()), vertices.size() * sizeof(float), 0};
+        draw.index_buffer = {reinterpret_cast<uint8_t *>(indices.data()), indices.size() * sizeof(uint32_t), 0};
+        draw.index_size = sizeof(uint32_t);
+        draw.count = (uint32_t)indices.size();
+        draw.viewport = {0.0f, 0.0f, (float)kGridSize, (float)kGridSize, 0.0f, 1.0f};
+        draw.rect = {{0, 0}, {kGridSize, kGridSize}};
+        draw.colors[0] = GetRenderTarget(color.data(), VK_FORMAT_R8G8B8A8_UNORM, kGridSize);
+        draw.depth = GetRenderTarget(depth.data(), VK_FORMAT_D32_SFLOAT, kGridSize);
+
+        bool exact = true;
+        double seconds = 0.0;
+        for (uint32_t run = 0; run < kGridRuns; ++run) {
+            std::fill(color.begin(), color.end(), 0);
+            std::fill(depth.begin(), depth.end(), 1.0f);
+            auto start = std::chrono::steady_clock::now();
+            GraphicsDrawCounts counts = RunGraphicsDraw(&executor, draw);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            exact = exact && counts.primitives == indices.size() / 3 && counts.fragments == (uint64_t)kGridSize * kGridSize &&
+                    std::find(color.begin(), color.end(), 0u) == color.end();
+        }
+        passed &= Check(exact, "grid: one fragment for every pixel");
+        double triangles = (double)kGridRuns * indices.size() / 3, fragments = (double)kGridRuns * kGridSize * kGridSize;
+        printf("grid: %.2f Mtriangles/s, %.2f Mfragments/s on %u threads\n", triangles / seconds / 1e6,
+               fragments / seconds / 1e6, std::max(thread_count, 1u));
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,3473 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mock_icd_shader.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace vkmock {
+
+// The parts of the SPIR-V specification that the compiler understands
+static constexpr uint32_t kSpirvMagic = 0x07230203;
+enum class SpvOp : uint32_t {
+    Nop = 0,
+    Undef = 1,
+    Line = 8,
+    ExtInstImport = 11,
+    ExtInst = 12,
+    EntryPoint = 15,
+    ExecutionMode = 16,
+    TypeVoid = 19,
+    TypeBool = 20,
+    TypeInt = 21,
+    TypeFloat = 22,
+    TypeVector = 23,
+    TypeMatrix = 24,
+    TypeImage = 25,
+    TypeSampler = 26,
+    TypeSampledImage = 27,
+    TypeArray = 28,
+    TypeRuntimeArray = 29,
+    TypeStruct = 30,
+    TypePointer = 32,
+    TypeFunction = 33,
+    ConstantTrue = 41,
+    ConstantFalse = 42,
+    Constant = 43,
+    ConstantComposite = 44,
+    ConstantNull = 46,
+    SpecConstantTrue = 48,
+    SpecConstantFalse = 49,
+    SpecConstant = 50,
+    SpecConstantComposite = 51,
+    SpecConstantOp = 52,
+    Function = 54,
+    FunctionParameter = 55,
+    FunctionEnd = 56,
+    FunctionCall = 57,
+    Variable = 59,
+    Load = 61,
+    Store = 62,
+    CopyMemory = 63,
+    AccessChain = 65,
+    InBoundsAccessChain = 66,
+    ArrayLength = 68,
+    Decorate = 71,
+    MemberDecorate = 72,
+    VectorExtractDynamic = 77,
+    VectorInsertDynamic = 78,
+    VectorShuffle = 79,
+    CompositeConstruct = 80,
+    CompositeExtract = 81,
+    CompositeInsert = 82,
+    CopyObject = 83,
+    Transpose = 84,
+    SampledImage = 86,
+    ImageSampleImplicitLod = 87,
+    ImageSampleExplicitLod = 88,
+    Image = 100,
+    ConvertFToU = 109,
+    ConvertFToS = 110,
+    ConvertSToF = 111,
+    ConvertUToF = 112,
+    UConvert = 113,
+    SConvert = 114,
+    FConvert = 115,
+    Bitcast = 124,
+    SNegate = 126,
+    FNegate = 127,
+    IAdd = 128,
+    FAdd = 129,
+    ISub = 130,
+    FSub = 131,
+    IMul = 132,
+    FMul = 133,
+    UDiv = 134,
+    SDiv = 135,
+    FDiv = 136,
+    UMod = 137,
+    SRem = 138,
+    SMod = 139,
+    FRem = 140,
+    FMod = 141,
+    VectorTimesScalar = 142,
+    MatrixTimesScalar = 143,
+    VectorTimesMatrix = 144,
+    MatrixTimesVector = 145,
+    MatrixTimesMatrix = 146,
+    Dot = 148,
+    Any = 154,
+    All = 155,
+    IsNan = 156,
+    IsInf = 157,
+    LogicalEqual = 164,
+    LogicalNotEqual = 165,
+    LogicalOr = 166,
+    LogicalAnd = 167,
+    LogicalNot = 168,
+    Select = 169,
+    IEqual = 170,
+    INotEqual = 171,
+    UGreaterThan = 172,
+    SGreaterThan = 173,
+    UGreaterThanEqual = 174,
+    SGreaterThanEqual = 175,
+    ULessThan = 176,
+    SLessThan = 177,
+    ULessThanEqual = 178,
+    SLessThanEqual = 179,
+    FOrdEqual = 180,
+    FUnordEqual = 181,
+    FOrdNotEqual = 182,
+    FUnordNotEqual = 183,
+    FOrdLessThan = 184,
+    FUnordLessThan = 185,
+    FOrdGreaterThan = 186,
+    FUnordGreaterThan = 187,
+    FOrdLessThanEqual = 188,
+    FUnordLessThanEqual = 189,
+    FOrdGreaterThanEqual = 190,
+    FUnordGreaterThanEqual = 191,
+    ShiftRightLogical = 194,
+    ShiftRightArithmetic = 195,
+    ShiftLeftLogical = 196,
+    BitwiseOr = 197,
+    BitwiseXor = 198,
+    BitwiseAnd = 199,
+    Not = 200,
+    BitCount = 205,
+    DPdx = 207,
+    DPdy = 208,
+    Fwidth = 209,
+    DPdxFine = 210,
+    DPdyFine = 211,
+    FwidthFine = 212,
+    DPdxCoarse = 213,
+    DPdyCoarse = 214,
+    FwidthCoarse = 215,
+    ControlBarrier = 224,
+    MemoryBarrier = 225,
+    AtomicLoad = 227,
+    AtomicStore = 228,
+    AtomicExchange = 229,
+    AtomicCompareExchange = 230,
+    AtomicIIncrement = 232,
+    AtomicIDecrement = 233,
+    AtomicIAdd = 234,
+    AtomicISub = 235,
+    AtomicSMin = 236,
+    AtomicUMin = 237,
+    AtomicSMax = 238,
+    AtomicUMax = 239,
+    AtomicAnd = 240,
+    AtomicOr = 241,
+    AtomicXor = 242,
+    Phi = 245,
+    LoopMerge = 246,
+    SelectionMerge = 247,
+    Label = 248,
+    Branch = 249,
+    BranchConditional = 250,
+    Switch = 251,
+    Kill = 252,
+    Return = 253,
+    ReturnValue = 254,
+    Unreachable = 255,
+    LifetimeStart = 256,
+    LifetimeStop = 257,
+    NoLine = 317,
+    ExecutionModeId = 331,
+    TerminateInvocation = 4416,
+};
+enum class SpvDecoration : uint32_t {
+    SpecId = 1,
+    RowMajor = 4,
+    ArrayStride = 6,
+    MatrixStride = 7,
+    BuiltIn = 11,
+    NoPerspective = 13,
+    Flat = 14,
+    Location = 30,
+    Component = 31,
+    Binding = 33,
+    DescriptorSet = 34,
+    Offset = 35,
+};
+enum class SpvStorageClass : uint32_t {
+    UniformConstant = 0,
+    Input = 1,
+    Uniform = 2,
+    Output = 3,
+    Workgroup = 4,
+    Private = 6,
+    Function = 7,
+    PushConstant = 9,
+    StorageBuffer = 12,
+};
+enum class SpvBuiltIn : uint32_t {
+    Position = 0,
+    PointSize = 1,
+    ClipDistance = 3,
+    CullDistance = 4,
+    FragCoord = 15,
+    FrontFacing = 17,
+    FragDepth = 22,
+    NumWorkgroups = 24,
+    WorkgroupSize = 25,
+    WorkgroupId = 26,
+    LocalInvocationId = 27,
+    GlobalInvocationId = 28,
+    LocalInvocationIndex = 29,
+    VertexIndex = 42,
+    InstanceIndex = 43,
+};
+static constexpr uint32_t kSpvExecutionModeEarlyFragmentTests = 9;
+static constexpr uint32_t kSpvExecutionModeLocalSize = 17;
+static constexpr uint32_t kSpvExecutionModeLocalSizeId = 38;
+static constexpr uint32_t kSpvImageOperandsBias = 0x1;
+static constexpr uint32_t kSpvImageOperandsLod = 0x2;
+static constexpr uint32_t kSpvDim1D = 0;
+static constexpr uint32_t kSpvDim2D = 1;
+enum class GlslStd450 : uint32_t {
+    Round = 1,
+    RoundEven = 2,
+    Trunc = 3,
+    FAbs = 4,
+    SAbs = 5,
+    FSign = 6,
+    SSign = 7,
+    Floor = 8,
+    Ceil = 9,
+    Fract = 10,
+    Radians = 11,
+    Degrees = 12,
+    Sin = 13,
+    Cos = 14,
+    Tan = 15,
+    Asin = 16,
+    Acos = 17,
+    Atan = 18,
+    Sinh = 19,
+    Cosh = 20,
+    Tanh = 21,
+    Atan2 = 25,
+    Pow = 26,
+    Exp = 27,
+    Log = 28,
+    Exp2 = 29,
+    Log2 = 30,
+    Sqrt = 31,
+    InverseSqrt = 32,
+    FMin = 37,
+    UMin = 38,
+    SMin = 39,
+    FMax = 40,
+    UMax = 41,
+    SMax = 42,
+    FClamp = 43,
+    UClamp = 44,
+    SClamp = 45,
+    FMix = 46,
+    Step = 48,
+    SmoothStep = 49,
+    Fma = 50,
+    Length = 66,
+    Distance = 67,
+    Cross = 68,
+    Normalize = 69,
+    Reflect = 71,
+    FindILsb = 73,
+    FindSMsb = 74,
+    FindUMsb = 75,
+    NMin = 79,
+    NMax = 80,
+    NClamp = 81,
+};
+
+// Largest workgroup the interpreter runs, and most registers it gives one
+static constexpr uint32_t kMaxShaderLanes = 1024;
+static constexpr uint64_t kMaxShaderRegisterValues = 16 * 1024 * 1024;
+// Vertex and fragment shaders run this many invocations at a time
+static constexpr uint32_t kGraphicsShaderLanes = 256;
+
+static std::atomic<uint64_t> next_shader_program_serial{1};
+
+class ShaderCompiler {
+  public:
+    ShaderCompiler(const uint32_t* words, size_t word_count) : words_(words), word_count_(word_count) {}
+
+    // Returns null if the module isn't valid or uses anything the interpreter doesn't support
+    std::unique_ptr<ShaderProgram> Compile(const char* entry_point, uint32_t execution_model,
+                                           const VkSpecializationInfo* specialization) {
+        if (word_count_ < 5 || words_[0] != kSpirvMagic || words_[3] > (1u << 22)) return nullptr;
+        program_.reset(new ShaderProgram());
+        program_->serial = next_shader_program_serial.fetch_add(1, std::memory_order_relaxed);
+        std::fill_n(program_->builtin_offsets, kShaderBuiltInCount, kUnusedShaderOffset);
+        const uint32_t bound = words_[3];
+        ids_.resize(bound);
+        specialization_ = specialization;
+        execution_model_ = execution_model;
+        if (!ParseModule(entry_point, execution_model) || !entry_function_) return nullptr;
+        for (const auto& initializer : initializers_) {
+            if (!EmitStore(initializer.first, initializer.second)) return nullptr;
+        }
+        if (!CompileFunction(entry_function_, true, kNone, nullptr, 0)) return nullptr;
+        program_->register_count = next_register_;
+        const uint32_t lane_count = execution_model == kSpvExecutionModelGLCompute ? program_->LaneCount() : kGraphicsShaderLanes;
+        if ((uint64_t)program_->register_count * lane_count > kMaxShaderRegisterValues) return nullptr;
+        return std::move(program_);
+    }
+
+  private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kMaxCallDepth = 64;
+
+    enum class TypeKind : uint8_t {
+        None, Void, Bool, Int, Float, Vector, Matrix, Array, RuntimeArray, Struct, Pointer, Function, Image, Sampler, SampledImage, Opaque
+    };
+    struct MemberDecorations {
+        uint32_t offset = kNone;
+        uint32_t matrix_stride = 0;
+        bool row_major = false;
+        uint32_t builtin = kNone;
+    };
+    // How the value a pointer points at is laid out in memory
+    struct Layout {
+        bool explicit_layout;       // Offset, ArrayStride and MatrixStride decorations apply
+        uint32_t matrix_stride;     // Of the matrices of the value, 0 for the natural layout
+        bool row_major;
+        uint32_t component_stride;  // Between the components of vectors, 4 except for the rows of row-major matrices
+    };
+    struct Id {
+        // Types
+        TypeKind kind = TypeKind::None;
+        uint32_t element = 0;     // Of vectors, matrices (their columns), arrays and pointers (the pointee)
+        uint32_t length = 0;      // Of vectors, matrices and arrays
+        uint32_t storage = 0;     // Of pointers
+        uint32_t components = 0;  // Scalars in a value of the type, 0 if there's no way to hold the value in registers
+        uint32_t size = 0;        // In memory without an explicit layout
+        std::vector<uint32_t> members;
+        uint32_t dimensions = 0;  // Of images the interpreter can sample, 0 for the others
+        bool arrayed = false;
+        // Decorations
+        uint32_t builtin = kNone;
+        uint32_t spec_id = kNone;
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        uint32_t array_stride = 0;
+        uint32_t location = kNone;
+        uint32_t component = 0;
+        ShaderInterpolation interpolation = ShaderInterpolation::Perspective;
+        std::vector<MemberDecorations> member_decorations;
+        // Values
+        uint32_t type = 0;
+        uint32_t reg = kNone;
+        bool constant = false;
+        std::vector<ShaderValue> values;  // Of constants
+        // Pointers
+        uint32_t variable = kNone;
+        Layout layout;
+        // Images, samplers and sampled images, which aren't held in registers: the variables they were loaded from
+        uint32_t image_variable = kNone;
+        uint32_t sampler_variable = kNone;
+        // Functions
+        size_t function_start = 0;
+    };
+
+    // An instruction of the module, valid while in the range of the module
+    struct Instruction {
+        const uint32_t* words;
+        uint32_t word_count;
+        SpvOp op() const { return (SpvOp)(words[0] & 0xffff); }
+        uint32_t operator[](uint32_t i) const { return i < word_count ? words[i] : 0; }
+    };
+    bool GetInstruction(size_t offset, Instruction* instruction) const {
+        if (offset >= word_count_) return false;
+        instruction->words = words_ + offset;
+        instruction->word_count = words_[offset] >> 16;
+        return instruction->word_count > 0 && offset + instruction->word_count <= word_count_;
+    }
+    bool ValidId(uint32_t id) const { return id > 0 && id < ids_.size(); }
+    static std::string ReadString(const Instruction& instruction, uint32_t first_word) {
+        std::string s;
+        for (uint32_t i = first_word; i < instruction.word_count; ++i) {
+            for (uint32_t byte = 0; byte < 4; ++byte) {
+                const char c = (char)(instruction.words[i] >> (8 * byte));
+                if (!c) return s;
+                s += c;
+            }
+        }
+        return s;
+    }
+
+    bool ParseModule(const char* entry_point, uint32_t execution_model) {
+        std::vector<uint32_t> local_size_ids;
+        Instruction in;
+        for (size_t offset = 5; offset < word_count_; offset += in.word_count) {
+            if (!GetInstruction(offset, &in)) return false;
+            switch (in.op()) {
+                case SpvOp::ExtInstImport:
+                    if (!ValidId(in[1])) return false;
+                    if (ReadString(in, 2) == "GLSL.std.450") glsl_std_450_ = in[1];
+                    // Debug information and the like, which doesn't change what the shader does
+                    if (ReadString(in, 2).compare(0, 12, "NonSemantic.") == 0) ids_[in[1]].kind = TypeKind::Opaque;
+                    break;
+                case SpvOp::EntryPoint:
+                    if (in[1] == execution_model && ReadString(in, 3) == entry_point) {
+                        entry_function_ = in[2];
+                        // The input and output variables of the entry point follow its name
+                        const uint32_t name_words = (uint32_t)ReadString(in, 3).size() / 4 + 1;
+                        interface_.assign(in.words + (std::min)(3 + name_words, in.word_count), in.words + in.word_count);
+                    }
+                    break;
+                case SpvOp::ExecutionMode:
+                case SpvOp::ExecutionModeId:
+                    if (in[1] != entry_function_) break;
+                    if (in[2] == kSpvExecutionModeEarlyFragmentTests) program_->early_fragment_tests = true;
+                    if (in.word_count < 6) break;
+                    if (in[2] == kSpvExecutionModeLocalSize) std::copy(in.words + 3, in.words + 6, program_->local_size);
+                    if (in[2] == kSpvExecutionModeLocalSizeId) local_size_ids.assign(in.words + 3, in.words + 6);
+                    break;
+                case SpvOp::Decorate:
+                    if (!ValidId(in[1])) return false;
+                    Decorate(&ids_[in[1]], (SpvDecoration)in[2], in[3]);
+                    break;
+                case SpvOp::MemberDecorate:
+                    if (!ValidId(in[1]) || in[2] > 0xffff) return false;
+                    DecorateMember(&ids_[in[1]], in[2], (SpvDecoration)in[3], in[4]);
+                    break;
+                case SpvOp::Function:
+                    if (!ValidId(in[2])) return false;
+                    ids_[in[2]].kind = TypeKind::Function;
+                    ids_[in[2]].function_start = offset;
+                    // Function bodies are compiled once they are called
+                    while (in.op() != SpvOp::FunctionEnd) {
+                        offset += in.word_count;
+                        if (!GetInstruction(offset, &in)) return false;
+                    }
+                    break;
+                default:
+                    if (!ParseDeclaration(in)) return false;
+                    break;
+            }
+        }
+        if (!local_size_ids.empty()) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                if (!ValidId(local_size_ids[i]) || ids_[local_size_ids[i]].values.size() != 1) return false;
+                program_->local_size[i] = ids_[local_size_ids[i]].values[0].u;
+            }
+        }
+        // A constant decorated as the WorkgroupSize built-in overrides the execution mode
+        for (const auto& id : ids_) {
+            if (id.constant && id.builtin == (uint32_t)SpvBuiltIn::WorkgroupSize && id.values.size() == 3) {
+                for (uint32_t i = 0; i < 3; ++i) program_->local_size[i] = id.values[i].u;
+            }
+        }
+        const uint64_t lanes = (uint64_t)program_->local_size[0] * program_->local_size[1] * program_->local_size[2];
+        return lanes > 0 && lanes <= kMaxShaderLanes;
+    }
+
+    static void Decorate(Id* id, SpvDecoration decoration, uint32_t value) {
+        switch (decoration) {
+            case SpvDecoration::SpecId:
+                id->spec_id = value;
+                break;
+            case SpvDecoration::ArrayStride:
+                id->array_stride = value;
+                break;
+            case SpvDecoration::BuiltIn:
+                id->builtin = value;
+                break;
+            case SpvDecoration::Binding:
+                id->binding = value;
+                break;
+            case SpvDecoration::DescriptorSet:
+                id->set = value;
+                break;
+            case SpvDecoration::Location:
+                id->location = value;
+                break;
+            case SpvDecoration::Component:
+                id->component = value;
+                break;
+            case SpvDecoration::Flat:
+                id->interpolation = ShaderInterpolation::Flat;
+                break;
+            case SpvDecoration::NoPerspective:
+                id->interpolation = ShaderInterpolation::Linear;
+                break;
+            default:
+                break;
+        }
+    }
+    static void DecorateMember(Id* id, uint32_t member, SpvDecoration decoration, uint32_t value) {
+        if (id->member_decorations.size() <= member) id->member_decorations.resize(member + 1);
+        auto& decorations = id->member_decorations[member];
+        switch (decoration) {
+            case SpvDecoration::Offset:
+                decorations.offset = value;
+                break;
+            case SpvDecoration::MatrixStride:
+                decorations.matrix_stride = value;
+                break;
+            case SpvDecoration::RowMajor:
+                decorations.row_major = true;
+                break;
+            case SpvDecoration::BuiltIn:
+                decorations.builtin = value;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Types, constants and global variables
+    bool ParseDeclaration(const Instruction& in) {
+        switch (in.op()) {
+            case SpvOp::TypeVoid:
+                return DefineType(in[1], TypeKind::Void, 0, 0, 0, 0);
+            case SpvOp::TypeBool:
+                return DefineType(in[1], TypeKind::Bool, 0, 0, 1, 4);
+            case SpvOp::TypeInt:
+            case SpvOp::TypeFloat:
+                // Types of other widths can be declared, values of them fail to compile
+                if (in[2] != 32) return DefineType(in[1], TypeKind::Opaque, 0, 0, 0, 0);
+                return DefineType(in[1], in.op() == SpvOp::TypeInt ? TypeKind::Int : TypeKind::Float, 0, 0, 1, 4);
+            case SpvOp::TypeVector:
+            case SpvOp::TypeMatrix: {
+                if (!ValidId(in[2])) return false;
+                const Id& element = ids_[in[2]];
+                const auto kind = in.op() == SpvOp::TypeVector ? TypeKind::Vector : TypeKind::Matrix;
+                return DefineType(in[1], kind, in[2], in[3], element.components * in[3], element.size * in[3]);
+            }
+            case SpvOp::TypeArray: {
+                if (!ValidId(in[2]) || !ValidId(in[3]) || ids_[in[3]].values.size() != 1) return false;
+                const Id& element = ids_[in[2]];
+                const uint64_t length = ids_[in[3]].values[0].u;
+                const uint64_t components = element.components * length;
+                const uint64_t size = element.size * length;
+                if (size > UINT32_MAX) return false;
+                return DefineType(in[1], TypeKind::Array, in[2], (uint32_t)length,
+                                  components > kMaxShaderRegisterValues ? 0 : (uint32_t)components, (uint32_t)size);
+            }
+            case SpvOp::TypeRuntimeArray:
+                return ValidId(in[2]) && DefineType(in[1], TypeKind::RuntimeArray, in[2], 0, 0, 0);
+            case SpvOp::TypeStruct: {
+                if (!DefineType(in[1], TypeKind::Struct, 0, 0, 0, 0)) return false;
+                Id& type = ids_[in[1]];
+                uint64_t components = 0, size = 0;
+                bool registers = true;
+                for (uint32_t i = 2; i < in.word_count; ++i) {
+                    if (!ValidId(in[i])) return false;
+                    const Id& member = ids_[in[i]];
+                    type.members.push_back(in[i]);
+                    registers = registers && member.components > 0;
+                    components += member.components;
+                    size += member.size;
+                }
+                if (size > UINT32_MAX) return false;
+                type.components = registers && components <= kMaxShaderRegisterValues ? (uint32_t)components : 0;
+                type.size = (uint32_t)size;
+                type.member_decorations.resize(type.members.size());
+                return true;
+            }
+            case SpvOp::TypePointer:
+                if (!DefineType(in[1], TypeKind::Pointer, in[3], 0, 1, 4)) return false;
+                ids_[in[1]].storage = in[2];
+                return ValidId(in[3]);
+            case SpvOp::TypeFunction:
+                return DefineType(in[1], TypeKind::Function, 0, 0, 0, 0);
+            case SpvOp::TypeImage: {
+                if (!DefineType(in[1], TypeKind::Image, 0, 0, 0, 0)) return false;
+                // Single-sampled 1D and 2D images, arrayed or not, that are sampled rather than used as storage images
+                Id& type = ids_[in[1]];
+                const bool sampled = (in[3] == kSpvDim1D || in[3] == kSpvDim2D) && !in[6] && in[7] != 2;
+                type.dimensions = sampled ? in[3] - kSpvDim1D + 1 : 0;
+                type.arrayed = in[5] != 0;
+                return true;
+            }
+            case SpvOp::TypeSampler:
+                return DefineType(in[1], TypeKind::Sampler, 0, 0, 0, 0);
+            case SpvOp::TypeSampledImage:
+                return ValidId(in[2]) && DefineType(in[1], TypeKind::SampledImage, in[2], 0, 0, 0);
+            case SpvOp::ConstantTrue:
+            case SpvOp::ConstantFalse:
+                return DefineConstant(in[1], in[2], {ScalarValue(in.op() == SpvOp::ConstantTrue)});
+            case SpvOp::SpecConstantTrue:
+            case SpvOp::SpecConstantFalse: {
+                ShaderValue value = ScalarValue(in.op() == SpvOp::SpecConstantTrue);
+                if (ValidId(in[2])) Specialize(ids_[in[2]].spec_id, &value);
+                value.u = value.u ? 1 : 0;
+                return DefineConstant(in[1], in[2], {value});
+            }
+            case SpvOp::Constant:
+            case SpvOp::SpecConstant: {
+                if (!ValidId(in[1]) || ids_[in[1]].components != 1 || in.word_count != 4) return false;
+                ShaderValue value;
+                value.u = in[3];
+                if (in.op() == SpvOp::SpecConstant && ValidId(in[2])) Specialize(ids_[in[2]].spec_id, &value);
+                return DefineConstant(in[1], in[2], {value});
+            }
+            case SpvOp::ConstantComposite:
+            case SpvOp::SpecConstantComposite: {
+                std::vector<ShaderValue> values;
+                for (uint32_t i = 3; i < in.word_count; ++i) {
+                    if (!ValidId(in[i]) || !ids_[in[i]].constant) return false;
+                    values.insert(values.end(), ids_[in[i]].values.begin(), ids_[in[i]].values.end());
+                }
+                return DefineConstant(in[1], in[2], values);
+            }
+            case SpvOp::ConstantNull:
+            case SpvOp::Undef:
+                // Undefined values are zero, which is as good as any
+                if (!ValidId(in[1])) return false;
+                return DefineConstant(in[1], in[2], std::vector<ShaderValue>(ids_[in[1]].components, ScalarValue(0)));
+            case SpvOp::SpecConstantOp:
+                return FoldSpecConstantOp(in);
+            case SpvOp::Variable:
+                return ValidId(in[2]) && DefineVariable(in[2], in[1], in[3], in.word_count > 4 ? in[4] : 0);
+            default:
+                // Capabilities, extensions, names, strings and the like don't matter
+                return true;
+        }
+    }
+
+    bool DefineType(uint32_t id, TypeKind kind, uint32_t element, uint32_t length, uint64_t components, uint64_t size) {
+        if (!ValidId(id) || ids_[id].kind != TypeKind::None || components > kMaxShaderRegisterValues || size > UINT32_MAX) return false;
+        Id& type = ids_[id];
+        type.kind = kind;
+        type.element = element;
+        type.length = length;
+        type.components = (uint32_t)components;
+        type.size = (uint32_t)size;
+        return true;
+    }
+    static ShaderValue ScalarValue(uint32_t u) {
+        ShaderValue value;
+        value.u = u;
+        return value;
+    }
+    void Specialize(uint32_t spec_id, ShaderValue* value) const {
+        if (spec_id == kNone || !specialization_) return;
+        for (uint32_t i = 0; i < specialization_->mapEntryCount; ++i) {
+            const auto& entry = specialization_->pMapEntries[i];
+            if (entry.constantID != spec_id || entry.offset + entry.size > specialization_->dataSize) continue;
+            value->u = 0;
+            std::memcpy(&value->u, static_cast<const uint8_t*>(specialization_->pData) + entry.offset, (std::min)(entry.size, sizeof(uint32_t)));
+        }
+    }
+    bool DefineConstant(uint32_t type, uint32_t id, std::vector<ShaderValue> values) {
+        if (!ValidId(type) || !ValidId(id) || values.size() != ids_[type].components) return false;
+        Id& constant = ids_[id];
+        constant.type = type;
+        constant.constant = true;
+        constant.values = std::move(values);
+        return true;
+    }
+    // The integer operations of specialization constants, such as sizes of workgroup arrays derived from the workgroup size
+    bool FoldSpecConstantOp(const Instruction& in) {
+        auto operand = [&](uint32_t i) -> const std::vector<ShaderValue>* {
+            return ValidId(in[i]) && ids_[in[i]].constant ? &ids_[in[i]].values : nullptr;
+        };
+        const auto a = operand(4);
+        if (!a) return false;
+        if ((SpvOp)in[3] == SpvOp::CompositeExtract) {
+            if (in.word_count != 6 || in[5] >= a->size()) return false;
+            return DefineConstant(in[1], in[2], {(*a)[in[5]]});
+        }
+        const auto b = operand(5);
+        if (!b || a->size() != b->size()) return false;
+        std::vector<ShaderValue> values(a->size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            const uint32_t x = (*a)[i].u, y = (*b)[i].u;
+            switch ((SpvOp)in[3]) {
+                case SpvOp::IAdd: values[i].u = x + y; break;
+                case SpvOp::ISub: values[i].u = x - y; break;
+                case SpvOp::IMul: values[i].u = x * y; break;
+                case SpvOp::UDiv: values[i].u = y ? x / y : 0; break;
+                case SpvOp::UMod: values[i].u = y ? x % y : 0; break;
+                case SpvOp::ShiftLeftLogical: values[i].u = x << (y & 31); break;
+                case SpvOp::ShiftRightLogical: values[i].u = x >> (y & 31); break;
+                case SpvOp::BitwiseAnd: values[i].u = x & y; break;
+                case SpvOp::BitwiseOr: values[i].u = x | y; break;
+                case SpvOp::BitwiseXor: values[i].u = x ^ y; break;
+                default: return false;
+            }
+        }
+        return DefineConstant(in[1], in[2], values);
+    }
+
+    bool DefineVariable(uint32_t id, uint32_t pointer_type, uint32_t storage, uint32_t initializer) {
+        if (!ValidId(pointer_type) || ids_[pointer_type].kind != TypeKind::Pointer) return false;
+        const uint32_t type = ids_[pointer_type].element;
+        const Id& pointee = ids_[type];
+        ShaderVariable variable = {ShaderMemory::Opaque, 0, pointee.size, ids_[id].set, ids_[id].binding};
+        switch ((SpvStorageClass)storage) {
+            case SpvStorageClass::Input:
+            case SpvStorageClass::Output:
+            case SpvStorageClass::Private:
+            case SpvStorageClass::Function:
+                variable.memory = ShaderMemory::Lane;
+                variable.offset = program_->lane_memory_size;
+                program_->lane_memory_size += (pointee.size + 3) & ~3u;
+                break;
+            case SpvStorageClass::Workgroup:
+                variable.memory = ShaderMemory::Workgroup;
+                variable.offset = program_->workgroup_memory_size;
+                program_->workgroup_memory_size += (pointee.size + 3) & ~3u;
+                break;
+            case SpvStorageClass::PushConstant:
+                variable.memory = ShaderMemory::PushConstant;
+                break;
+            case SpvStorageClass::Uniform:
+            case SpvStorageClass::StorageBuffer:
+                // Arrays of buffers aren't supported
+                if (pointee.kind == TypeKind::Struct) variable.memory = ShaderMemory::Buffer;
+                break;
+            default:
+                break;
+        }
+        if (program_->lane_memory_size > (1u << 24) || program_->workgroup_memory_size > (1u << 24)) return false;
+        const auto storage_class = (SpvStorageClass)storage;
+        if (storage_class == SpvStorageClass::Input || storage_class == SpvStorageClass::Output) {
+            const bool bound = BindInterface(id, type, storage_class == SpvStorageClass::Input, variable.offset);
+            // Inputs the program isn't given can't be read, outputs nothing reads are written all the same
+            if (!bound && storage_class == SpvStorageClass::Input) variable.memory = ShaderMemory::Opaque;
+        }
+        Id& pointer = ids_[id];
+        pointer.type = pointer_type;
+        pointer.variable = (uint32_t)program_->variables.size();
+        const bool explicit_layout = variable.memory == ShaderMemory::Buffer || variable.memory == ShaderMemory::PushConstant;
+        pointer.layout = Layout{explicit_layout, 0, false, 4};
+        pointer.reg = ConstantRegister(0u);
+        program_->variables.push_back(variable);
+        if (initializer) initializers_.emplace_back(id, initializer);
+        return true;
+    }
+    // Bind an input or output variable of the entry point at offset in lane memory to what it stands for: a built-in,
+    // a block of built-ins such as gl_PerVertex, or the vectors at its locations
+    bool BindInterface(uint32_t id, uint32_t type_id, bool input, uint32_t offset) {
+        if (std::find(interface_.begin(), interface_.end(), id) == interface_.end()) return false;
+        const Id& variable = ids_[id];
+        if (variable.builtin != kNone) return BindBuiltIn(variable.builtin, input, offset);
+        const Id& type = ids_[type_id];
+        if (type.kind == TypeKind::Struct && !type.member_decorations.empty() && type.member_decorations[0].builtin != kNone) {
+            bool bound = true;
+            for (uint32_t i = 0; i < type.members.size(); ++i) {
+                const uint32_t member_offset = offset + MemberOffset(type, i, Layout{false, 0, false, 4});
+                bound = BindBuiltIn(type.member_decorations[i].builtin, input, member_offset) && bound;
+            }
+            return bound;
+        }
+        if (variable.location == kNone || execution_model_ == kSpvExecutionModelGLCompute) return false;
+        uint32_t location = variable.location, component = variable.component;
+        return AppendInterface(type_id, variable.interpolation, &location, &component, &offset,
+                               input ? &program_->inputs : &program_->outputs);
+    }
+    // Split a value of a type at a location into the vectors it takes: one for each scalar, vector and matrix column,
+    // each at a location of its own
+    bool AppendInterface(uint32_t type_id, ShaderInterpolation interpolation, uint32_t* location, uint32_t* component, uint32_t* offset,
+                         std::vector<ShaderInterface>* interfaces) const {
+        static constexpr uint32_t kMaxLocations = 64;
+        const Id& type = ids_[type_id];
+        switch (type.kind) {
+            case TypeKind::Bool:
+            case TypeKind::Int:
+            case TypeKind::Float:
+            case TypeKind::Vector:
+                if (*location >= kMaxLocations || *component + type.components > 4) return false;
+                interfaces->push_back(ShaderInterface{*location, *component, type.components, *offset, interpolation});
+                ++*location;
+                *component = 0;
+                *offset += type.size;
+                return true;
+            case TypeKind::Matrix:
+            case TypeKind::Array:
+                for (uint32_t i = 0; i < type.length; ++i) {
+                    if (!AppendInterface(type.element, interpolation, location, component, offset, interfaces)) return false;
+                }
+                return true;
+            case TypeKind::Struct:
+                for (const auto member : type.members) {
+                    if (!AppendInterface(member, interpolation, location, component, offset, interfaces)) return false;
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+    // Outputs the program has no use for, such as the point size, are bound all the same
+    bool BindBuiltIn(uint32_t builtin, bool input, uint32_t offset) {
+        ShaderBuiltIn shader_builtin;
+        switch ((SpvBuiltIn)builtin) {
+            case SpvBuiltIn::GlobalInvocationId:
+                shader_builtin = kBuiltInGlobalInvocationId;
+                break;
+            case SpvBuiltIn::LocalInvocationId:
+                shader_builtin = kBuiltInLocalInvocationId;
+                break;
+            case SpvBuiltIn::WorkgroupId:
+                shader_builtin = kBuiltInWorkgroupId;
+                break;
+            case SpvBuiltIn::NumWorkgroups:
+                shader_builtin = kBuiltInNumWorkgroups;
+                break;
+            case SpvBuiltIn::LocalInvocationIndex:
+                shader_builtin = kBuiltInLocalInvocationIndex;
+                break;
+            case SpvBuiltIn::VertexIndex:
+                shader_builtin = kBuiltInVertexIndex;
+                break;
+            case SpvBuiltIn::InstanceIndex:
+                shader_builtin = kBuiltInInstanceIndex;
+                break;
+            case SpvBuiltIn::FragCoord:
+                shader_builtin = kBuiltInFragCoord;
+                break;
+            case SpvBuiltIn::FrontFacing:
+                shader_builtin = kBuiltInFrontFacing;
+                break;
+            case SpvBuiltIn::Position:
+                shader_builtin = kBuiltInPosition;
+                break;
+            case SpvBuiltIn::FragDepth:
+                shader_builtin = kBuiltInFragDepth;
+                break;
+            default:
+                return !input;
+        }
+        program_->builtin_offsets[shader_builtin] = offset;
+        return true;
+    }
+
+    // Registers
+    uint32_t AllocateRegisters(uint32_t count) {
+        const uint32_t first = next_register_;
+        next_register_ += count;
+        return first;
+    }
+    uint32_t ConstantRegister(uint32_t value) {
+        auto it = constant_registers_.find(value);
+        if (it != constant_registers_.end()) return it->second;
+        const uint32_t reg = AllocateRegisters(1);
+        program_->constants.emplace_back(reg, ScalarValue(value));
+        constant_registers_[value] = reg;
+        return reg;
+    }
+    // Registers of the value of id, allocated on first use. Returns kNone if the value can't be held in registers.
+    uint32_t Register(uint32_t id) {
+        if (!ValidId(id)) return kNone;
+        Id& value = ids_[id];
+        if (value.reg != kNone) return value.reg;
+        if (!ValidId(value.type) || !ids_[value.type].components) return kNone;
+        value.reg = AllocateRegisters(ids_[value.type].components);
+        if (value.constant) {
+            for (uint32_t i = 0; i < value.values.size(); ++i) program_->constants.emplace_back(value.reg + i, value.values[i]);
+        }
+        return value.reg;
+    }
+    // Registers of the result of an instruction
+    uint32_t Result(uint32_t type, uint32_t id) {
+        if (!ValidId(id) || !ValidId(type)) return kNone;
+        ids_[id].type = type;
+        return Register(id);
+    }
+
+    void Emit(ShaderOp op, uint32_t count, uint32_t dst, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t imm = 0,
+              uint8_t scalar_operands = 0) {
+        program_->code.push_back(ShaderInstruction{op, scalar_operands, (uint16_t)count, dst, a, b, c, imm});
+    }
+    void EmitMov(uint32_t dst, uint32_t src, uint32_t count) {
+        if (count && dst != src) Emit(ShaderOp::Mov, count, dst, src);
+    }
+    // An operation on the components of operands of the same type as the result, or scalars that apply to all of them
+    bool EmitComponentwise(ShaderOp op, uint32_t type, uint32_t id, uint32_t a, uint32_t b = 0, uint32_t c = 0) {
+        const uint32_t operands[3] = {a, b, c};
+        uint32_t registers[3] = {0, 0, 0};
+        uint8_t scalar_operands = 0;
+        const uint32_t dst = Result(type, id);
+        if (dst == kNone) return false;
+        const uint32_t count = ids_[type].components;
+        for (uint32_t i = 0; i < 3 && operands[i]; ++i) {
+            registers[i] = Register(operands[i]);
+            const uint32_t components = ComponentsOf(operands[i]);
+            if (registers[i] == kNone || (components != count && components != 1)) return false;
+            if (components == 1 && count > 1) scalar_operands |= 1 << i;
+        }
+        Emit(op, count, dst, registers[0], registers[1], registers[2], 0, scalar_operands);
+        return true;
+    }
+    // An operation on whole vectors
+    bool EmitVectorOp(ShaderOp op, uint32_t type, uint32_t id, uint32_t a, uint32_t b = 0) {
+        const uint32_t dst = Result(type, id);
+        const uint32_t ra = Register(a);
+        const uint32_t rb = b ? Register(b) : 0;
+        if (dst == kNone || ra == kNone || rb == kNone || (b && ComponentsOf(b) != ComponentsOf(a))) return false;
+        Emit(op, ComponentsOf(a), dst, ra, rb);
+        return true;
+    }
+    uint32_t ComponentsOf(uint32_t id) const {
+        if (!ValidId(id) || !ValidId(ids_[id].type)) return 0;
+        return ids_[ids_[id].type].components;
+    }
+
+    // Memory layouts
+    uint32_t MemberOffset(const Id& type, uint32_t member, const Layout& layout) const {
+        if (layout.explicit_layout && type.member_decorations[member].offset != kNone) return type.member_decorations[member].offset;
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < member; ++i) offset += ids_[type.members[i]].size;
+        return offset;
+    }
+    Layout MemberLayout(const Id& type, uint32_t member, const Layout& layout) const {
+        const auto& decorations = type.member_decorations[member];
+        return Layout{layout.explicit_layout, decorations.matrix_stride, decorations.row_major, 4};
+    }
+    uint32_t ArrayStride(const Id& type, const Layout& layout) const {
+        return layout.explicit_layout && type.array_stride ? type.array_stride : ids_[type.element].size;
+    }
+    // Strides between the columns of a matrix and between the components of a column
+    void MatrixStrides(const Id& type, const Layout& layout, uint32_t* column_stride, uint32_t* component_stride) const {
+        if (layout.explicit_layout && layout.matrix_stride) {
+            *column_stride = layout.row_major ? 4 : layout.matrix_stride;
+            *component_stride = layout.row_major ? layout.matrix_stride : 4;
+        } else {
+            *column_stride = ids_[type.element].size;
+            *component_stride = 4;
+        }
+    }
+    // Byte offsets of the scalars of a value of type at offset in memory, in the order of its registers
+    void AppendMemoryOffsets(uint32_t type_id, uint32_t offset, const Layout& layout, std::vector<uint32_t>* offsets) const {
+        const Id& type = ids_[type_id];
+        switch (type.kind) {
+            case TypeKind::Bool:
+            case TypeKind::Int:
+            case TypeKind::Float:
+                offsets->push_back(offset);
+                break;
+            case TypeKind::Vector:
+                for (uint32_t i = 0; i < type.length; ++i) offsets->push_back(offset + i * layout.component_stride);
+                break;
+            case TypeKind::Matrix: {
+                uint32_t column_stride, component_stride;
+                MatrixStrides(type, layout, &column_stride, &component_stride);
+                const uint32_t rows = ids_[type.element].length;
+                for (uint32_t column = 0; column < type.length; ++column) {
+                    for (uint32_t row = 0; row < rows; ++row) offsets->push_back(offset + column * column_stride + row * component_stride);
+                }
+                break;
+            }
+            case TypeKind::Array:
+                for (uint32_t i = 0; i < type.length; ++i) {
+                    AppendMemoryOffsets(type.element, offset + i * ArrayStride(type, layout), layout, offsets);
+                }
+                break;
+            case TypeKind::Struct:
+                for (uint32_t i = 0; i < type.members.size(); ++i) {
+                    AppendMemoryOffsets(type.members[i], offset + MemberOffset(type, i, layout), MemberLayout(type, i, layout), offsets);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    // Offset of the registers of an element of a composite in the registers of the composite
+    bool CompositeOffset(uint32_t type_id, const uint32_t* indices, uint32_t index_count, uint32_t* offset, uint32_t* element_type) const {
+        *offset = 0;
+        for (uint32_t i = 0; i < index_count; ++i) {
+            const Id& type = ids_[type_id];
+            const uint32_t index = indices[i];
+            switch (type.kind) {
+                case TypeKind::Vector:
+                case TypeKind::Matrix:
+                case TypeKind::Array:
+                    if (index >= type.length) return false;
+                    *offset += index * ids_[type.element].components;
+                    type_id = type.element;
+                    break;
+                case TypeKind::Struct:
+                    if (index >= type.members.size()) return false;
+                    for (uint32_t m = 0; m < index; ++m) *offset += ids_[type.members[m]].components;
+                    type_id = type.members[index];
+                    break;
+                default:
+                    return false;
+            }
+        }
+        *element_type = type_id;
+        return true;
+    }
+    // Pointer ids and the variables they point into
+    const Id* AccessiblePointer(uint32_t id) const {
+        if (!ValidId(id) || ids_[id].variable == kNone) return nullptr;
+        const Id& pointer = ids_[id];
+        return program_->variables[pointer.variable].memory == ShaderMemory::Opaque ? nullptr : &pointer;
+    }
+    uint32_t Pointee(const Id& pointer) const { return ids_[pointer.type].element; }
+    // Fragment shaders run helper invocations for the derivatives along the edges of primitives, which mustn't write
+    // buffers, so they can't be run at all when the shader does
+    bool Writable(const Id& pointer) const {
+        return execution_model_ != kSpvExecutionModelFragment || program_->variables[pointer.variable].memory != ShaderMemory::Buffer;
+    }
+
+    bool EmitLoad(uint32_t type, uint32_t id, uint32_t pointer_id) {
+        if (ValidId(type) && IsTextureKind(ids_[type].kind)) return EmitLoadTexture(type, id, pointer_id);
+        const Id* pointer = AccessiblePointer(pointer_id);
+        const uint32_t dst = Result(type, id);
+        if (!pointer || dst == kNone || Pointee(*pointer) != type) return false;
+        const uint32_t first_offset = (uint32_t)program_->memory_offsets.size();
+        AppendMemoryOffsets(type, 0, pointer->layout, &program_->memory_offsets);
+        Emit(ShaderOp::Load, ids_[type].components, dst, pointer->reg, first_offset, 0, pointer->variable);
+        return true;
+    }
+    bool EmitStore(uint32_t pointer_id, uint32_t value_id) {
+        const Id* pointer = AccessiblePointer(pointer_id);
+        const uint32_t value = Register(value_id);
+        if (!pointer || !Writable(*pointer) || value == kNone || ComponentsOf(value_id) != ids_[Pointee(*pointer)].components) return false;
+        const uint32_t first_offset = (uint32_t)program_->memory_offsets.size();
+        AppendMemoryOffsets(Pointee(*pointer), 0, pointer->layout, &program_->memory_offsets);
+        Emit(ShaderOp::Store, ComponentsOf(value_id), 0, pointer->reg, value, first_offset, pointer->variable);
+        return true;
+    }
+    bool EmitAccessChain(const Instruction& in) {
+        const Id* base = AccessiblePointer(in[3]);
+        if (!base || !ValidId(in[2]) || !ValidId(in[1])) return false;
+        Id result = *base;
+        result.type = in[1];
+        const uint32_t dst = AllocateRegisters(1);
+        const size_t first = program_->code.size();
+        Emit(ShaderOp::PtrAdd, 1, dst, base->reg);
+        uint32_t constant_offset = 0;
+        uint32_t type_id = Pointee(*base);
+        for (uint32_t i = 4; i < in.word_count; ++i) {
+            const uint32_t index_id = in[i];
+            if (!ValidId(index_id) || ComponentsOf(index_id) != 1) return false;
+            const bool constant_index = ids_[index_id].constant;
+            const uint32_t index = constant_index ? ids_[index_id].values[0].u : 0;
+            const Id& type = ids_[type_id];
+            uint32_t stride;
+            switch (type.kind) {
+                case TypeKind::Struct:
+                    if (!constant_index || index >= type.members.size()) return false;
+                    constant_offset += MemberOffset(type, index, result.layout);
+                    result.layout = MemberLayout(type, index, result.layout);
+                    type_id = type.members[index];
+                    continue;
+                case TypeKind::Array:
+                case TypeKind::RuntimeArray:
+                    stride = ArrayStride(type, result.layout);
+                    break;
+                case TypeKind::Matrix: {
+                    uint32_t component_stride;
+                    MatrixStrides(type, result.layout, &stride, &component_stride);
+                    result.layout.component_stride = component_stride;
+                    break;
+                }
+                case TypeKind::Vector:
+                    stride = result.layout.component_stride;
+                    break;
+                default:
+                    return false;
+            }
+            if (constant_index) {
+                constant_offset += index * stride;
+            } else {
+                Emit(ShaderOp::PtrAddScaled, 1, dst, dst, Register(index_id), 0, stride);
+            }
+            type_id = type.element;
+        }
+        if (type_id != ids_[in[1]].element) return false;
+        program_->code[first].imm = constant_offset;
+        result.reg = dst;
+        result.constant = false;
+        ids_[in[2]].type = result.type;
+        ids_[in[2]].reg = result.reg;
+        ids_[in[2]].variable = result.variable;
+        ids_[in[2]].layout = result.layout;
+        return true;
+    }
+    bool EmitAtomic(ShaderOp op, uint32_t type, uint32_t id, uint32_t pointer_id, uint32_t value = 0, uint32_t comparator = 0) {
+        const Id* pointer = AccessiblePointer(pointer_id);
+        if (!pointer || !Writable(*pointer) || ids_[Pointee(*pointer)].kind != TypeKind::Int) return false;
+        const uint32_t dst = type ? Result(type, id) : 0;
+        const uint32_t b = value ? Register(value) : 0;
+        const uint32_t c = comparator ? Register(comparator) : 0;
+        if (dst == kNone || b == kNone || c == kNone) return false;
+        Emit(op, 1, dst, pointer->reg, b, c, pointer->variable);
+        return true;
+    }
+    static bool IsTextureKind(TypeKind kind) {
+        return kind == TypeKind::Image || kind == TypeKind::Sampler || kind == TypeKind::SampledImage;
+    }
+    // Images and samplers aren't held in registers: their values are the variables they were loaded from, which
+    // Sample instructions look up the descriptors of
+    bool EmitLoadTexture(uint32_t type, uint32_t id, uint32_t pointer_id) {
+        if (!ValidId(id) || !ValidId(pointer_id) || ids_[pointer_id].variable == kNone || Pointee(ids_[pointer_id]) != type) return false;
+        const uint32_t variable = ids_[pointer_id].variable;
+        const TypeKind kind = ids_[type].kind;
+        Id& value = ids_[id];
+        value.type = type;
+        value.image_variable = kind == TypeKind::Sampler ? kNone : variable;
+        value.sampler_variable = kind == TypeKind::Image ? kNone : variable;
+        return true;
+    }
+    bool EmitSample(const Instruction& in) {
+        const uint32_t type = in[1], id = in[2], operands = in[5];
+        if (!ValidId(in[3]) || !ValidId(ids_[in[3]].type)) return false;
+        const uint32_t image_variable = ids_[in[3]].image_variable;
+        const uint32_t sampler_variable = ids_[in[3]].sampler_variable;
+        const Id& image_type = ids_[ids_[ids_[in[3]].type].element];
+        const uint32_t dimensions = image_type.dimensions;
+        const bool arrayed = image_type.arrayed;
+        uint32_t mode = kSampleImplicitLod, lod_id = 0;
+        if (in.op() == SpvOp::ImageSampleExplicitLod) {
+            if (operands != kSpvImageOperandsLod) return false;
+            mode = kSampleExplicitLod;
+            lod_id = in[6];
+        } else {
+            // Implicit levels of detail come from derivatives, which only fragment shaders have
+            if (execution_model_ != kSpvExecutionModelFragment || (operands & ~kSpvImageOperandsBias)) return false;
+            if (operands) {
+                mode = kSampleBias;
+                lod_id = in[6];
+            }
+        }
+        const uint32_t coordinate_count = dimensions + (arrayed ? 1 : 0);
+        const uint32_t dst = Result(type, id);
+        const uint32_t coordinates = Register(in[4]);
+        const uint32_t lod = lod_id ? Register(lod_id) : 0;
+        if (image_variable == kNone || sampler_variable == kNone || !dimensions || dst == kNone || coordinates == kNone || lod == kNone ||
+            ComponentsOf(id) != 4 || ComponentsOf(in[4]) < coordinate_count || (lod_id && ComponentsOf(lod_id) != 1)) {
+            return false;
+        }
+        const ShaderVariable& image = program_->variables[image_variable];
+        const ShaderVariable& sampler = program_->variables[sampler_variable];
+        const ShaderTextureBinding texture = {image.set, image.binding, sampler.set, sampler.binding, dimensions, arrayed};
+        auto& textures = program_->textures;
+        const auto it = std::find_if(textures.begin(), textures.end(), [&](const ShaderTextureBinding& other) {
+            return other.image_set == texture.image_set && other.image_binding == texture.image_binding &&
+                   other.sampler_set == texture.sampler_set && other.sampler_binding == texture.sampler_binding &&
+                   other.dimensions == texture.dimensions && other.arrayed == texture.arrayed;
+        });
+        const uint32_t index = (uint32_t)(it - textures.begin());
+        if (it == textures.end()) textures.push_back(texture);
+        Emit(ShaderOp::Sample, coordinate_count, dst, coordinates, lod, mode, index);
+        return true;
+    }
+    // Derivatives are differences between the invocations of the quads of fragment shaders
+    bool EmitDerivative(ShaderOp op, uint32_t type, uint32_t id, uint32_t x) {
+        return execution_model_ == kSpvExecutionModelFragment && EmitComponentwise(op, type, id, x);
+    }
+    bool EmitFwidth(ShaderOp dx_op, ShaderOp dy_op, uint32_t type, uint32_t id, uint32_t x) {
+        const uint32_t dst = Result(type, id);
+        const uint32_t a = Register(x);
+        const uint32_t count = ComponentsOf(x);
+        if (execution_model_ != kSpvExecutionModelFragment || dst == kNone || a == kNone || count != ids_[type].components) return false;
+        const uint32_t dx = AllocateRegisters(count), dy = AllocateRegisters(count);
+        Emit(dx_op, count, dx, a);
+        Emit(dy_op, count, dy, a);
+        Emit(ShaderOp::FAbs, count, dx, dx);
+        Emit(ShaderOp::FAbs, count, dy, dy);
+        Emit(ShaderOp::FAdd, count, dst, dx, dy);
+        return true;
+    }
+    // M * v, where M has columns of rows components
+    void EmitMatrixTimesVector(uint32_t dst, uint32_t matrix, uint32_t vector, uint32_t columns, uint32_t rows) {
+        Emit(ShaderOp::FMul, rows, dst, matrix, vector, 0, 0, 2);
+        for (uint32_t column = 1; column < columns; ++column) {
+            Emit(ShaderOp::Fma, rows, dst, matrix + column * rows, vector + column, dst, 0, 2);
+        }
+    }
+    bool EmitMatrixOp(const Instruction& in) {
+        const uint32_t dst = Result(in[1], in[2]);
+        const uint32_t a = Register(in[3]);
+        const uint32_t b = Register(in[4]);
+        if (dst == kNone || a == kNone || b == kNone) return false;
+        const Id& a_type = ids_[ids_[in[3]].type];
+        const Id& b_type = ids_[ids_[in[4]].type];
+        switch (in.op()) {
+            case SpvOp::MatrixTimesVector:
+                EmitMatrixTimesVector(dst, a, b, a_type.length, ids_[a_type.element].length);
+                return b_type.length == a_type.length;
+            case SpvOp::VectorTimesMatrix: {
+                // Each component of the result is the dot product with a column
+                const uint32_t rows = ids_[b_type.element].length;
+                for (uint32_t column = 0; column < b_type.length; ++column) Emit(ShaderOp::Dot, rows, dst + column, a, b + column * rows);
+                return a_type.length == rows;
+            }
+            case SpvOp::MatrixTimesMatrix: {
+                const uint32_t rows = ids_[a_type.element].length;
+                for (uint32_t column = 0; column < b_type.length; ++column) {
+                    EmitMatrixTimesVector(dst + column * rows, a, b + column * a_type.length, a_type.length, rows);
+                }
+                return ids_[b_type.element].length == a_type.length;
+            }
+            default:
+                return false;
+        }
+    }
+    bool EmitExtInst(const Instruction& in) {
+        if (ValidId(in[3]) && ids_[in[3]].kind == TypeKind::Opaque) return true;
+        if (in[3] != glsl_std_450_ || !glsl_std_450_) return false;
+        const uint32_t type = in[1], id = in[2], x = in[5], y = in[6], z = in[7];
+        switch ((GlslStd450)in[4]) {
+            case GlslStd450::Round: return EmitComponentwise(ShaderOp::Round, type, id, x);
+            case GlslStd450::RoundEven: return EmitComponentwise(ShaderOp::RoundEven, type, id, x);
+            case GlslStd450::Trunc: return EmitComponentwise(ShaderOp::Trunc, type, id, x);
+            case GlslStd450::FAbs: return EmitComponentwise(ShaderOp::FAbs, type, id, x);
+            case GlslStd450::SAbs: return EmitComponentwise(ShaderOp::SAbs, type, id, x);
+            case GlslStd450::FSign: return EmitComponentwise(ShaderOp::FSign, type, id, x);
+            case GlslStd450::SSign: return EmitComponentwise(ShaderOp::SSign, type, id, x);
+            case GlslStd450::Floor: return EmitComponentwise(ShaderOp::Floor, type, id, x);
+            case GlslStd450::Ceil: return EmitComponentwise(ShaderOp::Ceil, type, id, x);
+            case GlslStd450::Fract: return EmitComponentwise(ShaderOp::Fract, type, id, x);
+            case GlslStd450::Radians: return EmitComponentwise(ShaderOp::FMul, type, id, x, ConstantId(3.14159265f / 180.0f));
+            case GlslStd450::Degrees: return EmitComponentwise(ShaderOp::FMul, type, id, x, ConstantId(180.0f / 3.14159265f));
+            case GlslStd450::Sin: return EmitComponentwise(ShaderOp::Sin, type, id, x);
+            case GlslStd450::Cos: return EmitComponentwise(ShaderOp::Cos, type, id, x);
+            case GlslStd450::Tan: return EmitComponentwise(ShaderOp::Tan, type, id, x);
+            case GlslStd450::Asin: return EmitComponentwise(ShaderOp::Asin, type, id, x);
+            case GlslStd450::Acos: return EmitComponentwise(ShaderOp::Acos, type, id, x);
+            case GlslStd450::Atan: return EmitComponentwise(ShaderOp::Atan, type, id, x);
+            case GlslStd450::Sinh: return EmitComponentwise(ShaderOp::Sinh, type, id, x);
+            case GlslStd450::Cosh: return EmitComponentwise(ShaderOp::Cosh, type, id, x);
+            case GlslStd450::Tanh: return EmitComponentwise(ShaderOp::Tanh, type, id, x);
+            case GlslStd450::Atan2: return EmitComponentwise(ShaderOp::Atan2, type, id, x, y);
+            case GlslStd450::Pow: return EmitComponentwise(ShaderOp::Pow, type, id, x, y);
+            case GlslStd450::Exp: return EmitComponentwise(ShaderOp::Exp, type, id, x);
+            case GlslStd450::Log: return EmitComponentwise(ShaderOp::Log, type, id, x);
+            case GlslStd450::Exp2: return EmitComponentwise(ShaderOp::Exp2, type, id, x);
+            case GlslStd450::Log2: return EmitComponentwise(ShaderOp::Log2, type, id, x);
+            case GlslStd450::Sqrt: return EmitComponentwise(ShaderOp::Sqrt, type, id, x);
+            case GlslStd450::InverseSqrt: return EmitComponentwise(ShaderOp::InverseSqrt, type, id, x);
+            case GlslStd450::FMin:
+            case GlslStd450::NMin: return EmitComponentwise(ShaderOp::FMin, type, id, x, y);
+            case GlslStd450::FMax:
+            case GlslStd450::NMax: return EmitComponentwise(ShaderOp::FMax, type, id, x, y);
+            case GlslStd450::UMin: return EmitComponentwise(ShaderOp::UMin, type, id, x, y);
+            case GlslStd450::UMax: return EmitComponentwise(ShaderOp::UMax, type, id, x, y);
+            case GlslStd450::SMin: return EmitComponentwise(ShaderOp::SMin, type, id, x, y);
+            case GlslStd450::SMax: return EmitComponentwise(ShaderOp::SMax, type, id, x, y);
+            case GlslStd450::FClamp:
+            case GlslStd450::NClamp: return EmitComponentwise(ShaderOp::FClamp, type, id, x, y, z);
+            case GlslStd450::UClamp: return EmitComponentwise(ShaderOp::UClamp, type, id, x, y, z);
+            case GlslStd450::SClamp: return EmitComponentwise(ShaderOp::SClamp, type, id, x, y, z);
+            case GlslStd450::FMix: return EmitComponentwise(ShaderOp::FMix, type, id, x, y, z);
+            case GlslStd450::Step: return EmitComponentwise(ShaderOp::Step, type, id, x, y);
+            case GlslStd450::SmoothStep: return EmitComponentwise(ShaderOp::SmoothStep, type, id, x, y, z);
+            case GlslStd450::Fma: return EmitComponentwise(ShaderOp::Fma, type, id, x, y, z);
+            case GlslStd450::FindILsb: return EmitComponentwise(ShaderOp::FindILsb, type, id, x);
+            case GlslStd450::FindSMsb: return EmitComponentwise(ShaderOp::FindSMsb, type, id, x);
+            case GlslStd450::FindUMsb: return EmitComponentwise(ShaderOp::FindUMsb, type, id, x);
+            case GlslStd450::Length: return EmitVectorOp(ShaderOp::Length, type, id, x);
+            case GlslStd450::Normalize: return EmitVectorOp(ShaderOp::Normalize, type, id, x);
+            case GlslStd450::Cross: return ComponentsOf(x) == 3 && EmitVectorOp(ShaderOp::Cross, type, id, x, y);
+            case GlslStd450::Reflect: return EmitVectorOp(ShaderOp::Reflect, type, id, x, y);
+            case GlslStd450::Distance: {
+                const uint32_t count = ComponentsOf(x);
+                const uint32_t dst = Result(type, id);
+                const uint32_t a = Register(x), b = Register(y);
+                if (dst == kNone || a == kNone || b == kNone || ComponentsOf(y) != count) return false;
+                const uint32_t difference = AllocateRegisters(count);
+                Emit(ShaderOp::FSub, count, difference, a, b);
+                Emit(ShaderOp::Length, count, dst, difference);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+    // An id of a float constant, for the constants the compiler introduces itself
+    uint32_t ConstantId(float value) {
+        if (!float_type_) {
+            float_type_ = NewId();
+            ids_[float_type_].kind = TypeKind::Float;
+            ids_[float_type_].components = 1;
+            ids_[float_type_].size = 4;
+        }
+        ShaderValue v;
+        v.f = value;
+        const uint32_t id = NewId();
+        Id& constant = ids_[id];
+        constant.type = float_type_;
+        constant.constant = true;
+        constant.values.push_back(v);
+        constant.reg = ConstantRegister(v.u);
+        return id;
+    }
+    // An id past the ids of the module, for values the compiler introduces. Invalidates references to ids.
+    uint32_t NewId() {
+        ids_.emplace_back();
+        return (uint32_t)ids_.size() - 1;
+    }
+
+    // Control flow
+    struct Phi {
+        uint32_t id;
+        uint32_t type;
+        uint32_t shadow;  // Registers the predecessors write the incoming value to, so that phis read each other's old values
+        std::vector<std::pair<uint32_t, uint32_t>> incoming;  // Values and the blocks they come from
+    };
+    enum class FixupField : uint8_t { Imm, B, SwitchCase };
+    struct Fixup {
+        FixupField field;
+        size_t index;  // Of the instruction or the switch case
+        uint32_t label;
+    };
+    struct FunctionState {
+        std::unordered_map<uint32_t, uint32_t> labels;  // Program counters of the blocks
+        std::unordered_map<uint32_t, std::vector<Phi>> phis;  // Of each block
+        std::vector<Fixup> fixups;
+        std::vector<size_t> returns;  // Jumps to the end of an inlined call
+        uint32_t block = 0;
+    };
+    void EmitPhiCopies(FunctionState* state, uint32_t successor) {
+        auto it = state->phis.find(successor);
+        if (it == state->phis.end()) return;
+        for (const auto& phi : it->second) {
+            for (const auto& incoming : phi.incoming) {
+                if (incoming.second == state->block) EmitMov(phi.shadow, Register(incoming.first), ids_[phi.type].components);
+            }
+        }
+    }
+    bool EmitBranch(FunctionState* state, ShaderOp op, uint32_t condition, uint32_t target, uint32_t false_target = 0) {
+        EmitPhiCopies(state, target);
+        if (false_target) EmitPhiCopies(state, false_target);
+        state->fixups.push_back(Fixup{FixupField::Imm, program_->code.size(), target});
+        if (false_target) state->fixups.push_back(Fixup{FixupField::B, program_->code.size(), false_target});
+        Emit(op, 1, 0, condition);
+        return true;
+    }
+
+    // Compile a function into the program at its end. Calls are inlined: the parameters of the function take the
+    // registers of the arguments, and the result of the function is moved to result.
+    bool CompileFunction(uint32_t function, bool entry, uint32_t result, const uint32_t* arguments, uint32_t argument_count) {
+        if (!ValidId(function) || ids_[function].kind != TypeKind::Function || call_depth_ >= kMaxCallDepth) return false;
+        ++call_depth_;
+        FunctionState state;
+        const size_t start = ids_[function].function_start;
+        Instruction in;
+        // Find the phis first, their predecessors are compiled before them
+        uint32_t block = 0;
+        for (size_t offset = start; GetInstruction(offset, &in) && in.op() != SpvOp::FunctionEnd; offset += in.word_count) {
+            if (in.op() == SpvOp::Label) block = in[1];
+            if (in.op() != SpvOp::Phi) continue;
+            Phi phi = {in[2], in[1], kNone, {}};
+            for (uint32_t i = 3; i + 1 < in.word_count; i += 2) phi.incoming.emplace_back(in[i], in[i + 1]);
+            if (!ValidId(phi.type) || !ids_[phi.type].components) return false;
+            phi.shadow = AllocateRegisters(ids_[phi.type].components);
+            state.phis[block].push_back(phi);
+        }
+        uint32_t parameter = 0;
+        size_t offset = start;
+        for (;; offset += in.word_count) {
+            if (!GetInstruction(offset, &in)) return false;
+            if (in.op() == SpvOp::FunctionEnd) break;
+            if (!CompileInstruction(in, &state, entry, result, arguments, argument_count, &parameter)) return false;
+        }
+        const uint32_t end = (uint32_t)program_->code.size();
+        for (const auto jump : state.returns) program_->code[jump].imm = end;
+        for (const auto& fixup : state.fixups) {
+            auto label = state.labels.find(fixup.label);
+            if (label == state.labels.end()) return false;
+            switch (fixup.field) {
+                case FixupField::Imm:
+                    program_->code[fixup.index].imm = label->second;
+                    break;
+                case FixupField::B:
+                    program_->code[fixup.index].b = label->second;
+                    break;
+                case FixupField::SwitchCase:
+                    program_->switch_cases[fixup.index] = label->second;
+                    break;
+            }
+        }
+        --call_depth_;
+        return true;
+    }
+
+    bool CompileInstruction(const Instruction& in, FunctionState* state, bool entry, uint32_t result, const uint32_t* arguments,
+                            uint32_t argument_count, uint32_t* parameter) {
+        const uint32_t type = in[1], id = in[2];
+        switch (in.op()) {
+            case SpvOp::Function:
+            case SpvOp::Nop:
+            case SpvOp::Line:
+            case SpvOp::NoLine:
+            case SpvOp::LoopMerge:
+            case SpvOp::SelectionMerge:
+            case SpvOp::LifetimeStart:
+            case SpvOp::LifetimeStop:
+                return true;
+            case SpvOp::FunctionParameter: {
+                if (*parameter >= argument_count || !ValidId(id)) return false;
+                // Arguments are never written while the call runs, the parameter can share their registers
+                const Id& argument = ids_[arguments[(*parameter)++]];
+                Id& value = ids_[id];
+                value.type = type;
+                value.reg = argument.reg;
+                value.variable = argument.variable;
+                value.layout = argument.layout;
+                value.image_variable = argument.image_variable;
+                value.sampler_variable = argument.sampler_variable;
+                return value.reg != kNone || value.image_variable != kNone || value.sampler_variable != kNone;
+            }
+            case SpvOp::Label: {
+                state->block = in[1];
+                state->labels[in[1]] = (uint32_t)program_->code.size();
+                auto it = state->phis.find(in[1]);
+                if (it != state->phis.end()) {
+                    for (const auto& phi : it->second) {
+                        const uint32_t dst = Result(phi.type, phi.id);
+                        if (dst == kNone) return false;
+                        EmitMov(dst, phi.shadow, ids_[phi.type].components);
+                    }
+                }
+                return true;
+            }
+            case SpvOp::Phi:
+                return true;
+            case SpvOp::Variable:
+                if (!DefineVariable(id, type, in[3], 0)) return false;
+                return in.word_count <= 4 || EmitStore(id, in[4]);
+            case SpvOp::Undef:
+            case SpvOp::ConstantNull:
+                return ParseDeclaration(in);
+            case SpvOp::Load:
+                return EmitLoad(type, id, in[3]);
+            case SpvOp::Store:
+                return EmitStore(in[1], in[2]);
+            case SpvOp::CopyMemory: {
+                const Id* source = AccessiblePointer(in[2]);
+                if (!source) return false;
+                const uint32_t pointee = Pointee(*source);
+                const uint32_t value = NewId();
+                return EmitLoad(pointee, value, in[2]) && EmitStore(in[1], value);
+            }
+            case SpvOp::AccessChain:
+            case SpvOp::InBoundsAccessChain:
+                return EmitAccessChain(in);
+            case SpvOp::ArrayLength: {
+                const Id* pointer = AccessiblePointer(in[3]);
+                const uint32_t dst = Result(type, id);
+                if (!pointer || dst == kNone || program_->variables[pointer->variable].memory != ShaderMemory::Buffer) return false;
+                const Id& block_type = ids_[Pointee(*pointer)];
+                if (block_type.kind != TypeKind::Struct || in[4] >= block_type.members.size()) return false;
+                const Id& array = ids_[block_type.members[in[4]]];
+                if (array.kind != TypeKind::RuntimeArray) return false;
+                Emit(ShaderOp::ArrayLength, 1, dst, 0, MemberOffset(block_type, in[4], pointer->layout), ArrayStride(array, pointer->layout),
+                     pointer->variable);
+                return true;
+            }
+            case SpvOp::FunctionCall: {
+                const uint32_t dst = ids_[type].kind == TypeKind::Void ? kNone : Result(type, id);
+                if (dst == kNone && ids_[type].kind != TypeKind::Void) return false;
+                std::vector<uint32_t> call_arguments(in.words + 4, in.words + in.word_count);
+                for (const auto argument : call_arguments) {
+                    if (!ValidId(argument)) return false;
+                    const Id& value = ids_[argument];
+                    const bool texture = value.image_variable != kNone || value.sampler_variable != kNone;
+                    if (value.variable == kNone && !texture && Register(argument) == kNone) return false;
+                }
+                return CompileFunction(in[3], false, dst, call_arguments.data(), (uint32_t)call_arguments.size());
+            }
+            case SpvOp::ReturnValue:
+                if (entry || result == kNone || Register(in[1]) == kNone) return false;
+                EmitMov(result, Register(in[1]), ComponentsOf(in[1]));
+                state->returns.push_back(program_->code.size());
+                Emit(ShaderOp::Jump, 1, 0);
+                return true;
+            case SpvOp::Return:
+                if (entry) {
+                    Emit(ShaderOp::Exit, 1, 0);
+                } else {
+                    state->returns.push_back(program_->code.size());
+                    Emit(ShaderOp::Jump, 1, 0);
+                }
+                return true;
+            case SpvOp::Kill:
+            case SpvOp::TerminateInvocation:
+                if (execution_model_ != kSpvExecutionModelFragment) return false;
+                program_->kills = true;
+                Emit(ShaderOp::Kill, 1, 0);
+                return true;
+            case SpvOp::Unreachable:
+                Emit(ShaderOp::Exit, 1, 0);
+                return true;
+            case SpvOp::Branch:
+                return EmitBranch(state, ShaderOp::Jump, 0, in[1]);
+            case SpvOp::BranchConditional: {
+                const uint32_t condition = Register(in[1]);
+                return condition != kNone && EmitBranch(state, ShaderOp::Branch, condition, in[2], in[3]);
+            }
+            case SpvOp::Switch: {
+                const uint32_t selector = Register(in[1]);
+                if (selector == kNone || ComponentsOf(in[1]) != 1) return false;
+                EmitPhiCopies(state, in[2]);
+                for (uint32_t i = 3; i + 1 < in.word_count; i += 2) EmitPhiCopies(state, in[i + 1]);
+                const uint32_t first_case = (uint32_t)program_->switch_cases.size();
+                for (uint32_t i = 3; i + 1 < in.word_count; i += 2) {
+                    program_->switch_cases.push_back(in[i]);
+                    state->fixups.push_back(Fixup{FixupField::SwitchCase, program_->switch_cases.size(), in[i + 1]});
+                    program_->switch_cases.push_back(0);
+                }
+                state->fixups.push_back(Fixup{FixupField::B, program_->code.size(), in[2]});
+                Emit(ShaderOp::Switch, (in.word_count - 3) / 2, 0, selector, 0, 0, first_case);
+                return true;
+            }
+            case SpvOp::ControlBarrier:
+                Emit(ShaderOp::Barrier, 1, 0);
+                return true;
+            case SpvOp::MemoryBarrier:
+                Emit(ShaderOp::MemoryBarrier, 1, 0);
+                return true;
+            case SpvOp::AtomicLoad: return EmitAtomic(ShaderOp::AtomicLoad, type, id, in[3]);
+            case SpvOp::AtomicStore: return EmitAtomic(ShaderOp::AtomicStore, 0, 0, in[1], in[4]);
+            case SpvOp::AtomicExchange: return EmitAtomic(ShaderOp::AtomicExchange, type, id, in[3], in[6]);
+            case SpvOp::AtomicCompareExchange: return EmitAtomic(ShaderOp::AtomicCompareExchange, type, id, in[3], in[7], in[8]);
+            case SpvOp::AtomicIIncrement:
+            case SpvOp::AtomicIDecrement: {
+                const Id* pointer = AccessiblePointer(in[3]);
+                const uint32_t dst = Result(type, id);
+                if (!pointer || !Writable(*pointer) || dst == kNone) return false;
+                Emit(in.op() == SpvOp::AtomicIIncrement ? ShaderOp::AtomicAdd : ShaderOp::AtomicSub, 1, dst, pointer->reg,
+                     ConstantRegister(1u), 0, pointer->variable);
+                return true;
+            }
+            case SpvOp::AtomicIAdd: return EmitAtomic(ShaderOp::AtomicAdd, type, id, in[3], in[6]);
+            case SpvOp::AtomicISub: return EmitAtomic(ShaderOp::AtomicSub, type, id, in[3], in[6]);
+            case SpvOp::AtomicSMin: return EmitAtomic(ShaderOp::AtomicSMin, type, id, in[3], in[6]);
+            case SpvOp::AtomicUMin: return EmitAtomic(ShaderOp::AtomicUMin, type, id, in[3], in[6]);
+            case SpvOp::AtomicSMax: return EmitAtomic(ShaderOp::AtomicSMax, type, id, in[3], in[6]);
+            case SpvOp::AtomicUMax: return EmitAtomic(ShaderOp::AtomicUMax, type, id, in[3], in[6]);
+            case SpvOp::AtomicAnd: return EmitAtomic(ShaderOp::AtomicAnd, type, id, in[3], in[6]);
+            case SpvOp::AtomicOr: return EmitAtomic(ShaderOp::AtomicOr, type, id, in[3], in[6]);
+            case SpvOp::AtomicXor: return EmitAtomic(ShaderOp::AtomicXor, type, id, in[3], in[6]);
+            case SpvOp::CompositeExtract: {
+                uint32_t offset, element_type;
+                const uint32_t dst = Result(type, id);
+                const uint32_t composite = Register(in[3]);
+                if (dst == kNone || composite == kNone ||
+                    !CompositeOffset(ids_[in[3]].type, in.words + 4, in.word_count - 4, &offset, &element_type) || element_type != type) {
+                    return false;
+                }
+                EmitMov(dst, composite + offset, ids_[type].components);
+                return true;
+            }
+            case SpvOp::CompositeInsert: {
+                uint32_t offset, element_type;
+                const uint32_t dst = Result(type, id);
+                const uint32_t object = Register(in[3]);
+                const uint32_t composite = Register(in[4]);
+                if (dst == kNone || object == kNone || composite == kNone ||
+                    !CompositeOffset(type, in.words + 5, in.word_count - 5, &offset, &element_type)) {
+                    return false;
+                }
+                EmitMov(dst, composite, ids_[type].components);
+                EmitMov(dst + offset, object, ids_[element_type].components);
+                return true;
+            }
+            case SpvOp::CompositeConstruct: {
+                const uint32_t dst = Result(type, id);
+                if (dst == kNone) return false;
+                uint32_t offset = 0;
+                for (uint32_t i = 3; i < in.word_count; ++i) {
+                    const uint32_t constituent = Register(in[i]);
+                    if (constituent == kNone || offset + ComponentsOf(in[i]) > ids_[type].components) return false;
+                    EmitMov(dst + offset, constituent, ComponentsOf(in[i]));
+                    offset += ComponentsOf(in[i]);
+                }
+                return offset == ids_[type].components;
+            }
+            case SpvOp::VectorShuffle: {
+                const uint32_t dst = Result(type, id);
+                const uint32_t a = Register(in[3]), b = Register(in[4]);
+                if (dst == kNone || a == kNone || b == kNone) return false;
+                const uint32_t a_count = ComponentsOf(in[3]);
+                for (uint32_t i = 5; i < in.word_count; ++i) {
+                    const uint32_t component = in[i];
+                    if (component == UINT32_MAX) continue;  // Undefined
+                    if (component >= a_count + ComponentsOf(in[4])) return false;
+                    EmitMov(dst + i - 5, component < a_count ? a + component : b + component - a_count, 1);
+                }
+                return true;
+            }
+            case SpvOp::VectorExtractDynamic:
+                return EmitVectorOp(ShaderOp::ExtractDynamic, type, id, in[3]) && SetOperandB(in[4]);
+            case SpvOp::VectorInsertDynamic: {
+                const uint32_t dst = Result(type, id);
+                const uint32_t vector = Register(in[3]), component = Register(in[4]), index = Register(in[5]);
+                if (dst == kNone || vector == kNone || component == kNone || index == kNone) return false;
+                EmitMov(dst, vector, ComponentsOf(in[3]));
+                Emit(ShaderOp::InsertDynamic, ComponentsOf(in[3]), dst, component, index);
+                return true;
+            }
+            case SpvOp::CopyObject:
+            case SpvOp::Bitcast:
+            case SpvOp::UConvert:
+            case SpvOp::SConvert:
+            case SpvOp::FConvert:
+                // Only 32-bit types make it here, so these are moves. Pointers can't be cast.
+                if (ids_[type].kind == TypeKind::Pointer) return false;
+                return EmitComponentwise(ShaderOp::Mov, type, id, in[3]);
+            case SpvOp::Transpose: {
+                const uint32_t dst = Result(type, id);
+                const uint32_t matrix = Register(in[3]);
+                if (dst == kNone || matrix == kNone) return false;
+                const Id& result_type = ids_[type];
+                const uint32_t rows = ids_[result_type.element].length;  // Columns of the operand
+                for (uint32_t column = 0; column < result_type.length; ++column) {
+                    for (uint32_t row = 0; row < rows; ++row) EmitMov(dst + column * rows + row, matrix + row * result_type.length + column, 1);
+                }
+                return true;
+            }
+            case SpvOp::ConvertFToU: return EmitComponentwise(ShaderOp::ConvertFToU, type, id, in[3]);
+            case SpvOp::ConvertFToS: return EmitComponentwise(ShaderOp::ConvertFToS, type, id, in[3]);
+            case SpvOp::ConvertSToF: return EmitComponentwise(ShaderOp::ConvertSToF, type, id, in[3]);
+            case SpvOp::ConvertUToF: return EmitComponentwise(ShaderOp::ConvertUToF, type, id, in[3]);
+            case SpvOp::SNegate: return EmitComponentwise(ShaderOp::SNegate, type, id, in[3]);
+            case SpvOp::FNegate: return EmitComponentwise(ShaderOp::FNegate, type, id, in[3]);
+            case SpvOp::IAdd: return EmitComponentwise(ShaderOp::IAdd, type, id, in[3], in[4]);
+            case SpvOp::FAdd: return EmitComponentwise(ShaderOp::FAdd, type, id, in[3], in[4]);
+            case SpvOp::ISub: return EmitComponentwise(ShaderOp::ISub, type, id, in[3], in[4]);
+            case SpvOp::FSub: return EmitComponentwise(ShaderOp::FSub, type, id, in[3], in[4]);
+            case SpvOp::IMul: return EmitComponentwise(ShaderOp::IMul, type, id, in[3], in[4]);
+            case SpvOp::FMul:
+            case SpvOp::VectorTimesScalar:
+            case SpvOp::MatrixTimesScalar: return EmitComponentwise(ShaderOp::FMul, type, id, in[3], in[4]);
+            case SpvOp::UDiv: return EmitComponentwise(ShaderOp::UDiv, type, id, in[3], in[4]);
+            case SpvOp::SDiv: return EmitComponentwise(ShaderOp::SDiv, type, id, in[3], in[4]);
+            case SpvOp::FDiv: return EmitComponentwise(ShaderOp::FDiv, type, id, in[3], in[4]);
+            case SpvOp::UMod: return EmitComponentwise(ShaderOp::UMod, type, id, in[3], in[4]);
+            case SpvOp::SRem: return EmitComponentwise(ShaderOp::SRem, type, id, in[3], in[4]);
+            case SpvOp::SMod: return EmitComponentwise(ShaderOp::SMod, type, id, in[3], in[4]);
+            case SpvOp::FRem: return EmitComponentwise(ShaderOp::FRem, type, id, in[3], in[4]);
+            case SpvOp::FMod: return EmitComponentwise(ShaderOp::FMod, type, id, in[3], in[4]);
+            case SpvOp::VectorTimesMatrix:
+            case SpvOp::MatrixTimesVector:
+            case SpvOp::MatrixTimesMatrix: return EmitMatrixOp(in);
+            case SpvOp::Dot: return EmitVectorOp(ShaderOp::Dot, type, id, in[3], in[4]);
+            case SpvOp::Any: return EmitVectorOp(ShaderOp::Any, type, id, in[3]);
+            case SpvOp::All: return EmitVectorOp(ShaderOp::All, type, id, in[3]);
+            case SpvOp::IsNan: return EmitComponentwise(ShaderOp::IsNan, type, id, in[3]);
+            case SpvOp::IsInf: return EmitComponentwise(ShaderOp::IsInf, type, id, in[3]);
+            case SpvOp::LogicalEqual:
+            case SpvOp::IEqual: return EmitComponentwise(ShaderOp::IEqual, type, id, in[3], in[4]);
+            case SpvOp::LogicalNotEqual:
+            case SpvOp::INotEqual: return EmitComponentwise(ShaderOp::INotEqual, type, id, in[3], in[4]);
+            case SpvOp::LogicalOr: return EmitComponentwise(ShaderOp::BitOr, type, id, in[3], in[4]);
+            case SpvOp::LogicalAnd: return EmitComponentwise(ShaderOp::BitAnd, type, id, in[3], in[4]);
+            case SpvOp::LogicalNot: return EmitComponentwise(ShaderOp::LogicalNot, type, id, in[3]);
+            case SpvOp::Select: return EmitComponentwise(ShaderOp::Select, type, id, in[3], in[4], in[5]);
+            // Greater-than comparisons are less-than comparisons with their operands swapped
+            case SpvOp::UGreaterThan: return EmitComponentwise(ShaderOp::ULess, type, id, in[4], in[3]);
+            case SpvOp::SGreaterThan: return EmitComponentwise(ShaderOp::SLess, type, id, in[4], in[3]);
+            case SpvOp::UGreaterThanEqual: return EmitComponentwise(ShaderOp::ULessEqual, type, id, in[4], in[3]);
+            case SpvOp::SGreaterThanEqual: return EmitComponentwise(ShaderOp::SLessEqual, type, id, in[4], in[3]);
+            case SpvOp::ULessThan: return EmitComponentwise(ShaderOp::ULess, type, id, in[3], in[4]);
+            case SpvOp::SLessThan: return EmitComponentwise(ShaderOp::SLess, type, id, in[3], in[4]);
+            case SpvOp::ULessThanEqual: return EmitComponentwise(ShaderOp::ULessEqual, type, id, in[3], in[4]);
+            case SpvOp::SLessThanEqual: return EmitComponentwise(ShaderOp::SLessEqual, type, id, in[3], in[4]);
+            case SpvOp::FOrdEqual: return EmitComponentwise(ShaderOp::FOrdEqual, type, id, in[3], in[4]);
+            case SpvOp::FUnordEqual: return EmitComponentwise(ShaderOp::FUnordEqual, type, id, in[3], in[4]);
+            case SpvOp::FOrdNotEqual: return EmitComponentwise(ShaderOp::FOrdNotEqual, type, id, in[3], in[4]);
+            case SpvOp::FUnordNotEqual: return EmitComponentwise(ShaderOp::FUnordNotEqual, type, id, in[3], in[4]);
+            case SpvOp::FOrdLessThan: return EmitComponentwise(ShaderOp::FOrdLess, type, id, in[3], in[4]);
+            case SpvOp::FUnordLessThan: return EmitComponentwise(ShaderOp::FUnordLess, type, id, in[3], in[4]);
+            case SpvOp::FOrdGreaterThan: return EmitComponentwise(ShaderOp::FOrdLess, type, id, in[4], in[3]);
+            case SpvOp::FUnordGreaterThan: return EmitComponentwise(ShaderOp::FUnordLess, type, id, in[4], in[3]);
+            case SpvOp::FOrdLessThanEqual: return EmitComponentwise(ShaderOp::FOrdLessEqual, type, id, in[3], in[4]);
+            case SpvOp::FUnordLessThanEqual: return EmitComponentwise(ShaderOp::FUnordLessEqual, type, id, in[3], in[4]);
+            case SpvOp::FOrdGreaterThanEqual: return EmitComponentwise(ShaderOp::FOrdLessEqual, type, id, in[4], in[3]);
+            case SpvOp::FUnordGreaterThanEqual: return EmitComponentwise(ShaderOp::FUnordLessEqual, type, id, in[4], in[3]);
+            case SpvOp::ShiftRightLogical: return EmitComponentwise(ShaderOp::ShiftRightLogical, type, id, in[3], in[4]);
+            case SpvOp::ShiftRightArithmetic: return EmitComponentwise(ShaderOp::ShiftRightArithmetic, type, id, in[3], in[4]);
+            case SpvOp::ShiftLeftLogical: return EmitComponentwise(ShaderOp::ShiftLeft, type, id, in[3], in[4]);
+            case SpvOp::BitwiseOr: return EmitComponentwise(ShaderOp::BitOr, type, id, in[3], in[4]);
+            case SpvOp::BitwiseXor: return EmitComponentwise(ShaderOp::BitXor, type, id, in[3], in[4]);
+            case SpvOp::BitwiseAnd: return EmitComponentwise(ShaderOp::BitAnd, type, id, in[3], in[4]);
+            case SpvOp::Not: return EmitComponentwise(ShaderOp::Not, type, id, in[3]);
+            case SpvOp::BitCount: return EmitComponentwise(ShaderOp::BitCount, type, id, in[3]);
+            case SpvOp::ExtInst: return EmitExtInst(in);
+            case SpvOp::SampledImage:
+            case SpvOp::Image: {
+                const bool sampled_image = in.op() == SpvOp::SampledImage;
+                if (!ValidId(id) || !ValidId(type) || !ValidId(in[3]) || (sampled_image && !ValidId(in[4]))) return false;
+                const uint32_t image_variable = ids_[in[3]].image_variable;
+                const uint32_t sampler_variable = sampled_image ? ids_[in[4]].sampler_variable : kNone;
+                Id& value = ids_[id];
+                value.type = type;
+                value.image_variable = image_variable;
+                value.sampler_variable = sampler_variable;
+                return image_variable != kNone && (!sampled_image || sampler_variable != kNone);
+            }
+            case SpvOp::ImageSampleImplicitLod:
+            case SpvOp::ImageSampleExplicitLod:
+                return EmitSample(in);
+            case SpvOp::DPdx:
+            case SpvOp::DPdxFine: return EmitDerivative(ShaderOp::DPdx, type, id, in[3]);
+            case SpvOp::DPdy:
+            case SpvOp::DPdyFine: return EmitDerivative(ShaderOp::DPdy, type, id, in[3]);
+            case SpvOp::DPdxCoarse: return EmitDerivative(ShaderOp::DPdxCoarse, type, id, in[3]);
+            case SpvOp::DPdyCoarse: return EmitDerivative(ShaderOp::DPdyCoarse, type, id, in[3]);
+            case SpvOp::Fwidth:
+            case SpvOp::FwidthFine: return EmitFwidth(ShaderOp::DPdx, ShaderOp::DPdy, type, id, in[3]);
+            case SpvOp::FwidthCoarse: return EmitFwidth(ShaderOp::DPdxCoarse, ShaderOp::DPdyCoarse, type, id, in[3]);
+            default:
+                return false;
+        }
+    }
+    // Set the b operand of the instruction just emitted, for the index of ExtractDynamic
+    bool SetOperandB(uint32_t id) {
+        const uint32_t reg = Register(id);
+        if (reg == kNone) return false;
+        program_->code.back().b = reg;
+        return true;
+    }
+
+    const uint32_t* words_;
+    size_t word_count_;
+    std::vector<Id> ids_;
+    std::unique_ptr<ShaderProgram> program_;
+    const VkSpecializationInfo* specialization_ = nullptr;
+    uint32_t entry_function_ = 0;
+    uint32_t glsl_std_450_ = 0;
+    uint32_t float_type_ = 0;
+    uint32_t execution_model_ = 0;
+    std::vector<uint32_t> interface_;  // Input and output variables of the entry point
+    uint32_t next_register_ = 0;
+    uint32_t call_depth_ = 0;
+    std::unordered_map<uint32_t, uint32_t> constant_registers_;
+    std::vector<std::pair<uint32_t, uint32_t>> initializers_;  // Private variables and their initial values
+};
+
+std::unique_ptr<ShaderProgram> CompileShader(const uint32_t* words, size_t word_count, const char* entry_point, uint32_t execution_model,
+                                             const VkSpecializationInfo* specialization) {
+    ShaderCompiler compiler(words, word_count);
+    return compiler.Compile(entry_point, execution_model, specialization);
+}
+
+enum class ShaderLaneState : uint8_t { Running, Blocked, Done };
+
+// State of the invocations a thread runs, reused between runs of the same program
+struct ShaderScratch {
+    uint64_t program_serial = 0;
+    uint32_t lane_count = 0;
+    std::vector<ShaderValue> registers;  // Component k of register r of lane l is at (r + k) * lane_count + l
+    std::vector<uint32_t> lane_memory;   // As words, so that atomics on it are aligned
+    std::vector<uint32_t> workgroup_memory;
+    std::vector<ShaderMemoryRange> memory;  // Of each variable
+    std::vector<uint32_t> pcs;
+    std::vector<ShaderLaneState> lane_states;
+    std::vector<uint32_t> lanes;  // At the program counter that runs next
+    uint64_t steps_left = 0;      // Jumps the invocations may still take before they are stopped
+    std::vector<uint8_t> killed;  // Lanes of fragment shaders that were discarded
+    const ShaderTexture* textures = nullptr;  // Per texture of the program, set by the caller
+
+    uint8_t* LaneMemory(uint32_t lane) { return reinterpret_cast<uint8_t*>(lane_memory.data()) + (size_t)lane * lane_memory_stride(); }
+    uint32_t lane_memory_stride() const { return lane_count ? (uint32_t)(lane_memory.size() / lane_count * sizeof(uint32_t)) : 0; }
+};
+
+// Get scratch ready to run lane_count invocations of program. bound_memory holds the memory of the PushConstant and
+// Buffer variables of the program, the memory of the others is in the scratch.
+static void PrepareShaderScratch(const ShaderProgram& program, uint32_t lane_count, const ShaderMemoryRange* bound_memory,
+                                 ShaderScratch* scratch) {
+    if (scratch->program_serial != program.serial || scratch->lane_count != lane_count) {
+        scratch->program_serial = program.serial;
+        scratch->lane_count = lane_count;
+        scratch->registers.assign((size_t)program.register_count * lane_count, ShaderValue());
+        for (const auto& constant : program.constants) {
+            std::fill_n(scratch->registers.begin() + (size_t)constant.first * lane_count, lane_count, constant.second);
+        }
+        scratch->lane_memory.assign((size_t)program.lane_memory_size / sizeof(uint32_t) * lane_count, 0);
+        scratch->workgroup_memory.assign(program.workgroup_memory_size / sizeof(uint32_t), 0);
+        scratch->pcs.resize(lane_count);
+        scratch->lane_states.resize(lane_count);
+        scratch->lanes.resize(lane_count);
+        scratch->killed.resize(lane_count);
+    }
+    scratch->memory.resize(program.variables.size());
+    for (size_t i = 0; i < program.variables.size(); ++i) {
+        const auto& variable = program.variables[i];
+        auto& memory = scratch->memory[i];
+        switch (variable.memory) {
+            case ShaderMemory::Lane:
+                memory = ShaderMemoryRange{reinterpret_cast<uint8_t*>(scratch->lane_memory.data()) + variable.offset, variable.size,
+                                           program.lane_memory_size};
+                break;
+            case ShaderMemory::Workgroup:
+                memory = ShaderMemoryRange{reinterpret_cast<uint8_t*>(scratch->workgroup_memory.data()) + variable.offset, variable.size, 0};
+                break;
+            case ShaderMemory::PushConstant:
+            case ShaderMemory::Buffer:
+                memory = bound_memory[i];
+                break;
+            case ShaderMemory::Opaque:
+                memory = ShaderMemoryRange{nullptr, 0, 0};
+                break;
+        }
+    }
+}
+
+// Invocations that run an instruction. Dense sets are lanes [0, count), which the loops over lanes vectorize.
+struct ShaderLaneSet {
+    const uint32_t* lanes;
+    uint32_t count;
+    bool dense;
+};
+
+template <typename Func>
+static inline void ForEachLane(const ShaderLaneSet& set, Func func) {
+    if (set.dense) {
+        for (uint32_t lane = 0; lane < set.count; ++lane) func(lane);
+    } else {
+        for (uint32_t i = 0; i < set.count; ++i) func(set.lanes[i]);
+    }
+}
+
+// Run func(a, b, c) for every component of every lane of the set
+template <typename Func>
+static inline void ShaderComponentwise(const ShaderInstruction& in, const ShaderLaneSet& set, ShaderValue* registers, uint32_t stride,
+                                       Func func) {
+    for (uint32_t k = 0; k < in.count; ++k) {
+        ShaderValue* dst = registers + (size_t)(in.dst + k) * stride;
+        const ShaderValue* a = registers + (size_t)(in.a + ((in.scalar_operands & 1) ? 0 : k)) * stride;
+        const ShaderValue* b = registers + (size_t)(in.b + ((in.scalar_operands & 2) ? 0 : k)) * stride;
+        const ShaderValue* c = registers + (size_t)(in.c + ((in.scalar_operands & 4) ? 0 : k)) * stride;
+        if (set.dense) {
+            for (uint32_t lane = 0; lane < set.count; ++lane) dst[lane] = func(a[lane], b[lane], c[lane]);
+        } else {
+            for (uint32_t i = 0; i < set.count; ++i) {
+                const uint32_t lane = set.lanes[i];
+                dst[lane] = func(a[lane], b[lane], c[lane]);
+            }
+        }
+    }
+}
+
+static inline uint32_t ShaderFToU(float f) { return f >= 4294967296.0f ? UINT32_MAX : f > 0.0f ? (uint32_t)f : 0; }
+static inline int32_t ShaderFToS(float f) {
+    if (f != f) return 0;
+    return f >= 2147483648.0f ? INT32_MAX : f <= -2147483648.0f ? INT32_MIN : (int32_t)f;
+}
+static inline uint32_t ShaderBitCount(uint32_t u) {
+    uint32_t count = 0;
+    for (; u; u &= u - 1) ++count;
+    return count;
+}
+static inline int32_t ShaderFindMsb(uint32_t u) {
+    int32_t msb = -1;
+    for (; u; u >>= 1) ++msb;
+    return msb;
+}
+static inline int32_t ShaderFindLsb(uint32_t u) {
+    if (!u) return -1;
+    int32_t lsb = 0;
+    for (; !(u & 1); u >>= 1) ++lsb;
+    return lsb;
+}
+static inline float ShaderClamp(float x, float lo, float hi) { return std::fmin(std::fmax(x, lo), hi); }
+
+// Address of the 4 bytes at offset in the memory of a lane, null if they're out of bounds
+static inline uint8_t* ShaderAddress(const ShaderMemoryRange& memory, uint32_t lane, uint64_t offset) {
+    if (!memory.base || offset + sizeof(uint32_t) > memory.size) return nullptr;
+    return memory.base + (size_t)lane * memory.lane_stride + offset;
+}
+static inline std::atomic<uint32_t>* ShaderAtomicAddress(const ShaderMemoryRange& memory, uint32_t lane, uint32_t offset) {
+    uint8_t* address = ShaderAddress(memory, lane, offset);
+    if (!address || ((uintptr_t)address & 3)) return nullptr;
+    return reinterpret_cast<std::atomic<uint32_t>*>(address);
+}
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Atomics must work in place on shader memory");
+
+template <typename Func>
+static inline uint32_t ShaderAtomicUpdate(std::atomic<uint32_t>* target, Func func) {
+    uint32_t old = target->load(std::memory_order_relaxed);
+    while (!target->compare_exchange_weak(old, func(old))) {
+    }
+    return old;
+}
+
+static void ExecuteAtomic(const ShaderInstruction& in, const ShaderLaneSet& set, ShaderValue* registers, uint32_t stride,
+                          const ShaderMemoryRange& memory) {
+    const ShaderValue* pointer = registers + (size_t)in.a * stride;
+    const ShaderValue* value = registers + (size_t)in.b * stride;
+    const ShaderValue* comparator = registers + (size_t)in.c * stride;
+    ShaderValue* dst = registers + (size_t)in.dst * stride;
+    ForEachLane(set, [&](uint32_t lane) {
+        std::atomic<uint32_t>* target = ShaderAtomicAddress(memory, lane, pointer[lane].u);
+        if (!target) {
+            if (in.op != ShaderOp::AtomicStore) dst[lane].u = 0;
+            return;
+        }
+        const uint32_t v = value[lane].u;
+        uint32_t old = 0;
+        switch (in.op) {
+            case ShaderOp::AtomicLoad: old = target->load(); break;
+            case ShaderOp::AtomicStore: target->store(v); return;
+            case ShaderOp::AtomicExchange: old = target->exchange(v); break;
+            case ShaderOp::AtomicCompareExchange:
+                old = comparator[lane].u;
+                target->compare_exchange_strong(old, v);
+                break;
+            case ShaderOp::AtomicAdd: old = target->fetch_add(v); break;
+            case ShaderOp::AtomicSub: old = target->fetch_sub(v); break;
+            case ShaderOp::AtomicAnd: old = target->fetch_and(v); break;
+            case ShaderOp::AtomicOr: old = target->fetch_or(v); break;
+            case ShaderOp::AtomicXor: old = target->fetch_xor(v); break;
+            case ShaderOp::AtomicUMin: old = ShaderAtomicUpdate(target, [=](uint32_t x) { return (std::min)(x, v); }); break;
+            case ShaderOp::AtomicUMax: old = ShaderAtomicUpdate(target, [=](uint32_t x) { return (std::max)(x, v); }); break;
+            case ShaderOp::AtomicSMin:
+                old = ShaderAtomicUpdate(target, [=](uint32_t x) { return (int32_t)x < (int32_t)v ? x : v; });
+                break;
+            case ShaderOp::AtomicSMax:
+                old = ShaderAtomicUpdate(target, [=](uint32_t x) { return (int32_t)x > (int32_t)v ? x : v; });
+                break;
+            default: break;
+        }
+        dst[lane].u = old;
+    });
+}
+
+TexelFormat GetTexelFormat(VkFormat format) {
+    static constexpr TexelType kTypes[7] = {TexelType::Unorm,   TexelType::Snorm, TexelType::Uscaled, TexelType::Sscaled,
+                                            TexelType::Uint,    TexelType::Sint,  TexelType::Srgb};
+    static constexpr TexelType kTypes16[7] = {TexelType::Unorm, TexelType::Snorm, TexelType::Uscaled, TexelType::Sscaled,
+                                              TexelType::Uint,  TexelType::Sint,  TexelType::Float};
+    static constexpr TexelType kTypes32[3] = {TexelType::Uint, TexelType::Sint, TexelType::Float};
+    if (format >= VK_FORMAT_R8_UNORM && format <= VK_FORMAT_A8B8G8R8_SRGB_PACK32) {
+        // R, RG, RGB, BGR, RGBA, BGRA and packed ABGR, which is RGBA in memory
+        static constexpr uint8_t kComponents[7] = {1, 2, 3, 3, 4, 4, 4};
+        const uint32_t group = (format - VK_FORMAT_R8_UNORM) / 7;
+        return {kTypes[(format - VK_FORMAT_R8_UNORM) % 7], kComponents[group], 8, group == 3 || group == 5};
+    }
+    if (format >= VK_FORMAT_R16_UNORM && format <= VK_FORMAT_R16G16B16A16_SFLOAT) {
+        return {kTypes16[(format - VK_FORMAT_R16_UNORM) % 7], (uint8_t)((format - VK_FORMAT_R16_UNORM) / 7 + 1), 16, false};
+    }
+    if (format >= VK_FORMAT_R32_UINT && format <= VK_FORMAT_R32G32B32A32_SFLOAT) {
+        return {kTypes32[(format - VK_FORMAT_R32_UINT) % 3], (uint8_t)((format - VK_FORMAT_R32_UINT) / 3 + 1), 32, false};
+    }
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+            return {TexelType::Unorm, 1, 16, false};
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+            return {TexelType::Unorm, 1, 24, false};
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return {TexelType::Float, 1, 32, false};
+        default:
+            return {TexelType::Unorm, 0, 0, false};
+    }
+}
+
+static inline bool IsIntegerTexel(const TexelFormat& format) { return format.type == TexelType::Uint || format.type == TexelType::Sint; }
+
+static float HalfToFloat(uint16_t half) {
+    const uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1F, mantissa = half & 0x3FF;
+    if (!exponent) {
+        const float denormal = std::ldexp((float)mantissa, -24);
+        return sign ? -denormal : denormal;
+    }
+    const uint32_t bits = sign | (exponent == 31 ? 0x7F800000 : (exponent + 112) << 23) | (mantissa << 13);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Rounds to nearest even
+static uint16_t FloatToHalf(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const uint16_t sign = (bits >> 16) & 0x8000;
+    const uint32_t magnitude = bits & 0x7FFFFFFF;
+    if (magnitude > 0x7F800000) return sign | 0x7E00;
+    if (magnitude >= 0x477FF000) return sign | 0x7C00;
+    if (magnitude < 0x38800000) {
+        float value;
+        std::memcpy(&value, &magnitude, sizeof(value));
+        return sign | (uint16_t)std::nearbyint(value * 16777216.0f);
+    }
+    return sign | (uint16_t)((magnitude + 0xFFF + ((magnitude >> 13) & 1) - 0x38000000) >> 13);
+}
+
+static float SrgbToLinear(uint32_t c) {
+    static const auto table = [] {
+        std::array<float, 256> linear;
+        for (uint32_t i = 0; i < 256; ++i) {
+            const float s = i / 255.0f;
+            linear[i] = s <= 0.04045f ? s / 12.92f : std::pow((s + 0.055f) / 1.055f, 2.4f);
+        }
+        return linear;
+    }();
+    return table[c & 0xFF];
+}
+
+static float Unorm8ToFloat(uint32_t c) {
+    static const auto table = [] {
+        std::array<float, 256> unorm;
+        for (uint32_t i = 0; i < 256; ++i) unorm[i] = i / 255.0f;
+        return unorm;
+    }();
+    return table[c & 0xFF];
+}
+
+static float LinearToSrgb(float c) { return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f; }
+
+static ShaderValue DecodeTexelComponent(TexelType type, uint32_t bits, uint32_t raw) {
+    const uint32_t max = bits == 32 ? UINT32_MAX : (1u << bits) - 1;
+    const int32_t sign_extended = (int32_t)(raw << (32 - bits)) >> (32 - bits);
+    switch (type) {
+        case TexelType::Unorm: return ShaderF(bits == 8 ? Unorm8ToFloat(raw) : (float)((double)raw / max));
+        case TexelType::Snorm: return ShaderF((std::max)((float)sign_extended / (float)(max >> 1), -1.0f));
+        case TexelType::Uscaled: return ShaderF((float)raw);
+        case TexelType::Sscaled: return ShaderF((float)sign_extended);
+        case TexelType::Uint: return ShaderU(raw);
+        case TexelType::Sint: return ShaderI(sign_extended);
+        case TexelType::Srgb: return ShaderF(SrgbToLinear(raw));
+        case TexelType::Float: break;
+    }
+    if (bits == 16) return ShaderF(HalfToFloat((uint16_t)raw));
+    return ShaderU(raw);
+}
+
+static uint32_t EncodeTexelComponent(TexelType type, uint32_t bits, ShaderValue value) {
+    const uint32_t max = bits == 32 ? UINT32_MAX : (1u << bits) - 1;
+    const int32_t signed_max = (int32_t)(max >> 1);
+    switch (type) {
+        case TexelType::Unorm: return (uint32_t)std::lround(ShaderClamp(value.f, 0.0f, 1.0f) * (double)max);
+        case TexelType::Snorm: return (uint32_t)std::lround(ShaderClamp(value.f, -1.0f, 1.0f) * signed_max) & max;
+        case TexelType::Uscaled: return (uint32_t)ShaderClamp(std::nearbyint(value.f), 0.0f, (float)max);
+        case TexelType::Sscaled:
+            return (uint32_t)(int32_t)ShaderClamp(std::nearbyint(value.f), (float)(-signed_max - 1), (float)signed_max) & max;
+        case TexelType::Uint: return (std::min)(value.u, max);
+        case TexelType::Sint: return (uint32_t)(std::max)((std::min)(value.i, signed_max), -signed_max - 1) & max;
+        case TexelType::Srgb: return (uint32_t)std::lround(LinearToSrgb(ShaderClamp(value.f, 0.0f, 1.0f)) * 255.0f);
+        case TexelType::Float: break;
+    }
+    return bits == 16 ? FloatToHalf(value.f) : value.u;
+}
+
+// Components are 1, 2, 3 or 4 bytes. Sizes known at compile time let memcpy compile into plain loads and stores.
+static inline uint32_t ReadTexelComponent(const uint8_t* p, uint32_t bytes) {
+    uint32_t raw = 0;
+    switch (bytes) {
+        case 1: return *p;
+        case 2: std::memcpy(&raw, p, 2); return raw;
+        case 3: std::memcpy(&raw, p, 3); return raw;
+        default: std::memcpy(&raw, p, 4); return raw;
+    }
+}
+static inline void WriteTexelComponent(uint8_t* p, uint32_t bytes, uint32_t raw) {
+    switch (bytes) {
+        case 1: *p = (uint8_t)raw; break;
+        case 2: std::memcpy(p, &raw, 2); break;
+        case 3: std::memcpy(p, &raw, 3); break;
+        default: std::memcpy(p, &raw, 4); break;
+    }
+}
+
+// Texels read as RGBA, with the components the format doesn't have as 0, 0, 0 and 1. The alpha of sRGB formats is
+// linear.
+static void DecodeTexel(const TexelFormat& format, const uint8_t* texel, ShaderValue* rgba) {
+    const bool integer = IsIntegerTexel(format);
+    rgba[0] = rgba[1] = rgba[2] = integer ? ShaderU(0) : ShaderF(0.0f);
+    rgba[3] = integer ? ShaderU(1) : ShaderF(1.0f);
+    const uint32_t bytes = format.bits / 8;
+    for (uint32_t i = 0; i < format.components; ++i) {
+        const uint32_t raw = ReadTexelComponent(texel + i * bytes, bytes);
+        const uint32_t c = format.bgr && i < 3 ? 2 - i : i;
+        rgba[c] = DecodeTexelComponent(format.type == TexelType::Srgb && c == 3 ? TexelType::Unorm : format.type, format.bits, raw);
+    }
+}
+
+void EncodeTexel(const TexelFormat& format, const ShaderValue* rgba, uint32_t write_mask, uint8_t* texel) {
+    const uint32_t bytes = format.bits / 8;
+    for (uint32_t i = 0; i < format.components; ++i) {
+        const uint32_t c = format.bgr && i < 3 ? 2 - i : i;
+        if (!(write_mask & (1u << c))) continue;
+        const uint32_t raw =
+            EncodeTexelComponent(format.type == TexelType::Srgb && c == 3 ? TexelType::Unorm : format.type, format.bits, rgba[c]);
+        WriteTexelComponent(texel + i * bytes, bytes, raw);
+    }
+}
+
+static int32_t AddressTexel(int32_t i, int32_t size, VkSamplerAddressMode mode) {
+    switch (mode) {
+        case VK_SAMPLER_ADDRESS_MODE_REPEAT:
+            i %= size;
+            return i < 0 ? i + size : i;
+        case VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT: {
+            int32_t mirrored = i % (2 * size);
+            if (mirrored < 0) mirrored += 2 * size;
+            return mirrored < size ? mirrored : 2 * size - 1 - mirrored;
+        }
+        case VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER:
+            return i < 0 || i >= size ? -1 : i;
+        case VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE:
+            return (std::min)(i < 0 ? -1 - i : i, size - 1);
+        default:
+            return (std::max)((std::min)(i, size - 1), 0);
+    }
+}
+
+static inline int32_t TexelIndex(float x) { return (int32_t)std::floor(ShaderClamp(x, -16777216.0f, 16777216.0f)); }
+
+static void FetchTexel(const ShaderTexture& texture, const ShaderTexture::Level& level, int32_t x, int32_t y, uint32_t layer,
+                       ShaderValue* rgba) {
+    if (x < 0 || y < 0) {
+        std::copy_n(texture.border, 4, rgba);
+        return;
+    }
+    DecodeTexel(texture.format, level.base + layer * level.layer_pitch + y * level.row_pitch + (size_t)x * texture.texel_size, rgba);
+}
+
+static void SampleLevel(const ShaderTexture& texture, uint32_t level_index, bool linear, float u, float v, uint32_t layer,
+                        ShaderValue* rgba) {
+    const ShaderTexture::Level& level = texture.levels[level_index];
+    const int32_t width = (int32_t)level.width, height = (int32_t)level.height;
+    const float x = texture.unnormalized ? u : u * width;
+    const float y = texture.dimensions < 2 ? 0.5f : texture.unnormalized ? v : v * height;
+    if (!linear) {
+        FetchTexel(texture, level, AddressTexel(TexelIndex(x), width, texture.address_modes[0]),
+                   AddressTexel(TexelIndex(y), height, texture.address_modes[1]), layer, rgba);
+        return;
+    }
+    const float fx = x - 0.5f, fy = y - 0.5f;
+    const float x0 = std::floor(fx), y0 = std::floor(fy);
+    const float a = fx - x0, b = texture.dimensions < 2 ? 0.0f : fy - y0;
+    const int32_t i0 = TexelIndex(x0), j0 = TexelIndex(y0);
+    const int32_t i[2] = {AddressTexel(i0, width, texture.address_modes[0]), AddressTexel(i0 + 1, width, texture.address_modes[0])};
+    const int32_t j[2] = {AddressTexel(j0, height, texture.address_modes[1]), AddressTexel(j0 + 1, height, texture.address_modes[1])};
+    const float weights[4] = {(1 - a) * (1 - b), a * (1 - b), (1 - a) * b, a * b};
+    float sum[4] = {};
+    for (uint32_t corner = 0; corner < 4; ++corner) {
+        if (!weights[corner]) continue;
+        ShaderValue texel[4];
+        FetchTexel(texture, level, i[corner & 1], j[corner >> 1], layer, texel);
+        for (uint32_t c = 0; c < 4; ++c) sum[c] += weights[corner] * texel[c].f;
+    }
+    for (uint32_t c = 0; c < 4; ++c) rgba[c] = ShaderF(sum[c]);
+}
+
+// Sample a texture for a lane at the coordinates of registers coordinates. The level of detail of implicit lods
+// comes from the differences between the coordinates of the lanes of its quad, like a GPU does.
+static void SampleTexture(const ShaderTexture& texture, uint32_t mode, const ShaderValue* coordinates, float lod, uint32_t stride,
+                          uint32_t lane, ShaderValue* result) {
+    if (!texture.level_count) {
+        std::fill_n(result, 4, ShaderU(0));
+        return;
+    }
+    auto coordinate = [&](uint32_t k, uint32_t l) { return coordinates[(size_t)k * stride + l].f; };
+    const float u = coordinate(0, lane), v = texture.dimensions > 1 ? coordinate(1, lane) : 0.0f;
+    float lambda = 0.0f;
+    if (!texture.unnormalized) {
+        if (mode == kSampleExplicitLod) {
+            lambda = lod;
+        } else {
+            const uint32_t quad = lane & ~3u;
+            const float width = (float)texture.levels[0].width, height = (float)texture.levels[0].height;
+            const float dudx = (coordinate(0, quad + 1) - coordinate(0, quad)) * width;
+            const float dudy = (coordinate(0, quad + 2) - coordinate(0, quad)) * width;
+            const float dvdx = texture.dimensions > 1 ? (coordinate(1, quad + 1) - coordinate(1, quad)) * height : 0.0f;
+            const float dvdy = texture.dimensions > 1 ? (coordinate(1, quad + 2) - coordinate(1, quad)) * height : 0.0f;
+            lambda = std::log2((std::max)(std::sqrt(dudx * dudx + dvdx * dvdx), std::sqrt(dudy * dudy + dvdy * dvdy)));
+            if (mode == kSampleBias) lambda += lod;
+        }
+        lambda = ShaderClamp(lambda + texture.lod_bias, texture.min_lod, texture.max_lod);
+    }
+    const bool integer = IsIntegerTexel(texture.format);
+    const bool magnify = lambda <= 0.0f;
+    const bool linear = !integer && (magnify ? texture.mag_linear : texture.min_linear);
+    uint32_t layer = 0;
+    if (texture.layer_count > 1 && coordinate(texture.dimensions, lane) > 0.0f) {
+        layer = (uint32_t)(std::min)(std::nearbyint(coordinate(texture.dimensions, lane)), (float)(texture.layer_count - 1));
+    }
+    const float last = (float)(texture.level_count - 1);
+    ShaderValue texel[4];
+    if (magnify || integer || !texture.mip_linear) {
+        const uint32_t level = magnify ? 0 : (uint32_t)(std::min)(std::ceil(lambda + 0.5f) - 1.0f, last);
+        SampleLevel(texture, level, linear, u, v, layer, texel);
+    } else {
+        const float d = (std::min)(lambda, last);
+        const uint32_t level = (uint32_t)d;
+        const float fraction = d - level;
+        ShaderValue next[4];
+        SampleLevel(texture, level, linear, u, v, layer, texel);
+        SampleLevel(texture, (std::min)(level + 1, texture.level_count - 1), linear, u, v, layer, next);
+        for (uint32_t c = 0; c < 4; ++c) texel[c] = ShaderF(texel[c].f + (next[c].f - texel[c].f) * fraction);
+    }
+    for (uint32_t c = 0; c < 4; ++c) {
+        const uint8_t source = texture.swizzle[c];
+        result[c] = source < 4 ? texel[source] : source == 4 ? ShaderU(0) : integer ? ShaderU(1) : ShaderF(1.0f);
+    }
+}
+
+static void ExecuteSample(const ShaderInstruction& in, const ShaderLaneSet& set, ShaderValue* registers, uint32_t stride,
+                          const ShaderTexture& texture) {
+    ShaderValue* dst = registers + (size_t)in.dst * stride;
+    const ShaderValue* coordinates = registers + (size_t)in.a * stride;
+    const ShaderValue* lod = registers + (size_t)in.b * stride;
+    ForEachLane(set, [&](uint32_t lane) {
+        ShaderValue texel[4];
+        SampleTexture(texture, in.c, coordinates, in.c == kSampleImplicitLod ? 0.0f : lod[lane].f, stride, lane, texel);
+        for (uint32_t c = 0; c < 4; ++c) dst[(size_t)c * stride + lane] = texel[c];
+    });
+}
+
+// Differences between the lanes of the 2x2 quads of fragment shaders
+static void ExecuteDerivative(const ShaderInstruction& in, const ShaderLaneSet& set, ShaderValue* registers, uint32_t stride) {
+    for (uint32_t k = 0; k < in.count; ++k) {
+        ShaderValue* dst = registers + (size_t)(in.dst + k) * stride;
+        const ShaderValue* a = registers + (size_t)(in.a + ((in.scalar_operands & 1) ? 0 : k)) * stride;
+        ForEachLane(set, [&](uint32_t lane) {
+            const uint32_t quad = lane & ~3u;
+            uint32_t from;
+            uint32_t to;
+            switch (in.op) {
+                case ShaderOp::DPdx:
+                    from = quad + (lane & 2);
+                    to = from + 1;
+                    break;
+                case ShaderOp::DPdy:
+                    from = quad + (lane & 1);
+                    to = from + 2;
+                    break;
+                case ShaderOp::DPdxCoarse:
+                    from = quad;
+                    to = quad + 1;
+                    break;
+                default:
+                    from = quad;
+                    to = quad + 2;
+                    break;
+            }
+            dst[lane] = ShaderF(a[to].f - a[from].f);
+        });
+    }
+}
+
+// Run the instructions of program from pc for the lanes of set, which are all at pc, up to the next instruction that
+// moves them apart. live_count is the number of lanes that haven't exited.
+static void ExecuteShaderBlock(const ShaderProgram& program, uint32_t pc, const ShaderLaneSet& set, uint32_t live_count,
+                               ShaderScratch* scratch) {
+    ShaderValue* r = scratch->registers.data();
+    const uint32_t stride = scratch->lane_count;
+    uint32_t* pcs = scratch->pcs.data();
+    auto move_to = [&](uint32_t target) { ForEachLane(set, [&](uint32_t lane) { pcs[lane] = target; }); };
+    for (;; ++pc) {
+        const ShaderInstruction& in = program.code[pc];
+        switch (in.op) {
+            case ShaderOp::Mov: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return a; }); break;
+            case ShaderOp::FNegate: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(-a.f); }); break;
+            case ShaderOp::FAbs: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::fabs(a.f)); }); break;
+            case ShaderOp::FSign:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(a.f > 0.0f ? 1.0f : a.f < 0.0f ? -1.0f : 0.0f); });
+                break;
+            case ShaderOp::Floor: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::floor(a.f)); }); break;
+            case ShaderOp::Ceil: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::ceil(a.f)); }); break;
+            case ShaderOp::Trunc: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::trunc(a.f)); }); break;
+            case ShaderOp::Round: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::round(a.f)); }); break;
+            case ShaderOp::RoundEven: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::nearbyint(a.f)); }); break;
+            case ShaderOp::Fract: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(a.f - std::floor(a.f)); }); break;
+            case ShaderOp::Sqrt: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::sqrt(a.f)); }); break;
+            case ShaderOp::InverseSqrt: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(1.0f / std::sqrt(a.f)); }); break;
+            case ShaderOp::Exp: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::exp(a.f)); }); break;
+            case ShaderOp::Exp2: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::exp2(a.f)); }); break;
+            case ShaderOp::Log: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::log(a.f)); }); break;
+            case ShaderOp::Log2: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::log2(a.f)); }); break;
+            case ShaderOp::Sin: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::sin(a.f)); }); break;
+            case ShaderOp::Cos: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::cos(a.f)); }); break;
+            case ShaderOp::Tan: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::tan(a.f)); }); break;
+            case ShaderOp::Asin: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::asin(a.f)); }); break;
+            case ShaderOp::Acos: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::acos(a.f)); }); break;
+            case ShaderOp::Atan: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::atan(a.f)); }); break;
+            case ShaderOp::Sinh: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::sinh(a.f)); }); break;
+            case ShaderOp::Cosh: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::cosh(a.f)); }); break;
+            case ShaderOp::Tanh: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF(std::tanh(a.f)); }); break;
+            case ShaderOp::IsNan: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(std::isnan(a.f) ? 1 : 0); }); break;
+            case ShaderOp::IsInf: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(std::isinf(a.f) ? 1 : 0); }); break;
+            case ShaderOp::ConvertFToU: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(ShaderFToU(a.f)); }); break;
+            case ShaderOp::ConvertFToS: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderI(ShaderFToS(a.f)); }); break;
+            case ShaderOp::FAdd: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(a.f + b.f); }); break;
+            case ShaderOp::FSub: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(a.f - b.f); }); break;
+            case ShaderOp::FMul: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(a.f * b.f); }); break;
+            case ShaderOp::FDiv: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(a.f / b.f); }); break;
+            case ShaderOp::FRem: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(std::fmod(a.f, b.f)); }); break;
+            case ShaderOp::FMod:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(a.f - b.f * std::floor(a.f / b.f)); });
+                break;
+            case ShaderOp::FMin: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(std::fmin(a.f, b.f)); }); break;
+            case ShaderOp::FMax: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(std::fmax(a.f, b.f)); }); break;
+            case ShaderOp::Atan2: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(std::atan2(a.f, b.f)); }); break;
+            case ShaderOp::Pow: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(std::pow(a.f, b.f)); }); break;
+            case ShaderOp::Step: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderF(b.f < a.f ? 0.0f : 1.0f); }); break;
+            case ShaderOp::FOrdEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.f == b.f); }); break;
+            case ShaderOp::FOrdNotEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.f < b.f || a.f > b.f); }); break;
+            case ShaderOp::FOrdLess: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.f < b.f); }); break;
+            case ShaderOp::FOrdLessEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.f <= b.f); }); break;
+            case ShaderOp::FUnordEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(!(a.f < b.f || a.f > b.f)); }); break;
+            case ShaderOp::FUnordNotEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.f != b.f); }); break;
+            case ShaderOp::FUnordLess: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(!(a.f >= b.f)); }); break;
+            case ShaderOp::FUnordLessEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(!(a.f > b.f)); }); break;
+            case ShaderOp::FClamp:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return ShaderF(ShaderClamp(a.f, b.f, c.f)); });
+                break;
+            case ShaderOp::FMix:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return ShaderF(a.f + (b.f - a.f) * c.f); });
+                break;
+            case ShaderOp::SmoothStep:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) {
+                    const float t = ShaderClamp((c.f - a.f) / (b.f - a.f), 0.0f, 1.0f);
+                    return ShaderF(t * t * (3.0f - 2.0f * t));
+                });
+                break;
+            case ShaderOp::Fma: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return ShaderF(a.f * b.f + c.f); }); break;
+            case ShaderOp::SNegate: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(0u - a.u); }); break;
+            case ShaderOp::SAbs: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(a.i < 0 ? 0u - a.u : a.u); }); break;
+            case ShaderOp::SSign: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderI(a.i > 0 ? 1 : a.i < 0 ? -1 : 0); }); break;
+            case ShaderOp::Not: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(~a.u); }); break;
+            case ShaderOp::BitCount: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(ShaderBitCount(a.u)); }); break;
+            case ShaderOp::FindILsb: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderI(ShaderFindLsb(a.u)); }); break;
+            case ShaderOp::FindSMsb:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderI(ShaderFindMsb(a.i < 0 ? ~a.u : a.u)); });
+                break;
+            case ShaderOp::FindUMsb: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderI(ShaderFindMsb(a.u)); }); break;
+            case ShaderOp::ConvertSToF: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF((float)a.i); }); break;
+            case ShaderOp::ConvertUToF: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderF((float)a.u); }); break;
+            case ShaderOp::LogicalNot: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue, ShaderValue) { return ShaderU(a.u ^ 1); }); break;
+            case ShaderOp::IAdd: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u + b.u); }); break;
+            case ShaderOp::ISub: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u - b.u); }); break;
+            case ShaderOp::IMul: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u * b.u); }); break;
+            // Division by zero is undefined, it gives 0 rather than trapping
+            case ShaderOp::UDiv: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(b.u ? a.u / b.u : 0); }); break;
+            case ShaderOp::UMod: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(b.u ? a.u % b.u : 0); }); break;
+            case ShaderOp::SDiv:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) {
+                    return b.i == 0 ? ShaderI(0) : b.i == -1 ? ShaderU(0u - a.u) : ShaderI(a.i / b.i);
+                });
+                break;
+            case ShaderOp::SRem:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderI(b.i == 0 || b.i == -1 ? 0 : a.i % b.i); });
+                break;
+            case ShaderOp::SMod:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) {
+                    if (b.i == 0 || b.i == -1) return ShaderI(0);
+                    const int32_t rem = a.i % b.i;
+                    return ShaderI(rem && ((rem < 0) != (b.i < 0)) ? rem + b.i : rem);
+                });
+                break;
+            case ShaderOp::ShiftLeft: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u << (b.u & 31)); }); break;
+            case ShaderOp::ShiftRightLogical: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u >> (b.u & 31)); }); break;
+            case ShaderOp::ShiftRightArithmetic:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) {
+                    const uint32_t shift = b.u & 31;
+                    return ShaderU(a.i < 0 ? ~(~a.u >> shift) : a.u >> shift);
+                });
+                break;
+            case ShaderOp::BitAnd: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u & b.u); }); break;
+            case ShaderOp::BitOr: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u | b.u); }); break;
+            case ShaderOp::BitXor: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u ^ b.u); }); break;
+            case ShaderOp::UMin: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return a.u < b.u ? a : b; }); break;
+            case ShaderOp::UMax: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return a.u > b.u ? a : b; }); break;
+            case ShaderOp::SMin: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return a.i < b.i ? a : b; }); break;
+            case ShaderOp::SMax: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return a.i > b.i ? a : b; }); break;
+            case ShaderOp::IEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u == b.u); }); break;
+            case ShaderOp::INotEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u != b.u); }); break;
+            case ShaderOp::ULess: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u < b.u); }); break;
+            case ShaderOp::ULessEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.u <= b.u); }); break;
+            case ShaderOp::SLess: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.i < b.i); }); break;
+            case ShaderOp::SLessEqual: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue) { return ShaderU(a.i <= b.i); }); break;
+            case ShaderOp::UClamp:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return ShaderU((std::min)((std::max)(a.u, b.u), c.u)); });
+                break;
+            case ShaderOp::SClamp:
+                ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return ShaderI((std::min)((std::max)(a.i, b.i), c.i)); });
+                break;
+            case ShaderOp::Select: ShaderComponentwise(in, set, r, stride, [](ShaderValue a, ShaderValue b, ShaderValue c) { return a.u ? b : c; }); break;
+            case ShaderOp::Dot:
+            case ShaderOp::Length:
+            case ShaderOp::Any:
+            case ShaderOp::All:
+            case ShaderOp::Normalize:
+            case ShaderOp::Cross:
+            case ShaderOp::Reflect:
+            case ShaderOp::ExtractDynamic:
+            case ShaderOp::InsertDynamic: {
+                const uint32_t count = in.count;
+                ShaderValue* dst = r + (size_t)in.dst * stride;
+                const ShaderValue* a = r + (size_t)in.a * stride;
+                const ShaderValue* b = r + (size_t)in.b * stride;
+                auto component = [=](const ShaderValue* base, uint32_t k, uint32_t lane) -> const ShaderValue& {
+                    return base[(size_t)k * stride + lane];
+                };
+                ForEachLane(set, [&](uint32_t lane) {
+                    switch (in.op) {
+                        case ShaderOp::Dot: {
+                            float sum = 0.0f;
+                            for (uint32_t k = 0; k < count; ++k) sum += component(a, k, lane).f * component(b, k, lane).f;
+                            dst[lane].f = sum;
+                            break;
+                        }
+                        case ShaderOp::Length: {
+                            float sum = 0.0f;
+                            for (uint32_t k = 0; k < count; ++k) sum += component(a, k, lane).f * component(a, k, lane).f;
+                            dst[lane].f = std::sqrt(sum);
+                            break;
+                        }
+                        case ShaderOp::Any:
+                        case ShaderOp::All: {
+                            uint32_t any = 0, all = 1;
+                            for (uint32_t k = 0; k < count; ++k) {
+                                any |= component(a, k, lane).u;
+                                all &= component(a, k, lane).u;
+                            }
+                            dst[lane].u = in.op == ShaderOp::Any ? any : all;
+                            break;
+                        }
+                        case ShaderOp::Normalize: {
+                            float sum = 0.0f;
+                            for (uint32_t k = 0; k < count; ++k) sum += component(a, k, lane).f * component(a, k, lane).f;
+                            const float scale = 1.0f / std::sqrt(sum);
+                            for (uint32_t k = 0; k < count; ++k) dst[(size_t)k * stride + lane].f = component(a, k, lane).f * scale;
+                            break;
+                        }
+                        case ShaderOp::Cross: {
+                            const float ax = component(a, 0, lane).f, ay = component(a, 1, lane).f, az = component(a, 2, lane).f;
+                            const float bx = component(b, 0, lane).f, by = component(b, 1, lane).f, bz = component(b, 2, lane).f;
+                            dst[lane].f = ay * bz - az * by;
+                            dst[stride + lane].f = az * bx - ax * bz;
+                            dst[2 * stride + lane].f = ax * by - ay * bx;
+                            break;
+                        }
+                        case ShaderOp::Reflect: {
+                            // I - 2 * dot(N, I) * N
+                            float dot = 0.0f;
+                            for (uint32_t k = 0; k < count; ++k) dot += component(a, k, lane).f * component(b, k, lane).f;
+                            for (uint32_t k = 0; k < count; ++k) {
+                                dst[(size_t)k * stride + lane].f = component(a, k, lane).f - 2.0f * dot * component(b, k, lane).f;
+                            }
+                            break;
+                        }
+                        case ShaderOp::ExtractDynamic: {
+                            const uint32_t index = b[lane].u;
+                            dst[lane].u = index < count ? component(a, index, lane).u : 0;
+                            break;
+                        }
+                        case ShaderOp::InsertDynamic: {
+                            const uint32_t index = b[lane].u;
+                            if (index < count) dst[(size_t)index * stride + lane] = a[lane];
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                });
+                break;
+            }
+            case ShaderOp::PtrAdd: {
+                ShaderValue* dst = r + (size_t)in.dst * stride;
+                const ShaderValue* a = r + (size_t)in.a * stride;
+                const uint32_t offset = in.imm;
+                ForEachLane(set, [&](uint32_t lane) { dst[lane].u = a[lane].u + offset; });
+                break;
+            }
+            case ShaderOp::PtrAddScaled: {
+                ShaderValue* dst = r + (size_t)in.dst * stride;
+                const ShaderValue* a = r + (size_t)in.a * stride;
+                const ShaderValue* b = r + (size_t)in.b * stride;
+                const uint32_t scale = in.imm;
+                ForEachLane(set, [&](uint32_t lane) { dst[lane].u = a[lane].u + b[lane].u * scale; });
+                break;
+            }
+            // Accesses out of the bounds of the memory of a variable read 0 and write nothing
+            case ShaderOp::Load: {
+                const ShaderMemoryRange& memory = scratch->memory[in.imm];
+                const ShaderValue* pointer = r + (size_t)in.a * stride;
+                const uint32_t* offsets = program.memory_offsets.data() + in.b;
+                for (uint32_t k = 0; k < in.count; ++k) {
+                    ShaderValue* dst = r + (size_t)(in.dst + k) * stride;
+                    ForEachLane(set, [&](uint32_t lane) {
+                        const uint8_t* address = ShaderAddress(memory, lane, (uint64_t)pointer[lane].u + offsets[k]);
+                        if (address) {
+                            std::memcpy(&dst[lane], address, sizeof(ShaderValue));
+                        } else {
+                            dst[lane].u = 0;
+                        }
+                    });
+                }
+                break;
+            }
+            case ShaderOp::Store: {
+                const ShaderMemoryRange& memory = scratch->memory[in.imm];
+                const ShaderValue* pointer = r + (size_t)in.a * stride;
+                const uint32_t* offsets = program.memory_offsets.data() + in.c;
+                for (uint32_t k = 0; k < in.count; ++k) {
+                    const ShaderValue* value = r + (size_t)(in.b + k) * stride;
+                    ForEachLane(set, [&](uint32_t lane) {
+                        uint8_t* address = ShaderAddress(memory, lane, (uint64_t)pointer[lane].u + offsets[k]);
+                        if (address) std::memcpy(address, &value[lane], sizeof(ShaderValue));
+                    });
+                }
+                break;
+            }
+            case ShaderOp::ArrayLength: {
+                const uint64_t size = scratch->memory[in.imm].size;
+                const uint32_t length = size > in.b && in.c ? (uint32_t)(std::min)((size - in.b) / in.c, (uint64_t)UINT32_MAX) : 0;
+                ShaderValue* dst = r + (size_t)in.dst * stride;
+                ForEachLane(set, [&](uint32_t lane) { dst[lane].u = length; });
+                break;
+            }
+            case ShaderOp::AtomicLoad:
+            case ShaderOp::AtomicStore:
+            case ShaderOp::AtomicExchange:
+            case ShaderOp::AtomicCompareExchange:
+            case ShaderOp::AtomicAdd:
+            case ShaderOp::AtomicSub:
+            case ShaderOp::AtomicSMin:
+            case ShaderOp::AtomicUMin:
+            case ShaderOp::AtomicSMax:
+            case ShaderOp::AtomicUMax:
+            case ShaderOp::AtomicAnd:
+            case ShaderOp::AtomicOr:
+            case ShaderOp::AtomicXor:
+                ExecuteAtomic(in, set, r, stride, scratch->memory[in.imm]);
+                break;
+            case ShaderOp::Jump:
+                if (!--scratch->steps_left) {
+                    ForEachLane(set, [&](uint32_t lane) { scratch->lane_states[lane] = ShaderLaneState::Done; });
+                    return;
+                }
+                // Lanes that stay together and are the only ones left carry on without being scheduled again
+                if (set.count == live_count) {
+                    pc = in.imm - 1;
+                    break;
+                }
+                move_to(in.imm);
+                return;
+            case ShaderOp::Branch: {
+                const ShaderValue* condition = r + (size_t)in.a * stride;
+                uint32_t taken = 0;
+                ForEachLane(set, [&](uint32_t lane) {
+                    const uint32_t target = condition[lane].u ? in.imm : in.b;
+                    pcs[lane] = target;
+                    taken += target == in.imm;
+                });
+                if (set.count == live_count && (taken == 0 || taken == set.count) && --scratch->steps_left) {
+                    pc = (taken ? in.imm : in.b) - 1;
+                    break;
+                }
+                return;
+            }
+            case ShaderOp::Switch: {
+                const ShaderValue* selector = r + (size_t)in.a * stride;
+                const uint32_t* cases = program.switch_cases.data() + in.imm;
+                ForEachLane(set, [&](uint32_t lane) {
+                    uint32_t target = in.b;
+                    for (uint32_t i = 0; i < in.count; ++i) {
+                        if (cases[2 * i] == selector[lane].u) {
+                            target = cases[2 * i + 1];
+                            break;
+                        }
+                    }
+                    pcs[lane] = target;
+                });
+                return;
+            }
+            case ShaderOp::DPdx:
+            case ShaderOp::DPdy:
+            case ShaderOp::DPdxCoarse:
+            case ShaderOp::DPdyCoarse:
+                ExecuteDerivative(in, set, r, stride);
+                break;
+            case ShaderOp::Sample:
+                ExecuteSample(in, set, r, stride, scratch->textures[in.imm]);
+                break;
+            case ShaderOp::Barrier:
+                // With every lane that is left at the barrier, it's already satisfied
+                if (set.count == live_count) break;
+                move_to(pc + 1);
+                ForEachLane(set, [&](uint32_t lane) { scratch->lane_states[lane] = ShaderLaneState::Blocked; });
+                return;
+            case ShaderOp::MemoryBarrier:
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                break;
+            case ShaderOp::Exit:
+                ForEachLane(set, [&](uint32_t lane) { scratch->lane_states[lane] = ShaderLaneState::Done; });
+                return;
+            case ShaderOp::Kill:
+                ForEachLane(set, [&](uint32_t lane) {
+                    scratch->lane_states[lane] = ShaderLaneState::Done;
+                    scratch->killed[lane] = 1;
+                });
+                return;
+        }
+    }
+}
+
+// Invocations that loop for longer than this are stopped, like a GPU would reset after a timeout
+static constexpr uint64_t kMaxShaderSteps = 1ull << 32;
+
+// Run the first lane_count invocations of the program scratch was prepared for to completion. Invocations that are
+// apart run in groups of those at the same program counter, lowest first, so that they meet again where the paths of
+// structured control flow merge.
+static void RunShaderProgram(const ShaderProgram& program, uint32_t lane_count, ShaderScratch* scratch) {
+    scratch->steps_left = kMaxShaderSteps;
+    std::fill_n(scratch->pcs.begin(), lane_count, 0);
+    std::fill_n(scratch->lane_states.begin(), lane_count, ShaderLaneState::Running);
+    std::fill_n(scratch->killed.begin(), lane_count, 0);
+    uint32_t live_count = lane_count;
+    uint32_t* lanes = scratch->lanes.data();
+    for (;;) {
+        uint32_t pc = UINT32_MAX;
+        uint32_t blocked = 0;
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            if (scratch->lane_states[lane] == ShaderLaneState::Running) {
+                pc = (std::min)(pc, scratch->pcs[lane]);
+            } else if (scratch->lane_states[lane] == ShaderLaneState::Blocked) {
+                ++blocked;
+            }
+        }
+        if (pc == UINT32_MAX) {
+            if (!blocked) return;
+            // Every lane left is waiting at a barrier, which lets them all go
+            for (uint32_t lane = 0; lane < lane_count; ++lane) {
+                if (scratch->lane_states[lane] == ShaderLaneState::Blocked) scratch->lane_states[lane] = ShaderLaneState::Running;
+            }
+            continue;
+        }
+        uint32_t count = 0;
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            if (scratch->lane_states[lane] == ShaderLaneState::Running && scratch->pcs[lane] == pc) lanes[count++] = lane;
+        }
+        const ShaderLaneSet set = {lanes, count, count == lane_count};
+        if (!--scratch->steps_left) return;
+        ExecuteShaderBlock(program, pc, set, live_count, scratch);
+        live_count = 0;
+        for (uint32_t lane = 0; lane < lane_count; ++lane) live_count += scratch->lane_states[lane] != ShaderLaneState::Done;
+    }
+}
+
+static void WriteShaderBuiltIn(const ShaderProgram& program, ShaderBuiltIn builtin, ShaderScratch* scratch, uint32_t lane,
+                               const uint32_t* values, uint32_t count) {
+    const uint32_t offset = program.builtin_offsets[builtin];
+    if (offset != kUnusedShaderOffset) std::memcpy(scratch->LaneMemory(lane) + offset, values, count * sizeof(uint32_t));
+}
+
+// Run workgroups [first, last) of a dispatch, numbered with x varying fastest
+static void RunComputeWorkgroups(const ComputeDispatch& dispatch, uint64_t first, uint64_t last) {
+    static thread_local ShaderScratch scratch;
+    const ShaderProgram& program = *dispatch.program;
+    const uint32_t lane_count = program.LaneCount();
+    PrepareShaderScratch(program, lane_count, dispatch.bound_memory.data(), &scratch);
+    scratch.textures = dispatch.textures.data();
+    const uint32_t* local_size = program.local_size;
+    for (uint32_t lane = 0; lane < lane_count; ++lane) {
+        const uint32_t local_id[3] = {lane % local_size[0], lane / local_size[0] % local_size[1], lane / (local_size[0] * local_size[1])};
+        WriteShaderBuiltIn(program, kBuiltInLocalInvocationId, &scratch, lane, local_id, 3);
+        WriteShaderBuiltIn(program, kBuiltInLocalInvocationIndex, &scratch, lane, &lane, 1);
+        WriteShaderBuiltIn(program, kBuiltInNumWorkgroups, &scratch, lane, dispatch.count, 3);
+    }
+    const bool global_id = program.builtin_offsets[kBuiltInGlobalInvocationId] != kUnusedShaderOffset;
+    for (uint64_t index = first; index < last; ++index) {
+        const uint32_t group_id[3] = {dispatch.base[0] + (uint32_t)(index % dispatch.count[0]),
+                                      dispatch.base[1] + (uint32_t)(index / dispatch.count[0] % dispatch.count[1]),
+                                      dispatch.base[2] + (uint32_t)(index / ((uint64_t)dispatch.count[0] * dispatch.count[1]))};
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            WriteShaderBuiltIn(program, kBuiltInWorkgroupId, &scratch, lane, group_id, 3);
+            if (!global_id) continue;
+            const uint32_t id[3] = {group_id[0] * local_size[0] + lane % local_size[0],
+                                    group_id[1] * local_size[1] + lane / local_size[0] % local_size[1],
+                                    group_id[2] * local_size[2] + lane / (local_size[0] * local_size[1])};
+            WriteShaderBuiltIn(program, kBuiltInGlobalInvocationId, &scratch, lane, id, 3);
+        }
+        RunShaderProgram(program, lane_count, &scratch);
+    }
+}
+
+// Workgroups of a dispatch are handed to the worker pool in chunks of about this many invocations
+static constexpr uint64_t kInvocationsPerChunk = 4096;
+
+void RunComputeDispatch(ParallelExecutor* worker_pool, const ComputeDispatch& dispatch) {
+    const uint64_t group_count = (uint64_t)dispatch.count[0] * dispatch.count[1] * dispatch.count[2];
+    if (!group_count) return;
+    const uint64_t groups_per_chunk = (std::max)(kInvocationsPerChunk / dispatch.program->LaneCount(), (uint64_t)1);
+    const uint64_t chunk_count = (group_count + groups_per_chunk - 1) / groups_per_chunk;
+    // Dispatches too large to count chunks in 32 bits are split into as many chunks as that allows
+    const uint64_t chunk_size = chunk_count > UINT32_MAX ? (group_count + UINT32_MAX - 1) / UINT32_MAX : groups_per_chunk;
+    worker_pool->ParallelFor((uint32_t)((group_count + chunk_size - 1) / chunk_size), [&](uint32_t chunk) {
+        const uint64_t first = chunk * chunk_size;
+        RunComputeWorkgroups(dispatch, first, (std::min)(first + chunk_size, group_count));
+    });
+}
+
+void LinkGraphicsShaders(GraphicsPipeline* pipeline) {
+    if (!pipeline->fragment) return;
+    for (const auto& input : pipeline->fragment->inputs) {
+        for (uint32_t k = 0; k < input.components; ++k) {
+            const uint32_t component = input.component + k;
+            GraphicsPipeline::Varying varying = {kUnusedShaderOffset, input.offset + k * (uint32_t)sizeof(ShaderValue),
+                                                 input.interpolation};
+            for (const auto& output : pipeline->vertex->outputs) {
+                if (output.location == input.location && component >= output.component &&
+                    component < output.component + output.components) {
+                    varying.vertex_offset = output.offset + (component - output.component) * (uint32_t)sizeof(ShaderValue);
+                }
+            }
+            pipeline->varyings.push_back(varying);
+            pipeline->flat_varyings |= input.interpolation == ShaderInterpolation::Flat;
+        }
+    }
+    for (const auto& output : pipeline->fragment->outputs) {
+        if (output.location < kMaxColorTargets) pipeline->color_outputs.push_back(output);
+    }
+}
+
+static constexpr uint32_t kPrimitiveRestart = UINT32_MAX;
+
+// The vertices the vertex shader runs for, as the VertexIndex of each, and the vertex of each position of the draw.
+// Indexed draws whose indices fall in a range no larger than the draw run the vertex shader once per vertex of the
+// range, the others once per index.
+static void GatherVertices(const GraphicsDraw& draw, std::vector<uint32_t>* vertex_ids, std::vector<uint32_t>* sequence) {
+    sequence->resize(draw.count);
+    if (!draw.index_size) {
+        vertex_ids->resize(draw.count);
+        for (uint32_t i = 0; i < draw.count; ++i) {
+            (*vertex_ids)[i] = draw.first + i;
+            (*sequence)[i] = i;
+        }
+        return;
+    }
+    const uint32_t restart = draw.index_size == 4 ? UINT32_MAX : (1u << (draw.index_size * 8)) - 1;
+    uint32_t min_index = UINT32_MAX, max_index = 0;
+    for (uint32_t i = 0; i < draw.count; ++i) {
+        // Indices out of the bounds of the index buffer read as 0
+        const uint64_t offset = ((uint64_t)draw.first + i) * draw.index_size;
+        uint32_t index = 0;
+        if (offset + draw.index_size <= draw.index_buffer.size) std::memcpy(&index, draw.index_buffer.base + offset, draw.index_size);
+        if (draw.pipeline->primitive_restart && index == restart) {
+            (*sequence)[i] = kPrimitiveRestart;
+            continue;
+        }
+        (*sequence)[i] = index;
+        min_index = (std::min)(min_index, index);
+        max_index = (std::max)(max_index, index);
+    }
+    vertex_ids->clear();
+    if (min_index > max_index) return;
+    if (max_index - min_index < draw.count) {
+        vertex_ids->resize(max_index - min_index + 1);
+        for (uint32_t i = 0; i < vertex_ids->size(); ++i) (*vertex_ids)[i] = min_index + i + draw.vertex_offset;
+        for (auto& vertex : *sequence) {
+            if (vertex != kPrimitiveRestart) vertex -= min_index;
+        }
+    } else {
+        for (uint32_t i = 0; i < draw.count; ++i) {
+            if ((*sequence)[i] == kPrimitiveRestart) continue;
+            vertex_ids->push_back((*sequence)[i] + draw.vertex_offset);
+            (*sequence)[i] = (uint32_t)vertex_ids->size() - 1;
+        }
+    }
+}
+
+bool IsTriangleTopology(VkPrimitiveTopology topology) {
+    return topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP ||
+           topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+}
+
+// Vertices of the triangles of a draw, three at a time with the provoking vertex first
+static void AssembleTriangles(VkPrimitiveTopology topology, const std::vector<uint32_t>& sequence, std::vector<uint32_t>* triangles) {
+    auto push = [&](uint32_t a, uint32_t b, uint32_t c) {
+        triangles->push_back(a);
+        triangles->push_back(b);
+        triangles->push_back(c);
+    };
+    for (size_t begin = 0; begin < sequence.size();) {
+        size_t end = begin;
+        while (end < sequence.size() && sequence[end] != kPrimitiveRestart) ++end;
+        const uint32_t* v = sequence.data() + begin;
+        const size_t length = end - begin;
+        switch (topology) {
+            case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+                for (size_t i = 0; i + 2 < length; i += 3) push(v[i], v[i + 1], v[i + 2]);
+                break;
+            case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+                for (size_t i = 0; i + 2 < length; ++i) {
+                    if (i & 1) {
+                        push(v[i], v[i + 2], v[i + 1]);
+                    } else {
+                        push(v[i], v[i + 1], v[i + 2]);
+                    }
+                }
+                break;
+            case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+                for (size_t i = 1; i + 1 < length; ++i) push(v[i], v[i + 1], v[0]);
+                break;
+            default:
+                break;
+        }
+        begin = end + 1;
+    }
+}
+
+// Shaded vertices are their clip space position followed by their varyings
+static constexpr uint32_t kVertexPosition = 4;
+
+// Run the vertex shader for vertices [first, last) of an instance of a draw
+static void ShadeVertices(const GraphicsDraw& draw, const uint32_t* vertex_ids, uint32_t instance, uint32_t first, uint32_t last,
+                          float* vertices) {
+    static thread_local ShaderScratch scratch;
+    static const uint8_t kZeroAttribute[16] = {};
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    const ShaderProgram& program = *pipeline.vertex;
+    PrepareShaderScratch(program, kGraphicsShaderLanes, draw.vertex_memory.data(), &scratch);
+    scratch.textures = draw.vertex_textures.data();
+    const uint32_t instance_index = draw.first_instance + instance;
+    const size_t stride = kVertexPosition + pipeline.varyings.size();
+    const uint32_t position_offset = program.builtin_offsets[kBuiltInPosition];
+    for (uint32_t batch = first; batch < last; batch += kGraphicsShaderLanes) {
+        const uint32_t lane_count = (std::min)(kGraphicsShaderLanes, last - batch);
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            const uint32_t vertex_index = vertex_ids[batch + lane];
+            WriteShaderBuiltIn(program, kBuiltInVertexIndex, &scratch, lane, &vertex_index, 1);
+            WriteShaderBuiltIn(program, kBuiltInInstanceIndex, &scratch, lane, &instance_index, 1);
+            uint8_t* lane_memory = scratch.LaneMemory(lane);
+            for (const auto& attribute : pipeline.attributes) {
+                const auto& binding = pipeline.bindings[attribute.binding];
+                const ShaderMemoryRange& buffer = draw.vertex_buffers[attribute.binding];
+                const uint64_t offset =
+                    (uint64_t)(binding.per_instance ? instance_index : vertex_index) * binding.stride + attribute.offset;
+                // Attributes out of the bounds of their vertex buffer read as 0
+                const bool in_bounds = buffer.base && offset + attribute.size <= buffer.size;
+                ShaderValue values[4];
+                DecodeTexel(attribute.format, in_bounds ? buffer.base + offset : kZeroAttribute, values);
+                std::memcpy(lane_memory + attribute.program_offset, values + attribute.component,
+                            attribute.components * sizeof(ShaderValue));
+            }
+        }
+        RunShaderProgram(program, lane_count, &scratch);
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            float* vertex = vertices + (batch + lane) * stride;
+            const uint8_t* lane_memory = scratch.LaneMemory(lane);
+            if (position_offset != kUnusedShaderOffset) {
+                std::memcpy(vertex, lane_memory + position_offset, kVertexPosition * sizeof(float));
+            } else {
+                std::fill_n(vertex, kVertexPosition, 0.0f);
+            }
+            for (size_t i = 0; i < pipeline.varyings.size(); ++i) {
+                const uint32_t offset = pipeline.varyings[i].vertex_offset;
+                vertex[kVertexPosition + i] = 0.0f;
+                if (offset != kUnusedShaderOffset) std::memcpy(&vertex[kVertexPosition + i], lane_memory + offset, sizeof(float));
+            }
+        }
+    }
+}
+
+// Screen positions are fixed point with this many bits of subpixel precision
+static constexpr uint32_t kSubpixelBits = 8;
+static constexpr int64_t kSubpixelOne = 1 << kSubpixelBits;
+// Triangles are clipped to this many pixels around the viewport rather than to the viewport, which keeps the fixed
+// point positions and the edge functions computed from them in range
+static constexpr float kGuardBand = 8192.0f;
+static constexpr float kMinClipW = 1e-6f;
+
+// A triangle after setup: its edge functions, which are positive inside it, and the planes its depth, 1/w and
+// varyings are interpolated along
+struct RasterTriangle {
+    // Edge i is opposite vertex i and at a point (x, y) in fixed point is a[i] * x + b[i] * y + c[i], biased so that
+    // pixels on edges that aren't top or left edges are outside
+    int64_t a[3];
+    int64_t b[3];
+    int64_t c[3];
+    int32_t min_x;  // Of the pixels it may cover, inclusive and within the rect of the draw
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+    bool front_facing;
+    // Offset of the planes in the setup data of the draw: for depth, 1/w and each varying (divided by w when it's
+    // interpolated with perspective), the value at the center of pixel (min_x, min_y) and its steps in x and y
+    size_t planes;
+};
+
+static inline int64_t FloorDivide(int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+struct TriangleSetup {
+    const GraphicsDraw* draw;
+    uint32_t varying_count;
+    float guard_x;  // Of the guard band in clip space, as a multiple of w
+    float guard_y;
+    uint32_t clip_planes;
+    std::vector<RasterTriangle> triangles;
+    std::vector<float> planes;
+    std::vector<float> polygons[2];  // Scratch for clipping
+};
+
+static float ClipDistance(const TriangleSetup& setup, uint32_t plane, const float* v) {
+    switch (plane) {
+        case 0: return v[3] * setup.guard_x + v[0];
+        case 1: return v[3] * setup.guard_x - v[0];
+        case 2: return v[3] * setup.guard_y + v[1];
+        case 3: return v[3] * setup.guard_y - v[1];
+        case 4: return v[2];
+        case 5: return v[3] - v[2];
+        default: return v[3] - kMinClipW;
+    }
+}
+static constexpr uint32_t kClipPlaneCount = 7;
+static constexpr uint32_t kDepthClipPlanes = (1 << 4) | (1 << 5);
+
+// Set up a triangle whose vertices are in screen space: fixed point x and y, then depth, 1/w and the varyings
+static void SetupScreenTriangle(TriangleSetup* setup, const int64_t* const xy[3], const float* const attributes[3]) {
+    const GraphicsDraw& draw = *setup->draw;
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    int64_t x[3] = {xy[0][0], xy[1][0], xy[2][0]};
+    int64_t y[3] = {xy[0][1], xy[1][1], xy[2][1]};
+    const float* values[3] = {attributes[0], attributes[1], attributes[2]};
+    int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (!area) return;
+    // In framebuffer coordinates y points down, so counter-clockwise triangles have a negative area here
+    const bool front_facing = (pipeline.front_face == VK_FRONT_FACE_COUNTER_CLOCKWISE) == (area < 0);
+    if ((pipeline.cull_mode & (front_facing ? VK_CULL_MODE_FRONT_BIT : VK_CULL_MODE_BACK_BIT))) return;
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(values[1], values[2]);
+        area = -area;
+    }
+    RasterTriangle triangle;
+    triangle.front_facing = front_facing;
+    const int64_t half = kSubpixelOne / 2;
+    const int64_t min_x = (std::min)({x[0], x[1], x[2]}), max_x = (std::max)({x[0], x[1], x[2]});
+    const int64_t min_y = (std::min)({y[0], y[1], y[2]}), max_y = (std::max)({y[0], y[1], y[2]});
+    triangle.min_x = (int32_t)(std::max)(-FloorDivide(half - min_x, kSubpixelOne), (int64_t)draw.rect.offset.x);
+    triangle.min_y = (int32_t)(std::max)(-FloorDivide(half - min_y, kSubpixelOne), (int64_t)draw.rect.offset.y);
+    triangle.max_x = (int32_t)(std::min)(FloorDivide(max_x - half, kSubpixelOne), (int64_t)draw.rect.offset.x + draw.rect.extent.width - 1);
+    triangle.max_y =
+        (int32_t)(std::min)(FloorDivide(max_y - half, kSubpixelOne), (int64_t)draw.rect.offset.y + draw.rect.extent.height - 1);
+    if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) return;
+    // Barycentric coordinates at the center of the first pixel, and their steps from pixel to pixel
+    const int64_t origin_x = triangle.min_x * kSubpixelOne + half, origin_y = triangle.min_y * kSubpixelOne + half;
+    double barycentric[3], step_x[3], step_y[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        const uint32_t j = (i + 1) % 3, k = (i + 2) % 3;
+        triangle.a[i] = y[j] - y[k];
+        triangle.b[i] = x[k] - x[j];
+        triangle.c[i] = (y[k] - y[j]) * x[j] - (x[k] - x[j]) * y[j];
+        barycentric[i] = (double)(triangle.a[i] * origin_x + triangle.b[i] * origin_y + triangle.c[i]) / area;
+        step_x[i] = (double)(triangle.a[i] * kSubpixelOne) / area;
+        step_y[i] = (double)(triangle.b[i] * kSubpixelOne) / area;
+        const bool top_left = (triangle.a[i] == 0 && triangle.b[i] > 0) || triangle.a[i] > 0;
+        if (!top_left) triangle.c[i] -= 1;
+    }
+    triangle.planes = setup->planes.size();
+    const uint32_t attribute_count = 2 + setup->varying_count;
+    for (uint32_t attribute = 0; attribute < attribute_count; ++attribute) {
+        if (attribute >= 2 && pipeline.varyings[attribute - 2].interpolation == ShaderInterpolation::Flat) {
+            setup->planes.insert(setup->planes.end(), {values[0][attribute], 0.0f, 0.0f});
+            continue;
+        }
+        double value = 0, dx = 0, dy = 0;
+        for (uint32_t i = 0; i < 3; ++i) {
+            value += barycentric[i] * values[i][attribute];
+            dx += step_x[i] * values[i][attribute];
+            dy += step_y[i] * values[i][attribute];
+        }
+        setup->planes.push_back((float)value);
+        setup->planes.push_back((float)dx);
+        setup->planes.push_back((float)dy);
+    }
+    setup->triangles.push_back(triangle);
+}
+
+// Clip a triangle of shaded vertices, project what's left to the screen and set it up
+static void SetupTriangle(TriangleSetup* setup, const float* const vertices[3]) {
+    const GraphicsDraw& draw = *setup->draw;
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    const uint32_t stride = kVertexPosition + setup->varying_count;
+    uint32_t outside_all = (1u << kClipPlaneCount) - 1, outside_any = 0;
+    for (uint32_t i = 0; i < 3; ++i) {
+        uint32_t outcode = 0;
+        for (uint32_t plane = 0; plane < kClipPlaneCount; ++plane) {
+            // Also true of NaNs, which reject the triangle
+            if (!(ClipDistance(*setup, plane, vertices[i]) >= 0.0f)) outcode |= 1 << plane;
+        }
+        outcode &= setup->clip_planes;
+        outside_all &= outcode;
+        outside_any |= outcode;
+    }
+    if (outside_all) return;
+    std::vector<float>* polygon = &setup->polygons[0];
+    std::vector<float>* clipped = &setup->polygons[1];
+    polygon->clear();
+    for (uint32_t i = 0; i < 3; ++i) polygon->insert(polygon->end(), vertices[i], vertices[i] + stride);
+    if (pipeline.flat_varyings) {
+        // Flat varyings come from the provoking vertex, clipping interpolates between copies of its values
+        for (uint32_t i = 1; i < 3; ++i) {
+            for (uint32_t v = 0; v < setup->varying_count; ++v) {
+                if (pipeline.varyings[v].interpolation == ShaderInterpolation::Flat) {
+                    (*polygon)[i * stride + kVertexPosition + v] = vertices[0][kVertexPosition + v];
+                }
+            }
+        }
+    }
+    for (uint32_t plane = 0; plane < kClipPlaneCount && outside_any; ++plane) {
+        if (!(outside_any & (1 << plane))) continue;
+        clipped->clear();
+        const size_t count = polygon->size() / stride;
+        for (size_t i = 0; i < count; ++i) {
+            const float* from = polygon->data() + i * stride;
+            const float* to = polygon->data() + (i + 1) % count * stride;
+            const float from_distance = ClipDistance(*setup, plane, from), to_distance = ClipDistance(*setup, plane, to);
+            if (from_distance >= 0.0f) clipped->insert(clipped->end(), from, from + stride);
+            if ((from_distance >= 0.0f) != (to_distance >= 0.0f)) {
+                const float t = from_distance / (from_distance - to_distance);
+                for (uint32_t k = 0; k < stride; ++k) {
+                    // Flat varyings may hold integers, which mustn't go through float arithmetic
+                    const bool flat =
+                        k >= kVertexPosition && pipeline.varyings[k - kVertexPosition].interpolation == ShaderInterpolation::Flat;
+                    clipped->push_back(flat ? from[k] : from[k] + (to[k] - from[k]) * t);
+                }
+            }
+        }
+        std::swap(polygon, clipped);
+        if (polygon->size() < 3 * stride) return;
+    }
+    // Project to the screen: fixed point x and y, depth, 1/w and the varyings to interpolate
+    const VkViewport& viewport = draw.viewport;
+    const float min_depth = (std::min)(viewport.minDepth, viewport.maxDepth), max_depth = (std::max)(viewport.minDepth, viewport.maxDepth);
+    const size_t count = polygon->size() / stride;
+    const uint32_t attribute_count = 2 + setup->varying_count;
+    // Each plane clips off at most one corner, adding a vertex
+    int64_t positions[3 + kClipPlaneCount][2];
+    std::vector<float>& screen = *clipped;
+    screen.resize(count * attribute_count);
+    for (size_t i = 0; i < count; ++i) {
+        const float* vertex = polygon->data() + i * stride;
+        const float inverse_w = 1.0f / vertex[3];
+        const float screen_x = viewport.x + (vertex[0] * inverse_w + 1.0f) * 0.5f * viewport.width;
+        const float screen_y = viewport.y + (vertex[1] * inverse_w + 1.0f) * 0.5f * viewport.height;
+        positions[i][0] = (int64_t)std::llround(screen_x * kSubpixelOne);
+        positions[i][1] = (int64_t)std::llround(screen_y * kSubpixelOne);
+        float* out = screen.data() + i * attribute_count;
+        out[0] = ShaderClamp(viewport.minDepth + vertex[2] * inverse_w * (viewport.maxDepth - viewport.minDepth), min_depth, max_depth);
+        out[1] = inverse_w;
+        for (uint32_t v = 0; v < setup->varying_count; ++v) {
+            const float value = vertex[kVertexPosition + v];
+            out[2 + v] = pipeline.varyings[v].interpolation == ShaderInterpolation::Perspective ? value * inverse_w : value;
+        }
+    }
+    for (size_t i = 1; i + 1 < count; ++i) {
+        const int64_t* xy_corners[3] = {positions[0], positions[i], positions[i + 1]};
+        const float* corners[3] = {screen.data(), screen.data() + i * attribute_count, screen.data() + (i + 1) * attribute_count};
+        SetupScreenTriangle(setup, xy_corners, corners);
+    }
+}
+
+// Depth as the draw compares it: the raw value of unorm formats, which is what the test of a GPU compares too
+static double StoredDepth(const TexelFormat& format, const uint8_t* texel) {
+    uint32_t raw = 0;
+    std::memcpy(&raw, texel, format.bits / 8);
+    if (format.type == TexelType::Unorm) return raw;
+    float depth;
+    std::memcpy(&depth, &raw, sizeof(depth));
+    return depth;
+}
+static double FragmentDepth(const TexelFormat& format, float z) {
+    if (format.type == TexelType::Unorm) return (double)std::lround(ShaderClamp(z, 0.0f, 1.0f) * (double)((1u << format.bits) - 1));
+    return z;
+}
+
+static bool CompareDepth(VkCompareOp op, double fragment, double stored) {
+    switch (op) {
+        case VK_COMPARE_OP_NEVER: return false;
+        case VK_COMPARE_OP_LESS: return fragment < stored;
+        case VK_COMPARE_OP_EQUAL: return fragment == stored;
+        case VK_COMPARE_OP_LESS_OR_EQUAL: return fragment <= stored;
+        case VK_COMPARE_OP_GREATER: return fragment > stored;
+        case VK_COMPARE_OP_NOT_EQUAL: return fragment != stored;
+        case VK_COMPARE_OP_GREATER_OR_EQUAL: return fragment >= stored;
+        default: return true;
+    }
+}
+
+static float BlendFactor(VkBlendFactor factor, const float* src, const float* dst, const float* constants, uint32_t c) {
+    switch (factor) {
+        case VK_BLEND_FACTOR_ONE: return 1.0f;
+        case VK_BLEND_FACTOR_SRC_COLOR: return src[c];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR: return 1.0f - src[c];
+        case VK_BLEND_FACTOR_DST_COLOR: return dst[c];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR: return 1.0f - dst[c];
+        case VK_BLEND_FACTOR_SRC_ALPHA: return src[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA: return 1.0f - src[3];
+        case VK_BLEND_FACTOR_DST_ALPHA: return dst[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA: return 1.0f - dst[3];
+        case VK_BLEND_FACTOR_CONSTANT_COLOR: return constants[c];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR: return 1.0f - constants[c];
+        case VK_BLEND_FACTOR_CONSTANT_ALPHA: return constants[3];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA: return 1.0f - constants[3];
+        case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE: return c == 3 ? 1.0f : (std::min)(src[3], 1.0f - dst[3]);
+        default: return 0.0f;  // Zero, and the dual source factors, which no pipeline can use without dualSrcBlend
+    }
+}
+
+static float BlendComponent(VkBlendOp op, float src, float src_factor, float dst, float dst_factor) {
+    switch (op) {
+        case VK_BLEND_OP_SUBTRACT: return src * src_factor - dst * dst_factor;
+        case VK_BLEND_OP_REVERSE_SUBTRACT: return dst * dst_factor - src * src_factor;
+        case VK_BLEND_OP_MIN: return (std::min)(src, dst);
+        case VK_BLEND_OP_MAX: return (std::max)(src, dst);
+        default: return src * src_factor + dst * dst_factor;
+    }
+}
+
+// Write the color of a fragment to a render target, blended with what's there
+static void WriteColor(const RenderTarget& target, const GraphicsPipeline::Blend& blend, const float* blend_constants, uint32_t x,
+                       uint32_t y, ShaderValue* color) {
+    uint8_t* texel = target.Texel(x, y);
+    if (blend.enable && !IsIntegerTexel(target.format)) {
+        ShaderValue dst_values[4];
+        DecodeTexel(target.format, texel, dst_values);
+        // Normalized formats blend values clamped to their range
+        const bool unsigned_range = target.format.type == TexelType::Unorm || target.format.type == TexelType::Srgb;
+        const bool signed_range = target.format.type == TexelType::Snorm;
+        float src[4], dst[4], constants[4];
+        for (uint32_t c = 0; c < 4; ++c) {
+            src[c] = color[c].f;
+            dst[c] = dst_values[c].f;
+            constants[c] = blend_constants[c];
+            if (unsigned_range || signed_range) {
+                const float lo = unsigned_range ? 0.0f : -1.0f;
+                src[c] = ShaderClamp(src[c], lo, 1.0f);
+                constants[c] = ShaderClamp(constants[c], lo, 1.0f);
+            }
+        }
+        for (uint32_t c = 0; c < 4; ++c) {
+            const bool alpha = c == 3;
+            const float src_factor = BlendFactor(alpha ? blend.src_alpha : blend.src_color, src, dst, constants, c);
+            const float dst_factor = BlendFactor(alpha ? blend.dst_alpha : blend.dst_color, src, dst, constants, c);
+            color[c].f = BlendComponent(alpha ? blend.alpha_op : blend.color_op, src[c], src_factor, dst[c], dst_factor);
+        }
+    }
+    EncodeTexel(target.format, color, blend.write_mask, texel);
+}
+
+// Pixels are rasterized in blocks of 4x4, which are 2x2 quads of fragments. Bit i of the coverage of a block is
+// pixel (kBlockX[i], kBlockY[i]) of it, so that the bits of each quad are in the order of its lanes.
+static constexpr uint32_t kBlockSize = 4;
+static constexpr uint8_t kBlockX[16] = {0, 1, 0, 1, 2, 3, 2, 3, 0, 1, 0, 1, 2, 3, 2, 3};
+static constexpr uint8_t kBlockY[16] = {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 3, 3, 2, 2, 3, 3};
+// Triangles are binned into tiles of this many pixels square, which the worker pool rasterizes in parallel
+static constexpr int32_t kTileSize = 64;
+
+struct FragmentQuad {
+    const RasterTriangle* triangle;
+    int32_t x;  // Of the top left pixel
+    int32_t y;
+    uint8_t coverage;  // Lanes of the pixels the triangle covers, the others are helpers
+};
+
+// Fragments a thread has rasterized and not yet shaded
+struct FragmentBatch {
+    const GraphicsDraw* draw;
+    const float* planes;
+    bool early_depth_test;   // Fragments that fail the depth test are taken out before the fragment shader runs
+    bool early_depth_write;  // And depth is written then
+    bool late_depth;         // Depth is tested and written after the fragment shader runs
+    std::vector<FragmentQuad> quads;
+    uint64_t fragments = 0;
+};
+static constexpr uint32_t kQuadsPerBatch = kGraphicsShaderLanes / 4;
+
+// Interpolate along the planes of a triangle at a pixel
+static inline float PlaneAt(const float* plane, const RasterTriangle& triangle, int32_t x, int32_t y) {
+    return plane[0] + (float)(x - triangle.min_x) * plane[1] + (float)(y - triangle.min_y) * plane[2];
+}
+
+// Run the fragment shader for the quads of a batch and write the fragments that survive it
+static void ShadeFragments(FragmentBatch* batch) {
+    static thread_local ShaderScratch scratch;
+    if (batch->quads.empty()) return;
+    const GraphicsDraw& draw = *batch->draw;
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    const ShaderProgram& program = *pipeline.fragment;
+    const uint32_t lane_count = (uint32_t)batch->quads.size() * 4;
+    PrepareShaderScratch(program, kGraphicsShaderLanes, draw.fragment_memory.data(), &scratch);
+    scratch.textures = draw.fragment_textures.data();
+    const uint32_t frag_coord_offset = program.builtin_offsets[kBuiltInFragCoord];
+    for (uint32_t lane = 0; lane < lane_count; ++lane) {
+        const FragmentQuad& quad = batch->quads[lane / 4];
+        const RasterTriangle& triangle = *quad.triangle;
+        const float* planes = batch->planes + triangle.planes;
+        const int32_t x = quad.x + (lane & 1), y = quad.y + (lane >> 1 & 1);
+        uint8_t* lane_memory = scratch.LaneMemory(lane);
+        const float inverse_w = PlaneAt(planes + 3, triangle, x, y);
+        if (frag_coord_offset != kUnusedShaderOffset) {
+            const float frag_coord[4] = {x + 0.5f, y + 0.5f, PlaneAt(planes, triangle, x, y), inverse_w};
+            std::memcpy(lane_memory + frag_coord_offset, frag_coord, sizeof(frag_coord));
+        }
+        const uint32_t front_facing = triangle.front_facing;
+        WriteShaderBuiltIn(program, kBuiltInFrontFacing, &scratch, lane, &front_facing, 1);
+        for (size_t i = 0; i < pipeline.varyings.size(); ++i) {
+            const auto& varying = pipeline.varyings[i];
+            const float* plane = planes + (2 + i) * 3;
+            float value;
+            switch (varying.interpolation) {
+                case ShaderInterpolation::Flat:
+                    value = plane[0];
+                    break;
+                case ShaderInterpolation::Linear:
+                    value = PlaneAt(plane, triangle, x, y);
+                    break;
+                default:
+                    value = PlaneAt(plane, triangle, x, y) / inverse_w;
+                    break;
+            }
+            std::memcpy(lane_memory + varying.fragment_offset, &value, sizeof(value));
+        }
+    }
+    RunShaderProgram(program, lane_count, &scratch);
+    const uint32_t frag_depth_offset = program.builtin_offsets[kBuiltInFragDepth];
+    const VkViewport& viewport = draw.viewport;
+    const float min_depth = (std::min)(viewport.minDepth, viewport.maxDepth), max_depth = (std::max)(viewport.minDepth, viewport.maxDepth);
+    const RenderTarget& depth = draw.depth;
+    for (uint32_t lane = 0; lane < lane_count; ++lane) {
+        const FragmentQuad& quad = batch->quads[lane / 4];
+        if (!(quad.coverage & (1 << (lane & 3))) || scratch.killed[lane]) continue;
+        const int32_t x = quad.x + (lane & 1), y = quad.y + (lane >> 1 & 1);
+        const uint8_t* lane_memory = scratch.LaneMemory(lane);
+        if (batch->late_depth && pipeline.depth_test && depth.base) {
+            float z;
+            if (frag_depth_offset != kUnusedShaderOffset) {
+                std::memcpy(&z, lane_memory + frag_depth_offset, sizeof(z));
+                z = ShaderClamp(z, min_depth, max_depth);
+            } else {
+                z = PlaneAt(batch->planes + quad.triangle->planes, *quad.triangle, x, y);
+            }
+            uint8_t* texel = depth.Texel(x, y);
+            if (!CompareDepth(pipeline.depth_compare, FragmentDepth(depth.format, z), StoredDepth(depth.format, texel))) {
+                continue;
+            }
+            if (pipeline.depth_write) {
+                const ShaderValue value = ShaderF(z);
+                EncodeTexel(depth.format, &value, 1, texel);
+            }
+        }
+        ++batch->fragments;
+        ShaderValue colors[kMaxColorTargets][4] = {};
+        uint32_t written = 0;
+        for (const auto& output : pipeline.color_outputs) {
+            std::memcpy(&colors[output.location][output.component], lane_memory + output.offset, output.components * sizeof(ShaderValue));
+            written |= 1 << output.location;
+        }
+        for (uint32_t location = 0; location < kMaxColorTargets; ++location) {
+            if (!(written & (1 << location)) || !draw.colors[location].base) continue;
+            WriteColor(draw.colors[location], pipeline.blends[location], draw.blend_constants, x, y, colors[location]);
+        }
+    }
+    batch->quads.clear();
+}
+
+// Rasterize the part of a triangle that falls in a tile, in blocks of 4x4 pixels
+static void RasterizeTriangle(const RasterTriangle& triangle, int32_t tile_x, int32_t tile_y, FragmentBatch* batch) {
+    const GraphicsDraw& draw = *batch->draw;
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    const RenderTarget& depth = draw.depth;
+    const bool depth_test = batch->early_depth_test && pipeline.depth_test && depth.base;
+    const float* planes = batch->planes + triangle.planes;
+    const int32_t min_x = (std::max)(triangle.min_x, tile_x), max_x = (std::min)(triangle.max_x, tile_x + kTileSize - 1);
+    const int32_t min_y = (std::max)(triangle.min_y, tile_y), max_y = (std::min)(triangle.max_y, tile_y + kTileSize - 1);
+    const int64_t half = kSubpixelOne / 2;
+    for (int32_t block_y = min_y & ~(int32_t)(kBlockSize - 1); block_y <= max_y; block_y += kBlockSize) {
+        for (int32_t block_x = min_x & ~(int32_t)(kBlockSize - 1); block_x <= max_x; block_x += kBlockSize) {
+            // Edge functions at the center of the top left pixel and across the block, whose extremes are at its corners
+            int64_t edges[3];
+            bool outside = false, inside = true;
+            for (uint32_t i = 0; i < 3 && !outside; ++i) {
+                edges[i] =
+                    triangle.a[i] * (block_x * kSubpixelOne + half) + triangle.b[i] * (block_y * kSubpixelOne + half) + triangle.c[i];
+                const int64_t step_x = triangle.a[i] * kSubpixelOne * (kBlockSize - 1);
+                const int64_t step_y = triangle.b[i] * kSubpixelOne * (kBlockSize - 1);
+                outside = edges[i] + (std::max)(step_x, (int64_t)0) + (std::max)(step_y, (int64_t)0) < 0;
+                inside = inside && edges[i] + (std::min)(step_x, (int64_t)0) + (std::min)(step_y, (int64_t)0) >= 0;
+            }
+            if (outside) continue;
+            uint32_t coverage = 0;
+            for (uint32_t bit = 0; bit < 16; ++bit) {
+                const int32_t x = block_x + kBlockX[bit], y = block_y + kBlockY[bit];
+                if (x < min_x || x > max_x || y < min_y || y > max_y) continue;
+                bool covered = inside;
+                if (!covered) {
+                    covered = true;
+                    for (uint32_t i = 0; i < 3 && covered; ++i) {
+                        covered = edges[i] + triangle.a[i] * kBlockX[bit] * kSubpixelOne + triangle.b[i] * kBlockY[bit] * kSubpixelOne >= 0;
+                    }
+                }
+                if (!covered) continue;
+                // Early depth test, which takes out the fragments that fail it before they are shaded. Fragments that
+                // are tested again after the shader only write depth there.
+                if (depth_test) {
+                    uint8_t* texel = depth.Texel(x, y);
+                    const float z = PlaneAt(planes, triangle, x, y);
+                    if (!CompareDepth(pipeline.depth_compare, FragmentDepth(depth.format, z), StoredDepth(depth.format, texel))) continue;
+                    if (batch->early_depth_write && pipeline.depth_write) {
+                        const ShaderValue value = ShaderF(z);
+                        EncodeTexel(depth.format, &value, 1, texel);
+                    }
+                }
+                coverage |= 1 << bit;
+            }
+            if (!coverage) continue;
+            if (!pipeline.fragment) {
+                batch->fragments += ShaderBitCount(coverage);
+                continue;
+            }
+            for (uint32_t quad = 0; quad < 4; ++quad) {
+                const uint8_t quad_coverage = (coverage >> (quad * 4)) & 0xf;
+                if (!quad_coverage) continue;
+                batch->quads.push_back({&triangle, block_x + (int32_t)(quad & 1) * 2, block_y + (int32_t)(quad >> 1) * 2, quad_coverage});
+                if (batch->quads.size() == kQuadsPerBatch) ShadeFragments(batch);
+            }
+        }
+    }
+}
+
+// Whether any pixel of a tile may be inside a triangle
+static bool TileOverlaps(const RasterTriangle& triangle, int32_t tile_x, int32_t tile_y) {
+    const int64_t half = kSubpixelOne / 2;
+    for (uint32_t i = 0; i < 3; ++i) {
+        const int64_t edge =
+            triangle.a[i] * (tile_x * kSubpixelOne + half) + triangle.b[i] * (tile_y * kSubpixelOne + half) + triangle.c[i];
+        const int64_t step_x = triangle.a[i] * kSubpixelOne * (kTileSize - 1), step_y = triangle.b[i] * kSubpixelOne * (kTileSize - 1);
+        if (edge + (std::max)(step_x, (int64_t)0) + (std::max)(step_y, (int64_t)0) < 0) return false;
+    }
+    return true;
+}
+
+// Vertices and triangles of a draw are handed to the worker pool in chunks of this many
+static constexpr uint32_t kVerticesPerChunk = 4 * kGraphicsShaderLanes;
+static constexpr uint32_t kTrianglesPerChunk = 1024;
+
+GraphicsDrawCounts RunGraphicsDraw(ParallelExecutor* worker_pool, const GraphicsDraw& draw) {
+    const GraphicsPipeline& pipeline = *draw.pipeline;
+    GraphicsDrawCounts counts = {};
+    std::vector<uint32_t> vertex_ids, sequence, triangles;
+    GatherVertices(draw, &vertex_ids, &sequence);
+    AssembleTriangles(pipeline.topology, sequence, &triangles);
+    const uint32_t vertex_count = (uint32_t)vertex_ids.size();
+    const uint32_t triangle_count = (uint32_t)(triangles.size() / 3);
+    counts.vertices = (uint64_t)draw.count * draw.instance_count;
+    counts.primitives = (uint64_t)triangle_count * draw.instance_count;
+    if (!vertex_count || !triangle_count || !draw.instance_count) return counts;
+
+    // Vertex shading, one instance after another
+    const uint32_t stride = kVertexPosition + (uint32_t)pipeline.varyings.size();
+    std::vector<float> vertices((size_t)vertex_count * draw.instance_count * stride);
+    const uint32_t vertex_chunks = (vertex_count + kVerticesPerChunk - 1) / kVerticesPerChunk;
+    worker_pool->ParallelFor(vertex_chunks * draw.instance_count, [&](uint32_t chunk) {
+        const uint32_t instance = chunk / vertex_chunks;
+        const uint32_t first = chunk % vertex_chunks * kVerticesPerChunk;
+        ShadeVertices(draw, vertex_ids.data(), instance, first, (std::min)(first + kVerticesPerChunk, vertex_count),
+                      vertices.data() + (size_t)instance * vertex_count * stride);
+    });
+    if (pipeline.rasterizer_discard || draw.rect.extent.width == 0 || draw.rect.extent.height == 0) return counts;
+
+    // Setup of the triangles of all instances, in order
+    const uint32_t triangle_chunks = (triangle_count + kTrianglesPerChunk - 1) / kTrianglesPerChunk;
+    std::vector<TriangleSetup> setups(triangle_chunks * draw.instance_count);
+    const float width = std::fabs(draw.viewport.width), height = std::fabs(draw.viewport.height);
+    worker_pool->ParallelFor((uint32_t)setups.size(), [&](uint32_t chunk) {
+        TriangleSetup& setup = setups[chunk];
+        setup.draw = &draw;
+        setup.varying_count = (uint32_t)pipeline.varyings.size();
+        setup.guard_x = width > 0.0f ? 1.0f + 2.0f * kGuardBand / width : 1.0f;
+        setup.guard_y = height > 0.0f ? 1.0f + 2.0f * kGuardBand / height : 1.0f;
+        setup.clip_planes = pipeline.depth_clamp ? ((1u << kClipPlaneCount) - 1) & ~kDepthClipPlanes : (1u << kClipPlaneCount) - 1;
+        const uint32_t instance = chunk / triangle_chunks;
+        const uint32_t first = chunk % triangle_chunks * kTrianglesPerChunk;
+        const uint32_t last = (std::min)(first + kTrianglesPerChunk, triangle_count);
+        const float* instance_vertices = vertices.data() + (size_t)instance * vertex_count * stride;
+        for (uint32_t i = first; i < last; ++i) {
+            const float* corners[3] = {instance_vertices + (size_t)triangles[i * 3] * stride,
+                                       instance_vertices + (size_t)triangles[i * 3 + 1] * stride,
+                                       instance_vertices + (size_t)triangles[i * 3 + 2] * stride};
+            SetupTriangle(&setup, corners);
+        }
+    });
+    std::vector<RasterTriangle> raster_triangles;
+    std::vector<float> planes;
+    for (const auto& setup : setups) {
+        for (RasterTriangle triangle : setup.triangles) {
+            triangle.planes += planes.size();
+            raster_triangles.push_back(triangle);
+        }
+        planes.insert(planes.end(), setup.planes.begin(), setup.planes.end());
+    }
+    if (raster_triangles.empty()) return counts;
+
+    // Binning, each tile getting the triangles that may cover it in order
+    const int32_t first_tile_x = draw.rect.offset.x / kTileSize, first_tile_y = draw.rect.offset.y / kTileSize;
+    const uint32_t tiles_x = (uint32_t)((draw.rect.offset.x + (int32_t)draw.rect.extent.width - 1) / kTileSize - first_tile_x + 1);
+    const uint32_t tiles_y = (uint32_t)((draw.rect.offset.y + (int32_t)draw.rect.extent.height - 1) / kTileSize - first_tile_y + 1);
+    std::vector<std::vector<uint32_t>> bins((size_t)tiles_x * tiles_y);
+    for (uint32_t i = 0; i < raster_triangles.size(); ++i) {
+        const RasterTriangle& triangle = raster_triangles[i];
+        for (int32_t tile_y = triangle.min_y / kTileSize; tile_y <= triangle.max_y / kTileSize; ++tile_y) {
+            for (int32_t tile_x = triangle.min_x / kTileSize; tile_x <= triangle.max_x / kTileSize; ++tile_x) {
+                if (!TileOverlaps(triangle, tile_x * kTileSize, tile_y * kTileSize)) continue;
+                bins[(size_t)(tile_y - first_tile_y) * tiles_x + (tile_x - first_tile_x)].push_back(i);
+            }
+        }
+    }
+    std::vector<uint32_t> tiles;
+    for (uint32_t i = 0; i < bins.size(); ++i) {
+        if (!bins[i].empty()) tiles.push_back(i);
+    }
+
+    // Depth is written before shading unless the shader may change it or discard the fragment. When it is only
+    // tested then, fragments that fail are still taken out early if they would fail after the shader as well.
+    const ShaderProgram* fragment = pipeline.fragment.get();
+    const bool frag_depth = fragment && fragment->builtin_offsets[kBuiltInFragDepth] != kUnusedShaderOffset;
+    const bool early_depth_write = !fragment || fragment->early_fragment_tests || (!frag_depth && !fragment->kills);
+    const bool early_depth_test =
+        early_depth_write || (!frag_depth && (pipeline.depth_compare != VK_COMPARE_OP_NOT_EQUAL || !pipeline.depth_write));
+    std::atomic<uint64_t> fragments{0};
+    worker_pool->ParallelFor((uint32_t)tiles.size(), [&](uint32_t index) {
+        const uint32_t tile = tiles[index];
+        const int32_t tile_x = (first_tile_x + (int32_t)(tile % tiles_x)) * kTileSize;
+        const int32_t tile_y = (first_tile_y + (int32_t)(tile / tiles_x)) * kTileSize;
+        FragmentBatch batch;
+        batch.draw = &draw;
+        batch.planes = planes.data();
+        batch.early_depth_test = early_depth_test;
+        batch.early_depth_write = early_depth_write;
+        batch.late_depth = !early_depth_write;
+        batch.quads.reserve(kQuadsPerBatch);
+        for (const uint32_t i : bins[tile]) RasterizeTriangle(raster_triangles[i], tile_x, tile_y, &batch);
+        ShadeFragments(&batch);
+        fragments.fetch_add(batch.fragments, std::memory_order_relaxed);
+    });
+    counts.fragments = fragments.load(std::memory_order_relaxed);
+    return counts;
+}
+
+}  // namespace vkmock
@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MOCK_ICD_SHADER_H
+#define MOCK_ICD_SHADER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vkmock {
+
+// SPIR-V shader execution
+//
+// With VK_MOCK_ICD_EXECUTE_SHADERS set to a list that contains "compute", vkCmdDispatch runs the compute shader of the
+// bound pipeline against the memory of the buffers bound to it. The SPIR-V is compiled once, when the pipeline is
+// created, into a ShaderProgram: a flat array of register-based instructions in which every SPIR-V result has fixed
+// registers, memory accesses are resolved to byte offsets and function calls are inlined. A register holds one 32-bit
+// value for every invocation of a workgroup, and each instruction runs for all of the invocations that are at it
+// before the next instruction does, so it's the loops over invocations that the host compiler vectorizes.
+// Invocations that branch apart are run in groups that share a program counter, lowest first, which brings them
+// back together at the merge blocks of structured control flow. The workgroups of a dispatch are spread across the
+// worker pool of the device.
+//
+// Shaders can use 32-bit integer, float and bool scalars, vectors, matrices, arrays and structs, uniform and storage
+// buffers, push constants, workgroup memory, barriers, 32-bit integer atomics and most of GLSL.std.450. Pipelines
+// whose shaders use anything else aren't compiled, and dispatching them does nothing, like before.
+//
+// With a list that contains "graphics", vkCmdDraw and vkCmdDrawIndexed in render passes run the vertex and fragment
+// shaders of the bound pipeline and rasterize triangles into the memory of the color and depth attachments, and
+// render passes clear their attachments. Vertex shaders run in batches of vertices; the triangles are
+// clipped, set up and binned into screen tiles, which the worker pool rasterizes in parallel, 4x4 blocks of pixels at
+// a time. Fragment shaders run in 2x2 quads, which gives them derivatives and implicit levels of detail for sampling
+// 1D and 2D textures through combined image samplers.
+//
+// mock_icd.cpp resolves the pipelines, descriptors and attachments of the commands into the structures below and
+// hands them to the functions declared here.
+
+// Runs the workgroups of dispatches and the vertices and tiles of draws in parallel. The WorkerPool of the device
+// implements it.
+class ParallelExecutor {
+  public:
+    // Call func(index) for every index in [0, count), spread across the workers and the calling thread
+    virtual void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func) = 0;
+
+  protected:
+    ~ParallelExecutor() = default;
+};
+
+// Execution models of the entry points the compiler compiles
+static constexpr uint32_t kSpvExecutionModelVertex = 0;
+static constexpr uint32_t kSpvExecutionModelFragment = 4;
+static constexpr uint32_t kSpvExecutionModelGLCompute = 5;
+
+// A register of a ShaderProgram holds one of these for every invocation of the workgroup. Bools are 0 or 1, pointers
+// are byte offsets into the memory of the variable they point into.
+union ShaderValue {
+    uint32_t u;
+    int32_t i;
+    float f;
+};
+
+// Instructions of a ShaderProgram. Unless noted otherwise they apply to count components: component k of dst, a, b
+// and c is in register dst + k, a + k and so on.
+enum class ShaderOp : uint8_t {
+    Mov,
+    // Float operations
+    FNegate, FAbs, FSign, Floor, Ceil, Trunc, Round, RoundEven, Fract, Sqrt, InverseSqrt, Exp, Exp2, Log, Log2,
+    Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, IsNan, IsInf, ConvertFToU, ConvertFToS,
+    FAdd, FSub, FMul, FDiv, FRem, FMod, FMin, FMax, Atan2, Pow, Step,
+    FOrdEqual, FOrdNotEqual, FOrdLess, FOrdLessEqual, FUnordEqual, FUnordNotEqual, FUnordLess, FUnordLessEqual,
+    FClamp, FMix, SmoothStep, Fma,
+    // Integer and bool operations
+    SNegate, SAbs, SSign, Not, BitCount, FindILsb, FindSMsb, FindUMsb, ConvertSToF, ConvertUToF, LogicalNot,
+    IAdd, ISub, IMul, UDiv, SDiv, UMod, SRem, SMod, ShiftLeft, ShiftRightLogical, ShiftRightArithmetic,
+    BitAnd, BitOr, BitXor, UMin, UMax, SMin, SMax, IEqual, INotEqual, ULess, ULessEqual, SLess, SLessEqual,
+    UClamp, SClamp,
+    Select,  // dst = a ? b : c
+    // Operations on whole vectors of count components, with a scalar result unless noted otherwise
+    Dot, Length, Any, All,
+    Normalize, Cross, Reflect,  // Vector results
+    ExtractDynamic,             // dst = component b of a
+    InsertDynamic,              // Component b of dst = a
+    // Memory access. imm is the variable the pointer points into, a is the pointer.
+    PtrAdd,        // dst = a + imm (no variable)
+    PtrAddScaled,  // dst = a + b * imm (no variable)
+    Load,          // Component k of dst = the memory at a + memory_offsets[b + k]
+    Store,         // The memory at a + memory_offsets[c + k] = component k of b
+    ArrayLength,   // dst = (size of the variable - b) / c
+    // Atomics on the 32-bit value a points at, dst is the value it held before
+    AtomicLoad, AtomicStore, AtomicExchange, AtomicCompareExchange, AtomicAdd, AtomicSub, AtomicSMin, AtomicUMin,
+    AtomicSMax, AtomicUMax, AtomicAnd, AtomicOr, AtomicXor,  // With the operand b, and the comparator c for exchanges
+    // Fragment shader operations. The invocations run in 2x2 quads of lanes 4n to 4n + 3, x varying fastest, and
+    // derivatives are the differences between the values of the lanes of a quad.
+    DPdx, DPdy,              // Fine derivatives, along the row or column of the lane
+    DPdxCoarse, DPdyCoarse,  // Along the first row or column of the quad
+    Sample,                  // dst (a vec4) = texture imm at the count coordinates of a, with the ShaderSampleMode c and its lod b
+    // Control flow, which moves each invocation to a program counter of its own
+    Jump,           // To imm
+    Branch,         // To imm if a, to b otherwise
+    Switch,         // To the target of the case of switch_cases[imm..] that matches a, to b if none does
+    Barrier,        // Wait for all invocations of the workgroup
+    MemoryBarrier,  // Make the writes of the invocation visible to other workgroups
+    Exit,           // The invocation is done
+    Kill,           // The invocation is done and its outputs are discarded
+};
+
+enum ShaderSampleMode : uint32_t {
+    kSampleImplicitLod,  // From the derivatives of the coordinates
+    kSampleBias,         // From the derivatives, plus the bias
+    kSampleExplicitLod,
+};
+
+struct ShaderInstruction {
+    ShaderOp op;
+    uint8_t scalar_operands;  // Bit n set if operand n (a, b, c) is a scalar that applies to all components
+    uint16_t count;
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t imm;
+};
+
+// Where the memory of a variable comes from when a workgroup runs
+enum class ShaderMemory : uint8_t {
+    Lane,          // Function, Private, Input and Output variables, of which every invocation has its own
+    Workgroup,     // Shared by the invocations of a workgroup
+    PushConstant,  // The push constants of the command buffer
+    Buffer,        // The uniform or storage buffer bound to set and binding
+    Opaque,        // Images, samplers and arrays of buffers, which can't be accessed
+};
+
+struct ShaderVariable {
+    ShaderMemory memory;
+    uint32_t offset;  // Of Lane and Workgroup variables in their memory
+    uint32_t size;    // Of Lane and Workgroup variables
+    uint32_t set;
+    uint32_t binding;
+};
+
+// Built-ins of the lane memory of the program. Inputs are written there before the invocations run, outputs are read
+// from there after they are done.
+enum ShaderBuiltIn : uint32_t {
+    kBuiltInGlobalInvocationId,
+    kBuiltInLocalInvocationId,
+    kBuiltInWorkgroupId,
+    kBuiltInNumWorkgroups,
+    kBuiltInLocalInvocationIndex,
+    kBuiltInVertexIndex,
+    kBuiltInInstanceIndex,
+    kBuiltInFragCoord,
+    kBuiltInFrontFacing,
+    kBuiltInPosition,   // Output of vertex shaders
+    kBuiltInFragDepth,  // Output of fragment shaders
+    kShaderBuiltInCount,
+};
+static constexpr uint32_t kUnusedShaderOffset = UINT32_MAX;
+
+// A vector of the Location inputs or outputs of a vertex or fragment shader. Variables that span several locations
+// are split into a vector per location.
+enum class ShaderInterpolation : uint8_t { Perspective, Linear, Flat };
+struct ShaderInterface {
+    uint32_t location;
+    uint32_t component;  // The first one of the location the vector takes
+    uint32_t components;
+    uint32_t offset;  // In lane memory
+    ShaderInterpolation interpolation;
+};
+
+// An image that Sample instructions sample, with the sampler they sample it with. Both are found at the set and
+// binding of the descriptor that holds them, which is the same one for combined image samplers.
+struct ShaderTextureBinding {
+    uint32_t image_set;
+    uint32_t image_binding;
+    uint32_t sampler_set;
+    uint32_t sampler_binding;
+    uint32_t dimensions;  // 1 or 2
+    bool arrayed;
+};
+
+struct ShaderProgram {
+    std::vector<ShaderInstruction> code;
+    std::vector<uint32_t> memory_offsets;  // Byte offsets of the components Load and Store move
+    std::vector<uint32_t> switch_cases;    // Pairs of a literal and a target of Switch instructions
+    std::vector<ShaderVariable> variables;
+    std::vector<std::pair<uint32_t, ShaderValue>> constants;  // Registers that hold the same value in every lane
+    uint32_t register_count = 0;
+    uint32_t lane_memory_size = 0;
+    uint32_t workgroup_memory_size = 0;
+    uint32_t local_size[3] = {1, 1, 1};
+    uint32_t builtin_offsets[kShaderBuiltInCount];  // In lane memory, kUnusedShaderOffset if the program doesn't use it
+    // Of vertex and fragment shaders
+    std::vector<ShaderInterface> inputs;
+    std::vector<ShaderInterface> outputs;
+    std::vector<ShaderTextureBinding> textures;  // Indexed by the imm of Sample instructions
+    bool early_fragment_tests = false;
+    bool kills = false;  // Has Kill instructions
+    // Tells programs apart in the per-thread state of the threads that run them, set by the compiler
+    uint64_t serial = 0;
+
+    uint32_t LaneCount() const { return local_size[0] * local_size[1] * local_size[2]; }
+};
+
+// Compiles an entry point of a SPIR-V module into a ShaderProgram. Everything the compiler doesn't understand fails
+// the compilation, rather than leaving the program to compute something else than the shader, and null is returned.
+std::unique_ptr<ShaderProgram> CompileShader(const uint32_t* words, size_t word_count, const char* entry_point, uint32_t execution_model,
+                                             const VkSpecializationInfo* specialization);
+
+// Memory a variable of a ShaderProgram is accessed in while it runs. Lane variables are lane_stride bytes apart
+// between invocations, the other kinds of memory are shared by all of them.
+struct ShaderMemoryRange {
+    uint8_t* base;  // Null for memory that can't be accessed
+    uint64_t size;
+    uint32_t lane_stride;
+};
+
+inline ShaderValue ShaderU(uint32_t u) {
+    ShaderValue value;
+    value.u = u;
+    return value;
+}
+inline ShaderValue ShaderI(int32_t i) {
+    ShaderValue value;
+    value.i = i;
+    return value;
+}
+inline ShaderValue ShaderF(float f) {
+    ShaderValue value;
+    value.f = f;
+    return value;
+}
+
+// Formats of the images that are sampled and rendered to: color formats of 8, 16 and 32-bit components, and the
+// depth of the depth/stencil formats
+enum class TexelType : uint8_t { Unorm, Snorm, Uscaled, Sscaled, Uint, Sint, Srgb, Float };
+struct TexelFormat {
+    TexelType type;
+    uint8_t components;  // 0 for the formats that aren't supported
+    uint8_t bits;        // Of each component, 24 for the depth of the D24 formats
+    bool bgr;            // Red and blue are swapped in memory
+};
+
+TexelFormat GetTexelFormat(VkFormat format);
+// Write the RGBA components of write_mask to a texel
+void EncodeTexel(const TexelFormat& format, const ShaderValue* rgba, uint32_t write_mask, uint8_t* texel);
+
+// The image view and sampler a Sample instruction reads, resolved from the descriptors when the draw starts
+static constexpr uint32_t kMaxTextureLevels = 16;
+struct ShaderTexture {
+    struct Level {
+        const uint8_t* base;  // Of the first layer of the view
+        uint32_t width;
+        uint32_t height;
+        size_t row_pitch;
+        size_t layer_pitch;
+    };
+    Level levels[kMaxTextureLevels];
+    uint32_t level_count = 0;  // 0 when there is nothing to sample, which reads as 0
+    uint32_t layer_count = 0;
+    uint32_t dimensions = 0;
+    TexelFormat format;
+    uint32_t texel_size = 0;
+    uint8_t swizzle[4];  // Component of the texel of each component of the result, 4 for 0 and 5 for 1
+    bool mag_linear = false;
+    bool min_linear = false;
+    bool mip_linear = false;
+    bool unnormalized = false;
+    VkSamplerAddressMode address_modes[2];
+    float lod_bias = 0.0f;
+    float min_lod = 0.0f;
+    float max_lod = 0.0f;
+    ShaderValue border[4];
+};
+
+// A vkCmdDispatch* of a compute program, with the memory of its push constants and buffers resolved
+struct ComputeDispatch {
+    const ShaderProgram* program;
+    std::vector<ShaderMemoryRange> bound_memory;  // Per variable of the program
+    std::vector<ShaderTexture> textures;          // Per texture binding of the program
+    uint32_t base[3];
+    uint32_t count[3];
+};
+
+void RunComputeDispatch(ParallelExecutor* worker_pool, const ComputeDispatch& dispatch);
+
+// Graphics pipelines, in the form the rasterizer runs them
+static constexpr uint32_t kMaxVertexBindings = 16;  // maxVertexInputBindings
+static constexpr uint32_t kMaxColorTargets = 4;     // maxColorAttachments
+
+struct GraphicsPipeline {
+    std::shared_ptr<const ShaderProgram> vertex;
+    std::shared_ptr<const ShaderProgram> fragment;  // Null for pipelines that only write depth
+    struct VertexBinding {
+        uint32_t stride;
+        bool per_instance;
+    };
+    VertexBinding bindings[kMaxVertexBindings] = {};
+    // Vertex attributes, each read into an input vector of the vertex shader
+    struct Attribute {
+        uint32_t binding;
+        uint32_t offset;
+        TexelFormat format;
+        uint32_t size;            // Bytes of the attribute in the vertex buffer
+        uint32_t program_offset;  // Of the input vector in lane memory
+        uint32_t component;       // First component of the attribute that the vector takes
+        uint32_t components;
+    };
+    std::vector<Attribute> attributes;
+    // Scalar inputs of the fragment shader and the outputs of the vertex shader they are interpolated from
+    struct Varying {
+        uint32_t vertex_offset;  // kUnusedShaderOffset when the vertex shader doesn't write it, which reads as 0
+        uint32_t fragment_offset;
+        ShaderInterpolation interpolation;
+    };
+    std::vector<Varying> varyings;
+    bool flat_varyings = false;
+    std::vector<ShaderInterface> color_outputs;  // Outputs of the fragment shader to locations below kMaxColorTargets
+    VkPrimitiveTopology topology;
+    bool primitive_restart;
+    bool rasterizer_discard;
+    bool depth_clamp;
+    VkCullModeFlags cull_mode;
+    VkFrontFace front_face;
+    bool depth_test;
+    bool depth_write;
+    VkCompareOp depth_compare;
+    struct Blend {
+        bool enable;
+        VkBlendFactor src_color;
+        VkBlendFactor dst_color;
+        VkBlendOp color_op;
+        VkBlendFactor src_alpha;
+        VkBlendFactor dst_alpha;
+        VkBlendOp alpha_op;
+        VkColorComponentFlags write_mask;
+    };
+    Blend blends[kMaxColorTargets] = {};
+    // State that command buffers set instead when it's dynamic
+    bool dynamic_viewport;
+    bool dynamic_scissor;
+    bool dynamic_blend_constants;
+    VkViewport viewport;
+    VkRect2D scissor;
+    float blend_constants[4];
+};
+
+// Match the inputs of the fragment shader with the outputs of the vertex shader by location and component. Inputs
+// the vertex shader doesn't write read as 0.
+void LinkGraphicsShaders(GraphicsPipeline* pipeline);
+
+// An attachment a draw renders to: the first layer of the mip level of an image view
+struct RenderTarget {
+    uint8_t* base = nullptr;  // Null when there is nothing to render to
+    TexelFormat format = {};
+    uint32_t texel_size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t row_pitch = 0;
+
+    uint8_t* Texel(uint32_t x, uint32_t y) const { return base + y * row_pitch + (size_t)x * texel_size; }
+};
+
+// A vkCmdDraw* of a graphics pipeline, with its buffers, textures and attachments resolved
+struct GraphicsDraw {
+    const GraphicsPipeline* pipeline;
+    std::vector<ShaderMemoryRange> vertex_memory;  // Per variable of the vertex shader
+    std::vector<ShaderMemoryRange> fragment_memory;
+    std::vector<ShaderTexture> vertex_textures;  // Per texture of the vertex shader
+    std::vector<ShaderTexture> fragment_textures;
+    ShaderMemoryRange vertex_buffers[kMaxVertexBindings] = {};  // From the bound offset to the end of the buffer
+    ShaderMemoryRange index_buffer = {};
+    uint32_t index_size = 0;  // In bytes, 0 for draws that aren't indexed
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first;  // Vertex or index
+    int32_t vertex_offset;
+    uint32_t first_instance;
+    VkViewport viewport;
+    VkRect2D rect;  // Pixels the draw may write: the scissor within the render area and the attachments
+    float blend_constants[4];
+    RenderTarget colors[kMaxColorTargets];  // By location of the outputs of the fragment shader
+    RenderTarget depth;
+};
+
+struct GraphicsDrawCounts {
+    uint64_t vertices;
+    uint64_t primitives;
+    uint64_t fragments;  // That passed the depth test
+};
+
+bool IsTriangleTopology(VkPrimitiveTopology topology);
+
+// Run a draw: shade its vertices, assemble, clip and set up its triangles, bin them into tiles and rasterize the
+// tiles in parallel. Tiles don't share pixels, and each one rasterizes its triangles in order, so fragments are
+// written in the order the API asks for.
+GraphicsDrawCounts RunGraphicsDraw(ParallelExecutor* worker_pool, const GraphicsDraw& draw);
+
+}  // namespace vkmock
+
+#endif  // MOCK_ICD_SHADER_H
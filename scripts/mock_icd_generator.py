@@ -32,11 +32,53 @@ from common_codegen import *
 # Mock header code
 HEADER_C_CODE = '''
 using mutex_t = std::mutex;
-using lock_guard_t = std::lock_guard<mutex_t>;
-using unique_lock_t = std::unique_lock<mutex_t>;
+
+// Opt-in call statistics, written to the file VK_MOCK_ICD_CALL_STATS names. See CallTimer.
+static const char* const call_stats_path = getenv("VK_MOCK_ICD_CALL_STATS");
+static const bool call_stats_enabled = call_stats_path && *call_stats_path;
+static void RecordLockWait(std::chrono::steady_clock::duration wait);
+
+// Locks of the ICD's internal mutexes. Acquisitions that have to wait are timed when call statistics are enabled, the
+// uncontended path costs the same as std::mutex::lock().
+static inline void AcquireLock(std::unique_lock<mutex_t>& lock) {
+    if (lock.try_lock()) return;
+    if (!call_stats_enabled) {
+        lock.lock();
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    RecordLockWait(std::chrono::steady_clock::now() - start);
+}
+class unique_lock_t : public std::unique_lock<mutex_t> {
+  public:
+    explicit unique_lock_t(mutex_t& mutex) : std::unique_lock<mutex_t>(mutex, std::defer_lock) { AcquireLock(*this); }
+};
+class lock_guard_t {
+  public:
+    explicit lock_guard_t(mutex_t& mutex) : lock_(mutex) {}
+
+  private:
+    unique_lock_t lock_;
+};
 
 static mutex_t global_lock;
-static uint64_t global_unique_handle = 1;
+static std::atomic<uint64_t> global_unique_handle{1};
+// Non-dispatchable handles are handed out from blocks reserved per thread, so creating an object
+// needs neither a lock nor a shared atomic increment except once every kHandleBlockSize handles.
+static constexpr uint64_t kHandleBlockSize = 256;
+static uint64_t NewHandle() {
+    struct HandleBlock {
+        uint64_t next;
+        uint64_t end;
+    };
+    static thread_local HandleBlock block = {0, 0};
+    if (block.next == block.end) {
+        block.next = global_unique_handle.fetch_add(kHandleBlockSize, std::memory_order_relaxed);
+        block.end = block.next + kHandleBlockSize;
+    }
+    return block.next++;
+}
 static const uint32_t SUPPORTED_LOADER_ICD_INTERFACE_VERSION = 5;
 static uint32_t loader_interface_version = 0;
 static bool negotiate_loader_icd_interface_called = false;
@@ -45,31 +87,3523 @@ static void* CreateDispObjHandle() {
     set_loader_magic_value(handle);
     return handle;
 }
-static void DestroyDispObjHandle(void* handle) {
-    delete reinterpret_cast<VK_LOADER_DATA*>(handle);
+static void DestroyDispObjHandle(void* handle) {
+    delete reinterpret_cast<VK_LOADER_DATA*>(handle);
+}
+
+// Entries of the name lookup tables generated below. The tables only hold string literals and function
+// addresses, so they are constant initialized at load time and can be searched without allocating.
+struct NameToFuncPtr {
+    const char* name;
+    void* funcptr;
+};
+struct ExtensionNameToVersion {
+    const char* name;
+    uint32_t spec_version;
+};
+template <typename Entry, size_t N>
+static constexpr uint32_t TableSize(const Entry (&)[N]) {
+    return (uint32_t)N;
+}
+// Binary search of a table that is sorted by name
+template <typename Entry, size_t N>
+static const Entry* FindByName(const Entry (&table)[N], const char* name) {
+    const auto entry = std::lower_bound(table, table + N, name,
+                                        [](const Entry& lhs, const char* rhs) { return std::strcmp(lhs.name, rhs) < 0; });
+    if (entry != table + N && std::strcmp(entry->name, name) == 0) return entry;
+    return nullptr;
+}
+// 32-bit FNV-1a, must match hash_name() in mock_icd_generator.py
+static inline uint32_t HashName(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; ++name) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash;
+}
+static constexpr uint16_t kEmptySlot = 0xFFFF;
+
+// Entries of the tables of struct members that device profiles can set, which are generated below
+enum class ProfileFieldType : uint32_t { Bool32, Uint32, Int32, Uint64, Size, Float };
+struct ProfileField {
+    const char* name;
+    uint32_t offset;
+    ProfileFieldType type;
+    uint32_t count;  // Of array elements, 1 for scalars
+};
+'''
+
+# Structs whose members device profiles can set, and the names of their generated ProfileField tables
+PROFILE_STRUCTS = {
+    'VkPhysicalDeviceFeatures': 'physical_device_features_fields',
+    'VkPhysicalDeviceLimits': 'physical_device_limits_fields',
+}
+# ProfileFieldType of each member type of the PROFILE_STRUCTS
+PROFILE_FIELD_TYPES = {
+    'VkBool32': 'Bool32',
+    'uint32_t': 'Uint32',
+    'VkSampleCountFlags': 'Uint32',
+    'int32_t': 'Int32',
+    'VkDeviceSize': 'Uint64',
+    'size_t': 'Size',
+    'float': 'Float',
+}
+# Arrays that the struct parameters of vkCmd* commands point to and that executing the commands reads. They are
+# recorded right after the struct, the pointers in the recorded struct dangle once the command has been recorded.
+RECORDED_MEMBER_ARRAYS = {
+    'VkRenderPassBeginInfo': [('pClearValues', 'clearValueCount')],
+}
+
+# Manual code at the top of the cpp source file
+SOURCE_CPP_PREFIX = '''
+using std::unordered_map;
+
+static constexpr uint32_t kSupportedVulkanAPIVersion = VK_API_VERSION_1_1;
+static unordered_map<VkInstance, std::vector<VkPhysicalDevice>> physical_device_map;
+
+static constexpr uint32_t icd_swapchain_image_count = 1;
+
+// Call statistics
+//
+// When VK_MOCK_ICD_CALL_STATS is set, every intercept is timed by a CallTimer. Each thread keeps its call counts, total
+// and bucketed latencies, and the time it waited for the ICD's internal locks in counters of its own, so recording them
+// needs neither a lock nor an atomic read-modify-write. vkDestroyInstance merges the counters of all threads and writes
+// them to the file VK_MOCK_ICD_CALL_STATS names, as CSV if the name ends in .csv and as JSON otherwise.
+
+// Latency bucket i counts the calls that took [2^i, 2^(i+1)) ns, the last bucket also counts all longer calls
+static constexpr uint32_t kLatencyBucketCount = 32;
+// Counters of the time spent outside of any intercept, such as the lock waits of queue threads
+static constexpr uint32_t kInternalCallStats = kEntryPointCount;
+
+struct CallCounters {
+    // Only the owning thread writes these, with a relaxed load and store that compile to plain moves. They are
+    // atomic so that WriteCallStats() can read them while their thread keeps counting.
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> lock_waits;
+    std::atomic<uint64_t> lock_wait_ns;
+    std::atomic<uint64_t> latency[kLatencyBucketCount];
+};
+struct ThreadCallStats {
+    bool in_use;  // Guarded by call_stats_lock
+    CallCounters counters[kEntryPointCount + 1];
+};
+
+// Counters of all threads that have been timed. The counters of threads that have exited are reused by new threads.
+// The mutex is a plain std::mutex so that waiting for it isn't recorded as a lock wait itself.
+static std::mutex call_stats_lock;
+static std::vector<ThreadCallStats*> call_stats;
+
+struct ThreadCallStatsSlot {
+    ThreadCallStats* stats = nullptr;
+    ~ThreadCallStatsSlot() {
+        if (!stats) return;
+        std::lock_guard<std::mutex> lock(call_stats_lock);
+        stats->in_use = false;
+    }
+};
+static thread_local ThreadCallStatsSlot thread_call_stats;
+// The outermost intercept the thread is in, kInternalCallStats outside of intercepts
+static thread_local uint32_t current_entry_point = kInternalCallStats;
+
+static CallCounters& GetCallCounters(uint32_t entry_point) {
+    ThreadCallStats*& stats = thread_call_stats.stats;
+    if (!stats) {
+        std::lock_guard<std::mutex> lock(call_stats_lock);
+        auto unused = std::find_if(call_stats.begin(), call_stats.end(), [](const ThreadCallStats* s) { return !s->in_use; });
+        if (unused != call_stats.end()) {
+            stats = *unused;
+        } else {
+            stats = new ThreadCallStats();
+            call_stats.push_back(stats);
+        }
+        stats->in_use = true;
+    }
+    return stats->counters[entry_point];
+}
+
+static void AddToCounter(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static uint32_t GetLatencyBucket(uint64_t ns) {
+    uint32_t bucket = 0;
+    while (ns > 1 && bucket + 1 < kLatencyBucketCount) {
+        ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+static void RecordLockWait(std::chrono::steady_clock::duration wait) {
+    auto& counters = GetCallCounters(current_entry_point);
+    AddToCounter(counters.lock_waits, 1);
+    AddToCounter(counters.lock_wait_ns, std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count());
+}
+
+static void WriteCallStats() {
+    struct MergedCounters {
+        uint64_t calls;
+        uint64_t total_ns;
+        uint64_t lock_waits;
+        uint64_t lock_wait_ns;
+        uint64_t latency[kLatencyBucketCount];
+    };
+    std::vector<MergedCounters> merged(kEntryPointCount + 1, MergedCounters());
+    {
+        std::lock_guard<std::mutex> lock(call_stats_lock);
+        for (const auto stats : call_stats) {
+            for (uint32_t i = 0; i <= kEntryPointCount; ++i) {
+                const auto& counters = stats->counters[i];
+                merged[i].calls += counters.calls.load(std::memory_order_relaxed);
+                merged[i].total_ns += counters.total_ns.load(std::memory_order_relaxed);
+                merged[i].lock_waits += counters.lock_waits.load(std::memory_order_relaxed);
+                merged[i].lock_wait_ns += counters.lock_wait_ns.load(std::memory_order_relaxed);
+                for (uint32_t bucket = 0; bucket < kLatencyBucketCount; ++bucket)
+                    merged[i].latency[bucket] += counters.latency[bucket].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    FILE* file = fopen(call_stats_path, "w");
+    if (!file) return;
+    const size_t path_length = strlen(call_stats_path);
+    const bool csv = path_length >= 4 && strcmp(call_stats_path + path_length - 4, ".csv") == 0;
+    // EntryPoint values index name_to_funcptr_map
+    auto name = [](uint32_t i) { return i == kInternalCallStats ? "(internal)" : name_to_funcptr_map[i].name; };
+    if (csv) {
+        fprintf(file, "name,calls,total_ns,lock_waits,lock_wait_ns");
+        for (uint32_t bucket = 0; bucket < kLatencyBucketCount; ++bucket)
+            fprintf(file, ",latency_%llu_ns", bucket ? 1ull << bucket : 0ull);
+        fprintf(file, "\\n");
+    } else {
+        fprintf(file, "{\\n    \\"latency_bucket_ns\\": [");
+        for (uint32_t bucket = 0; bucket < kLatencyBucketCount; ++bucket)
+            fprintf(file, "%s%llu", bucket ? ", " : "", bucket ? 1ull << bucket : 0ull);
+        fprintf(file, "],\\n    \\"entry_points\\": {");
+    }
+    bool first = true;
+    for (uint32_t i = 0; i <= kEntryPointCount; ++i) {
+        const auto& counters = merged[i];
+        if (!counters.calls && !counters.lock_waits) continue;
+        if (csv) {
+            fprintf(file, "%s,%llu,%llu,%llu,%llu", name(i), (unsigned long long)counters.calls,
+                    (unsigned long long)counters.total_ns, (unsigned long long)counters.lock_waits,
+                    (unsigned long long)counters.lock_wait_ns);
+            for (uint32_t bucket = 0; bucket < kLatencyBucketCount; ++bucket)
+                fprintf(file, ",%llu", (unsigned long long)counters.latency[bucket]);
+            fprintf(file, "\\n");
+        } else {
+            fprintf(file,
+                    "%s\\n        \\"%s\\": {\\"calls\\": %llu, \\"total_ns\\": %llu, "
+                    "\\"lock_waits\\": %llu, \\"lock_wait_ns\\": %llu, \\"latency\\": [",
+                    first ? "" : ",", name(i), (unsigned long long)counters.calls, (unsigned long long)counters.total_ns,
+                    (unsigned long long)counters.lock_waits, (unsigned long long)counters.lock_wait_ns);
+            for (uint32_t bucket = 0; bucket < kLatencyBucketCount; ++bucket)
+                fprintf(file, "%s%llu", bucket ? ", " : "", (unsigned long long)counters.latency[bucket]);
+            fprintf(file, "]}");
+        }
+        first = false;
+    }
+    if (!csv) fprintf(file, "\\n    }\\n}\\n");
+    fclose(file);
+}
+
+// API trace
+//
+// When VK_MOCK_ICD_TRACE names a file, every intercept the application calls also writes a TraceRecord of its handle
+// and scalar arguments to a ring buffer of the calling thread. Writing a record takes no lock and formats nothing. A
+// background thread drains the rings to the file every millisecond, and vkDestroyInstance flushes them. Destroying the
+// last instance stops the thread and closes the file, and creating an instance again reopens it to append to it. When a
+// ring is full the call isn't recorded and a record of the number of dropped calls is written instead.
+//
+// The file starts with a TraceFileHeader, then the name and the comma separated argument names of every EntryPoint as
+// NUL terminated strings, then the TraceRecords in the order they were drained, which is in order of time per thread
+// only. scripts/mock_icd_trace.py prints the file or converts it to the Chrome trace event format.
+
+static const char* const trace_path = getenv("VK_MOCK_ICD_TRACE");
+static const bool trace_enabled = trace_path && *trace_path;
+
+static constexpr uint32_t kTraceFileVersion = 1;
+static constexpr uint32_t kMaxTraceArgs = 8;  // The generator passes the first this many handles and scalars
+static constexpr uint64_t kTraceRingSize = 1 << 15;  // Records per thread, a power of two
+
+struct TraceFileHeader {
+    char magic[8];  // "VKMOCKTR"
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t entry_point_count;
+    uint32_t max_args;
+};
+// Kinds of the arguments of a TraceRecord, 4 bits each in arg_kinds
+enum TraceArgKind : uint32_t {
+    kTraceArgUnsigned = 0,
+    kTraceArgSigned = 1,
+    kTraceArgFloat = 2,  // Stored as its bits
+    kTraceArgEnum = 3,
+    kTraceArgHandle = 4,
+};
+struct TraceRecord {
+    uint64_t timestamp_ns;  // steady_clock time the call started at
+    uint64_t duration_ns;
+    uint32_t thread_id;    // Threads are numbered from 1 in the order of their first traced call
+    // EntryPoint, or kEntryPointCount in a record of dropped calls. Those hold the number of calls in args[0] and the
+    // time the drain thread noticed them at.
+    uint16_t entry_point;
+    uint16_t arg_count;
+    uint32_t arg_kinds;
+    uint32_t reserved;
+    uint64_t args[kMaxTraceArgs];
+};
+
+static uint64_t GetTraceTimestamp(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+static void AddTraceArg(TraceRecord* record, TraceArgKind kind, uint64_t value) {
+    record->arg_kinds |= kind << (4 * record->arg_count);
+    record->args[record->arg_count++] = value;
+}
+// Dispatchable handles, and non-dispatchable ones on 64-bit platforms
+template <typename T>
+static void SetTraceArg(TraceRecord* record, T* handle) {
+    AddTraceArg(record, kTraceArgHandle, (uint64_t)(uintptr_t)handle);
+}
+template <typename T>
+static typename std::enable_if<std::is_enum<T>::value>::type SetTraceArg(TraceRecord* record, T value) {
+    AddTraceArg(record, kTraceArgEnum, (uint64_t)(int64_t)value);
+}
+template <typename T>
+static typename std::enable_if<std::is_integral<T>::value>::type SetTraceArg(TraceRecord* record, T value) {
+    AddTraceArg(record, std::is_signed<T>::value ? kTraceArgSigned : kTraceArgUnsigned, (uint64_t)value);
+}
+static void SetTraceArg(TraceRecord* record, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    AddTraceArg(record, kTraceArgFloat, bits);
+}
+
+struct TraceRing {
+    // The recording thread fills records[head] and then advances head, the drain thread writes out the records up to
+    // head and then advances tail. The indices only grow, each on a cache line of its own.
+    std::atomic<uint64_t> head;
+    char head_padding[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> tail;
+    char tail_padding[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> dropped;  // Only the recording thread writes this
+    std::atomic<uint32_t> thread_id;
+    uint64_t reported_dropped;  // Only the drain thread accesses this
+    bool in_use;                // Guarded by TraceState::lock
+    TraceRecord records[kTraceRingSize];
+};
+
+// Never destroyed, so that the drain thread can keep running while the process exits without destroying its instances
+struct TraceState {
+    // Guards rings, the in_use flags of the rings, thread_count, file, header_written and stop_drain
+    std::mutex lock;
+    std::vector<TraceRing*> rings;
+    uint32_t thread_count = 0;
+    FILE* file = nullptr;
+    bool header_written = false;  // Once set, the file is appended to when tracing resumes
+    std::thread drain_thread;     // Runs while file is open
+    bool stop_drain = false;
+    std::condition_variable drain_cv;  // Wakes the drain thread up to stop
+    std::mutex drain_lock;             // Serializes DrainTrace()
+};
+static TraceState& GetTraceState() {
+    static TraceState* state = new TraceState();
+    return *state;
+}
+
+static void DrainTrace(TraceState& state, bool flush) {
+    std::lock_guard<std::mutex> drain_lock(state.drain_lock);
+    std::vector<TraceRing*> rings;
+    FILE* file;
+    {
+        std::lock_guard<std::mutex> lock(state.lock);
+        rings = state.rings;
+        file = state.file;
+    }
+    if (!file) return;
+    for (const auto ring : rings) {
+        const uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != ring->reported_dropped) {
+            TraceRecord record = {};
+            record.timestamp_ns = GetTraceTimestamp(std::chrono::steady_clock::now());
+            record.thread_id = ring->thread_id.load(std::memory_order_relaxed);
+            record.entry_point = (uint16_t)kEntryPointCount;
+            AddTraceArg(&record, kTraceArgUnsigned, dropped - ring->reported_dropped);
+            fwrite(&record, sizeof(record), 1, file);
+            ring->reported_dropped = dropped;
+        }
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (uint64_t next = ring->tail.load(std::memory_order_relaxed); next != head;) {
+            const uint64_t index = next & (kTraceRingSize - 1);
+            const uint64_t count = std::min(head - next, kTraceRingSize - index);
+            fwrite(&ring->records[index], sizeof(TraceRecord), count, file);
+            next += count;
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+    if (flush) fflush(file);
+}
+
+static void FlushTrace() { DrainTrace(GetTraceState(), true); }
+
+// Called with state.lock held by the first thread that records a call, and by vkCreateInstance once the trace was
+// closed by destroying the last instance. The records of a resumed trace are appended to the file.
+static void OpenTrace(TraceState& state) {
+    FILE* file = fopen(trace_path, state.header_written ? "ab" : "wb");
+    if (!file) return;
+    if (!state.header_written) {
+        TraceFileHeader header = {{'V', 'K', 'M', 'O', 'C', 'K', 'T', 'R'}, kTraceFileVersion, sizeof(TraceRecord),
+                                  kEntryPointCount, kMaxTraceArgs};
+        fwrite(&header, sizeof(header), 1, file);
+        for (uint32_t i = 0; i < kEntryPointCount; ++i) {
+            fwrite(name_to_funcptr_map[i].name, strlen(name_to_funcptr_map[i].name) + 1, 1, file);
+            fwrite(entry_point_trace_args[i], strlen(entry_point_trace_args[i]) + 1, 1, file);
+        }
+        state.header_written = true;
+    }
+    state.file = file;
+    state.stop_drain = false;
+    state.drain_thread = std::thread([&state] {
+        std::unique_lock<std::mutex> lock(state.lock);
+        while (!state.drain_cv.wait_for(lock, std::chrono::milliseconds(1), [&state] { return state.stop_drain; })) {
+            lock.unlock();
+            DrainTrace(state, false);
+            lock.lock();
+        }
+    });
+}
+
+static void ResumeTrace() {
+    auto& state = GetTraceState();
+    std::lock_guard<std::mutex> lock(state.lock);
+    if (!state.file && state.header_written) OpenTrace(state);
+}
+
+// Stops the drain thread, writes out what is left in the rings and closes the file. Records that are made afterwards
+// stay in the rings until tracing resumes.
+static void CloseTrace() {
+    auto& state = GetTraceState();
+    std::thread drain_thread;
+    {
+        std::lock_guard<std::mutex> lock(state.lock);
+        if (!state.file) return;
+        state.stop_drain = true;
+        drain_thread = std::move(state.drain_thread);
+    }
+    state.drain_cv.notify_one();
+    drain_thread.join();
+    DrainTrace(state, true);
+    std::lock_guard<std::mutex> drain_lock(state.drain_lock);
+    std::lock_guard<std::mutex> lock(state.lock);
+    fclose(state.file);
+    state.file = nullptr;
+}
+
+struct ThreadTraceSlot {
+    TraceRing* ring = nullptr;
+    uint32_t thread_id = 0;
+    ~ThreadTraceSlot() {
+        if (!ring) return;
+        auto& state = GetTraceState();
+        std::lock_guard<std::mutex> lock(state.lock);
+        ring->in_use = false;
+    }
+};
+static thread_local ThreadTraceSlot thread_trace;
+
+static ThreadTraceSlot& GetThreadTrace() {
+    auto& slot = thread_trace;
+    if (slot.ring) return slot;
+    auto& state = GetTraceState();
+    std::lock_guard<std::mutex> lock(state.lock);
+    if (state.rings.empty()) OpenTrace(state);
+    auto unused = std::find_if(state.rings.begin(), state.rings.end(), [](const TraceRing* r) { return !r->in_use; });
+    if (unused != state.rings.end()) {
+        slot.ring = *unused;
+    } else {
+        slot.ring = new TraceRing();
+        state.rings.push_back(slot.ring);
+    }
+    slot.ring->in_use = true;
+    slot.thread_id = ++state.thread_count;
+    slot.ring->thread_id.store(slot.thread_id, std::memory_order_relaxed);
+    return slot;
+}
+
+// Times the intercept it's declared in for the call statistics and records it in the API trace. Calls that intercepts
+// make to other intercepts are part of the outer call and aren't counted or recorded on their own. When neither is
+// enabled this costs a single branch.
+class CallTimer {
+  public:
+    template <typename... Args>
+    explicit CallTimer(EntryPoint entry_point, Args... args) {
+        if (!(call_stats_enabled || trace_enabled) || current_entry_point != kInternalCallStats) return;
+        entry_point_ = (uint32_t)entry_point;
+        current_entry_point = entry_point_;
+        if (trace_enabled) BeginTraceRecord(args...);
+        start_ = std::chrono::steady_clock::now();
+    }
+    ~CallTimer() {
+        if (entry_point_ == kInternalCallStats) return;
+        const auto end = std::chrono::steady_clock::now();
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+        if (call_stats_enabled) {
+            auto& counters = GetCallCounters(entry_point_);
+            AddToCounter(counters.calls, 1);
+            AddToCounter(counters.total_ns, ns);
+            AddToCounter(counters.latency[GetLatencyBucket(ns)], 1);
+        }
+        if (trace_record_) {
+            trace_record_->timestamp_ns = GetTraceTimestamp(start_);
+            trace_record_->duration_ns = ns;
+            thread_trace.ring->head.store(trace_head_ + 1, std::memory_order_release);
+        }
+        current_entry_point = kInternalCallStats;
+    }
+
+  private:
+    template <typename... Args>
+    void BeginTraceRecord(Args... args) {
+        auto& slot = GetThreadTrace();
+        trace_head_ = slot.ring->head.load(std::memory_order_relaxed);
+        if (trace_head_ - slot.ring->tail.load(std::memory_order_acquire) == kTraceRingSize) {
+            AddToCounter(slot.ring->dropped, 1);
+            return;
+        }
+        trace_record_ = &slot.ring->records[trace_head_ & (kTraceRingSize - 1)];
+        trace_record_->thread_id = slot.thread_id;
+        trace_record_->entry_point = (uint16_t)entry_point_;
+        trace_record_->arg_count = 0;
+        trace_record_->arg_kinds = 0;
+        const int expand[] = {0, (SetTraceArg(trace_record_, args), 0)...};
+        (void)expand;
+    }
+
+    uint32_t entry_point_ = kInternalCallStats;
+    std::chrono::steady_clock::time_point start_;
+    TraceRecord* trace_record_ = nullptr;
+    uint64_t trace_head_ = 0;
+};
+
+// Numbered slots for SlotTable and ObjectSlab, stored in chunks that never move so that finding a slot by its number
+// is two array accesses without a lock. Freed slots are pushed on a lock-free stack and reused before new ones, which
+// are handed out by an atomic count. A lock is only taken to allocate and publish a chunk, once every kChunkSize new
+// slots. Slot must have a std::atomic<uint32_t> next_free member for the stack.
+template <typename Slot>
+class SlotStorage {
+  public:
+    static constexpr uint32_t kChunkSize = 1024;
+    static constexpr uint32_t kMaxChunks = 2048;
+    static constexpr uint32_t kMaxSlots = kChunkSize * kMaxChunks;
+
+    SlotStorage() = default;
+    SlotStorage(const SlotStorage&) = delete;
+    SlotStorage& operator=(const SlotStorage&) = delete;
+    ~SlotStorage() {
+        for (auto& chunk : chunks_) delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    // Returns the number of a free slot, or kMaxSlots if all of them are in use
+    uint32_t Allocate() {
+        // The head holds the number of the top slot plus one, 0 when empty, and a count of the changes to the stack
+        // in its upper half so that a slot that was popped and pushed again in between doesn't fool the exchange
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while ((uint32_t)head) {
+            const uint32_t index = (uint32_t)head - 1;
+            const uint64_t next = ((head >> 32) + 1) << 32 | Get(index).next_free.load(std::memory_order_relaxed);
+            if (free_head_.compare_exchange_weak(head, next, std::memory_order_acquire)) return index;
+        }
+        // Slots that were never used are handed out by bumping the count, which never passes kMaxSlots
+        uint32_t index = slot_count_.load(std::memory_order_relaxed);
+        do {
+            if (index == kMaxSlots) return kMaxSlots;
+        } while (!slot_count_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+        // Only the threads that take the first slots of a chunk before it's published lock, to publish it once
+        auto& chunk = chunks_[index / kChunkSize];
+        if (!chunk.load(std::memory_order_acquire)) {
+            lock_guard_t lock(lock_);
+            if (!chunk.load(std::memory_order_relaxed)) chunk.store(new Slot[kChunkSize](), std::memory_order_release);
+        }
+        return index;
+    }
+    void Free(uint32_t index) {
+        Slot& slot = Get(index);
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        do {
+            slot.next_free.store((uint32_t)head, std::memory_order_relaxed);
+        } while (!free_head_.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | (index + 1), std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+    // index must have been handed out by Allocate
+    Slot& Get(uint32_t index) const { return chunks_[index / kChunkSize].load(std::memory_order_acquire)[index % kChunkSize]; }
+    // Returns nullptr for slots that were never handed out, index must be less than kMaxSlots
+    Slot* Find(uint32_t index) const {
+        Slot* chunk = chunks_[index / kChunkSize].load(std::memory_order_acquire);
+        return chunk ? &chunk[index % kChunkSize] : nullptr;
+    }
+    // Number of slots handed out so far, only meaningful while no other thread allocates
+    uint32_t size() const { return slot_count_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<Slot*> chunks_[kMaxChunks] = {};
+    std::atomic<uint64_t> free_head_{0};
+    std::atomic<uint32_t> slot_count_{0};
+    mutex_t lock_;  // Taken to publish chunks
+};
+
+// Source of the identifiers that keep the handles of different SlotTables apart
+static std::atomic<uint64_t> next_slot_table_id{1};
+
+// Table that owns the state of a kind of non-dispatchable object and hands out its handles. A handle encodes the
+// number of the object's slot and the generation of that slot, which changes whenever the slot is allocated or freed,
+// so slots are reused under churn while handles of freed objects are recognized as stale instead of aliasing the
+// objects that reuse their slots. Looking up a handle doesn't take a lock.
+//
+// Handles hold the slot number plus one in bits 0-23, the generation in bits 24-39 and the table identifier in bits
+// 40-62, so that tables of different devices never hand out the same handle. Bit 63 is set so that they don't collide
+// with the handles of objects that point at their state either. Stale handles are only mistaken for live objects again
+// once their slot has been reused 32768 times.
+template <typename Handle, typename T>
+class SlotTable {
+  public:
+    SlotTable()
+        : table_bits_(kHandleTag | ((next_slot_table_id.fetch_add(1, std::memory_order_relaxed) << kTableShift) & ~kHandleTag)) {}
+    SlotTable(const SlotTable&) = delete;
+    SlotTable& operator=(const SlotTable&) = delete;
+
+    // Store value in a free slot, returns its handle or VK_NULL_HANDLE if the table is full
+    Handle insert(T value) {
+        const uint32_t index = slots_.Allocate();
+        if (index == Storage::kMaxSlots) return VK_NULL_HANDLE;
+        Slot& slot = slots_.Get(index);
+        slot.value = std::move(value);
+        // Odd generations mark live objects, so handles never match slots that are free or were never used
+        const uint32_t generation = (slot.generation.load(std::memory_order_relaxed) + 1) & kGenerationMask;
+        slot.generation.store(generation, std::memory_order_release);
+        return (Handle)(table_bits_ | ((uint64_t)generation << kGenerationShift) | (index + 1));
+    }
+    // Copy the value for handle into *value, returns false if handle isn't a live object of this table
+    bool find(Handle handle, T* value) const {
+        const Slot* slot = Lookup(handle);
+        if (!slot) return false;
+        *value = slot->value;
+        return true;
+    }
+    // Call func on the value for handle, returns false if handle isn't a live object of this table. Writes through
+    // func must be externally synchronized like the Vulkan calls that make them.
+    template <typename Func>
+    bool update(Handle handle, Func func) {
+        Slot* slot = Lookup(handle);
+        if (!slot) return false;
+        func(slot->value);
+        return true;
+    }
+    // Free the slot of handle for reuse, returns false if handle isn't a live object of this table. Freeing an object
+    // is externally synchronized, so the generation can't change between checking and bumping it.
+    bool erase(Handle handle) {
+        Slot* slot = Lookup(handle);
+        if (!slot) return false;
+        slot->generation.store((GetGeneration(handle) + 1) & kGenerationMask, std::memory_order_relaxed);
+        slot->value = T();
+        slots_.Free((uint32_t)((uint64_t)handle & kIndexMask) - 1);
+        return true;
+    }
+
+  private:
+    static constexpr uint32_t kGenerationShift = 24;
+    static constexpr uint32_t kGenerationMask = 0xffff;
+    static constexpr uint32_t kTableShift = 40;
+    static constexpr uint64_t kHandleTag = 1ull << 63;
+    static constexpr uint64_t kIndexMask = (1ull << kGenerationShift) - 1;
+    struct Slot {
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint32_t> next_free{0};
+        T value;
+    };
+    using Storage = SlotStorage<Slot>;
+    static_assert(Storage::kMaxSlots < kIndexMask, "Slot numbers must fit in the index bits of handles");
+
+    static uint32_t GetGeneration(Handle handle) { return (uint32_t)((uint64_t)handle >> kGenerationShift) & kGenerationMask; }
+    Slot* Lookup(Handle handle) const {
+        const uint64_t bits = (uint64_t)handle;
+        const uint64_t index = bits & kIndexMask;
+        if ((bits & ~((1ull << kTableShift) - 1)) != table_bits_ || index == 0 || index > Storage::kMaxSlots) return nullptr;
+        Slot* slot = slots_.Find((uint32_t)index - 1);
+        if (!slot || slot->generation.load(std::memory_order_acquire) != GetGeneration(handle)) return nullptr;
+        return slot;
+    }
+
+    const uint64_t table_bits_;
+    Storage slots_;
+};
+
+// Slab of the objects of a device whose handles point at their state, such as fences and device memory. Objects are
+// constructed in place in slots that are reused once they are freed. The slab belongs to the device, so destroying
+// the device destroys the objects the application left behind and releases their storage a chunk at a time.
+template <typename T>
+class ObjectSlab {
+  public:
+    ObjectSlab() = default;
+    ObjectSlab(const ObjectSlab&) = delete;
+    ObjectSlab& operator=(const ObjectSlab&) = delete;
+    ~ObjectSlab() {
+        for (uint32_t i = 0; i < slots_.size(); ++i) {
+            auto& slot = slots_.Get(i);
+            if (slot.live) reinterpret_cast<T*>(&slot.storage)->~T();
+        }
+    }
+
+    // Returns a value-initialized object, or nullptr if the slab is full
+    T* Allocate() {
+        const uint32_t index = slots_.Allocate();
+        if (index == SlotStorage<Slot>::kMaxSlots) return nullptr;
+        Slot& slot = slots_.Get(index);
+        slot.index = index;
+        slot.live = true;
+        return new (&slot.storage) T();
+    }
+    // Destroy an object of this slab, null is ignored
+    void Free(T* object) {
+        if (!object) return;
+        object->~T();
+        auto& slot = *reinterpret_cast<Slot*>(object);
+        slot.live = false;
+        slots_.Free(slot.index);
+    }
+
+  private:
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;  // Must be first, objects are cast to Slot
+        std::atomic<uint32_t> next_free;
+        uint32_t index;
+        bool live;
+    };
+    SlotStorage<Slot> slots_;
+};
+
+// Small pool of worker threads that split large jobs with the calling thread. The threads are only started by
+// the first job that is worth splitting, and are joined when the pool is destroyed.
+class WorkerPool final : public ParallelExecutor {
+  public:
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() {
+        {
+            lock_guard_t lock(lock_);
+            stop_ = true;
+        }
+        job_cv_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func) override {
+        lock_guard_t job_lock(job_lock_);  // One job at a time
+        if (count > 1 && !started_) StartThreads();
+        if (count <= 1 || threads_.empty()) {
+            for (uint32_t i = 0; i < count; ++i) func(i);
+            return;
+        }
+        {
+            lock_guard_t lock(lock_);
+            job_func_ = &func;
+            job_count_ = count;
+            next_index_ = 0;
+            busy_workers_ = (uint32_t)threads_.size();
+            ++job_generation_;
+        }
+        job_cv_.notify_all();
+        RunJob();
+        unique_lock_t lock(lock_);
+        done_cv_.wait(lock, [this]() { return busy_workers_ == 0; });
+        job_func_ = nullptr;
+    }
+
+  private:
+    static constexpr uint32_t kMaxWorkerThreads = 3;
+
+    void StartThreads() {
+        started_ = true;
+        const uint32_t hardware_threads = std::thread::hardware_concurrency();
+        const uint32_t worker_count = hardware_threads > 1 ? (std::min)(hardware_threads - 1, kMaxWorkerThreads) : 0;
+        for (uint32_t i = 0; i < worker_count; ++i) threads_.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+    void RunJob() {
+        for (uint32_t index = next_index_++; index < job_count_; index = next_index_++) (*job_func_)(index);
+    }
+    void WorkerLoop() {
+        uint64_t seen_generation = 0;
+        unique_lock_t lock(lock_);
+        for (;;) {
+            job_cv_.wait(lock, [&]() { return stop_ || job_generation_ != seen_generation; });
+            if (stop_) return;
+            seen_generation = job_generation_;
+            lock.unlock();
+            RunJob();
+            lock.lock();
+            if (--busy_workers_ == 0) done_cv_.notify_one();
+        }
+    }
+
+    mutex_t job_lock_;
+    bool started_ = false;
+    std::vector<std::thread> threads_;
+    // Guards the members below
+    mutex_t lock_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+    bool stop_ = false;
+    uint64_t job_generation_ = 0;
+    uint32_t busy_workers_ = 0;
+    const std::function<void(uint32_t)>* job_func_ = nullptr;
+    uint32_t job_count_ = 0;
+    std::atomic<uint32_t> next_index_{0};
+};
+
+// Hands out loader-magic-initialized dispatchable objects from contiguous chunks instead of allocating each one
+// separately. T must start with a VK_LOADER_DATA loader_data member. Objects are constructed along with their
+// chunk and live until the slab is destroyed, which releases all chunks at once. Freed objects keep their state,
+// so anything they have allocated is reused by the next owner. Not thread safe, the owner of a slab guards it.
+template <typename T>
+class DispObjSlab {
+  public:
+    DispObjSlab() = default;
+    DispObjSlab(const DispObjSlab&) = delete;
+    DispObjSlab& operator=(const DispObjSlab&) = delete;
+
+    T* Allocate() {
+        T* object;
+        if (!free_list_.empty()) {
+            object = free_list_.back();
+            free_list_.pop_back();
+        } else {
+            if (chunk_used_ == chunk_size_) {
+                // Chunks start small so that pools with few objects stay cheap, then grow geometrically
+                chunk_size_ = chunks_.empty() ? kFirstChunkSize : (std::min)(chunk_size_ * 2, kMaxChunkSize);
+                chunks_.emplace_back(new T[chunk_size_]);
+                chunk_used_ = 0;
+            }
+            object = &chunks_.back()[chunk_used_++];
+        }
+        set_loader_magic_value(&object->loader_data);
+        return object;
+    }
+    void Free(T* object) { free_list_.push_back(object); }
+
+  private:
+    static constexpr uint32_t kFirstChunkSize = 16;
+    static constexpr uint32_t kMaxChunkSize = 1024;
+    std::vector<std::unique_ptr<T[]>> chunks_;
+    std::vector<T*> free_list_;
+    uint32_t chunk_size_ = 0;
+    uint32_t chunk_used_ = 0;
+};
+
+// Commands are recorded as a compact binary encoding: a CommandHeader followed by the command's parameters in
+// declaration order, each at its natural alignment. Pointer parameters are stored as arrays, a uint32_t element
+// count (0 for a null pointer) followed by the elements. Only the pointed-to elements are copied, pointers nested
+// inside of them (pNext chains included) are stored as is.
+static constexpr size_t kCommandAlignment = 8;
+struct CommandHeader {
+    CommandId id;
+    uint32_t size;  // Size of the whole command including this header, a multiple of kCommandAlignment
+};
+
+static inline size_t AlignCommandOffset(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename T>
+struct CommandArray {
+    const T* data;
+    uint32_t count;
+};
+// Wrap a pointer parameter so that count elements are recorded
+template <typename T>
+static CommandArray<T> RecordArray(const T* data, uint64_t count) {
+    return {data, data ? (uint32_t)count : 0u};
+}
+
+template <typename T>
+static size_t EncodedEnd(size_t offset, const T&) {
+    return AlignCommandOffset(offset, alignof(T)) + sizeof(T);
+}
+template <typename T>
+static size_t EncodedEnd(size_t offset, const CommandArray<T>& array) {
+    return AlignCommandOffset(EncodedEnd(offset, array.count), alignof(T)) + sizeof(T) * array.count;
+}
+static size_t EncodedSize(size_t offset) { return offset; }
+template <typename T, typename... Args>
+static size_t EncodedSize(size_t offset, const T& arg, const Args&... args) {
+    return EncodedSize(EncodedEnd(offset, arg), args...);
+}
+
+template <typename T>
+static void Encode(uint8_t* base, size_t* offset, const T& value) {
+    *offset = AlignCommandOffset(*offset, alignof(T));
+    std::memcpy(base + *offset, &value, sizeof(T));
+    *offset += sizeof(T);
+}
+template <typename T>
+static void Encode(uint8_t* base, size_t* offset, const CommandArray<T>& array) {
+    Encode(base, offset, array.count);
+    *offset = AlignCommandOffset(*offset, alignof(T));
+    if (array.count) std::memcpy(base + *offset, array.data, sizeof(T) * array.count);
+    *offset += sizeof(T) * array.count;
+}
+static void EncodeAll(uint8_t*, size_t*) {}
+template <typename T, typename... Args>
+static void EncodeAll(uint8_t* base, size_t* offset, const T& arg, const Args&... args) {
+    Encode(base, offset, arg);
+    EncodeAll(base, offset, args...);
+}
+
+// Decodes the parameters of a recorded command. They have to be read in the order they were recorded in.
+class CommandReader {
+  public:
+    explicit CommandReader(const CommandHeader& header)
+        : base_(reinterpret_cast<const uint8_t*>(&header)), offset_(sizeof(CommandHeader)) {}
+
+    template <typename T>
+    T Read() {
+        offset_ = AlignCommandOffset(offset_, alignof(T));
+        T value;
+        std::memcpy(&value, base_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+    // Returns a pointer to the recorded elements, or nullptr if there are none
+    template <typename T>
+    const T* ReadArray(uint32_t* count = nullptr) {
+        const uint32_t element_count = Read<uint32_t>();
+        if (count) *count = element_count;
+        offset_ = AlignCommandOffset(offset_, alignof(T));
+        const T* data = element_count ? reinterpret_cast<const T*>(base_ + offset_) : nullptr;
+        offset_ += sizeof(T) * element_count;
+        return data;
+    }
+
+  private:
+    const uint8_t* base_;
+    size_t offset_;
+};
+
+// Memory that a command pool records the commands of all of its command buffers into. It comes in chunks of
+// kChunkSize bytes, which command buffers take while they are recorded and give back when they are reset or freed.
+// Chunks are allocated through the allocation callbacks the pool was created with, so the application can observe
+// how much memory its command pools hold. The arena hands out the chunks it owns by index: those at or past
+// next_slot_ haven't been taken since the pool was last reset, those in recycled_ were given back since, so
+// resetting the pool takes back every chunk of every command buffer in O(1). Chunks stay with the pool once they
+// are allocated, until vkTrimCommandPool or vkResetCommandPool with VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT.
+// Command buffers of transient pools are expected to be short-lived, so chunks that a transient pool didn't need
+// between two resets are released by the second one.
+class CommandArena {
+  public:
+    static constexpr size_t kChunkSize = 16 * 1024;
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    CommandArena() = default;
+    CommandArena(const CommandArena&) = delete;
+    CommandArena& operator=(const CommandArena&) = delete;
+    ~CommandArena() {
+        for (auto chunk : chunks_) FreeMemory(chunk);
+    }
+
+    void Init(const VkAllocationCallbacks* allocator, bool transient) {
+        if (allocator) allocator_ = *allocator;
+        has_allocator_ = allocator != nullptr;
+        transient_ = transient;
+    }
+    // Take a chunk of kChunkSize bytes, returns kNoSlot if out of memory
+    uint32_t Acquire() {
+        uint32_t slot;
+        if (!recycled_.empty()) {
+            slot = recycled_.back();
+            recycled_.pop_back();
+            return slot;
+        }
+        if (next_slot_ == chunks_.size()) chunks_.push_back(nullptr);
+        if (!chunks_[next_slot_]) {
+            chunks_[next_slot_] = AllocateMemory(kChunkSize);
+            if (!chunks_[next_slot_]) return kNoSlot;
+        }
+        return next_slot_++;
+    }
+    void Release(uint32_t slot) { recycled_.push_back(slot); }
+    uint8_t* ChunkData(uint32_t slot) const { return chunks_[slot]; }
+    // Take back all chunks. The command buffers that hold them notice by the reset count of their pool.
+    void Reset() {
+        if (transient_) FreeSlotsFrom(next_slot_);
+        next_slot_ = 0;
+        recycled_.clear();
+    }
+    // Release the chunks no command buffer holds
+    void Trim() {
+        for (auto slot : recycled_) {
+            FreeMemory(chunks_[slot]);
+            chunks_[slot] = nullptr;
+        }
+        recycled_.clear();
+        FreeSlotsFrom(next_slot_);
+    }
+    // Allocations of commands that don't fit in a chunk, which their command buffer frees
+    uint8_t* AllocateMemory(size_t size) {
+        void* memory = has_allocator_
+                           ? allocator_.pfnAllocation(allocator_.pUserData, size, kCommandAlignment, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT)
+                           : ::operator new(size, std::nothrow);
+        return static_cast<uint8_t*>(memory);
+    }
+    void FreeMemory(uint8_t* memory) {
+        if (!memory) return;
+        if (has_allocator_) {
+            allocator_.pfnFree(allocator_.pUserData, memory);
+        } else {
+            ::operator delete(memory);
+        }
+    }
+
+  private:
+    void FreeSlotsFrom(uint32_t first) {
+        for (size_t slot = first; slot < chunks_.size(); ++slot) FreeMemory(chunks_[slot]);
+        chunks_.resize(first);
+    }
+
+    std::vector<uint8_t*> chunks_;  // Null for slots whose chunk has been trimmed
+    uint32_t next_slot_ = 0;
+    std::vector<uint32_t> recycled_;
+    VkAllocationCallbacks allocator_ = {};
+    bool has_allocator_ = false;
+    bool transient_ = false;
+};
+
+// The commands recorded into a command buffer, as a list of chunks of the arena of its pool. Commands larger than a
+// chunk get an allocation of their own.
+class CommandStream {
+  public:
+    class Iterator {
+      public:
+        const CommandHeader& operator*() const {
+            return *reinterpret_cast<const CommandHeader*>(stream_->chunks_[chunk_].data + offset_);
+        }
+        const CommandHeader* operator->() const { return &**this; }
+        Iterator& operator++() {
+            offset_ += (**this).size;
+            SkipEmptyChunks();
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return chunk_ == other.chunk_ && offset_ == other.offset_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+      private:
+        friend class CommandStream;
+        Iterator(const CommandStream* stream, size_t chunk) : stream_(stream), chunk_(chunk), offset_(0) { SkipEmptyChunks(); }
+        void SkipEmptyChunks() {
+            while (chunk_ < stream_->chunks_.size() && offset_ == stream_->chunks_[chunk_].used) {
+                ++chunk_;
+                offset_ = 0;
+            }
+        }
+        const CommandStream* stream_;
+        size_t chunk_;
+        size_t offset_;
+    };
+
+    CommandStream() = default;
+    CommandStream(const CommandStream&) = delete;
+    CommandStream& operator=(const CommandStream&) = delete;
+    ~CommandStream() { Drop(); }
+
+    void SetArena(CommandArena* arena) { arena_ = arena; }
+    template <typename... Args>
+    void Record(CommandId id, const Args&... args) {
+        const size_t size = AlignCommandOffset(EncodedSize(sizeof(CommandHeader), args...), kCommandAlignment);
+        uint8_t* base = Allocate(size);
+        if (!base) {
+            // Commands can't fail, vkEndCommandBuffer reports it instead
+            out_of_memory_ = true;
+            return;
+        }
+        auto header = reinterpret_cast<CommandHeader*>(base);
+        header->id = id;
+        header->size = (uint32_t)size;
+        size_t offset = sizeof(CommandHeader);
+        EncodeAll(base, &offset, args...);
+        ++command_count_;
+    }
+    // Drop all recorded commands and give their chunks back to the arena
+    void Reset() {
+        for (const auto& chunk : chunks_) {
+            if (chunk.slot != CommandArena::kNoSlot) arena_->Release(chunk.slot);
+        }
+        Drop();
+    }
+    // Drop all recorded commands after the arena has taken back their chunks
+    void Drop() {
+        for (const auto& chunk : chunks_) {
+            if (chunk.slot == CommandArena::kNoSlot) arena_->FreeMemory(chunk.data);
+        }
+        chunks_.clear();
+        command_count_ = 0;
+        out_of_memory_ = false;
+    }
+    uint32_t CommandCount() const { return command_count_; }
+    bool OutOfMemory() const { return out_of_memory_; }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, chunks_.size()); }
+
+  private:
+    struct Chunk {
+        uint8_t* data;
+        size_t capacity;
+        size_t used;
+        uint32_t slot;  // In the arena, or kNoSlot for the allocations of large commands
+    };
+
+    uint8_t* Allocate(size_t size) {
+        if (chunks_.empty() || chunks_.back().used + size > chunks_.back().capacity) {
+            Chunk chunk = {nullptr, size, 0, CommandArena::kNoSlot};
+            if (size <= CommandArena::kChunkSize) {
+                chunk.slot = arena_->Acquire();
+                if (chunk.slot == CommandArena::kNoSlot) return nullptr;
+                chunk.data = arena_->ChunkData(chunk.slot);
+                chunk.capacity = CommandArena::kChunkSize;
+            } else {
+                chunk.data = arena_->AllocateMemory(size);
+                if (!chunk.data) return nullptr;
+            }
+            chunks_.push_back(chunk);
+        }
+        auto& chunk = chunks_.back();
+        uint8_t* data = chunk.data + chunk.used;
+        chunk.used += size;
+        return data;
+    }
+
+    CommandArena* arena_ = nullptr;
+    std::vector<Chunk> chunks_;  // Keeps its capacity, so recording a command buffer again doesn't allocate
+    uint32_t command_count_ = 0;
+    bool out_of_memory_ = false;
+};
+
+struct CommandPoolData;
+
+// State tracked per VkCommandBuffer, the VkCommandBuffer handle points at this
+struct CommandBufferData {
+    VK_LOADER_DATA loader_data;  // Must be first, the loader stores its dispatch table pointer here
+    CommandPoolData* pool;
+    uint64_t pool_reset_count;  // Value of pool->reset_count when the command buffer was last reset
+    uint32_t device_mask;       // Initial device mask from VkDeviceGroupCommandBufferBeginInfo, all bits set without it
+    CommandStream commands;
+};
+
+// State tracked per VkCommandPool, the VkCommandPool handle points at this. Command pools are externally
+// synchronized, so allocating and freeing command buffers needs no lock. The pool owns both its command buffers and
+// the memory of their commands, destroying it releases all of them in bulk.
+struct CommandPoolData {
+    CommandArena arena;  // Declared first, the command buffers free their large commands through it
+    DispObjSlab<CommandBufferData> command_buffers;
+    // Incremented by vkResetCommandPool. Command buffers compare it to their own copy to notice the reset,
+    // so resetting a pool doesn't have to visit its command buffers.
+    uint64_t reset_count = 0;
+};
+
+static CommandPoolData* GetCommandPoolData(VkCommandPool command_pool) {
+    return reinterpret_cast<CommandPoolData*>((uintptr_t)command_pool);
+}
+
+static CommandBufferData* GetCommandBufferData(VkCommandBuffer command_buffer) {
+    return reinterpret_cast<CommandBufferData*>(command_buffer);
+}
+
+static void ResetCommandBufferData(CommandBufferData* command_buffer_data) {
+    // After the pool has been reset, the arena already has the chunks of the command buffer back
+    if (command_buffer_data->pool_reset_count == command_buffer_data->pool->reset_count) {
+        command_buffer_data->commands.Reset();
+    } else {
+        command_buffer_data->commands.Drop();
+    }
+    command_buffer_data->pool_reset_count = command_buffer_data->pool->reset_count;
+}
+
+// Commands recorded into a command buffer, for the submit path and diagnostics to walk
+static const CommandStream& GetRecordedCommands(VkCommandBuffer command_buffer) {
+    auto command_buffer_data = GetCommandBufferData(command_buffer);
+    if (command_buffer_data->pool_reset_count != command_buffer_data->pool->reset_count) {
+        ResetCommandBufferData(command_buffer_data);
+    }
+    return command_buffer_data->commands;
+}
+
+template <typename... Args>
+static void RecordCommand(VkCommandBuffer command_buffer, CommandId id, const Args&... args) {
+    GetCommandBufferData(command_buffer)->commands.Record(id, args...);
+}
+
+struct DeviceData;
+struct DeviceMemoryData;
+struct PhysicalDeviceData;
+
+// Fence and semaphore state, the VkFence and VkSemaphore handles point at these. Both are guarded by the
+// sync_lock of the owning device.
+struct FenceData {
+    bool signaled;  // Host waits sleep on the sync_cv of the device until this is set
+};
+
+static FenceData* GetFenceData(VkFence fence) {
+    return reinterpret_cast<FenceData*>((uintptr_t)fence);
+}
+
+struct SemaphoreData {
+    bool timeline;
+    // The payload of timeline semaphores, binary semaphores are 1 when signaled and 0 otherwise. Only written with
+    // the sync_lock held, but atomic so vkGetSemaphoreCounterValue can read it without taking the lock.
+    std::atomic<uint64_t> value;
+    // Threads blocked until value reaches the key. A signal only wakes the waiters whose value it reaches, so many
+    // waiters on distant values don't all wake up for every increment.
+    std::multimap<uint64_t, std::condition_variable*> waiters;
+};
+
+static SemaphoreData* GetSemaphoreData(VkSemaphore semaphore) {
+    return reinterpret_cast<SemaphoreData*>((uintptr_t)semaphore);
+}
+
+// Results of a VkQueryPool, the VkQueryPool handle points at this. values and available are guarded by the sync_lock
+// of the owning device, so vkGetQueryPoolResults can wait for queries to become available on its sync_cv.
+struct QueryPoolData {
+    VkQueryType type;
+    VkQueryPipelineStatisticFlags statistics;
+    uint32_t value_count;  // Values per query, one per statistic for pipeline statistics queries
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> available;
+};
+
+static QueryPoolData* GetQueryPoolData(VkQueryPool query_pool) {
+    return reinterpret_cast<QueryPoolData*>((uintptr_t)query_pool);
+}
+
+// Descriptor types that descriptor pools keep separate counts of. Acceleration structures and the descriptor types of
+// extensions the mock ICD doesn't know about share the last count.
+static constexpr uint32_t kDescriptorTypeCount = 13;
+static constexpr uint32_t kInlineUniformBlockTypeIndex = 11;
+static uint32_t GetDescriptorTypeIndex(VkDescriptorType type) {
+    if ((uint32_t)type <= (uint32_t)VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT) return (uint32_t)type;
+    if (type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return kInlineUniformBlockTypeIndex;
+    return kDescriptorTypeCount - 1;
+}
+
+// Contents of a descriptor, as last written by vkUpdateDescriptorSets
+union DescriptorData {
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+    VkBufferView texel_buffer_view;
+    VkAccelerationStructureKHR acceleration_structure;
+};
+
+// Descriptors of one type that a set takes from its pool, counted in bytes for inline uniform blocks
+struct DescriptorPoolUsage {
+    uint32_t type_index;
+    uint32_t count;
+};
+
+struct DescriptorBindingLayout {
+    uint32_t binding;
+    VkDescriptorType type;
+    uint32_t count;   // Bytes for inline uniform blocks
+    uint32_t offset;  // Of the first descriptor in the descriptors of the set, or of the bytes in its inline data
+};
+
+// State of a VkDescriptorSetLayout, the handle points at this
+struct DescriptorSetLayoutData {
+    std::vector<DescriptorBindingLayout> bindings;  // Sorted by binding number
+    std::vector<DescriptorPoolUsage> usages;        // Of a set with the full count of every binding
+    uint32_t descriptor_count;                      // Of all bindings but inline uniform blocks
+    uint32_t inline_size;                           // Bytes of all inline uniform blocks
+    bool variable_count;  // The last binding has VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT
+};
+
+static DescriptorSetLayoutData* GetDescriptorSetLayoutData(VkDescriptorSetLayout layout) {
+    return reinterpret_cast<DescriptorSetLayoutData*>((uintptr_t)layout);
+}
+
+// State of a VkDescriptorSet, the handle points at this. It's the start of a block in the arena of the pool of the
+// set, which holds everything about the set: this header, the usages the set takes from the pool, its bindings, its
+// descriptors and the bytes of its inline uniform blocks. The set has its own copy of the bindings of its layout,
+// because the application may destroy the layout while the set is still bound and executed.
+struct alignas(DescriptorData) DescriptorSetData {
+    uint32_t size;  // Of the block, including this header
+    uint32_t usage_count;
+    uint32_t binding_count;  // Bindings of the layout with descriptors in the set, sorted by binding number
+    uint32_t descriptor_count;
+    uint32_t inline_size;
+
+    DescriptorPoolUsage* usages() { return reinterpret_cast<DescriptorPoolUsage*>(this + 1); }
+    // The count of a variable-sized binding is the count the set was allocated with
+    DescriptorBindingLayout* bindings() { return reinterpret_cast<DescriptorBindingLayout*>(usages() + usage_count); }
+    DescriptorData* descriptors() { return reinterpret_cast<DescriptorData*>(bindings() + binding_count); }
+    uint8_t* inline_data() { return reinterpret_cast<uint8_t*>(descriptors() + descriptor_count); }
+};
+static_assert(sizeof(DescriptorSetData) % alignof(DescriptorData) == 0 &&
+                  sizeof(DescriptorPoolUsage) % alignof(DescriptorData) == 0 &&
+                  sizeof(DescriptorBindingLayout) % alignof(DescriptorData) == 0,
+              "Descriptors must be aligned after the header, usages and bindings");
+
+static DescriptorSetData* GetDescriptorSetData(VkDescriptorSet set) {
+    return reinterpret_cast<DescriptorSetData*>((uintptr_t)set);
+}
+
+// State of a VkDescriptorPool, the handle points at this. Sets are carved out of an arena that is sized from the pool
+// sizes when the pool is created, by bumping an offset, so resetting the pool is O(1) and never touches its sets. The
+// blocks of freed sets are reused by later sets that fit in them. Allocations fail like those of a real pool: with
+// VK_ERROR_OUT_OF_POOL_MEMORY once the pool is out of sets or of descriptors of a type, and with
+// VK_ERROR_FRAGMENTED_POOL when it has enough of both but no block is large enough.
+struct DescriptorPoolData {
+    struct Block {
+        size_t offset;
+        size_t size;
+    };
+    std::unique_ptr<uint64_t[]> arena;
+    size_t arena_size;
+    size_t arena_used;  // Bytes bumped, blocks below this are either sets or in free_blocks
+    std::vector<Block> free_blocks;  // Sorted by offset, no two of them adjacent
+    uint32_t max_sets;
+    uint32_t set_count;
+    uint32_t type_limits[kDescriptorTypeCount];
+    uint32_t type_counts[kDescriptorTypeCount];
+};
+
+static DescriptorPoolData* GetDescriptorPoolData(VkDescriptorPool pool) {
+    return reinterpret_cast<DescriptorPoolData*>((uintptr_t)pool);
+}
+
+static size_t GetDescriptorSetSize(uint32_t usage_count, uint32_t binding_count, uint32_t descriptor_count,
+                                   uint32_t inline_size) {
+    const size_t size = sizeof(DescriptorSetData) + usage_count * sizeof(DescriptorPoolUsage) +
+                        binding_count * sizeof(DescriptorBindingLayout) + descriptor_count * sizeof(DescriptorData) +
+                        inline_size;
+    return (size + alignof(DescriptorData) - 1) & ~(alignof(DescriptorData) - 1);
+}
+
+static void InitDescriptorSetLayout(DescriptorSetLayoutData* layout, const VkDescriptorSetLayoutCreateInfo* create_info) {
+    const auto flags_info = lvl_find_in_chain<VkDescriptorSetLayoutBindingFlagsCreateInfo>(create_info->pNext);
+    uint32_t variable_binding = UINT32_MAX;
+    for (uint32_t i = 0; i < create_info->bindingCount; ++i) {
+        const auto& binding = create_info->pBindings[i];
+        layout->bindings.push_back({binding.binding, binding.descriptorType, binding.descriptorCount, 0});
+        if (flags_info && i < flags_info->bindingCount &&
+            (flags_info->pBindingFlags[i] & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)) {
+            variable_binding = binding.binding;
+        }
+    }
+    std::sort(layout->bindings.begin(), layout->bindings.end(),
+              [](const DescriptorBindingLayout& a, const DescriptorBindingLayout& b) { return a.binding < b.binding; });
+    uint32_t type_counts[kDescriptorTypeCount] = {};
+    for (auto& binding : layout->bindings) {
+        const uint32_t type_index = GetDescriptorTypeIndex(binding.type);
+        type_counts[type_index] += binding.count;
+        uint32_t& offset = type_index == kInlineUniformBlockTypeIndex ? layout->inline_size : layout->descriptor_count;
+        binding.offset = offset;
+        offset += binding.count;
+    }
+    for (uint32_t i = 0; i < kDescriptorTypeCount; ++i) {
+        if (type_counts[i]) layout->usages.push_back({i, type_counts[i]});
+    }
+    // Only the binding with the largest number can have a variable count
+    layout->variable_count = !layout->bindings.empty() && layout->bindings.back().binding == variable_binding;
+}
+
+static VkResult InitDescriptorPool(DescriptorPoolData* pool, const VkDescriptorPoolCreateInfo* create_info) {
+    pool->max_sets = create_info->maxSets;
+    // Every set takes a header and at most one usage entry per type, next to its descriptors. Sets only copy the
+    // bindings that have descriptors, so there are at most as many of them as descriptors, and a quarter as many
+    // for inline uniform blocks, whose sizes are multiples of 4 bytes.
+    size_t size = (size_t)create_info->maxSets * GetDescriptorSetSize(0, 0, 0, 0);
+    for (uint32_t i = 0; i < create_info->poolSizeCount; ++i) {
+        const auto& pool_size = create_info->pPoolSizes[i];
+        const uint32_t type_index = GetDescriptorTypeIndex(pool_size.type);
+        pool->type_limits[type_index] += pool_size.descriptorCount;
+        size += (std::min)(create_info->maxSets, pool_size.descriptorCount) * sizeof(DescriptorPoolUsage);
+        if (type_index == kInlineUniformBlockTypeIndex) {
+            // The bytes of the inline uniform blocks of a set are rounded up to the alignment of the next set
+            size += pool_size.descriptorCount + (size_t)create_info->maxSets * (alignof(DescriptorData) - 1);
+            size += (size_t)(pool_size.descriptorCount / 4) * sizeof(DescriptorBindingLayout);
+        } else {
+            size += (size_t)pool_size.descriptorCount * (sizeof(DescriptorData) + sizeof(DescriptorBindingLayout));
+        }
+    }
+    // Left uninitialized so that the pages of large pools are only committed once sets are allocated from them
+    pool->arena.reset(new (std::nothrow) uint64_t[size / sizeof(uint64_t) + 1]);
+    if (!pool->arena) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    pool->arena_size = size;
+    return VK_SUCCESS;
+}
+
+static void FreeDescriptorSet(DescriptorPoolData* pool, DescriptorSetData* set) {
+    for (uint32_t i = 0; i < set->usage_count; ++i) pool->type_counts[set->usages()[i].type_index] -= set->usages()[i].count;
+    if (--pool->set_count == 0) {
+        pool->arena_used = 0;
+        pool->free_blocks.clear();
+        return;
+    }
+    const size_t offset = (size_t)(reinterpret_cast<uint8_t*>(set) - reinterpret_cast<uint8_t*>(pool->arena.get()));
+    // The free blocks are kept sorted by offset and merged with their neighbors, so sets freed in any order coalesce
+    auto& blocks = pool->free_blocks;
+    auto next = std::lower_bound(blocks.begin(), blocks.end(), offset,
+                                 [](const DescriptorPoolData::Block& block, size_t offset) { return block.offset < offset; });
+    if (next != blocks.begin() && std::prev(next)->offset + std::prev(next)->size == offset) {
+        auto prev = std::prev(next);
+        prev->size += set->size;
+        if (next != blocks.end() && prev->offset + prev->size == next->offset) {
+            prev->size += next->size;
+            blocks.erase(next);
+        }
+    } else if (next != blocks.end() && offset + set->size == next->offset) {
+        next->offset = offset;
+        next->size += set->size;
+    } else {
+        blocks.insert(next, {offset, set->size});
+    }
+    // Blocks that end at the top of the arena are given back to it
+    while (!blocks.empty() && blocks.back().offset + blocks.back().size == pool->arena_used) {
+        pool->arena_used = blocks.back().offset;
+        blocks.pop_back();
+    }
+}
+
+static VkResult AllocateDescriptorSet(DescriptorPoolData* pool, const DescriptorSetLayoutData* layout,
+                                      uint32_t variable_count, DescriptorSetData** set_out) {
+    uint32_t descriptor_count = layout->descriptor_count;
+    uint32_t inline_size = layout->inline_size;
+    DescriptorPoolUsage usages[kDescriptorTypeCount];
+    uint32_t usage_count = 0;
+    if (layout->variable_count) {
+        const auto& binding = layout->bindings.back();
+        const uint32_t type_index = GetDescriptorTypeIndex(binding.type);
+        variable_count = (std::min)(variable_count, binding.count);
+        const uint32_t unused = binding.count - variable_count;
+        (type_index == kInlineUniformBlockTypeIndex ? inline_size : descriptor_count) -= unused;
+        for (auto usage : layout->usages) {
+            if (usage.type_index == type_index) usage.count -= unused;
+            if (usage.count) usages[usage_count++] = usage;
+        }
+    } else {
+        std::copy(layout->usages.begin(), layout->usages.end(), usages);
+        usage_count = (uint32_t)layout->usages.size();
+        variable_count = layout->bindings.empty() ? 0 : layout->bindings.back().count;
+    }
+    // variable_count is now the count of the last binding in the set, whether it's variable or not
+    auto count_in_set = [&](size_t i) { return i + 1 == layout->bindings.size() ? variable_count : layout->bindings[i].count; };
+    uint32_t set_binding_count = 0;
+    for (size_t i = 0; i < layout->bindings.size(); ++i) {
+        if (count_in_set(i)) ++set_binding_count;
+    }
+    if (pool->set_count == pool->max_sets) return VK_ERROR_OUT_OF_POOL_MEMORY;
+    for (uint32_t i = 0; i < usage_count; ++i) {
+        if (pool->type_counts[usages[i].type_index] + usages[i].count > pool->type_limits[usages[i].type_index]) {
+            return VK_ERROR_OUT_OF_POOL_MEMORY;
+        }
+    }
+    const size_t size = GetDescriptorSetSize(usage_count, set_binding_count, descriptor_count, inline_size);
+    size_t offset;
+    if (pool->arena_used + size <= pool->arena_size) {
+        offset = pool->arena_used;
+        pool->arena_used += size;
+    } else {
+        // Reuse the lowest free block that fits, splitting off what the set doesn't need, which keeps the blocks sorted
+        auto block = std::find_if(pool->free_blocks.begin(), pool->free_blocks.end(),
+                                  [=](const DescriptorPoolData::Block& block) { return block.size >= size; });
+        if (block == pool->free_blocks.end()) return VK_ERROR_FRAGMENTED_POOL;
+        offset = block->offset;
+        if (block->size == size) {
+            pool->free_blocks.erase(block);
+        } else {
+            block->offset += size;
+            block->size -= size;
+        }
+    }
+    for (uint32_t i = 0; i < usage_count; ++i) pool->type_counts[usages[i].type_index] += usages[i].count;
+    ++pool->set_count;
+    auto set = reinterpret_cast<DescriptorSetData*>(reinterpret_cast<uint8_t*>(pool->arena.get()) + offset);
+    set->size = (uint32_t)size;
+    set->usage_count = usage_count;
+    set->binding_count = set_binding_count;
+    set->descriptor_count = descriptor_count;
+    set->inline_size = inline_size;
+    std::copy(usages, usages + usage_count, set->usages());
+    DescriptorBindingLayout* set_bindings = set->bindings();
+    for (size_t i = 0; i < layout->bindings.size(); ++i) {
+        if (!count_in_set(i)) continue;
+        *set_bindings = layout->bindings[i];
+        set_bindings->count = count_in_set(i);
+        ++set_bindings;
+    }
+    // Descriptors that were never written read as null handles
+    uint8_t* descriptors = reinterpret_cast<uint8_t*>(set->descriptors());
+    std::memset(descriptors, 0, size - (size_t)(descriptors - reinterpret_cast<uint8_t*>(set)));
+    *set_out = set;
+    return VK_SUCCESS;
+}
+
+// Position of a descriptor in a set. Advancing past the last array element of a binding continues with the first
+// element of the next binding, as writes and copies of consecutive descriptors do.
+class DescriptorCursor {
+  public:
+    DescriptorCursor(DescriptorSetData* set, uint32_t binding, uint32_t array_element) : set_(set), element_(array_element) {
+        const DescriptorBindingLayout* bindings = set->bindings();
+        const DescriptorBindingLayout* end = bindings + set->binding_count;
+        const auto iter = std::lower_bound(bindings, end, binding,
+                                           [](const DescriptorBindingLayout& a, uint32_t b) { return a.binding < b; });
+        index_ = (iter != end && iter->binding == binding) ? (uint32_t)(iter - bindings) : set->binding_count;
+        Skip();
+    }
+    bool valid() const { return index_ < set_->binding_count; }
+    const DescriptorBindingLayout& binding() const { return set_->bindings()[index_]; }
+    // Bytes of an inline uniform block left from the position, whose array element is a byte offset
+    uint32_t inline_bytes() const { return binding().count - element_; }
+    uint8_t* inline_data() const { return set_->inline_data() + binding().offset + element_; }
+    DescriptorData& descriptor() const { return set_->descriptors()[binding().offset + element_]; }
+    void Next() {
+        ++element_;
+        Skip();
+    }
+
+  private:
+    void Skip() {
+        while (valid() && element_ >= binding().count) {
+            element_ -= binding().count;
+            ++index_;
+        }
+    }
+    DescriptorSetData* set_;
+    uint32_t index_;
+    uint32_t element_;
+};
+
+// Store the descriptor at index i of a write
+static void WriteDescriptor(DescriptorData* descriptor, const VkWriteDescriptorSet& write, uint32_t i,
+                            const VkWriteDescriptorSetAccelerationStructureKHR* acceleration_structure_info) {
+    switch (write.descriptorType) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            descriptor->image = write.pImageInfo[i];
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            descriptor->texel_buffer_view = write.pTexelBufferView[i];
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+            descriptor->buffer = write.pBufferInfo[i];
+            break;
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+            if (acceleration_structure_info && i < acceleration_structure_info->accelerationStructureCount) {
+                descriptor->acceleration_structure = acceleration_structure_info->pAccelerationStructures[i];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// A move of count elements of size bytes from the data of vkUpdateDescriptorSetWithTemplate into a set. Element i is
+// read at src_offset + i * src_stride and written to descriptor dst_offset + i of the set, or for inline uniform
+// blocks, which are a single element of their bytes, to byte dst_offset of its inline data.
+struct DescriptorCopyOp {
+    size_t src_offset;
+    size_t src_stride;
+    uint32_t dst_offset;
+    uint32_t count;
+    uint32_t size;
+};
+
+// State of a VkDescriptorUpdateTemplate, the handle points at this. The entries of the template are resolved against
+// its set layout when it is created, into copy operations that already account for bindings, array elements rolling
+// over into the next binding and the size of each descriptor type. Applying the template is then just the moves.
+struct DescriptorUpdateTemplateData {
+    std::vector<DescriptorCopyOp> descriptor_ops;
+    std::vector<DescriptorCopyOp> inline_ops;
+};
+
+static DescriptorUpdateTemplateData* GetDescriptorUpdateTemplateData(VkDescriptorUpdateTemplate update_template) {
+    return reinterpret_cast<DescriptorUpdateTemplateData*>((uintptr_t)update_template);
+}
+
+// Bytes of a descriptor in the data of vkUpdateDescriptorSetWithTemplate, 0 for the types that aren't stored
+static uint32_t GetTemplateDescriptorSize(VkDescriptorType type) {
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            return sizeof(VkDescriptorImageInfo);
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            return sizeof(VkBufferView);
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+            return sizeof(VkDescriptorBufferInfo);
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+            return sizeof(VkAccelerationStructureKHR);
+        default:
+            return 0;
+    }
+}
+static_assert(sizeof(VkDescriptorImageInfo) == sizeof(DescriptorData) && sizeof(VkDescriptorBufferInfo) == sizeof(DescriptorData),
+              "Image and buffer descriptors must fill a DescriptorData");
+static_assert(sizeof(VkBufferView) == sizeof(uint64_t) && sizeof(VkAccelerationStructureKHR) == sizeof(uint64_t),
+              "Handle descriptors must be 64 bits");
+
+static void AddDescriptorCopyOp(std::vector<DescriptorCopyOp>* ops, const DescriptorCopyOp& op) {
+    // Runs of descriptors that continue the previous one in both the data and the set, as consecutive bindings do,
+    // are merged into a single move
+    if (!ops->empty()) {
+        auto& last = ops->back();
+        if (last.size == op.size && last.src_stride == op.src_stride && last.dst_offset + last.count == op.dst_offset &&
+            last.src_offset + last.count * last.src_stride == op.src_offset) {
+            last.count += op.count;
+            return;
+        }
+    }
+    ops->push_back(op);
+}
+
+static void InitDescriptorUpdateTemplate(DescriptorUpdateTemplateData* update_template,
+                                         const VkDescriptorUpdateTemplateCreateInfo* create_info) {
+    // Push descriptor templates are resolved against pipeline layouts, which the mock ICD doesn't track
+    if (create_info->templateType != VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET) return;
+    const auto& bindings = GetDescriptorSetLayoutData(create_info->descriptorSetLayout)->bindings;
+    for (uint32_t i = 0; i < create_info->descriptorUpdateEntryCount; ++i) {
+        const auto& entry = create_info->pDescriptorUpdateEntries[i];
+        auto binding = std::lower_bound(bindings.begin(), bindings.end(), entry.dstBinding,
+                                        [](const DescriptorBindingLayout& a, uint32_t b) { return a.binding < b; });
+        if (binding == bindings.end() || binding->binding != entry.dstBinding) continue;
+        if (entry.descriptorType == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+            // The array element and count of inline uniform blocks are in bytes
+            if (entry.dstArrayElement < binding->count) {
+                const uint32_t size = (std::min)(entry.descriptorCount, binding->count - entry.dstArrayElement);
+                update_template->inline_ops.push_back({entry.offset, 0, binding->offset + entry.dstArrayElement, 1, size});
+            }
+            continue;
+        }
+        const uint32_t size = GetTemplateDescriptorSize(entry.descriptorType);
+        if (!size) continue;
+        size_t src_offset = entry.offset;
+        uint32_t element = entry.dstArrayElement;
+        uint32_t remaining = entry.descriptorCount;
+        for (; binding != bindings.end() && remaining; ++binding) {
+            if (element >= binding->count) {
+                element -= binding->count;
+                continue;
+            }
+            const uint32_t count = (std::min)(remaining, binding->count - element);
+            AddDescriptorCopyOp(&update_template->descriptor_ops, {src_offset, entry.stride, binding->offset + element, count, size});
+            src_offset += count * entry.stride;
+            remaining -= count;
+            element = 0;
+        }
+    }
+}
+
+template <size_t kSize>
+static void CopyDescriptors(DescriptorData* dst, const uint8_t* src, size_t src_stride, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) std::memcpy(dst + i, src + i * src_stride, kSize);
+}
+
+static void ApplyDescriptorUpdateTemplate(DescriptorSetData* set, const DescriptorUpdateTemplateData* update_template,
+                                          const uint8_t* data) {
+    // Descriptors past the variable count of the set don't exist, the layout only knows their largest count
+    for (const auto& op : update_template->descriptor_ops) {
+        const uint32_t count = (std::min)(op.count, set->descriptor_count - (std::min)(op.dst_offset, set->descriptor_count));
+        DescriptorData* dst = set->descriptors() + op.dst_offset;
+        const uint8_t* src = data + op.src_offset;
+        if (op.size == sizeof(uint64_t)) {
+            CopyDescriptors<sizeof(uint64_t)>(dst, src, op.src_stride, count);
+        } else if (op.src_stride == sizeof(DescriptorData)) {
+            std::memcpy(dst, src, count * sizeof(DescriptorData));
+        } else {
+            CopyDescriptors<sizeof(DescriptorData)>(dst, src, op.src_stride, count);
+        }
+    }
+    const uint32_t inline_size = set->inline_size;
+    for (const auto& op : update_template->inline_ops) {
+        const uint32_t size = (std::min)(op.size, inline_size - (std::min)(op.dst_offset, inline_size));
+        std::memcpy(set->inline_data() + op.dst_offset, data + op.src_offset, size);
+    }
+}
+
+// VK_MOCK_ICD_EXECUTE_SHADERS picks the kinds of shaders that are run, see mock_icd_shader.h
+static const char* const execute_shaders = getenv("VK_MOCK_ICD_EXECUTE_SHADERS");
+static const bool execute_compute_shaders = execute_shaders && strstr(execute_shaders, "compute");
+static const bool execute_graphics_shaders = execute_shaders && strstr(execute_shaders, "graphics");
+
+// One batch of queue work. The handles are copied out of the submit info so the batch can complete after the
+// vkQueue* call has returned.
+struct SemaphoreValue {
+    VkSemaphore semaphore;
+    uint64_t value;  // Always 1 for binary semaphores
+};
+
+struct Submission {
+    std::atomic<Submission*> next;
+    std::vector<SemaphoreValue> waits;
+    std::vector<VkCommandBuffer> command_buffers;
+    std::vector<uint32_t> device_masks;  // Of each command buffer from VkDeviceGroupSubmitInfo, empty for all devices
+    std::vector<SemaphoreValue> signals;
+    VkFence fence;
+};
+
+// Intrusive multi-producer single-consumer queue (Vyukov). Push is wait-free, only the queue worker pops.
+class SubmissionQueue {
+  public:
+    SubmissionQueue() : head_(&stub_), tail_(&stub_) { stub_.next = nullptr; }
+    SubmissionQueue(const SubmissionQueue&) = delete;
+    SubmissionQueue& operator=(const SubmissionQueue&) = delete;
+
+    void Push(Submission* submission) {
+        submission->next.store(nullptr, std::memory_order_relaxed);
+        Submission* prev = head_.exchange(submission);
+        prev->next.store(submission, std::memory_order_release);
+    }
+    // Returns null when the queue is empty or a push is still linking its node
+    Submission* Pop() {
+        Submission* tail = tail_;
+        Submission* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) return nullptr;
+            tail_ = tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        if (tail != head_.load()) return nullptr;
+        Push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (!next) return nullptr;
+        tail_ = next;
+        return tail;
+    }
+    bool Empty() const { return tail_ == &stub_ && head_.load() == &stub_; }
+
+  private:
+    std::atomic<Submission*> head_;
+    Submission* tail_;
+    Submission stub_;
+};
+
+// State tracked per VkQueue, the VkQueue handle points at this. Each queue in use runs a worker thread that
+// executes its submissions in order, so vkQueueSubmit returns before the work completes like it would on a GPU.
+struct QueueData {
+    VK_LOADER_DATA loader_data;  // Must be first, the loader stores its dispatch table pointer here
+    DeviceData* device;
+    SubmissionQueue submissions;
+    std::thread worker;
+    std::atomic<bool> stop{false};
+    // The worker sleeps on wake_cv while it has nothing to do, submitters only take wake_lock to wake it up
+    std::atomic<bool> sleeping{false};
+    mutex_t wake_lock;
+    std::condition_variable wake_cv;
+    // The worker parks here while waiting for semaphores, see SemaphoreData::waiters
+    std::condition_variable semaphore_cv;
+    uint64_t submitted_count = 0;  // Written by the submitting thread, vkQueue* calls are externally synchronized
+    uint64_t completed_count = 0;  // Guarded by the sync_lock of the device
+    ~QueueData();
+};
+
+struct BufferData {
+    VkDeviceSize size;
+    DeviceMemoryData* memory;  // Null until memory is bound
+    VkDeviceSize memory_offset;
+};
+
+struct ImageData {
+    VkImageType type;
+    VkFormat format;
+    VkExtent3D extent;
+    uint32_t mip_levels;
+    uint32_t array_layers;
+    VkDeviceSize memory_size;
+    DeviceMemoryData* memory;  // Null until memory is bound
+    VkDeviceSize memory_offset;
+};
+
+struct ImageViewData {
+    VkImage image;
+    VkFormat format;
+    VkImageSubresourceRange subresource_range;
+    VkComponentMapping components;
+};
+
+struct RenderPassData {
+    // Per attachment, how many times each instance of the render pass moves it through memory: once to load its
+    // contents and once to store them. Stencil load and store ops are not counted separately.
+    std::vector<uint32_t> attachment_passes;
+    struct Attachment {
+        VkFormat format;
+        VkAttachmentLoadOp load_op;
+        VkAttachmentLoadOp stencil_load_op;
+    };
+    std::vector<Attachment> attachments;
+    struct Subpass {
+        std::vector<uint32_t> color_attachments;  // VK_ATTACHMENT_UNUSED for the locations that aren't written
+        uint32_t depth_attachment;                // VK_ATTACHMENT_UNUSED if there is none
+    };
+    std::vector<Subpass> subpasses;
+};
+
+struct FramebufferData {
+    std::vector<uint32_t> attachment_texel_sizes;  // Bytes per texel of each attachment, 0 when unknown
+    std::vector<VkImageView> attachments;          // Empty for imageless framebuffers
+    uint32_t layers;
+};
+
+// State of a VkShaderModule. The code is only kept while shaders are executed, nothing else reads it.
+struct ShaderModuleData {
+    std::vector<uint32_t> code;
+};
+
+// State of a compute or graphics VkPipeline
+struct PipelineData {
+    // Null unless the interpreter runs the shaders of the pipeline
+    std::shared_ptr<const ShaderProgram> compute;
+    std::shared_ptr<const GraphicsPipeline> graphics;
+};
+
+// Host backing store of a VkDeviceMemory, the VkDeviceMemory handle points at this. The backing store lives as
+// long as the allocation, so every map returns the same pointer and data written survives unmapping.
+struct DeviceMemoryData {
+    VkDeviceSize size;
+    void* data;
+    int fd;  // File descriptor of exported or imported memory, -1 otherwise
+    uint32_t type_index;
+    uint32_t device_mask;  // Physical devices the allocation is charged to
+    DeviceData* device;
+    ~DeviceMemoryData();  // Frees the backing store and releases the charges of the allocation
+};
+
+static DeviceMemoryData* GetDeviceMemoryData(VkDeviceMemory memory) {
+    return reinterpret_cast<DeviceMemoryData*>((uintptr_t)memory);
+}
+
+struct SwapchainData {
+    VkImage images[icd_swapchain_image_count];
+    // Memory bound to the images when draws render to them, VK_NULL_HANDLE when the images are bare handles
+    VkDeviceMemory memories[icd_swapchain_image_count];
+};
+
+// State tracked per VkDevice. The VkDevice handle points at this, so lookups don't need a global map
+// and every device gets its own lock domain.
+struct DeviceProfile;
+
+struct DeviceData {
+    VK_LOADER_DATA loader_data;  // Must be first, the loader stores its dispatch table pointer here
+    // One bit per physical device of the device group the device was created from
+    uint32_t device_mask;
+    const DeviceProfile* profile;  // Of the physical device the device was created from, nullptr for the built-in one
+    // The physical devices of device_mask, which device memory is allocated from
+    PhysicalDeviceData* physical_devices[VK_MAX_DEVICE_GROUP_SIZE];
+    uint32_t max_allocation_count;
+    std::atomic<uint32_t> allocation_count{0};
+    // Queues of family i are at queue_family_offsets[i] and up, each created by the first vkGetDeviceQueue for it
+    std::vector<uint32_t> queue_family_offsets;  // Has an extra entry holding the total queue count
+    std::unique_ptr<std::atomic<QueueData*>[]> queues;
+    mutex_t lock;  // Guards creating queues
+
+    SlotTable<VkBuffer, BufferData> buffers;
+    SlotTable<VkImage, ImageData> images;
+    SlotTable<VkImageView, ImageViewData> image_views;
+    SlotTable<VkSampler, VkSamplerCreateInfo> samplers;  // With no pNext chain
+    SlotTable<VkRenderPass, RenderPassData> render_passes;
+    SlotTable<VkFramebuffer, FramebufferData> framebuffers;
+    SlotTable<VkSwapchainKHR, SwapchainData> swapchains;
+    SlotTable<VkShaderModule, ShaderModuleData> shader_modules;
+    SlotTable<VkPipeline, PipelineData> pipelines;
+    // Objects whose handles point at their state, destroying the device frees the ones the application didn't
+    ObjectSlab<DeviceMemoryData> memory_slab;
+    ObjectSlab<CommandPoolData> command_pool_slab;
+    ObjectSlab<FenceData> fence_slab;
+    ObjectSlab<SemaphoreData> semaphore_slab;
+    ObjectSlab<QueryPoolData> query_pool_slab;
+    ObjectSlab<DescriptorSetLayoutData> descriptor_set_layout_slab;
+    ObjectSlab<DescriptorPoolData> descriptor_pool_slab;
+    ObjectSlab<DescriptorUpdateTemplateData> descriptor_update_template_slab;
+    // Splits large transfers executed by the queue workers
+    WorkerPool worker_pool;
+    // Guards fence, semaphore and queue completion state, sync_cv is notified whenever any of it is signaled
+    mutex_t sync_lock;
+    std::condition_variable sync_cv;
+    // Declared last so the queue workers are joined before anything they use is destroyed
+    DispObjSlab<QueueData> queue_slab;
+};
+
+static DeviceData* GetDeviceData(VkDevice device) {
+    return reinterpret_cast<DeviceData*>(device);
+}
+
+// Allocations at least this large reserve address space from the OS, which only backs pages with physical memory
+// once they are touched, so large allocations from the advertised heaps cost nothing until used. Smaller ones
+// aren't worth a system call each and come from the regular heap.
+static constexpr VkDeviceSize kMinReservedAllocationSize = 1024 * 1024;
+// Matches minMemoryMapAlignment
+static constexpr size_t kBackingStoreAlignment = 64;
+
+static void* AllocateBackingStore(VkDeviceSize size) {
+    if (size > SIZE_MAX) return nullptr;
+    if (size < kMinReservedAllocationSize) {
+#ifdef _WIN32
+        return _aligned_malloc((size_t)size, kBackingStoreAlignment);
+#else
+        void* data = nullptr;
+        return posix_memalign(&data, kBackingStoreAlignment, (size_t)size) == 0 ? data : nullptr;
+#endif
+    }
+#ifdef _WIN32
+    // Committed pages are zero-fill-on-demand, they only count against the commit limit until touched
+    return VirtualAlloc(nullptr, (size_t)size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* data = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return data == MAP_FAILED ? nullptr : data;
+#endif
+}
+
+static void FreeBackingStore(void* data, VkDeviceSize size) {
+    if (size < kMinReservedAllocationSize) {
+#ifdef _WIN32
+        _aligned_free(data);
+#else
+        free(data);
+#endif
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    munmap(data, (size_t)size);
+#endif
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#define MOCK_ICD_EXTERNAL_MEMORY_FD 1
+static constexpr VkExternalMemoryHandleTypeFlags kFdHandleTypes =
+    VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT | VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+
+static void* MapSharedBackingStore(int fd, VkDeviceSize size) {
+    if (size > SIZE_MAX) return nullptr;
+    void* data = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return data == MAP_FAILED ? nullptr : data;
+}
+
+// Exportable allocations are backed by a memfd, so that importing the fd handed out by vkGetMemoryFdKHR, in this
+// process or another one, maps the very same pages. Like the anonymous mappings, the memfd only consumes memory
+// for pages that are touched.
+static void* AllocateExportableBackingStore(VkDeviceSize size, int* fd) {
+    *fd = memfd_create("mock_icd_device_memory", MFD_CLOEXEC);
+    if (*fd < 0) return nullptr;
+    if (ftruncate(*fd, (off_t)size) == 0) {
+        void* data = MapSharedBackingStore(*fd, size);
+        if (data) return data;
+    }
+    close(*fd);
+    *fd = -1;
+    return nullptr;
+}
+#endif
+
+// Size in bytes and dimensions in texels of a format's texel block. Formats the transfer commands can't handle
+// (multi-planar formats for instance) have a size of 0.
+struct TexelBlock {
+    uint32_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+static TexelBlock GetTexelBlock(VkFormat format) {
+    if (format == VK_FORMAT_R4G4_UNORM_PACK8 || format == VK_FORMAT_S8_UINT) return {1, 1, 1};
+    if (format >= VK_FORMAT_R4G4B4A4_UNORM_PACK16 && format <= VK_FORMAT_A1R5G5B5_UNORM_PACK16) return {2, 1, 1};
+    if (format >= VK_FORMAT_R8_UNORM && format <= VK_FORMAT_R8_SRGB) return {1, 1, 1};
+    if (format >= VK_FORMAT_R8G8_UNORM && format <= VK_FORMAT_R8G8_SRGB) return {2, 1, 1};
+    if (format >= VK_FORMAT_R8G8B8_UNORM && format <= VK_FORMAT_B8G8R8_SRGB) return {3, 1, 1};
+    if (format >= VK_FORMAT_R8G8B8A8_UNORM && format <= VK_FORMAT_A2B10G10R10_SINT_PACK32) return {4, 1, 1};
+    if (format >= VK_FORMAT_R16_UNORM && format <= VK_FORMAT_R16_SFLOAT) return {2, 1, 1};
+    if (format >= VK_FORMAT_R16G16_UNORM && format <= VK_FORMAT_R16G16_SFLOAT) return {4, 1, 1};
+    if (format >= VK_FORMAT_R16G16B16_UNORM && format <= VK_FORMAT_R16G16B16_SFLOAT) return {6, 1, 1};
+    if (format >= VK_FORMAT_R16G16B16A16_UNORM && format <= VK_FORMAT_R16G16B16A16_SFLOAT) return {8, 1, 1};
+    if (format >= VK_FORMAT_R32_UINT && format <= VK_FORMAT_R32_SFLOAT) return {4, 1, 1};
+    if (format >= VK_FORMAT_R32G32_UINT && format <= VK_FORMAT_R32G32_SFLOAT) return {8, 1, 1};
+    if (format >= VK_FORMAT_R32G32B32_UINT && format <= VK_FORMAT_R32G32B32_SFLOAT) return {12, 1, 1};
+    if (format >= VK_FORMAT_R32G32B32A32_UINT && format <= VK_FORMAT_R32G32B32A32_SFLOAT) return {16, 1, 1};
+    if (format >= VK_FORMAT_R64_UINT && format <= VK_FORMAT_R64_SFLOAT) return {8, 1, 1};
+    if (format >= VK_FORMAT_R64G64_UINT && format <= VK_FORMAT_R64G64_SFLOAT) return {16, 1, 1};
+    if (format >= VK_FORMAT_R64G64B64_UINT && format <= VK_FORMAT_R64G64B64_SFLOAT) return {24, 1, 1};
+    if (format >= VK_FORMAT_R64G64B64A64_UINT && format <= VK_FORMAT_R64G64B64A64_SFLOAT) return {32, 1, 1};
+    if (format == VK_FORMAT_B10G11R11_UFLOAT_PACK32 || format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) return {4, 1, 1};
+    // Depth/stencil texels are stored whole, copies of either aspect move the whole texel
+    if (format == VK_FORMAT_D16_UNORM) return {2, 1, 1};
+    if (format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT) return {4, 1, 1};
+    if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT) return {4, 1, 1};
+    if (format == VK_FORMAT_D32_SFLOAT_S8_UINT) return {8, 1, 1};
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK) return {8, 4, 4};
+    if (format >= VK_FORMAT_BC2_UNORM_BLOCK && format <= VK_FORMAT_BC3_SRGB_BLOCK) return {16, 4, 4};
+    if (format >= VK_FORMAT_BC4_UNORM_BLOCK && format <= VK_FORMAT_BC4_SNORM_BLOCK) return {8, 4, 4};
+    if (format >= VK_FORMAT_BC5_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK) return {16, 4, 4};
+    if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK) return {8, 4, 4};
+    if (format >= VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK && format <= VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK) return {16, 4, 4};
+    if (format >= VK_FORMAT_EAC_R11_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11_SNORM_BLOCK) return {8, 4, 4};
+    if (format >= VK_FORMAT_EAC_R11G11_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK) return {16, 4, 4};
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        static const uint8_t astc_block_sizes[][2] = {{4, 4},  {5, 4},  {5, 5},  {6, 5},   {6, 6},   {8, 5},   {8, 6},
+                                                      {8, 8},  {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+        const auto block_size = astc_block_sizes[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+        return {16, block_size[0], block_size[1]};
+    }
+    return {0, 1, 1};
+}
+
+// Images are stored linearly and tightly packed, one mip level after the other, each holding all of the array
+// layers. This always fits in the memory size reported by vkGetImageMemoryRequirements.
+static VkSubresourceLayout GetLinearSubresourceLayout(const ImageData& image, uint32_t mip_level, uint32_t array_layer) {
+    const TexelBlock block = GetTexelBlock(image.format);
+    VkSubresourceLayout layout = {};
+    for (uint32_t level = 0; level <= mip_level; ++level) {
+        const uint32_t width = (std::max)(image.extent.width >> level, 1u);
+        const uint32_t height = (std::max)(image.extent.height >> level, 1u);
+        const uint32_t depth = (std::max)(image.extent.depth >> level, 1u);
+        layout.offset += layout.arrayPitch * image.array_layers;
+        layout.rowPitch = (VkDeviceSize)((width + block.width - 1) / block.width) * block.size;
+        layout.depthPitch = layout.rowPitch * ((height + block.height - 1) / block.height);
+        layout.arrayPitch = layout.depthPitch * depth;
+    }
+    layout.offset += layout.arrayPitch * array_layer;
+    layout.size = layout.arrayPitch;
+    return layout;
+}
+
+// Transfers at least this large are split across the device's worker pool, in pieces of this size
+static constexpr VkDeviceSize kParallelTransferSize = 1024 * 1024;
+
+static uint8_t* GetBoundAddress(DeviceMemoryData* memory, VkDeviceSize memory_offset) {
+    return memory ? static_cast<uint8_t*>(memory->data) + memory_offset : nullptr;
+}
+
+static void CopyMemory(DeviceData* device_data, uint8_t* dst, const uint8_t* src, VkDeviceSize size) {
+    if (size < 2 * kParallelTransferSize) {
+        std::memcpy(dst, src, (size_t)size);
+        return;
+    }
+    const uint32_t piece_count = (uint32_t)((size + kParallelTransferSize - 1) / kParallelTransferSize);
+    device_data->worker_pool.ParallelFor(piece_count, [=](uint32_t piece) {
+        const VkDeviceSize offset = piece * kParallelTransferSize;
+        std::memcpy(dst + offset, src + offset, (size_t)(std::min)(kParallelTransferSize, size - offset));
+    });
+}
+
+// Fill with a repeated 32-bit pattern. The pattern is doubled in place so that the work is done by memcpy.
+static void FillPattern(uint8_t* dst, VkDeviceSize size, uint32_t data) {
+    const uint8_t byte = (uint8_t)data;
+    if (data == byte * 0x01010101u) {
+        std::memset(dst, byte, (size_t)size);
+        return;
+    }
+    VkDeviceSize filled = (std::min)(size, (VkDeviceSize)sizeof(data));
+    std::memcpy(dst, &data, (size_t)filled);
+    while (filled < size) {
+        const VkDeviceSize count = (std::min)(filled, size - filled);
+        std::memcpy(dst + filled, dst, (size_t)count);
+        filled += count;
+    }
+}
+
+static void FillMemory(DeviceData* device_data, uint8_t* dst, VkDeviceSize size, uint32_t data) {
+    if (size < 2 * kParallelTransferSize) {
+        FillPattern(dst, size, data);
+        return;
+    }
+    const uint32_t piece_count = (uint32_t)((size + kParallelTransferSize - 1) / kParallelTransferSize);
+    device_data->worker_pool.ParallelFor(piece_count, [=](uint32_t piece) {
+        const VkDeviceSize offset = piece * kParallelTransferSize;
+        FillPattern(dst + offset, (std::min)(kParallelTransferSize, size - offset), data);
+    });
+}
+
+// Copy the texel rows of a buffer/image copy region in either direction
+static void CopyBufferImageRegion(DeviceData* device_data, uint8_t* buffer_address, const ImageData& image,
+                                  const VkBufferImageCopy& region, bool to_image) {
+    const TexelBlock block = GetTexelBlock(image.format);
+    if (block.size == 0) return;
+    const uint32_t row_length = region.bufferRowLength ? region.bufferRowLength : region.imageExtent.width;
+    const uint32_t image_height = region.bufferImageHeight ? region.bufferImageHeight : region.imageExtent.height;
+    const VkDeviceSize buffer_row_pitch = (VkDeviceSize)((row_length + block.width - 1) / block.width) * block.size;
+    const VkDeviceSize buffer_depth_pitch = buffer_row_pitch * ((image_height + block.height - 1) / block.height);
+    const size_t row_size = (size_t)((region.imageExtent.width + block.width - 1) / block.width) * block.size;
+    const uint32_t rows = (region.imageExtent.height + block.height - 1) / block.height;
+    const uint32_t slices = region.imageExtent.depth * region.imageSubresource.layerCount;
+    uint8_t* image_address = GetBoundAddress(image.memory, image.memory_offset);
+
+    auto copy_slice = [=](uint32_t slice) {
+        const uint32_t layer = slice / region.imageExtent.depth;
+        const uint32_t z = slice % region.imageExtent.depth;
+        const VkSubresourceLayout layout =
+            GetLinearSubresourceLayout(image, region.imageSubresource.mipLevel, region.imageSubresource.baseArrayLayer + layer);
+        uint8_t* image_row = image_address + layout.offset + (region.imageOffset.z + z) * layout.depthPitch +
+                             (region.imageOffset.y / block.height) * layout.rowPitch + (region.imageOffset.x / block.width) * block.size;
+        uint8_t* buffer_row = buffer_address + region.bufferOffset + slice * buffer_depth_pitch;
+        for (uint32_t row = 0; row < rows; ++row) {
+            if (to_image) {
+                std::memcpy(image_row, buffer_row, row_size);
+            } else {
+                std::memcpy(buffer_row, image_row, row_size);
+            }
+            image_row += layout.rowPitch;
+            buffer_row += buffer_row_pitch;
+        }
+    };
+    if (row_size * rows * slices < 2 * kParallelTransferSize || slices == 1) {
+        for (uint32_t slice = 0; slice < slices; ++slice) copy_slice(slice);
+    } else {
+        device_data->worker_pool.ParallelFor(slices, copy_slice);
+    }
+}
+
+// Vertices (or indices) of all instances of draw_count indirect draws whose parameters are read from the memory
+// bound to buffer
+static uint64_t GetIndirectVertexCount(DeviceData* device_data, VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count,
+                                       uint32_t stride, bool indexed) {
+    BufferData buffer_data;
+    if (!device_data->buffers.find(buffer, &buffer_data) || !buffer_data.memory) return 0;
+    const uint8_t* address = GetBoundAddress(buffer_data.memory, buffer_data.memory_offset) + offset;
+    if (!stride) stride = indexed ? sizeof(VkDrawIndexedIndirectCommand) : sizeof(VkDrawIndirectCommand);
+    uint64_t vertex_count = 0;
+    for (uint32_t i = 0; i < draw_count; ++i, address += stride) {
+        // The vertex or index count comes first in both command layouts, followed by the instance count
+        uint32_t counts[2];
+        std::memcpy(counts, address, sizeof(counts));
+        vertex_count += (uint64_t)counts[0] * counts[1];
+    }
+    return vertex_count;
+}
+
+// Number of draws of an indirect count draw, as read from the memory bound to count_buffer
+static uint32_t GetIndirectDrawCount(DeviceData* device_data, VkBuffer count_buffer, VkDeviceSize offset, uint32_t max_draw_count) {
+    BufferData buffer_data;
+    if (!device_data->buffers.find(count_buffer, &buffer_data) || !buffer_data.memory) return max_draw_count;
+    uint32_t count;
+    std::memcpy(&count, GetBoundAddress(buffer_data.memory, buffer_data.memory_offset) + offset, sizeof(count));
+    return (std::min)(count, max_draw_count);
+}
+
+static bool IsIndexedIndirectCountDraw(CommandId id) {
+    return id == CommandId::CmdDrawIndexedIndirectCount || id == CommandId::CmdDrawIndexedIndirectCountKHR ||
+           id == CommandId::CmdDrawIndexedIndirectCountAMD;
+}
+
+// Simulated GPU execution time of recorded work, all costs are in nanoseconds. The model is loaded from the file named
+// by the VK_MOCK_ICD_COST_MODEL environment variable, which holds "name = value" lines. Without it a submission
+// completes as soon as its commands have executed.
+struct CostModel {
+    bool enabled = false;
+    double draw_ns = 0;             // Fixed cost of every draw
+    double dispatch_ns = 0;         // Fixed cost of every dispatch
+    double vertex_ns = 0;           // Per vertex or index of every instance drawn
+    double transfer_byte_ns = 0;    // Per byte written by transfer commands
+    double barrier_ns = 0;          // Per pipeline barrier command
+    double attachment_byte_ns = 0;  // Per byte of attachment loaded or stored by a render pass instance
+};
+
+static CostModel LoadCostModel() {
+    CostModel model;
+    const char* path = getenv("VK_MOCK_ICD_COST_MODEL");
+    if (!path || !*path) return model;
+    FILE* file = fopen(path, "r");
+    if (!file) return model;
+    const struct {
+        const char* name;
+        double CostModel::*cost;
+    } costs[] = {
+        {"draw_ns", &CostModel::draw_ns},
+        {"dispatch_ns", &CostModel::dispatch_ns},
+        {"vertex_ns", &CostModel::vertex_ns},
+        {"transfer_byte_ns", &CostModel::transfer_byte_ns},
+        {"barrier_ns", &CostModel::barrier_ns},
+        {"attachment_byte_ns", &CostModel::attachment_byte_ns},
+    };
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        // Lines that don't parse, such as # comments, are skipped
+        char name[64];
+        double value;
+        if (sscanf(line, " %63[a-z_] = %lf", name, &value) != 2) continue;
+        for (const auto& cost : costs) {
+            if (strcmp(name, cost.name) == 0) {
+                model.*cost.cost = value;
+                model.enabled = true;
+            }
+        }
+    }
+    fclose(file);
+    return model;
+}
+
+static const CostModel& GetCostModel() {
+    static const CostModel model = LoadCostModel();
+    return model;
+}
+
+static double GetImageRegionBytes(VkFormat format, VkExtent3D extent, uint32_t layers) {
+    const TexelBlock block = GetTexelBlock(format);
+    if (block.size == 0) return 0;
+    return (double)((extent.width + block.width - 1) / block.width) * ((extent.height + block.height - 1) / block.height) *
+           extent.depth * layers * block.size;
+}
+
+static double GetRenderPassCost(DeviceData* device_data, const CostModel& model, const VkRenderPassBeginInfo& begin) {
+    RenderPassData render_pass;
+    FramebufferData framebuffer;
+    if (!device_data->render_passes.find(begin.renderPass, &render_pass) ||
+        !device_data->framebuffers.find(begin.framebuffer, &framebuffer)) {
+        return 0;
+    }
+    const size_t count = (std::min)(render_pass.attachment_passes.size(), framebuffer.attachment_texel_sizes.size());
+    double texel_bytes = 0;
+    for (size_t i = 0; i < count; ++i) texel_bytes += (double)render_pass.attachment_passes[i] * framebuffer.attachment_texel_sizes[i];
+    return model.attachment_byte_ns * texel_bytes * begin.renderArea.extent.width * begin.renderArea.extent.height * framebuffer.layers;
+}
+
+// Simulated GPU time of a recorded command, in nanoseconds. Secondary command buffers are charged command by command
+// as they execute.
+static double GetCommandCost(DeviceData* device_data, const CostModel& model, const CommandHeader& command) {
+    double cost = 0;
+    CommandReader reader(command);
+    switch (command.id) {
+        case CommandId::CmdDraw:
+        case CommandId::CmdDrawIndexed: {
+            const auto count = reader.Read<uint32_t>();
+            const auto instance_count = reader.Read<uint32_t>();
+            cost += model.draw_ns + model.vertex_ns * count * instance_count;
+            break;
+        }
+        case CommandId::CmdDrawIndirect:
+        case CommandId::CmdDrawIndexedIndirect: {
+            const auto buffer = reader.Read<VkBuffer>();
+            const auto offset = reader.Read<VkDeviceSize>();
+            const auto draw_count = reader.Read<uint32_t>();
+            const auto stride = reader.Read<uint32_t>();
+            cost += model.draw_ns * draw_count +
+                    model.vertex_ns * GetIndirectVertexCount(device_data, buffer, offset, draw_count, stride,
+                                                             command.id == CommandId::CmdDrawIndexedIndirect);
+            break;
+        }
+        case CommandId::CmdDrawIndirectCount:
+        case CommandId::CmdDrawIndirectCountKHR:
+        case CommandId::CmdDrawIndirectCountAMD:
+        case CommandId::CmdDrawIndexedIndirectCount:
+        case CommandId::CmdDrawIndexedIndirectCountKHR:
+        case CommandId::CmdDrawIndexedIndirectCountAMD: {
+            const auto buffer = reader.Read<VkBuffer>();
+            const auto offset = reader.Read<VkDeviceSize>();
+            const auto count_buffer = reader.Read<VkBuffer>();
+            const auto count_offset = reader.Read<VkDeviceSize>();
+            const auto max_draw_count = reader.Read<uint32_t>();
+            const auto stride = reader.Read<uint32_t>();
+            const uint32_t draw_count = GetIndirectDrawCount(device_data, count_buffer, count_offset, max_draw_count);
+            cost += model.draw_ns * draw_count +
+                    model.vertex_ns * GetIndirectVertexCount(device_data, buffer, offset, draw_count, stride,
+                                                             IsIndexedIndirectCountDraw(command.id));
+            break;
+        }
+        case CommandId::CmdDrawIndirectByteCountEXT:
+        case CommandId::CmdDrawMeshTasksNV:
+        case CommandId::CmdDrawMeshTasksIndirectNV:
+        case CommandId::CmdDrawMeshTasksIndirectCountNV:
+            cost += model.draw_ns;
+            break;
+        case CommandId::CmdDispatch:
+        case CommandId::CmdDispatchBase:
+        case CommandId::CmdDispatchBaseKHR:
+        case CommandId::CmdDispatchIndirect:
+            cost += model.dispatch_ns;
+            break;
+        case CommandId::CmdPipelineBarrier:
+            cost += model.barrier_ns;
+            break;
+        case CommandId::CmdCopyBuffer: {
+            reader.Read<VkBuffer>();
+            reader.Read<VkBuffer>();
+            reader.Read<uint32_t>();
+            uint32_t region_count;
+            const auto regions = reader.ReadArray<VkBufferCopy>(&region_count);
+            for (uint32_t i = 0; i < region_count; ++i) cost += model.transfer_byte_ns * regions[i].size;
+            break;
+        }
+        case CommandId::CmdFillBuffer: {
+            const auto dst_buffer = reader.Read<VkBuffer>();
+            const auto offset = reader.Read<VkDeviceSize>();
+            auto size = reader.Read<VkDeviceSize>();
+            BufferData dst;
+            if (size == VK_WHOLE_SIZE) size = device_data->buffers.find(dst_buffer, &dst) ? dst.size - offset : 0;
+            cost += model.transfer_byte_ns * size;
+            break;
+        }
+        case CommandId::CmdUpdateBuffer: {
+            reader.Read<VkBuffer>();
+            reader.Read<VkDeviceSize>();
+            cost += model.transfer_byte_ns * reader.Read<VkDeviceSize>();
+            break;
+        }
+        case CommandId::CmdCopyBufferToImage:
+        case CommandId::CmdCopyImageToBuffer: {
+            VkImage image_handle;
+            if (command.id == CommandId::CmdCopyBufferToImage) {
+                reader.Read<VkBuffer>();
+                image_handle = reader.Read<VkImage>();
+                reader.Read<VkImageLayout>();
+            } else {
+                image_handle = reader.Read<VkImage>();
+                reader.Read<VkImageLayout>();
+                reader.Read<VkBuffer>();
+            }
+            reader.Read<uint32_t>();
+            uint32_t region_count;
+            const auto regions = reader.ReadArray<VkBufferImageCopy>(&region_count);
+            ImageData image;
+            if (!device_data->images.find(image_handle, &image)) break;
+            for (uint32_t i = 0; i < region_count; ++i) {
+                cost += model.transfer_byte_ns *
+                        GetImageRegionBytes(image.format, regions[i].imageExtent, regions[i].imageSubresource.layerCount);
+            }
+            break;
+        }
+        case CommandId::CmdCopyImage:
+        case CommandId::CmdResolveImage: {
+            // VkImageCopy and VkImageResolve share a layout
+            const auto src_image = reader.Read<VkImage>();
+            reader.Read<VkImageLayout>();
+            reader.Read<VkImage>();
+            reader.Read<VkImageLayout>();
+            reader.Read<uint32_t>();
+            uint32_t region_count;
+            const auto regions = reader.ReadArray<VkImageCopy>(&region_count);
+            ImageData src;
+            if (!device_data->images.find(src_image, &src)) break;
+            for (uint32_t i = 0; i < region_count; ++i) {
+                cost += model.transfer_byte_ns * GetImageRegionBytes(src.format, regions[i].extent, regions[i].srcSubresource.layerCount);
+            }
+            break;
+        }
+        case CommandId::CmdBlitImage: {
+            reader.Read<VkImage>();
+            reader.Read<VkImageLayout>();
+            const auto dst_image = reader.Read<VkImage>();
+            reader.Read<VkImageLayout>();
+            reader.Read<uint32_t>();
+            uint32_t region_count;
+            const auto regions = reader.ReadArray<VkImageBlit>(&region_count);
+            ImageData dst;
+            if (!device_data->images.find(dst_image, &dst)) break;
+            for (uint32_t i = 0; i < region_count; ++i) {
+                const VkOffset3D* offsets = regions[i].dstOffsets;
+                const VkExtent3D extent = {(uint32_t)std::abs(offsets[1].x - offsets[0].x), (uint32_t)std::abs(offsets[1].y - offsets[0].y),
+                                           (uint32_t)std::abs(offsets[1].z - offsets[0].z)};
+                cost += model.transfer_byte_ns * GetImageRegionBytes(dst.format, extent, regions[i].dstSubresource.layerCount);
+            }
+            break;
+        }
+        case CommandId::CmdClearColorImage:
+        case CommandId::CmdClearDepthStencilImage: {
+            // Charged as a clear of the whole base level
+            ImageData image;
+            if (!device_data->images.find(reader.Read<VkImage>(), &image)) break;
+            cost += model.transfer_byte_ns * GetImageRegionBytes(image.format, image.extent, image.array_layers);
+            break;
+        }
+        case CommandId::CmdBeginRenderPass:
+        case CommandId::CmdBeginRenderPass2:
+        case CommandId::CmdBeginRenderPass2KHR: {
+            uint32_t count;
+            const auto begin = reader.ReadArray<VkRenderPassBeginInfo>(&count);
+            if (begin) cost += GetRenderPassCost(device_data, model, *begin);
+            break;
+        }
+        default:
+            break;
+    }
+    return cost;
+}
+
+// Timestamps count nanoseconds of the steady clock (CLOCK_MONOTONIC on Linux) divided by the advertised period
+static constexpr float kTimestampPeriod = 1.0f;
+
+// Work counted while the queries around it are active. Unless their shaders are executed, the counts are stand-ins
+// derived from draw and dispatch parameters: every draw is taken to be a triangle list that produces one fragment
+// sample per vertex, and every workgroup to be a single invocation. Draws that are rasterized count the vertices they
+// shade, the triangles they assemble and the fragments that pass the depth test.
+struct WorkCounts {
+    uint64_t vertices;
+    uint64_t primitives;
+    uint64_t fragments;
+    uint64_t compute_invocations;
+};
+
+struct ActiveQuery {
+    QueryPoolData* pool;
+    uint32_t query;
+    WorkCounts counts;
+};
+
+// Descriptor sets bound to a pipeline bind point. Sets with dynamic uniform or storage buffers also get the dynamic
+// offsets of their descriptors, in binding order.
+static constexpr uint32_t kMaxBoundDescriptorSets = 32;
+struct BoundDescriptorSets {
+    DescriptorSetData* sets[kMaxBoundDescriptorSets] = {};
+    std::vector<uint32_t> dynamic_offsets[kMaxBoundDescriptorSets];
+};
+
+// A render pass instance begun by the command buffer that executes, with the attachments of its framebuffer resolved
+struct RenderPassInstance {
+    bool active = false;
+    RenderPassData render_pass;
+    std::vector<RenderTarget> attachments;  // Per attachment of the render pass
+    uint32_t subpass = 0;
+    VkRect2D render_area;
+};
+
+// State that carries across the command buffers a queue worker executes for one batch
+struct ExecutionContext {
+    const CostModel* cost_model;
+    uint32_t submit_mask;  // Physical devices the current command buffer was submitted to
+    uint32_t device_mask;  // Physical devices that execute the current command, a subset of submit_mask
+    // Simulated time of each physical device of the device group, advanced by the cost of every command it executes
+    std::array<std::chrono::steady_clock::time_point, VK_MAX_DEVICE_GROUP_SIZE> gpu_times;
+    std::vector<ActiveQuery> active_queries;
+    // State bound by the commands of the command buffer that executes, for the shaders of its dispatches
+    std::shared_ptr<const ShaderProgram> compute_program;
+    BoundDescriptorSets compute_descriptor_sets;
+    std::vector<uint8_t> push_constants;
+    // The same for the shaders of its draws. The render pass instance is the one exception to secondary command
+    // buffers not inheriting state: they continue the one of the primary command buffer that executes them.
+    std::shared_ptr<const GraphicsPipeline> graphics_pipeline;
+    BoundDescriptorSets graphics_descriptor_sets;
+    ShaderMemoryRange vertex_buffers[kMaxVertexBindings];
+    ShaderMemoryRange index_buffer;
+    uint32_t index_size;  // 0 without an index buffer
+    VkViewport viewport;
+    VkRect2D scissor;
+    float blend_constants[4];
+    RenderPassInstance render_pass;
+};
+
+static uint32_t GetFirstDeviceIndex(uint32_t device_mask) {
+    uint32_t index = 0;
+    while (device_mask && !(device_mask & 1)) {
+        device_mask >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+static void CountVertices(ExecutionContext* context, uint64_t vertex_count) {
+    for (auto& active : context->active_queries) {
+        active.counts.vertices += vertex_count;
+        active.counts.primitives += vertex_count / 3;
+        active.counts.fragments += vertex_count;
+    }
+}
+
+static uint64_t GetStatisticValue(VkQueryPipelineStatisticFlagBits statistic, const WorkCounts& counts) {
+    switch (statistic) {
+        case VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT:
+        case VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT:
+            return counts.vertices;
+        case VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT:
+        case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT:
+        case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT:
+            return counts.primitives;
+        case VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT:
+            return counts.fragments;
+        case VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT:
+            return counts.compute_invocations;
+        default:
+            // No geometry or tessellation work is ever counted
+            return 0;
+    }
+}
+
+// Store the final values of an ended query and make it available, the caller holds the device sync_lock
+static void EndQuery(const ActiveQuery& active) {
+    QueryPoolData* pool = active.pool;
+    uint64_t* values = &pool->values[active.query * pool->value_count];
+    if (pool->type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        uint32_t index = 0;
+        for (uint32_t bit = 1; bit <= pool->statistics; bit <<= 1) {
+            if (pool->statistics & bit) values[index++] = GetStatisticValue((VkQueryPipelineStatisticFlagBits)bit, active.counts);
+        }
+    } else if (pool->type == VK_QUERY_TYPE_OCCLUSION) {
+        values[0] = active.counts.fragments;
+    }
+    pool->available[active.query] = 1;
+}
+
+static void ResetQueries(QueryPoolData* pool, uint32_t first_query, uint32_t query_count) {
+    std::fill_n(pool->values.begin() + (size_t)first_query * pool->value_count, (size_t)query_count * pool->value_count, 0);
+    std::fill_n(pool->available.begin() + first_query, query_count, 0);
+}
+
+// Write the results of queries [first_query, first_query + query_count) the way vkGetQueryPoolResults lays them out,
+// the caller holds the device sync_lock. Returns whether all of the queries were available.
+static bool WriteQueryResults(const QueryPoolData& pool, uint32_t first_query, uint32_t query_count, uint8_t* data,
+                              VkDeviceSize stride, VkQueryResultFlags flags) {
+    auto write = [=](uint8_t* result, uint32_t index, uint64_t value) {
+        if (flags & VK_QUERY_RESULT_64_BIT) {
+            std::memcpy(result + index * sizeof(uint64_t), &value, sizeof(uint64_t));
+        } else {
+            const uint32_t value32 = (uint32_t)value;
+            std::memcpy(result + index * sizeof(uint32_t), &value32, sizeof(uint32_t));
+        }
+    };
+    bool all_available = true;
+    for (uint32_t i = 0; i < query_count; ++i, data += stride) {
+        const uint32_t query = first_query + i;
+        const bool available = pool.available[query] != 0;
+        all_available = all_available && available;
+        // Values of unavailable queries are left alone unless partial results were asked for
+        if (available || (flags & VK_QUERY_RESULT_PARTIAL_BIT)) {
+            for (uint32_t v = 0; v < pool.value_count; ++v) write(data, v, pool.values[query * pool.value_count + v]);
+        }
+        if (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) write(data, pool.value_count, available ? 1 : 0);
+    }
+    return all_available;
+}
+
+// Timestamps come from the clock of the first physical device that executes the command
+static uint64_t GetTimestamp(const ExecutionContext& context) {
+    const auto time = context.cost_model->enabled ? context.gpu_times[GetFirstDeviceIndex(context.device_mask)]
+                                                  : std::chrono::steady_clock::now();
+    return (uint64_t)(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count() / kTimestampPeriod);
+}
+
+// Compile the shader of a pipeline stage for the interpreter, returns null if it can't run it. The module can also
+// come in the pNext chain of the stage instead of as a VkShaderModule.
+static std::shared_ptr<const ShaderProgram> CompileShaderStage(DeviceData* device_data, const VkPipelineShaderStageCreateInfo& stage,
+                                                               uint32_t execution_model) {
+    std::unique_ptr<ShaderProgram> program;
+    const auto module_info = lvl_find_in_chain<VkShaderModuleCreateInfo>(stage.pNext);
+    if (module_info) {
+        program = CompileShader(module_info->pCode, module_info->codeSize / sizeof(uint32_t), stage.pName, execution_model,
+                                stage.pSpecializationInfo);
+    } else {
+        device_data->shader_modules.update(stage.module, [&](const ShaderModuleData& module_data) {
+            program = CompileShader(module_data.code.data(), module_data.code.size(), stage.pName, execution_model,
+                                    stage.pSpecializationInfo);
+        });
+    }
+    return std::shared_ptr<const ShaderProgram>(std::move(program));
+}
+
+static bool IsDynamicBufferDescriptor(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+static void BindDescriptorSets(BoundDescriptorSets* bound, uint32_t first_set, uint32_t set_count, const VkDescriptorSet* sets,
+                               uint32_t dynamic_offset_count, const uint32_t* dynamic_offsets) {
+    for (uint32_t i = 0; i < set_count && first_set + i < kMaxBoundDescriptorSets; ++i) {
+        DescriptorSetData* set = sets[i] ? GetDescriptorSetData(sets[i]) : nullptr;
+        auto& offsets = bound->dynamic_offsets[first_set + i];
+        bound->sets[first_set + i] = set;
+        offsets.clear();
+        if (!set) continue;
+        for (uint32_t b = 0; b < set->binding_count; ++b) {
+            const auto& binding = set->bindings()[b];
+            if (!IsDynamicBufferDescriptor(binding.type)) continue;
+            for (uint32_t element = 0; element < binding.count && dynamic_offset_count; ++element, --dynamic_offset_count) {
+                offsets.push_back(*dynamic_offsets++);
+            }
+        }
+    }
+}
+
+// Memory of the uniform buffer, storage buffer or inline uniform block at the first element of a binding of a bound
+// set, with no base address if there isn't one
+static ShaderMemoryRange GetBoundBufferMemory(DeviceData* device_data, const BoundDescriptorSets& bound, uint32_t set_index,
+                                              uint32_t binding) {
+    const ShaderMemoryRange none = {nullptr, 0, 0};
+    DescriptorSetData* set = set_index < kMaxBoundDescriptorSets ? bound.sets[set_index] : nullptr;
+    if (!set) return none;
+    DescriptorCursor cursor(set, binding, 0);
+    if (!cursor.valid() || cursor.binding().binding != binding) return none;
+    const auto type = cursor.binding().type;
+    if (type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) return ShaderMemoryRange{cursor.inline_data(), cursor.inline_bytes(), 0};
+    if (type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER && type != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER && !IsDynamicBufferDescriptor(type)) {
+        return none;
+    }
+    const VkDescriptorBufferInfo& info = cursor.descriptor().buffer;
+    BufferData buffer;
+    if (!device_data->buffers.find(info.buffer, &buffer) || !buffer.memory) return none;
+    VkDeviceSize offset = info.offset;
+    if (IsDynamicBufferDescriptor(type)) {
+        // Dynamic offsets are in the order of the dynamic descriptors of the set
+        size_t index = 0;
+        for (uint32_t b = 0; b < set->binding_count; ++b) {
+            const auto& set_binding = set->bindings()[b];
+            if (set_binding.binding == binding) break;
+            if (IsDynamicBufferDescriptor(set_binding.type)) index += set_binding.count;
+        }
+        const auto& offsets = bound.dynamic_offsets[set_index];
+        if (index < offsets.size()) offset += offsets[index];
+    }
+    if (offset >= buffer.size) return none;
+    const VkDeviceSize size = info.range == VK_WHOLE_SIZE ? buffer.size - offset : (std::min)(info.range, buffer.size - offset);
+    return ShaderMemoryRange{GetBoundAddress(buffer.memory, buffer.memory_offset) + offset, size, 0};
+}
+
+// The image view and sampler of a texture of a shader, an empty texture that reads as 0 if there is no image to
+// sample. Views sample the levels and layers of their subresource range. Samplers the device doesn't know of, such
+// as the immutable samplers of set layouts, sample as a VkSamplerCreateInfo of zeros does.
+static ShaderTexture GetShaderTexture(DeviceData* device_data, VkImageView image_view, VkSampler sampler,
+                                      const ShaderTextureBinding& binding) {
+    ShaderTexture texture{};
+    ImageViewData view;
+    ImageData image;
+    if (!device_data->image_views.find(image_view, &view) || !device_data->images.find(view.image, &image) || !image.memory) return texture;
+    texture.format = GetTexelFormat(view.format);
+    if (!texture.format.components) return texture;
+    texture.texel_size = GetTexelBlock(view.format).size;
+    const auto& range = view.subresource_range;
+    const uint32_t level_count = range.levelCount == VK_REMAINING_MIP_LEVELS ? image.mip_levels - range.baseMipLevel : range.levelCount;
+    texture.level_count = (std::min)(level_count, kMaxTextureLevels);
+    texture.layer_count = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? image.array_layers - range.baseArrayLayer : range.layerCount;
+    for (uint32_t i = 0; i < texture.level_count; ++i) {
+        const uint32_t level = range.baseMipLevel + i;
+        const VkSubresourceLayout layout = GetLinearSubresourceLayout(image, level, range.baseArrayLayer);
+        texture.levels[i] = {GetBoundAddress(image.memory, image.memory_offset) + layout.offset,
+                             (std::max)(image.extent.width >> level, 1u), (std::max)(image.extent.height >> level, 1u),
+                             (size_t)layout.rowPitch, (size_t)layout.arrayPitch};
+    }
+    texture.dimensions = binding.dimensions;
+    const VkComponentSwizzle swizzles[4] = {view.components.r, view.components.g, view.components.b, view.components.a};
+    for (uint32_t c = 0; c < 4; ++c) {
+        switch (swizzles[c]) {
+            case VK_COMPONENT_SWIZZLE_ZERO: texture.swizzle[c] = 4; break;
+            case VK_COMPONENT_SWIZZLE_ONE: texture.swizzle[c] = 5; break;
+            case VK_COMPONENT_SWIZZLE_R:
+            case VK_COMPONENT_SWIZZLE_G:
+            case VK_COMPONENT_SWIZZLE_B:
+            case VK_COMPONENT_SWIZZLE_A: texture.swizzle[c] = (uint8_t)(swizzles[c] - VK_COMPONENT_SWIZZLE_R); break;
+            default: texture.swizzle[c] = (uint8_t)c; break;
+        }
+    }
+    VkSamplerCreateInfo sampler_info = {};
+    device_data->samplers.find(sampler, &sampler_info);
+    texture.mag_linear = sampler_info.magFilter == VK_FILTER_LINEAR;
+    texture.min_linear = sampler_info.minFilter == VK_FILTER_LINEAR;
+    texture.mip_linear = sampler_info.mipmapMode == VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    texture.unnormalized = sampler_info.unnormalizedCoordinates == VK_TRUE;
+    texture.address_modes[0] = sampler_info.addressModeU;
+    texture.address_modes[1] = sampler_info.addressModeV;
+    texture.lod_bias = sampler_info.mipLodBias;
+    texture.min_lod = sampler_info.minLod;
+    texture.max_lod = sampler_info.maxLod;
+    const bool integer_border = sampler_info.borderColor == VK_BORDER_COLOR_INT_TRANSPARENT_BLACK ||
+                                sampler_info.borderColor == VK_BORDER_COLOR_INT_OPAQUE_BLACK ||
+                                sampler_info.borderColor == VK_BORDER_COLOR_INT_OPAQUE_WHITE;
+    const bool white =
+        sampler_info.borderColor == VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE || sampler_info.borderColor == VK_BORDER_COLOR_INT_OPAQUE_WHITE;
+    const bool opaque = white || sampler_info.borderColor == VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK ||
+                        sampler_info.borderColor == VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    for (uint32_t c = 0; c < 4; ++c) {
+        const bool one = c == 3 ? opaque : white;
+        texture.border[c] = integer_border ? ShaderU(one ? 1 : 0) : ShaderF(one ? 1.0f : 0.0f);
+    }
+    return texture;
+}
+
+// Resolve what a program accesses from the state the command buffer bound: the memory of its push constant and
+// buffer variables and the textures of its Sample instructions
+static void GetShaderResources(DeviceData* device_data, const ShaderProgram& program, const BoundDescriptorSets& descriptor_sets,
+                               std::vector<uint8_t>* push_constants, std::vector<ShaderMemoryRange>* memory,
+                               std::vector<ShaderTexture>* textures) {
+    memory->assign(program.variables.size(), ShaderMemoryRange{nullptr, 0, 0});
+    for (size_t i = 0; i < program.variables.size(); ++i) {
+        const auto& variable = program.variables[i];
+        if (variable.memory == ShaderMemory::PushConstant) {
+            (*memory)[i] = ShaderMemoryRange{push_constants->data(), push_constants->size(), 0};
+        } else if (variable.memory == ShaderMemory::Buffer) {
+            (*memory)[i] = GetBoundBufferMemory(device_data, descriptor_sets, variable.set, variable.binding);
+        }
+    }
+    textures->clear();
+    for (const auto& binding : program.textures) {
+        auto find = [&](uint32_t set_index, uint32_t binding_number) -> const VkDescriptorImageInfo* {
+            DescriptorSetData* set = set_index < kMaxBoundDescriptorSets ? descriptor_sets.sets[set_index] : nullptr;
+            if (!set) return nullptr;
+            DescriptorCursor cursor(set, binding_number, 0);
+            if (!cursor.valid() || cursor.binding().binding != binding_number) return nullptr;
+            const auto type = cursor.binding().type;
+            if (type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && type != VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE &&
+                type != VK_DESCRIPTOR_TYPE_SAMPLER) {
+                return nullptr;
+            }
+            return &cursor.descriptor().image;
+        };
+        const VkDescriptorImageInfo* image = find(binding.image_set, binding.image_binding);
+        const VkDescriptorImageInfo* sampler = find(binding.sampler_set, binding.sampler_binding);
+        textures->push_back(GetShaderTexture(device_data, image ? image->imageView : VK_NULL_HANDLE,
+                                             sampler ? sampler->sampler : VK_NULL_HANDLE, binding));
+    }
+}
+
+// Build the state the rasterizer runs a graphics pipeline with, null if it can't run it: for pipelines with shader
+// stages other than vertex and fragment shaders, topologies other than triangles, polygon modes other than fill,
+// vertex attributes of formats it can't read, or dynamic state other than viewports, scissors and blend constants
+// (and the state that only matters to stencil, depth bias, depth bounds and lines).
+static std::shared_ptr<const GraphicsPipeline> CreateGraphicsPipeline(DeviceData* device_data,
+                                                                      const VkGraphicsPipelineCreateInfo& create_info) {
+    auto pipeline = std::make_shared<GraphicsPipeline>();
+    for (uint32_t i = 0; i < create_info.stageCount; ++i) {
+        const auto& stage = create_info.pStages[i];
+        if (stage.stage == VK_SHADER_STAGE_VERTEX_BIT) {
+            pipeline->vertex = CompileShaderStage(device_data, stage, kSpvExecutionModelVertex);
+            if (!pipeline->vertex) return nullptr;
+        } else if (stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+            pipeline->fragment = CompileShaderStage(device_data, stage, kSpvExecutionModelFragment);
+            if (!pipeline->fragment) return nullptr;
+        } else {
+            return nullptr;
+        }
+    }
+    const auto input_assembly = create_info.pInputAssemblyState;
+    const auto rasterization = create_info.pRasterizationState;
+    if (!pipeline->vertex || !input_assembly || !rasterization || !IsTriangleTopology(input_assembly->topology) ||
+        rasterization->polygonMode != VK_POLYGON_MODE_FILL) {
+        return nullptr;
+    }
+    if (create_info.pDynamicState) {
+        for (uint32_t i = 0; i < create_info.pDynamicState->dynamicStateCount; ++i) {
+            switch (create_info.pDynamicState->pDynamicStates[i]) {
+                case VK_DYNAMIC_STATE_VIEWPORT: pipeline->dynamic_viewport = true; break;
+                case VK_DYNAMIC_STATE_SCISSOR: pipeline->dynamic_scissor = true; break;
+                case VK_DYNAMIC_STATE_BLEND_CONSTANTS: pipeline->dynamic_blend_constants = true; break;
+                case VK_DYNAMIC_STATE_LINE_WIDTH:
+                case VK_DYNAMIC_STATE_DEPTH_BIAS:
+                case VK_DYNAMIC_STATE_DEPTH_BOUNDS:
+                case VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK:
+                case VK_DYNAMIC_STATE_STENCIL_WRITE_MASK:
+                case VK_DYNAMIC_STATE_STENCIL_REFERENCE: break;
+                default: return nullptr;
+            }
+        }
+    }
+    pipeline->topology = input_assembly->topology;
+    pipeline->primitive_restart = input_assembly->primitiveRestartEnable == VK_TRUE;
+    pipeline->rasterizer_discard = rasterization->rasterizerDiscardEnable == VK_TRUE;
+    pipeline->depth_clamp = rasterization->depthClampEnable == VK_TRUE;
+    pipeline->cull_mode = rasterization->cullMode;
+    pipeline->front_face = rasterization->frontFace;
+    if (const auto vertex_input = create_info.pVertexInputState) {
+        for (uint32_t i = 0; i < vertex_input->vertexBindingDescriptionCount; ++i) {
+            const auto& binding = vertex_input->pVertexBindingDescriptions[i];
+            if (binding.binding >= kMaxVertexBindings) return nullptr;
+            pipeline->bindings[binding.binding] = {binding.stride, binding.inputRate == VK_VERTEX_INPUT_RATE_INSTANCE};
+        }
+        // Inputs of the vertex shader without an attribute keep whatever was in lane memory
+        for (const auto& input : pipeline->vertex->inputs) {
+            for (uint32_t i = 0; i < vertex_input->vertexAttributeDescriptionCount; ++i) {
+                const auto& attribute = vertex_input->pVertexAttributeDescriptions[i];
+                if (attribute.location != input.location) continue;
+                const TexelFormat format = GetTexelFormat(attribute.format);
+                if (!format.components || attribute.binding >= kMaxVertexBindings) return nullptr;
+                pipeline->attributes.push_back({attribute.binding, attribute.offset, format, GetTexelBlock(attribute.format).size,
+                                                input.offset, input.component, input.components});
+            }
+        }
+    }
+    if (const auto depth_stencil = create_info.pDepthStencilState) {
+        pipeline->depth_test = depth_stencil->depthTestEnable == VK_TRUE;
+        pipeline->depth_write = depth_stencil->depthWriteEnable == VK_TRUE;
+        pipeline->depth_compare = depth_stencil->depthCompareOp;
+    }
+    if (const auto color_blend = create_info.pColorBlendState) {
+        for (uint32_t i = 0; i < color_blend->attachmentCount && i < kMaxColorTargets; ++i) {
+            const auto& attachment = color_blend->pAttachments[i];
+            pipeline->blends[i] = {attachment.blendEnable == VK_TRUE, attachment.srcColorBlendFactor, attachment.dstColorBlendFactor,
+                                   attachment.colorBlendOp,           attachment.srcAlphaBlendFactor, attachment.dstAlphaBlendFactor,
+                                   attachment.alphaBlendOp,           attachment.colorWriteMask};
+        }
+        std::copy_n(color_blend->blendConstants, 4, pipeline->blend_constants);
+    }
+    if (const auto viewport_state = create_info.pViewportState) {
+        if (viewport_state->pViewports && viewport_state->viewportCount) pipeline->viewport = viewport_state->pViewports[0];
+        if (viewport_state->pScissors && viewport_state->scissorCount) pipeline->scissor = viewport_state->pScissors[0];
+    }
+    LinkGraphicsShaders(pipeline.get());
+    return pipeline;
 }
-'''
 
-# Manual code at the top of the cpp source file
-SOURCE_CPP_PREFIX = '''
-using std::unordered_map;
+// What draws need to know of a render pass: the formats and load ops of its attachments and the attachments each
+// subpass renders to. The same for VkRenderPassCreateInfo and VkRenderPassCreateInfo2.
+template <typename RenderPassCreateInfo>
+static RenderPassData GetRenderPassData(const RenderPassCreateInfo& create_info) {
+    RenderPassData render_pass_data;
+    for (uint32_t i = 0; i < create_info.attachmentCount; ++i) {
+        const auto& attachment = create_info.pAttachments[i];
+        render_pass_data.attachment_passes.push_back((attachment.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? 1 : 0) +
+                                                     (attachment.storeOp == VK_ATTACHMENT_STORE_OP_STORE ? 1 : 0));
+        render_pass_data.attachments.push_back({attachment.format, attachment.loadOp, attachment.stencilLoadOp});
+    }
+    for (uint32_t i = 0; i < create_info.subpassCount; ++i) {
+        const auto& subpass = create_info.pSubpasses[i];
+        RenderPassData::Subpass subpass_data;
+        for (uint32_t j = 0; j < subpass.colorAttachmentCount; ++j) {
+            subpass_data.color_attachments.push_back(subpass.pColorAttachments[j].attachment);
+        }
+        subpass_data.depth_attachment =
+            subpass.pDepthStencilAttachment ? subpass.pDepthStencilAttachment->attachment : VK_ATTACHMENT_UNUSED;
+        render_pass_data.subpasses.push_back(std::move(subpass_data));
+    }
+    return render_pass_data;
+}
 
-static constexpr uint32_t icd_physical_device_count = 1;
-static constexpr uint32_t kSupportedVulkanAPIVersion = VK_API_VERSION_1_1;
-static unordered_map<VkInstance, std::array<VkPhysicalDevice, icd_physical_device_count>> physical_device_map;
+// The first mip level and layer of the subresource range of an image view, to render to. Views of formats the
+// rasterizer can't write and of images without memory have nothing to render to.
+static RenderTarget GetRenderTarget(DeviceData* device_data, VkImageView image_view) {
+    RenderTarget target;
+    ImageViewData view;
+    ImageData image;
+    if (!device_data->image_views.find(image_view, &view) || !device_data->images.find(view.image, &image) || !image.memory) return target;
+    target.format = GetTexelFormat(view.format);
+    if (!target.format.components) return target;
+    const uint32_t level = view.subresource_range.baseMipLevel;
+    const VkSubresourceLayout layout = GetLinearSubresourceLayout(image, level, view.subresource_range.baseArrayLayer);
+    target.base = GetBoundAddress(image.memory, image.memory_offset) + layout.offset;
+    target.texel_size = GetTexelBlock(view.format).size;
+    target.width = (std::max)(image.extent.width >> level, 1u);
+    target.height = (std::max)(image.extent.height >> level, 1u);
+    target.row_pitch = (size_t)layout.rowPitch;
+    return target;
+}
+
+static VkRect2D IntersectRects(const VkRect2D& a, const VkRect2D& b) {
+    const int64_t x0 = (std::max)(a.offset.x, b.offset.x), y0 = (std::max)(a.offset.y, b.offset.y);
+    const int64_t x1 = (std::min)((int64_t)a.offset.x + a.extent.width, (int64_t)b.offset.x + b.extent.width);
+    const int64_t y1 = (std::min)((int64_t)a.offset.y + a.extent.height, (int64_t)b.offset.y + b.extent.height);
+    if (x1 <= x0 || y1 <= y0) return VkRect2D{{(int32_t)x0, (int32_t)y0}, {0, 0}};
+    return VkRect2D{{(int32_t)x0, (int32_t)y0}, {(uint32_t)(x1 - x0), (uint32_t)(y1 - y0)}};
+}
+
+// Clear a rect of a render target to a value, the RGBA of a color or the depth of a depth/stencil texel. Stencil
+// is left alone.
+static void ClearRenderTarget(const RenderTarget& target, VkRect2D rect, const ShaderValue* value) {
+    if (!target.base) return;
+    rect = IntersectRects(rect, VkRect2D{{0, 0}, {target.width, target.height}});
+    if (!rect.extent.width || !rect.extent.height) return;
+    // The first texel is encoded, the rest of the rows are copies of it
+    uint8_t* first = target.Texel(rect.offset.x, rect.offset.y);
+    EncodeTexel(target.format, value, 0xF, first);
+    const size_t texel_bytes = (size_t)target.format.components * target.format.bits / 8;
+    for (uint32_t x = 1; x < rect.extent.width; ++x) std::memcpy(first + (size_t)x * target.texel_size, first, texel_bytes);
+    for (uint32_t y = 1; y < rect.extent.height; ++y) {
+        uint8_t* row = first + y * target.row_pitch;
+        if (texel_bytes == target.texel_size) {
+            std::memcpy(row, first, (size_t)rect.extent.width * target.texel_size);
+        } else {
+            for (uint32_t x = 0; x < rect.extent.width; ++x) std::memcpy(row + (size_t)x * target.texel_size, first, texel_bytes);
+        }
+    }
+}
 
-// Map device memory handle to any mapped allocations that we'll need to free on unmap
-static unordered_map<VkDeviceMemory, std::vector<void*>> mapped_memory_map;
+static bool HasDepth(VkFormat format) {
+    return format >= VK_FORMAT_D16_UNORM && format <= VK_FORMAT_D32_SFLOAT_S8_UINT && format != VK_FORMAT_S8_UINT;
+}
 
-// Map device memory allocation handle to the size
-static unordered_map<VkDeviceMemory, VkDeviceSize> allocated_memory_size_map;
+static void ClearValueToShaderValues(const VkClearValue& clear_value, VkFormat format, ShaderValue* values) {
+    if (HasDepth(format)) {
+        values[0] = ShaderF(clear_value.depthStencil.depth);
+    } else {
+        std::memcpy(values, clear_value.color.uint32, 4 * sizeof(ShaderValue));
+    }
+}
 
-static unordered_map<VkDevice, unordered_map<uint32_t, unordered_map<uint32_t, VkQueue>>> queue_map;
-static unordered_map<VkDevice, unordered_map<VkBuffer, VkBufferCreateInfo>> buffer_map;
-static unordered_map<VkDevice, unordered_map<VkImage, VkDeviceSize>> image_memory_size_map;
+// Begin a render pass instance, clearing the attachments whose load op says so over the render area
+static void BeginRenderPass(DeviceData* device_data, ExecutionContext* context, const VkRenderPassBeginInfo& begin,
+                            const VkClearValue* clear_values, uint32_t clear_value_count) {
+    RenderPassInstance& instance = context->render_pass;
+    instance = RenderPassInstance();
+    FramebufferData framebuffer;
+    if (!device_data->render_passes.find(begin.renderPass, &instance.render_pass) ||
+        !device_data->framebuffers.find(begin.framebuffer, &framebuffer) || framebuffer.attachments.empty()) {
+        return;
+    }
+    instance.active = true;
+    instance.render_area = begin.renderArea;
+    const auto& attachments = instance.render_pass.attachments;
+    for (uint32_t i = 0; i < framebuffer.attachments.size() && i < attachments.size(); ++i) {
+        instance.attachments.push_back(GetRenderTarget(device_data, framebuffer.attachments[i]));
+        if (attachments[i].load_op != VK_ATTACHMENT_LOAD_OP_CLEAR || i >= clear_value_count) continue;
+        ShaderValue values[4];
+        ClearValueToShaderValues(clear_values[i], attachments[i].format, values);
+        ClearRenderTarget(instance.attachments[i], begin.renderArea, values);
+    }
+}
 
-static constexpr uint32_t icd_swapchain_image_count = 1;
-static unordered_map<VkSwapchainKHR, VkImage[icd_swapchain_image_count]> swapchain_image_map;
+// vkCmdClearAttachments of the attachments of the current subpass
+static void ClearAttachments(ExecutionContext* context, const VkClearAttachment* clears, uint32_t clear_count, const VkClearRect* rects,
+                             uint32_t rect_count) {
+    const RenderPassInstance& instance = context->render_pass;
+    if (!instance.active || instance.subpass >= instance.render_pass.subpasses.size()) return;
+    const auto& subpass = instance.render_pass.subpasses[instance.subpass];
+    for (uint32_t i = 0; i < clear_count; ++i) {
+        const auto& clear = clears[i];
+        uint32_t attachment = VK_ATTACHMENT_UNUSED;
+        if (clear.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+            if (clear.colorAttachment < subpass.color_attachments.size()) attachment = subpass.color_attachments[clear.colorAttachment];
+        } else if (clear.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) {
+            attachment = subpass.depth_attachment;
+        }
+        if (attachment >= instance.attachments.size()) continue;
+        ShaderValue values[4];
+        ClearValueToShaderValues(clear.clearValue, instance.render_pass.attachments[attachment].format, values);
+        for (uint32_t r = 0; r < rect_count; ++r) ClearRenderTarget(instance.attachments[attachment], rects[r].rect, values);
+    }
+}
+
+// Count the work of a draw for active queries and, with a graphics pipeline the rasterizer runs bound inside a
+// render pass instance, render it
+static void Draw(DeviceData* device_data, ExecutionContext* context, bool indexed, uint32_t count, uint32_t instance_count, uint32_t first,
+                 int32_t vertex_offset, uint32_t first_instance) {
+    const GraphicsPipeline* pipeline = context->graphics_pipeline.get();
+    const RenderPassInstance& instance = context->render_pass;
+    if (!pipeline || !instance.active || instance.subpass >= instance.render_pass.subpasses.size() ||
+        (indexed && !context->index_size)) {
+        CountVertices(context, (uint64_t)count * instance_count);
+        return;
+    }
+    GraphicsDraw draw;
+    draw.pipeline = pipeline;
+    GetShaderResources(device_data, *pipeline->vertex, context->graphics_descriptor_sets, &context->push_constants, &draw.vertex_memory,
+                       &draw.vertex_textures);
+    if (pipeline->fragment) {
+        GetShaderResources(device_data, *pipeline->fragment, context->graphics_descriptor_sets, &context->push_constants,
+                           &draw.fragment_memory, &draw.fragment_textures);
+    }
+    std::copy_n(context->vertex_buffers, kMaxVertexBindings, draw.vertex_buffers);
+    if (indexed) {
+        draw.index_buffer = context->index_buffer;
+        draw.index_size = context->index_size;
+    }
+    draw.count = count;
+    draw.instance_count = instance_count;
+    draw.first = first;
+    draw.vertex_offset = vertex_offset;
+    draw.first_instance = first_instance;
+    draw.viewport = pipeline->dynamic_viewport ? context->viewport : pipeline->viewport;
+    std::copy_n(pipeline->dynamic_blend_constants ? context->blend_constants : pipeline->blend_constants, 4, draw.blend_constants);
+    draw.rect = IntersectRects(pipeline->dynamic_scissor ? context->scissor : pipeline->scissor, instance.render_area);
+    const auto& subpass = instance.render_pass.subpasses[instance.subpass];
+    auto fit = [&](const RenderTarget& target) {
+        if (target.base) draw.rect = IntersectRects(draw.rect, VkRect2D{{0, 0}, {target.width, target.height}});
+    };
+    for (uint32_t location = 0; location < kMaxColorTargets && location < subpass.color_attachments.size(); ++location) {
+        const uint32_t attachment = subpass.color_attachments[location];
+        if (attachment < instance.attachments.size()) draw.colors[location] = instance.attachments[attachment];
+        fit(draw.colors[location]);
+    }
+    if (subpass.depth_attachment < instance.attachments.size() &&
+        HasDepth(instance.render_pass.attachments[subpass.depth_attachment].format)) {
+        draw.depth = instance.attachments[subpass.depth_attachment];
+        fit(draw.depth);
+    }
+    const GraphicsDrawCounts counts = RunGraphicsDraw(&device_data->worker_pool, draw);
+    for (auto& active : context->active_queries) {
+        active.counts.vertices += counts.vertices;
+        active.counts.primitives += counts.primitives;
+        active.counts.fragments += counts.fragments;
+    }
+}
+
+// Count the invocations of a dispatch for active queries and run the bound compute shader, if there is one
+static void Dispatch(DeviceData* device_data, ExecutionContext* context, const uint32_t base[3], const uint32_t count[3]) {
+    const ShaderProgram* program = context->compute_program.get();
+    const uint64_t group_count = (uint64_t)count[0] * count[1] * count[2];
+    for (auto& active : context->active_queries) active.counts.compute_invocations += group_count * (program ? program->LaneCount() : 1);
+    if (!program) return;
+    ComputeDispatch dispatch;
+    dispatch.program = program;
+    GetShaderResources(device_data, *program, context->compute_descriptor_sets, &context->push_constants, &dispatch.bound_memory,
+                       &dispatch.textures);
+    std::copy(base, base + 3, dispatch.base);
+    std::copy(count, count + 3, dispatch.count);
+    RunComputeDispatch(&device_data->worker_pool, dispatch);
+}
+
+// Execute the transfer and query commands recorded in command_buffer against the memory bound to their resources, and
+// count the work of draws and dispatches for active queries. Dispatches run their compute shaders and draws are
+// rasterized into their attachments when VK_MOCK_ICD_EXECUTE_SHADERS asks for it. Commands that touch unbound
+// resources are skipped, other commands are ignored for now.
+static void ExecuteCommandBuffer(DeviceData* device_data, VkCommandBuffer command_buffer, ExecutionContext* context) {
+    // Command buffers start out with nothing bound, secondary ones don't inherit what the primary one bound
+    if (execute_compute_shaders) {
+        context->compute_program.reset();
+        context->compute_descriptor_sets = BoundDescriptorSets();
+    }
+    if (execute_graphics_shaders) {
+        context->graphics_pipeline.reset();
+        context->graphics_descriptor_sets = BoundDescriptorSets();
+        std::fill_n(context->vertex_buffers, kMaxVertexBindings, ShaderMemoryRange{nullptr, 0, 0});
+        context->index_buffer = ShaderMemoryRange{nullptr, 0, 0};
+        context->index_size = 0;
+        context->viewport = VkViewport{};
+        context->scissor = VkRect2D{};
+        std::fill_n(context->blend_constants, 4, 0.0f);
+    }
+    if (execute_compute_shaders || execute_graphics_shaders) context->push_constants.clear();
+    for (const auto& command : GetRecordedCommands(command_buffer)) {
+        if (context->cost_model->enabled) {
+            const auto cost = std::chrono::nanoseconds((int64_t)GetCommandCost(device_data, *context->cost_model, command));
+            for (uint32_t mask = context->device_mask, index = 0; mask; mask >>= 1, ++index) {
+                if (mask & 1) context->gpu_times[index] += cost;
+            }
+        }
+        CommandReader reader(command);
+        switch (command.id) {
+            case CommandId::CmdCopyBuffer: {
+                const auto src_buffer = reader.Read<VkBuffer>();
+                const auto dst_buffer = reader.Read<VkBuffer>();
+                reader.Read<uint32_t>();
+                uint32_t region_count;
+                const auto regions = reader.ReadArray<VkBufferCopy>(&region_count);
+                BufferData src, dst;
+                if (!device_data->buffers.find(src_buffer, &src) || !device_data->buffers.find(dst_buffer, &dst)) break;
+                if (!src.memory || !dst.memory) break;
+                for (uint32_t i = 0; i < region_count; ++i) {
+                    CopyMemory(device_data, GetBoundAddress(dst.memory, dst.memory_offset) + regions[i].dstOffset,
+                               GetBoundAddress(src.memory, src.memory_offset) + regions[i].srcOffset, regions[i].size);
+                }
+                break;
+            }
+            case CommandId::CmdFillBuffer: {
+                const auto dst_buffer = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                auto size = reader.Read<VkDeviceSize>();
+                const auto data = reader.Read<uint32_t>();
+                BufferData dst;
+                if (!device_data->buffers.find(dst_buffer, &dst) || !dst.memory) break;
+                if (size == VK_WHOLE_SIZE) size = (dst.size - offset) & ~(VkDeviceSize)3;
+                FillMemory(device_data, GetBoundAddress(dst.memory, dst.memory_offset) + offset, size, data);
+                break;
+            }
+            case CommandId::CmdUpdateBuffer: {
+                const auto dst_buffer = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                reader.Read<VkDeviceSize>();
+                uint32_t size;
+                const auto data = reader.ReadArray<uint8_t>(&size);
+                BufferData dst;
+                if (!device_data->buffers.find(dst_buffer, &dst) || !dst.memory || !data) break;
+                std::memcpy(GetBoundAddress(dst.memory, dst.memory_offset) + offset, data, size);
+                break;
+            }
+            case CommandId::CmdCopyBufferToImage:
+            case CommandId::CmdCopyImageToBuffer: {
+                const bool to_image = command.id == CommandId::CmdCopyBufferToImage;
+                VkBuffer buffer_handle;
+                VkImage image_handle;
+                if (to_image) {
+                    buffer_handle = reader.Read<VkBuffer>();
+                    image_handle = reader.Read<VkImage>();
+                    reader.Read<VkImageLayout>();
+                } else {
+                    image_handle = reader.Read<VkImage>();
+                    reader.Read<VkImageLayout>();
+                    buffer_handle = reader.Read<VkBuffer>();
+                }
+                reader.Read<uint32_t>();
+                uint32_t region_count;
+                const auto regions = reader.ReadArray<VkBufferImageCopy>(&region_count);
+                BufferData buffer;
+                ImageData image;
+                if (!device_data->buffers.find(buffer_handle, &buffer) || !device_data->images.find(image_handle, &image)) break;
+                if (!buffer.memory || !image.memory) break;
+                for (uint32_t i = 0; i < region_count; ++i) {
+                    CopyBufferImageRegion(device_data, GetBoundAddress(buffer.memory, buffer.memory_offset), image, regions[i], to_image);
+                }
+                break;
+            }
+            case CommandId::CmdExecuteCommands: {
+                reader.Read<uint32_t>();
+                uint32_t count;
+                const auto secondaries = reader.ReadArray<VkCommandBuffer>(&count);
+                for (uint32_t i = 0; i < count; ++i) ExecuteCommandBuffer(device_data, secondaries[i], context);
+                break;
+            }
+            case CommandId::CmdSetDeviceMask:
+            case CommandId::CmdSetDeviceMaskKHR:
+                context->device_mask = context->submit_mask & reader.Read<uint32_t>();
+                break;
+            case CommandId::CmdDraw: {
+                if (context->active_queries.empty() && !context->graphics_pipeline) break;
+                const auto count = reader.Read<uint32_t>();
+                const auto instance_count = reader.Read<uint32_t>();
+                const auto first_vertex = reader.Read<uint32_t>();
+                const auto first_instance = reader.Read<uint32_t>();
+                Draw(device_data, context, false, count, instance_count, first_vertex, 0, first_instance);
+                break;
+            }
+            case CommandId::CmdDrawIndexed: {
+                if (context->active_queries.empty() && !context->graphics_pipeline) break;
+                const auto count = reader.Read<uint32_t>();
+                const auto instance_count = reader.Read<uint32_t>();
+                const auto first_index = reader.Read<uint32_t>();
+                const auto vertex_offset = reader.Read<int32_t>();
+                const auto first_instance = reader.Read<uint32_t>();
+                Draw(device_data, context, true, count, instance_count, first_index, vertex_offset, first_instance);
+                break;
+            }
+            case CommandId::CmdDrawIndirect:
+            case CommandId::CmdDrawIndexedIndirect: {
+                if (context->active_queries.empty()) break;
+                const auto buffer = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                const auto draw_count = reader.Read<uint32_t>();
+                const auto stride = reader.Read<uint32_t>();
+                CountVertices(context, GetIndirectVertexCount(device_data, buffer, offset, draw_count, stride,
+                                                              command.id == CommandId::CmdDrawIndexedIndirect));
+                break;
+            }
+            case CommandId::CmdDrawIndirectCount:
+            case CommandId::CmdDrawIndirectCountKHR:
+            case CommandId::CmdDrawIndirectCountAMD:
+            case CommandId::CmdDrawIndexedIndirectCount:
+            case CommandId::CmdDrawIndexedIndirectCountKHR:
+            case CommandId::CmdDrawIndexedIndirectCountAMD: {
+                if (context->active_queries.empty()) break;
+                const auto buffer = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                const auto count_buffer = reader.Read<VkBuffer>();
+                const auto count_offset = reader.Read<VkDeviceSize>();
+                const auto max_draw_count = reader.Read<uint32_t>();
+                const auto stride = reader.Read<uint32_t>();
+                const uint32_t draw_count = GetIndirectDrawCount(device_data, count_buffer, count_offset, max_draw_count);
+                CountVertices(context, GetIndirectVertexCount(device_data, buffer, offset, draw_count, stride,
+                                                              IsIndexedIndirectCountDraw(command.id)));
+                break;
+            }
+            case CommandId::CmdBindPipeline: {
+                const auto bind_point = reader.Read<VkPipelineBindPoint>();
+                PipelineData pipeline_data;
+                if (execute_compute_shaders && bind_point == VK_PIPELINE_BIND_POINT_COMPUTE) {
+                    device_data->pipelines.find(reader.Read<VkPipeline>(), &pipeline_data);
+                    context->compute_program = std::move(pipeline_data.compute);
+                } else if (execute_graphics_shaders && bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
+                    device_data->pipelines.find(reader.Read<VkPipeline>(), &pipeline_data);
+                    context->graphics_pipeline = std::move(pipeline_data.graphics);
+                }
+                break;
+            }
+            case CommandId::CmdBindDescriptorSets: {
+                const auto bind_point = reader.Read<VkPipelineBindPoint>();
+                BoundDescriptorSets* bound;
+                if (execute_compute_shaders && bind_point == VK_PIPELINE_BIND_POINT_COMPUTE) {
+                    bound = &context->compute_descriptor_sets;
+                } else if (execute_graphics_shaders && bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
+                    bound = &context->graphics_descriptor_sets;
+                } else {
+                    break;
+                }
+                reader.Read<VkPipelineLayout>();
+                const auto first_set = reader.Read<uint32_t>();
+                reader.Read<uint32_t>();
+                uint32_t set_count;
+                const auto sets = reader.ReadArray<VkDescriptorSet>(&set_count);
+                reader.Read<uint32_t>();
+                uint32_t dynamic_offset_count;
+                const auto dynamic_offsets = reader.ReadArray<uint32_t>(&dynamic_offset_count);
+                BindDescriptorSets(bound, first_set, set_count, sets, dynamic_offset_count, dynamic_offsets);
+                break;
+            }
+            case CommandId::CmdPushConstants: {
+                if (!execute_compute_shaders && !execute_graphics_shaders) break;
+                reader.Read<VkPipelineLayout>();
+                reader.Read<VkShaderStageFlags>();
+                const auto offset = reader.Read<uint32_t>();
+                reader.Read<uint32_t>();
+                uint32_t size;
+                const auto values = reader.ReadArray<uint8_t>(&size);
+                if (!values) break;
+                auto& push_constants = context->push_constants;
+                if (push_constants.size() < (size_t)offset + size) push_constants.resize((size_t)offset + size);
+                std::memcpy(push_constants.data() + offset, values, size);
+                break;
+            }
+            case CommandId::CmdBindVertexBuffers: {
+                if (!execute_graphics_shaders) break;
+                const auto first_binding = reader.Read<uint32_t>();
+                reader.Read<uint32_t>();
+                uint32_t binding_count;
+                const auto buffers = reader.ReadArray<VkBuffer>(&binding_count);
+                const auto offsets = reader.ReadArray<VkDeviceSize>();
+                for (uint32_t i = 0; i < binding_count && first_binding + i < kMaxVertexBindings; ++i) {
+                    BufferData buffer;
+                    auto& bound = context->vertex_buffers[first_binding + i];
+                    bound = ShaderMemoryRange{nullptr, 0, 0};
+                    if (!device_data->buffers.find(buffers[i], &buffer) || !buffer.memory || offsets[i] >= buffer.size) continue;
+                    bound = ShaderMemoryRange{GetBoundAddress(buffer.memory, buffer.memory_offset) + offsets[i],
+                                              buffer.size - offsets[i], 0};
+                }
+                break;
+            }
+            case CommandId::CmdBindIndexBuffer: {
+                if (!execute_graphics_shaders) break;
+                const auto buffer_handle = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                const auto index_type = reader.Read<VkIndexType>();
+                BufferData buffer;
+                context->index_buffer = ShaderMemoryRange{nullptr, 0, 0};
+                switch (index_type) {
+                    case VK_INDEX_TYPE_UINT16: context->index_size = 2; break;
+                    case VK_INDEX_TYPE_UINT32: context->index_size = 4; break;
+                    case VK_INDEX_TYPE_UINT8_EXT: context->index_size = 1; break;
+                    default: context->index_size = 0; break;
+                }
+                if (!device_data->buffers.find(buffer_handle, &buffer) || !buffer.memory || offset >= buffer.size) break;
+                context->index_buffer =
+                    ShaderMemoryRange{GetBoundAddress(buffer.memory, buffer.memory_offset) + offset, buffer.size - offset, 0};
+                break;
+            }
+            case CommandId::CmdSetViewport: {
+                if (!execute_graphics_shaders || reader.Read<uint32_t>() != 0) break;
+                reader.Read<uint32_t>();
+                if (const auto viewports = reader.ReadArray<VkViewport>()) context->viewport = viewports[0];
+                break;
+            }
+            case CommandId::CmdSetScissor: {
+                if (!execute_graphics_shaders || reader.Read<uint32_t>() != 0) break;
+                reader.Read<uint32_t>();
+                if (const auto scissors = reader.ReadArray<VkRect2D>()) context->scissor = scissors[0];
+                break;
+            }
+            case CommandId::CmdSetBlendConstants: {
+                if (!execute_graphics_shaders) break;
+                if (const auto blend_constants = reader.ReadArray<float>()) std::copy_n(blend_constants, 4, context->blend_constants);
+                break;
+            }
+            case CommandId::CmdBeginRenderPass:
+            case CommandId::CmdBeginRenderPass2:
+            case CommandId::CmdBeginRenderPass2KHR: {
+                if (!execute_graphics_shaders) break;
+                const auto begin = reader.ReadArray<VkRenderPassBeginInfo>();
+                uint32_t clear_value_count;
+                const auto clear_values = reader.ReadArray<VkClearValue>(&clear_value_count);
+                if (begin) BeginRenderPass(device_data, context, *begin, clear_values, clear_value_count);
+                break;
+            }
+            case CommandId::CmdNextSubpass:
+            case CommandId::CmdNextSubpass2:
+            case CommandId::CmdNextSubpass2KHR:
+                ++context->render_pass.subpass;
+                break;
+            case CommandId::CmdEndRenderPass:
+            case CommandId::CmdEndRenderPass2:
+            case CommandId::CmdEndRenderPass2KHR:
+                context->render_pass.active = false;
+                break;
+            case CommandId::CmdClearAttachments: {
+                if (!execute_graphics_shaders) break;
+                reader.Read<uint32_t>();
+                uint32_t clear_count;
+                const auto clears = reader.ReadArray<VkClearAttachment>(&clear_count);
+                reader.Read<uint32_t>();
+                uint32_t rect_count;
+                const auto rects = reader.ReadArray<VkClearRect>(&rect_count);
+                ClearAttachments(context, clears, clear_count, rects, rect_count);
+                break;
+            }
+            case CommandId::CmdDispatch:
+            case CommandId::CmdDispatchBase:
+            case CommandId::CmdDispatchBaseKHR: {
+                if (context->active_queries.empty() && !context->compute_program) break;
+                uint32_t base[3] = {0, 0, 0};
+                if (command.id != CommandId::CmdDispatch) {
+                    for (auto& base_group : base) base_group = reader.Read<uint32_t>();
+                }
+                uint32_t count[3];
+                for (auto& group_count : count) group_count = reader.Read<uint32_t>();
+                Dispatch(device_data, context, base, count);
+                break;
+            }
+            case CommandId::CmdDispatchIndirect: {
+                if (context->active_queries.empty() && !context->compute_program) break;
+                const auto buffer = reader.Read<VkBuffer>();
+                const auto offset = reader.Read<VkDeviceSize>();
+                BufferData buffer_data;
+                if (!device_data->buffers.find(buffer, &buffer_data) || !buffer_data.memory) break;
+                if (offset + sizeof(VkDispatchIndirectCommand) > buffer_data.size) break;
+                VkDispatchIndirectCommand indirect;
+                std::memcpy(&indirect, GetBoundAddress(buffer_data.memory, buffer_data.memory_offset) + offset, sizeof(indirect));
+                const uint32_t base[3] = {0, 0, 0};
+                const uint32_t count[3] = {indirect.x, indirect.y, indirect.z};
+                Dispatch(device_data, context, base, count);
+                break;
+            }
+            case CommandId::CmdResetQueryPool: {
+                const auto pool = GetQueryPoolData(reader.Read<VkQueryPool>());
+                const auto first_query = reader.Read<uint32_t>();
+                const auto query_count = reader.Read<uint32_t>();
+                lock_guard_t lock(device_data->sync_lock);
+                ResetQueries(pool, first_query, query_count);
+                break;
+            }
+            case CommandId::CmdBeginQuery:
+            case CommandId::CmdBeginQueryIndexedEXT: {
+                const auto pool = GetQueryPoolData(reader.Read<VkQueryPool>());
+                const auto query = reader.Read<uint32_t>();
+                context->active_queries.push_back(ActiveQuery{pool, query, WorkCounts{}});
+                break;
+            }
+            case CommandId::CmdEndQuery:
+            case CommandId::CmdEndQueryIndexedEXT: {
+                const auto pool = GetQueryPoolData(reader.Read<VkQueryPool>());
+                const auto query = reader.Read<uint32_t>();
+                auto& active_queries = context->active_queries;
+                auto active = std::find_if(active_queries.begin(), active_queries.end(),
+                                           [=](const ActiveQuery& a) { return a.pool == pool && a.query == query; });
+                if (active == active_queries.end()) break;
+                {
+                    lock_guard_t lock(device_data->sync_lock);
+                    EndQuery(*active);
+                }
+                active_queries.erase(active);
+                break;
+            }
+            case CommandId::CmdWriteTimestamp: {
+                reader.Read<VkPipelineStageFlagBits>();
+                const auto pool = GetQueryPoolData(reader.Read<VkQueryPool>());
+                const auto query = reader.Read<uint32_t>();
+                lock_guard_t lock(device_data->sync_lock);
+                pool->values[query] = GetTimestamp(*context);
+                pool->available[query] = 1;
+                break;
+            }
+            case CommandId::CmdCopyQueryPoolResults: {
+                const auto pool = GetQueryPoolData(reader.Read<VkQueryPool>());
+                const auto first_query = reader.Read<uint32_t>();
+                const auto query_count = reader.Read<uint32_t>();
+                const auto dst_buffer = reader.Read<VkBuffer>();
+                const auto dst_offset = reader.Read<VkDeviceSize>();
+                const auto stride = reader.Read<VkDeviceSize>();
+                const auto flags = reader.Read<VkQueryResultFlags>();
+                BufferData dst;
+                if (!device_data->buffers.find(dst_buffer, &dst) || !dst.memory) break;
+                // Queries written earlier on this queue are already available, so WAIT_BIT has nothing to wait for
+                lock_guard_t lock(device_data->sync_lock);
+                WriteQueryResults(*pool, first_query, query_count, GetBoundAddress(dst.memory, dst.memory_offset) + dst_offset, stride,
+                                  flags);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// Block on cv until pred() holds or timeout nanoseconds have passed, returns false on timeout
+template <typename Pred>
+static bool WaitWithTimeout(unique_lock_t& lock, std::condition_variable& cv, uint64_t timeout, Pred pred) {
+    // Timeouts too long to add to the clock are treated as infinite
+    if (timeout >= (uint64_t)INT64_MAX / 2) {
+        cv.wait(lock, pred);
+        return true;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout);
+    return cv.wait_until(lock, deadline, pred);
+}
+
+// Block until pred() holds or timeout nanoseconds have passed, with the sync_lock of device_data held
+template <typename Pred>
+static VkResult WaitForSync(DeviceData* device_data, uint64_t timeout, Pred pred) {
+    unique_lock_t lock(device_data->sync_lock);
+    return WaitWithTimeout(lock, device_data->sync_cv, timeout, pred) ? VK_SUCCESS : VK_TIMEOUT;
+}
+
+// Set the payload of semaphore_data and wake the waiters it satisfies, the caller holds the device sync_lock
+static void SignalSemaphoreValue(SemaphoreData* semaphore_data, uint64_t value) {
+    semaphore_data->value.store(value, std::memory_order_release);
+    const auto end = semaphore_data->waiters.upper_bound(value);
+    for (auto it = semaphore_data->waiters.begin(); it != end; ++it) it->second->notify_one();
+}
+
+// Block on cv until all (or with wait_any, any) of the semaphores reach their values, until abort() returns true,
+// or until timeout nanoseconds have passed. lock holds the device sync_lock. Returns whether the values were reached.
+template <typename Abort>
+static bool WaitSemaphoreValues(unique_lock_t& lock, std::condition_variable& cv, const SemaphoreValue* waits, uint32_t count,
+                                bool wait_any, uint64_t timeout, Abort abort) {
+    auto reached = [](const SemaphoreValue& wait) {
+        return GetSemaphoreData(wait.semaphore)->value.load(std::memory_order_acquire) >= wait.value;
+    };
+    auto done = [&]() {
+        return wait_any ? std::any_of(waits, waits + count, reached) : std::all_of(waits, waits + count, reached);
+    };
+    if (done()) return true;
+    std::vector<std::multimap<uint64_t, std::condition_variable*>::iterator> entries;
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) entries.push_back(GetSemaphoreData(waits[i].semaphore)->waiters.emplace(waits[i].value, &cv));
+    WaitWithTimeout(lock, cv, timeout, [&]() { return abort() || done(); });
+    for (uint32_t i = 0; i < count; ++i) GetSemaphoreData(waits[i].semaphore)->waiters.erase(entries[i]);
+    return !abort() && done();
+}
+
+// Signal the semaphores and fence of a batch that has finished on queue_data, and wake up anyone waiting for it
+static void CompleteSubmission(QueueData* queue_data, const Submission& submission) {
+    DeviceData* device_data = queue_data->device;
+    {
+        lock_guard_t lock(device_data->sync_lock);
+        for (const auto& signal : submission.signals) SignalSemaphoreValue(GetSemaphoreData(signal.semaphore), signal.value);
+        if (submission.fence) GetFenceData(submission.fence)->signaled = true;
+        ++queue_data->completed_count;
+    }
+    device_data->sync_cv.notify_all();
+}
+
+static void QueueWorkerLoop(QueueData* queue_data) {
+    DeviceData* device_data = queue_data->device;
+    for (;;) {
+        Submission* submission = queue_data->submissions.Pop();
+        if (!submission) {
+            unique_lock_t lock(queue_data->wake_lock);
+            queue_data->sleeping = true;
+            queue_data->wake_cv.wait(lock, [=]() { return queue_data->stop || !queue_data->submissions.Empty(); });
+            queue_data->sleeping = false;
+            if (queue_data->stop) return;
+            continue;
+        }
+        std::unique_ptr<Submission> owned(submission);
+        if (!submission->waits.empty()) {
+            unique_lock_t lock(device_data->sync_lock);
+            if (!WaitSemaphoreValues(lock, queue_data->semaphore_cv, submission->waits.data(), (uint32_t)submission->waits.size(),
+                                     false, UINT64_MAX, [=]() { return queue_data->stop.load(); })) {
+                return;
+            }
+            // Binary semaphore waits consume the signal
+            for (const auto& wait : submission->waits) {
+                auto semaphore_data = GetSemaphoreData(wait.semaphore);
+                if (!semaphore_data->timeline) semaphore_data->value.store(0, std::memory_order_relaxed);
+            }
+        }
+        // The simulated GPUs start on a batch once its waits are satisfied, and the previous batch has already
+        // completed by then. Each physical device of the device group works through the command buffers submitted
+        // to it in parallel with the others. The batch completes once the last of them is done after its modelled
+        // time, or once the commands have executed if that takes longer.
+        ExecutionContext context;
+        context.cost_model = &GetCostModel();
+        context.gpu_times.fill(std::chrono::steady_clock::now());
+        for (size_t i = 0; i < submission->command_buffers.size(); ++i) {
+            const auto command_buffer = submission->command_buffers[i];
+            context.submit_mask = submission->device_masks.empty() ? device_data->device_mask : submission->device_masks[i];
+            context.device_mask = context.submit_mask & GetCommandBufferData(command_buffer)->device_mask;
+            ExecuteCommandBuffer(device_data, command_buffer, &context);
+        }
+        if (context.cost_model->enabled) {
+            const auto completion_time = *std::max_element(context.gpu_times.begin(), context.gpu_times.end());
+            unique_lock_t lock(queue_data->wake_lock);
+            if (queue_data->wake_cv.wait_until(lock, completion_time, [=]() { return queue_data->stop.load(); })) return;
+        }
+        CompleteSubmission(queue_data, *submission);
+    }
+}
+
+// Hand a batch to the worker of queue_data, starting the worker on first use
+static void EnqueueSubmission(QueueData* queue_data, Submission* submission) {
+    if (!queue_data->worker.joinable()) queue_data->worker = std::thread(QueueWorkerLoop, queue_data);
+    ++queue_data->submitted_count;
+    queue_data->submissions.Push(submission);
+    if (queue_data->sleeping) {
+        lock_guard_t lock(queue_data->wake_lock);
+        queue_data->wake_cv.notify_one();
+    }
+}
+
+// Pair semaphores with the values to wait for or signal. values comes from VkTimelineSemaphoreSubmitInfo and may be
+// null when no timeline semaphores are involved.
+static void AddSemaphoreValues(std::vector<SemaphoreValue>* out, uint32_t count, const VkSemaphore* semaphores,
+                               const uint64_t* values) {
+    out->reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const bool timeline = GetSemaphoreData(semaphores[i])->timeline;
+        out->push_back(SemaphoreValue{semaphores[i], timeline && values ? values[i] : 1});
+    }
+}
+
+// timeline_info and device_group_info are the VkTimelineSemaphoreSubmitInfo and VkDeviceGroupSubmitInfo chained to the
+// submit, if any. Semaphores are shared by all physical devices, so the device indices of their waits and signals
+// don't matter.
+static Submission* NewSubmission(uint32_t wait_count, const VkSemaphore* wait_semaphores, uint32_t command_buffer_count,
+                                 const VkCommandBuffer* command_buffers, uint32_t signal_count,
+                                 const VkSemaphore* signal_semaphores, const VkTimelineSemaphoreSubmitInfo* timeline_info,
+                                 const VkDeviceGroupSubmitInfo* device_group_info, VkFence fence) {
+    auto submission = new Submission;
+    AddSemaphoreValues(&submission->waits, wait_count, wait_semaphores,
+                       timeline_info && timeline_info->waitSemaphoreValueCount ? timeline_info->pWaitSemaphoreValues : nullptr);
+    submission->command_buffers.assign(command_buffers, command_buffers + command_buffer_count);
+    if (device_group_info && device_group_info->commandBufferCount == command_buffer_count && command_buffer_count) {
+        submission->device_masks.assign(device_group_info->pCommandBufferDeviceMasks,
+                                        device_group_info->pCommandBufferDeviceMasks + command_buffer_count);
+    }
+    AddSemaphoreValues(&submission->signals, signal_count, signal_semaphores,
+                       timeline_info && timeline_info->signalSemaphoreValueCount ? timeline_info->pSignalSemaphoreValues : nullptr);
+    submission->fence = fence;
+    return submission;
+}
+
+// Signal a semaphore and fence from the host for work that is complete as soon as it is requested
+static void SignalNow(DeviceData* device_data, VkSemaphore semaphore, VkFence fence) {
+    {
+        lock_guard_t lock(device_data->sync_lock);
+        if (semaphore) SignalSemaphoreValue(GetSemaphoreData(semaphore), 1);
+        if (fence) GetFenceData(fence)->signaled = true;
+    }
+    device_data->sync_cv.notify_all();
+}
+
+// Wait until everything submitted to queue_data so far has completed
+static void WaitQueueIdle(QueueData* queue_data) {
+    const uint64_t submitted = queue_data->submitted_count;
+    WaitForSync(queue_data->device, UINT64_MAX, [=]() { return queue_data->completed_count >= submitted; });
+}
+
+QueueData::~QueueData() {
+    if (worker.joinable()) {
+        // Wake the worker wherever it sleeps, it may be blocked on a semaphore that is never going to be signaled
+        {
+            lock_guard_t lock(device->sync_lock);
+            stop = true;
+        }
+        semaphore_cv.notify_all();
+        {
+            lock_guard_t lock(wake_lock);
+            wake_cv.notify_all();
+        }
+        worker.join();
+    }
+    while (Submission* submission = submissions.Pop()) delete submission;
+}
+
+// Look up an intercepted function by name in the generated hash table (linear probing)
+static const NameToFuncPtr* FindFuncPtr(const char* name) {
+    const uint32_t mask = TableSize(name_to_funcptr_hash_table) - 1;
+    for (uint32_t slot = HashName(name) & mask;; slot = (slot + 1) & mask) {
+        const uint16_t index = name_to_funcptr_hash_table[slot];
+        if (index == kEmptySlot) return nullptr;
+        if (std::strcmp(name_to_funcptr_map[index].name, name) == 0) return &name_to_funcptr_map[index];
+    }
+}
 
 // TODO: Would like to codegen this but limits aren't in XML
 static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
@@ -171,7 +3705,7 @@ static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
     limits->storageImageSampleCounts = 0x7F;
     limits->maxSampleMaskWords = 1;
     limits->timestampComputeAndGraphics = VK_TRUE;
-    limits->timestampPeriod = 1;
+    limits->timestampPeriod = kTimestampPeriod;
     limits->maxClipDistances = 8;
     limits->maxCullDistances = 8;
     limits->maxCombinedClipAndCullDistances = 8;
@@ -188,14 +3722,677 @@ static VkPhysicalDeviceLimits SetLimits(VkPhysicalDeviceLimits *limits) {
     limits->optimalBufferCopyRowPitchAlignment = 1;
     limits->nonCoherentAtomSize = 256;
 
-    return *limits;
+    return *limits;
+}
+
+void SetBoolArrayTrue(VkBool32* bool_array, uint32_t num_bools)
+{
+    for (uint32_t i = 0; i < num_bools; ++i) {
+        bool_array[i] = VK_TRUE;
+    }
+}
+
+static void SetMemoryProperties(VkPhysicalDeviceMemoryProperties* memory_properties) {
+    memory_properties->memoryTypeCount = 2;
+    memory_properties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties->memoryTypes[0].heapIndex = 0;
+    memory_properties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties->memoryTypes[1].heapIndex = 1;
+    memory_properties->memoryHeapCount = 2;
+    memory_properties->memoryHeaps[0].flags = 0;
+    memory_properties->memoryHeaps[0].size = 8000000000;
+    memory_properties->memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    memory_properties->memoryHeaps[1].size = 8000000000;
+}
+
+static void SetQueueFamilyProperties(VkQueueFamilyProperties* queue_family_properties) {
+    queue_family_properties->queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
+    queue_family_properties->queueCount = 1;
+    queue_family_properties->timestampValidBits = 64;
+    queue_family_properties->minImageTransferGranularity = {1, 1, 1};
+}
+
+// Device profiles
+//
+// VK_MOCK_ICD_DEVICE_PROFILE can name JSON files in the schema of the DevSim layer's device profiles, one per physical
+// device. The limits, features, formats, memory types and heaps and queue families in a profile replace the built-in
+// ones, anything it leaves out keeps its built-in value. The JSON is only parsed once: it's compiled into a
+// DeviceProfile that is written next to it, with a .bin suffix, and later processes map that file directly for as
+// long as the JSON file's size and modification time stay the same.
+
+enum class JsonType { Null, Bool, Number, String, Array, Object };
+
+// Just enough of JSON for device profiles
+struct JsonValue {
+    JsonType type = JsonType::Null;
+    double number = 0;     // Bools are 0 or 1
+    uint64_t integer = 0;  // Exact value of non-negative numbers, 64-bit sizes can exceed the precision of a double
+    std::string string;
+    std::vector<JsonValue> elements;  // Of arrays
+    std::vector<std::string> keys;    // Of objects, with the member values in elements
+
+    const JsonValue* Find(const char* key) const {
+        if (type != JsonType::Object) return nullptr;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) return &elements[i];
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+  public:
+    JsonParser(const char* text, size_t size) : next_(text), end_(text + size) {}
+
+    // Returns false if the text isn't a single well-formed JSON value
+    bool Parse(JsonValue* value) {
+        if (!ParseValue(value, 0)) return false;
+        SkipSpace();
+        return next_ == end_;
+    }
+
+  private:
+    static constexpr int kMaxDepth = 64;
+
+    void SkipSpace() {
+        while (next_ != end_ && (*next_ == ' ' || *next_ == '\\t' || *next_ == '\\n' || *next_ == '\\r')) ++next_;
+    }
+    bool Peek(char c) {
+        SkipSpace();
+        return next_ != end_ && *next_ == c;
+    }
+    bool Consume(char c) {
+        if (!Peek(c)) return false;
+        ++next_;
+        return true;
+    }
+    bool ConsumeWord(const char* word) {
+        const size_t length = strlen(word);
+        if ((size_t)(end_ - next_) < length || strncmp(next_, word, length) != 0) return false;
+        next_ += length;
+        return true;
+    }
+    bool ParseValue(JsonValue* value, int depth) {
+        if (depth > kMaxDepth) return false;
+        SkipSpace();
+        if (next_ == end_) return false;
+        switch (*next_) {
+            case '{':
+                return ParseObject(value, depth);
+            case '[':
+                return ParseArray(value, depth);
+            case '"':
+                value->type = JsonType::String;
+                return ParseString(&value->string);
+            case 't':
+                value->type = JsonType::Bool;
+                value->number = 1;
+                value->integer = 1;
+                return ConsumeWord("true");
+            case 'f':
+                value->type = JsonType::Bool;
+                return ConsumeWord("false");
+            case 'n':
+                return ConsumeWord("null");
+            default:
+                return ParseNumber(value);
+        }
+    }
+    bool ParseObject(JsonValue* value, int depth) {
+        value->type = JsonType::Object;
+        ++next_;
+        if (Consume('}')) return true;
+        do {
+            value->keys.emplace_back();
+            value->elements.emplace_back();
+            if (!Peek('"') || !ParseString(&value->keys.back()) || !Consume(':') ||
+                !ParseValue(&value->elements.back(), depth + 1)) {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume('}');
+    }
+    bool ParseArray(JsonValue* value, int depth) {
+        value->type = JsonType::Array;
+        ++next_;
+        if (Consume(']')) return true;
+        do {
+            value->elements.emplace_back();
+            if (!ParseValue(&value->elements.back(), depth + 1)) return false;
+        } while (Consume(','));
+        return Consume(']');
+    }
+    bool ParseString(std::string* string) {
+        ++next_;
+        while (next_ != end_ && *next_ != '"') {
+            char c = *next_++;
+            if (c == '\\\\') {
+                if (next_ == end_) return false;
+                c = *next_++;
+                switch (c) {
+                    case 'b': c = '\\b'; break;
+                    case 'f': c = '\\f'; break;
+                    case 'n': c = '\\n'; break;
+                    case 'r': c = '\\r'; break;
+                    case 't': c = '\\t'; break;
+                    case 'u': {
+                        // Names in profiles are ASCII, other code points are replaced
+                        if (end_ - next_ < 4) return false;
+                        const unsigned long code = strtoul(std::string(next_, 4).c_str(), nullptr, 16);
+                        next_ += 4;
+                        c = code < 0x80 ? (char)code : '?';
+                        break;
+                    }
+                    default:  // '"', '\\\\' and '/' stand for themselves
+                        break;
+                }
+            }
+            string->push_back(c);
+        }
+        if (next_ == end_) return false;
+        ++next_;
+        return true;
+    }
+    bool ParseNumber(JsonValue* value) {
+        const char* start = next_;
+        while (next_ != end_ && *next_ && strchr("+-.0123456789eE", *next_)) ++next_;
+        if (next_ == start) return false;
+        // strtod() and strtoull() need a terminated string
+        const std::string token(start, next_);
+        char* token_end;
+        value->type = JsonType::Number;
+        value->number = strtod(token.c_str(), &token_end);
+        if (*token_end) return false;
+        if (token.find_first_of("-.eE") == std::string::npos) {
+            value->integer = strtoull(token.c_str(), nullptr, 10);
+        } else if (value->number > 0) {
+            value->integer = value->number < 18446744073709551616.0 ? (uint64_t)value->number : UINT64_MAX;
+        }
+        return true;
+    }
+
+    const char* next_;
+    const char* end_;
+};
+
+static uint64_t GetJsonInteger(const JsonValue& object, const char* key) {
+    const JsonValue* value = object.Find(key);
+    return value ? value->integer : 0;
+}
+
+static size_t GetProfileFieldSize(ProfileFieldType type) {
+    switch (type) {
+        case ProfileFieldType::Uint64:
+            return sizeof(uint64_t);
+        case ProfileFieldType::Size:
+            return sizeof(size_t);
+        default:
+            return sizeof(uint32_t);
+    }
+}
+
+static void SetProfileFieldValue(ProfileFieldType type, const JsonValue& value, uint8_t* field) {
+    union {
+        VkBool32 bool32;
+        uint32_t uint32;
+        int32_t int32;
+        uint64_t uint64;
+        size_t size;
+        float float32;
+    } converted;
+    switch (type) {
+        case ProfileFieldType::Bool32:
+            converted.bool32 = value.number != 0 ? VK_TRUE : VK_FALSE;
+            break;
+        case ProfileFieldType::Uint32:
+            converted.uint32 = (uint32_t)std::min<uint64_t>(value.integer, UINT32_MAX);
+            break;
+        case ProfileFieldType::Int32:
+            converted.int32 = (int32_t)std::max<double>(std::min<double>(value.number, INT32_MAX), INT32_MIN);
+            break;
+        case ProfileFieldType::Uint64:
+            converted.uint64 = value.integer;
+            break;
+        case ProfileFieldType::Size:
+            converted.size = (size_t)std::min<uint64_t>(value.integer, SIZE_MAX);
+            break;
+        case ProfileFieldType::Float:
+            converted.float32 = (float)value.number;
+            break;
+    }
+    memcpy(field, &converted, GetProfileFieldSize(type));
+}
+
+// Sets the members of a struct that a JSON object lists, using one of the generated ProfileField tables
+template <size_t N>
+static void SetProfileFields(const JsonValue* object, const ProfileField (&fields)[N], void* base) {
+    if (!object || object->type != JsonType::Object) return;
+    for (size_t i = 0; i < object->keys.size(); ++i) {
+        const ProfileField* field = FindByName(fields, object->keys[i].c_str());
+        if (!field) continue;
+        const JsonValue& value = object->elements[i];
+        uint8_t* member = static_cast<uint8_t*>(base) + field->offset;
+        if (field->count == 1) {
+            SetProfileFieldValue(field->type, value, member);
+        } else if (value.type == JsonType::Array) {
+            const size_t count = std::min<size_t>(field->count, value.elements.size());
+            for (size_t element = 0; element < count; ++element) {
+                SetProfileFieldValue(field->type, value.elements[element], member + element * GetProfileFieldSize(field->type));
+            }
+        }
+    }
+}
+
+static constexpr uint32_t kDeviceProfileMagic = 0x464F5250;  // "PROF"
+static constexpr uint32_t kMaxProfileQueueFamilies = 16;
+
+struct ProfileFormat {
+    VkFormat format;
+    VkFormatProperties properties;
+};
+
+// A compiled device profile. The cache file holds it as is, followed by format_count ProfileFormats sorted by format,
+// so it must stay trivially copyable.
+struct DeviceProfile {
+    uint32_t magic;
+    uint32_t header_size;  // sizeof(DeviceProfile) of the build that wrote the cache
+    uint64_t source_size;  // Of the JSON file the cache was compiled from
+    int64_t source_mtime;
+    int64_t source_mtime_nsec;  // 0 on platforms whose struct stat has whole seconds only
+    VkPhysicalDeviceLimits limits;
+    VkPhysicalDeviceFeatures features;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    uint32_t queue_family_count;
+    VkQueueFamilyProperties queue_families[kMaxProfileQueueFamilies];
+    uint32_t has_formats;  // Formats are unsupported unless listed once a profile lists any
+    uint32_t format_count;
+
+    const ProfileFormat* GetFormats() const { return reinterpret_cast<const ProfileFormat*>(this + 1); }
+};
+
+static bool ReadWholeFile(const char* path, std::vector<uint8_t>* contents) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) contents->insert(contents->end(), buffer, buffer + size);
+    const bool read = !ferror(file);
+    fclose(file);
+    return read;
+}
+
+// Sub-second part of the modification time of a file, so that a profile edited within the same second as the cache
+// was compiled from it still invalidates the cache
+static int64_t GetModificationNanoseconds(const struct stat& file) {
+#if defined(_WIN32)
+    (void)file;
+    return 0;
+#elif defined(__APPLE__)
+    return (int64_t)file.st_mtimespec.tv_nsec;
+#else
+    return (int64_t)file.st_mtim.tv_nsec;
+#endif
+}
+
+// The memory properties are checked too, since memory accounting indexes arrays by their counts and heap indices
+static bool AreProfileMemoryPropertiesValid(const VkPhysicalDeviceMemoryProperties& properties) {
+    if (properties.memoryTypeCount == 0 || properties.memoryTypeCount > VK_MAX_MEMORY_TYPES ||
+        properties.memoryHeapCount == 0 || properties.memoryHeapCount > VK_MAX_MEMORY_HEAPS) {
+        return false;
+    }
+    for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+        if (properties.memoryTypes[i].heapIndex >= properties.memoryHeapCount) return false;
+    }
+    return true;
+}
+
+static bool IsDeviceProfileCacheValid(const DeviceProfile* profile, size_t size, const struct stat& source) {
+    return size >= sizeof(DeviceProfile) && profile->magic == kDeviceProfileMagic && profile->header_size == sizeof(DeviceProfile) &&
+           profile->source_size == (uint64_t)source.st_size && profile->source_mtime == (int64_t)source.st_mtime &&
+           profile->source_mtime_nsec == GetModificationNanoseconds(source) &&
+           size == sizeof(DeviceProfile) + (size_t)profile->format_count * sizeof(ProfileFormat) &&
+           AreProfileMemoryPropertiesValid(profile->memory_properties);
+}
+
+// Profiles are never freed, like the mapped cache they stay valid for the lifetime of the process
+static const DeviceProfile* KeepDeviceProfile(std::vector<uint8_t>&& contents) {
+    return reinterpret_cast<const DeviceProfile*>((new std::vector<uint8_t>(std::move(contents)))->data());
+}
+
+static const DeviceProfile* MapDeviceProfileCache(const char* path, const struct stat& source) {
+#ifdef _WIN32
+    std::vector<uint8_t> contents;
+    if (!ReadWholeFile(path, &contents) || contents.size() < sizeof(DeviceProfile)) return nullptr;
+    if (!IsDeviceProfileCacheValid(reinterpret_cast<const DeviceProfile*>(contents.data()), contents.size(), source)) return nullptr;
+    return KeepDeviceProfile(std::move(contents));
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat cache;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &cache) == 0 && cache.st_size >= (off_t)sizeof(DeviceProfile)) {
+        data = mmap(nullptr, (size_t)cache.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    const auto profile = static_cast<const DeviceProfile*>(data);
+    if (IsDeviceProfileCacheValid(profile, (size_t)cache.st_size, source)) return profile;
+    munmap(data, (size_t)cache.st_size);
+    return nullptr;
+#endif
+}
+
+static void WriteDeviceProfileCache(const std::string& path, const std::vector<uint8_t>& contents) {
+    // Written to a file of our own and renamed, so that processes starting at the same time never map a partial cache
+#ifdef _WIN32
+    const std::string temp_path = path + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+#else
+    const std::string temp_path = path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+    FILE* file = fopen(temp_path.c_str(), "wb");
+    if (!file) return;
+    const bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    if (fclose(file) == 0 && written) {
+#ifdef _WIN32
+        if (MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) return;
+#else
+        if (rename(temp_path.c_str(), path.c_str()) == 0) return;
+#endif
+    }
+    remove(temp_path.c_str());
+}
+
+static std::vector<uint8_t> CompileDeviceProfile(const JsonValue& root, const struct stat& source) {
+    std::vector<ProfileFormat> formats;
+    const JsonValue* format_array = root.Find("ArrayOfVkFormatProperties");
+    if (format_array) {
+        for (const auto& element : format_array->elements) {
+            ProfileFormat format = {};
+            format.format = (VkFormat)GetJsonInteger(element, "formatID");
+            format.properties.linearTilingFeatures = (VkFormatFeatureFlags)GetJsonInteger(element, "linearTilingFeatures");
+            format.properties.optimalTilingFeatures = (VkFormatFeatureFlags)GetJsonInteger(element, "optimalTilingFeatures");
+            format.properties.bufferFeatures = (VkFormatFeatureFlags)GetJsonInteger(element, "bufferFeatures");
+            formats.push_back(format);
+        }
+        std::stable_sort(formats.begin(), formats.end(),
+                         [](const ProfileFormat& lhs, const ProfileFormat& rhs) { return lhs.format < rhs.format; });
+    }
+
+    // Zero initialized so that padding is written to the cache deterministically
+    std::vector<uint8_t> contents(sizeof(DeviceProfile) + formats.size() * sizeof(ProfileFormat));
+    const auto profile = reinterpret_cast<DeviceProfile*>(contents.data());
+    profile->magic = kDeviceProfileMagic;
+    profile->header_size = sizeof(DeviceProfile);
+    profile->source_size = (uint64_t)source.st_size;
+    profile->source_mtime = (int64_t)source.st_mtime;
+    profile->source_mtime_nsec = GetModificationNanoseconds(source);
+
+    SetLimits(&profile->limits);
+    if (const JsonValue* properties = root.Find("VkPhysicalDeviceProperties")) {
+        SetProfileFields(properties->Find("limits"), physical_device_limits_fields, &profile->limits);
+    }
+    SetBoolArrayTrue(&profile->features.robustBufferAccess, sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32));
+    SetProfileFields(root.Find("VkPhysicalDeviceFeatures"), physical_device_features_fields, &profile->features);
+
+    SetMemoryProperties(&profile->memory_properties);
+    if (const JsonValue* memory_properties = root.Find("VkPhysicalDeviceMemoryProperties")) {
+        // Empty arrays keep the built-in types and heaps, so that there is always at least one of each
+        auto& properties = profile->memory_properties;
+        const JsonValue* types = memory_properties->Find("memoryTypes");
+        if (types && types->type == JsonType::Array && !types->elements.empty()) {
+            properties.memoryTypeCount = (uint32_t)std::min<size_t>(types->elements.size(), VK_MAX_MEMORY_TYPES);
+            for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+                properties.memoryTypes[i].propertyFlags = (VkMemoryPropertyFlags)GetJsonInteger(types->elements[i], "propertyFlags");
+                const uint64_t heap_index = GetJsonInteger(types->elements[i], "heapIndex");
+                properties.memoryTypes[i].heapIndex = (uint32_t)std::min<uint64_t>(heap_index, UINT32_MAX);
+            }
+        }
+        const JsonValue* heaps = memory_properties->Find("memoryHeaps");
+        if (heaps && heaps->type == JsonType::Array && !heaps->elements.empty()) {
+            properties.memoryHeapCount = (uint32_t)std::min<size_t>(heaps->elements.size(), VK_MAX_MEMORY_HEAPS);
+            for (uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+                properties.memoryHeaps[i].size = GetJsonInteger(heaps->elements[i], "size");
+                properties.memoryHeaps[i].flags = (VkMemoryHeapFlags)GetJsonInteger(heaps->elements[i], "flags");
+            }
+        }
+        // Memory accounting indexes the heaps by the heap index of a type, so types of heaps that don't exist are
+        // dropped, and the types after them move down to keep the type indices contiguous
+        uint32_t type_count = 0;
+        for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+            if (properties.memoryTypes[i].heapIndex < properties.memoryHeapCount) {
+                properties.memoryTypes[type_count++] = properties.memoryTypes[i];
+            }
+        }
+        if (type_count == 0) {
+            // None of the types had a heap, fall back to the built-in types on the first heap
+            VkPhysicalDeviceMemoryProperties built_in;
+            SetMemoryProperties(&built_in);
+            type_count = built_in.memoryTypeCount;
+            for (uint32_t i = 0; i < type_count; ++i) {
+                properties.memoryTypes[i] = built_in.memoryTypes[i];
+                properties.memoryTypes[i].heapIndex = std::min(built_in.memoryTypes[i].heapIndex, properties.memoryHeapCount - 1);
+            }
+        }
+        properties.memoryTypeCount = type_count;
+    }
+
+    const JsonValue* queue_families = root.Find("ArrayOfVkQueueFamilyProperties");
+    if (queue_families && queue_families->type == JsonType::Array && !queue_families->elements.empty()) {
+        profile->queue_family_count = (uint32_t)std::min<size_t>(queue_families->elements.size(), kMaxProfileQueueFamilies);
+        for (uint32_t i = 0; i < profile->queue_family_count; ++i) {
+            const JsonValue& element = queue_families->elements[i];
+            auto& family = profile->queue_families[i];
+            family.queueFlags = (VkQueueFlags)GetJsonInteger(element, "queueFlags");
+            family.queueCount = (uint32_t)GetJsonInteger(element, "queueCount");
+            family.timestampValidBits = (uint32_t)GetJsonInteger(element, "timestampValidBits");
+            if (const JsonValue* granularity = element.Find("minImageTransferGranularity")) {
+                family.minImageTransferGranularity = {(uint32_t)GetJsonInteger(*granularity, "width"),
+                                                      (uint32_t)GetJsonInteger(*granularity, "height"),
+                                                      (uint32_t)GetJsonInteger(*granularity, "depth")};
+            }
+        }
+    } else {
+        profile->queue_family_count = 1;
+        SetQueueFamilyProperties(&profile->queue_families[0]);
+    }
+
+    profile->has_formats = format_array != nullptr;
+    profile->format_count = (uint32_t)formats.size();
+    if (!formats.empty()) memcpy(profile + 1, formats.data(), formats.size() * sizeof(ProfileFormat));
+    return contents;
 }
 
-void SetBoolArrayTrue(VkBool32* bool_array, uint32_t num_bools)
-{
-    for (uint32_t i = 0; i < num_bools; ++i) {
-        bool_array[i] = VK_TRUE;
+// Returns nullptr, for the built-in device, if the profile can't be read
+static const DeviceProfile* LoadDeviceProfile(const std::string& path) {
+    struct stat source;
+    if (stat(path.c_str(), &source) != 0) return nullptr;
+    const std::string cache_path = path + ".bin";
+    if (const DeviceProfile* profile = MapDeviceProfileCache(cache_path.c_str(), source)) return profile;
+
+    std::vector<uint8_t> text;
+    JsonValue root;
+    if (!ReadWholeFile(path.c_str(), &text) ||
+        !JsonParser(reinterpret_cast<const char*>(text.data()), text.size()).Parse(&root)) {
+        return nullptr;
+    }
+    std::vector<uint8_t> contents = CompileDeviceProfile(root, source);
+    WriteDeviceProfileCache(cache_path, contents);
+    return KeepDeviceProfile(std::move(contents));
+}
+
+// Physical devices reported by every instance, configured by environment variables:
+// - VK_MOCK_ICD_DEVICE_PROFILE: device profiles separated like the entries of PATH, the Nth physical device uses the
+//   Nth profile and the physical devices past the last profile use the last one
+// - VK_MOCK_ICD_PHYSICAL_DEVICE_COUNT: defaults to the number of profiles, or 1 without profiles
+// - VK_MOCK_ICD_DEVICE_GROUP_SIZE: number of consecutive physical devices in each device group, defaults to 1
+// - VK_MOCK_ICD_HEAP_LIMITS: the number of bytes that can be allocated from each memory heap, in order of the heaps and
+//   separated by commas. Numbers can have a K, M or G suffix, heaps without a limit can be allocated up to their size.
+struct PhysicalDeviceConfig {
+    uint32_t count;
+    uint32_t group_size;
+    std::vector<const DeviceProfile*> profiles;
+    std::vector<VkDeviceSize> heap_limits;  // 0 for heaps without a limit
+};
+
+// Device masks have a bit per physical device of a group, the emulated devices don't go beyond what one group holds
+static constexpr uint32_t kMaxPhysicalDevices = VK_MAX_DEVICE_GROUP_SIZE;
+
+static uint32_t GetEnvironmentCount(const char* name, uint32_t default_count) {
+    const char* value = getenv(name);
+    const unsigned long count = value ? strtoul(value, nullptr, 10) : 0;
+    if (count == 0) return default_count;
+    return (uint32_t)std::min<unsigned long>(count, kMaxPhysicalDevices);
+}
+
+static PhysicalDeviceConfig LoadPhysicalDeviceConfig() {
+    PhysicalDeviceConfig config;
+#ifdef _WIN32
+    const char separator = ';';
+#else
+    const char separator = ':';
+#endif
+    const char* paths = getenv("VK_MOCK_ICD_DEVICE_PROFILE");
+    while (paths && *paths && config.profiles.size() < kMaxPhysicalDevices) {
+        const char* end = strchr(paths, separator);
+        if (!end) end = paths + strlen(paths);
+        if (end != paths) config.profiles.push_back(LoadDeviceProfile(std::string(paths, end)));
+        paths = *end ? end + 1 : end;
+    }
+    config.count = GetEnvironmentCount("VK_MOCK_ICD_PHYSICAL_DEVICE_COUNT", std::max<uint32_t>((uint32_t)config.profiles.size(), 1));
+    config.group_size = GetEnvironmentCount("VK_MOCK_ICD_DEVICE_GROUP_SIZE", 1);
+    const char* limits = getenv("VK_MOCK_ICD_HEAP_LIMITS");
+    while (limits && *limits && config.heap_limits.size() < VK_MAX_MEMORY_HEAPS) {
+        char* end;
+        VkDeviceSize limit = strtoull(limits, &end, 10);
+        switch (*end) {
+            case 'G':
+            case 'g':
+                limit <<= 10;
+                // fall through
+            case 'M':
+            case 'm':
+                limit <<= 10;
+                // fall through
+            case 'K':
+            case 'k':
+                limit <<= 10;
+                ++end;
+                break;
+        }
+        config.heap_limits.push_back(limit);
+        end = strchr(end, ',');
+        limits = end ? end + 1 : nullptr;
+    }
+    return config;
+}
+
+static const PhysicalDeviceConfig& GetPhysicalDeviceConfig() {
+    static const PhysicalDeviceConfig config = LoadPhysicalDeviceConfig();
+    return config;
+}
+
+// State of a VkPhysicalDevice, the handle points at this
+struct PhysicalDeviceData {
+    VK_LOADER_DATA loader_data;  // Must be first, the loader stores its dispatch table pointer here
+    uint32_t index;              // In the order of vkEnumeratePhysicalDevices
+    const DeviceProfile* profile;  // nullptr for the built-in device
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    // Number of bytes that can be allocated from each heap, reported as the budget by VK_EXT_memory_budget
+    VkDeviceSize heap_limits[VK_MAX_MEMORY_HEAPS];
+    // Bytes allocated from each heap and memory type by all the devices created from the physical device
+    std::atomic<VkDeviceSize> heap_usage[VK_MAX_MEMORY_HEAPS];
+    std::atomic<VkDeviceSize> type_usage[VK_MAX_MEMORY_TYPES];
+};
+
+static PhysicalDeviceData* GetPhysicalDeviceData(VkPhysicalDevice physical_device) {
+    return reinterpret_cast<PhysicalDeviceData*>(physical_device);
+}
+
+static const DeviceProfile* GetDeviceProfile(VkPhysicalDevice physical_device) {
+    return GetPhysicalDeviceData(physical_device)->profile;
+}
+
+// Returns false unless the profile lists formats, formats it doesn't list have no features then
+static bool GetProfileFormatProperties(const DeviceProfile* profile, VkFormat format, VkFormatProperties* properties) {
+    if (!profile || !profile->has_formats) return false;
+    const ProfileFormat* begin = profile->GetFormats();
+    const ProfileFormat* end = begin + profile->format_count;
+    const ProfileFormat* entry =
+        std::lower_bound(begin, end, format, [](const ProfileFormat& lhs, VkFormat rhs) { return lhs.format < rhs; });
+    *properties = (entry != end && entry->format == format) ? entry->properties : VkFormatProperties{};
+    return true;
+}
+
+static uint32_t GetMemoryTypeBits(const DeviceProfile* profile) {
+    return profile ? (uint32_t)((1ull << profile->memory_properties.memoryTypeCount) - 1) : 0xFFFF;
+}
+
+static PhysicalDeviceData* NewPhysicalDeviceData(const PhysicalDeviceConfig& config, uint32_t index) {
+    auto physical_device_data = new PhysicalDeviceData();
+    set_loader_magic_value(&physical_device_data->loader_data);
+    physical_device_data->index = index;
+    physical_device_data->profile =
+        config.profiles.empty() ? nullptr : config.profiles[std::min<size_t>(index, config.profiles.size() - 1)];
+    auto& memory_properties = physical_device_data->memory_properties;
+    if (physical_device_data->profile) {
+        memory_properties = physical_device_data->profile->memory_properties;
+    } else {
+        SetMemoryProperties(&memory_properties);
+    }
+    for (uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i) {
+        const VkDeviceSize size = memory_properties.memoryHeaps[i].size;
+        const VkDeviceSize limit = i < config.heap_limits.size() ? config.heap_limits[i] : 0;
+        physical_device_data->heap_limits[i] = limit ? std::min(limit, size) : size;
+    }
+    return physical_device_data;
+}
+
+// Device memory accounting. An allocation counts towards the maxMemoryAllocationCount of its device, and its size is
+// charged to the heap of its memory type on every physical device in its device mask. Allocations that would take a
+// heap past its limit fail with VK_ERROR_OUT_OF_DEVICE_MEMORY.
+static void ReleaseDeviceMemory(DeviceData* device_data, uint32_t device_mask, uint32_t type_index, VkDeviceSize size) {
+    for (uint32_t i = 0; i < VK_MAX_DEVICE_GROUP_SIZE; ++i) {
+        if (!(device_mask & (1u << i))) continue;
+        auto physical_device_data = device_data->physical_devices[i];
+        const uint32_t heap = physical_device_data->memory_properties.memoryTypes[type_index].heapIndex;
+        physical_device_data->heap_usage[heap].fetch_sub(size, std::memory_order_relaxed);
+        physical_device_data->type_usage[type_index].fetch_sub(size, std::memory_order_relaxed);
+    }
+    device_data->allocation_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static VkResult ChargeDeviceMemory(DeviceData* device_data, uint32_t device_mask, uint32_t type_index, VkDeviceSize size) {
+    if (device_data->allocation_count.fetch_add(1, std::memory_order_relaxed) >= device_data->max_allocation_count) {
+        device_data->allocation_count.fetch_sub(1, std::memory_order_relaxed);
+        return VK_ERROR_TOO_MANY_OBJECTS;
+    }
+    for (uint32_t i = 0; i < VK_MAX_DEVICE_GROUP_SIZE; ++i) {
+        if (!(device_mask & (1u << i))) continue;
+        auto physical_device_data = device_data->physical_devices[i];
+        const uint32_t heap = physical_device_data->memory_properties.memoryTypes[type_index].heapIndex;
+        auto& heap_usage = physical_device_data->heap_usage[heap];
+        if (heap_usage.fetch_add(size, std::memory_order_relaxed) + size > physical_device_data->heap_limits[heap]) {
+            heap_usage.fetch_sub(size, std::memory_order_relaxed);
+            // Undo the charges to the physical devices before this one
+            ReleaseDeviceMemory(device_data, device_mask & ((1u << i) - 1), type_index, size);
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+        physical_device_data->type_usage[type_index].fetch_add(size, std::memory_order_relaxed);
+    }
+    return VK_SUCCESS;
+}
+
+DeviceMemoryData::~DeviceMemoryData() {
+#ifdef MOCK_ICD_EXTERNAL_MEMORY_FD
+    if (fd >= 0) {
+        munmap(data, (size_t)size);
+        close(fd);
+    } else
+#endif
+    if (data) {
+        FreeBackingStore(data, size);
     }
+    ReleaseDeviceMemory(device, device_mask, type_index, size);
 }
 '''
 
@@ -204,9 +4401,9 @@ SOURCE_CPP_POSTFIX = '''
 
 static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName) {
     // TODO: This function should only care about physical device functions and return nullptr for other functions
-    const auto &item = name_to_funcptr_map.find(funcName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = FindFuncPtr(funcName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(item->funcptr);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -430,65 +4627,204 @@ CUSTOM_C_INTERCEPTS = {
     if (loader_interface_version <= 4) {
         return VK_ERROR_INCOMPATIBLE_DRIVER;
     }
+    // Loads the device profiles, if there are any
+    const auto& config = GetPhysicalDeviceConfig();
     *pInstance = (VkInstance)CreateDispObjHandle();
-    for (auto& physical_device : physical_device_map[*pInstance])
-        physical_device = (VkPhysicalDevice)CreateDispObjHandle();
-    // TODO: If emulating specific device caps, will need to add intelligence here
+    unique_lock_t lock(global_lock);
+    auto& physical_devices = physical_device_map[*pInstance];
+    for (uint32_t i = 0; i < config.count; ++i) {
+        physical_devices.push_back(reinterpret_cast<VkPhysicalDevice>(NewPhysicalDeviceData(config, i)));
+    }
+    // Under global_lock, so that this can't race with the destruction of the last instance closing the trace
+    if (trace_enabled) ResumeTrace();
     return VK_SUCCESS;
 ''',
 'vkDestroyInstance': '''
     if (instance) {
+        unique_lock_t lock(global_lock);
         for (const auto physical_device : physical_device_map.at(instance))
-            DestroyDispObjHandle((void*)physical_device);
+            delete GetPhysicalDeviceData(physical_device);
         physical_device_map.erase(instance);
         DestroyDispObjHandle((void*)instance);
+        if (trace_enabled && physical_device_map.empty()) CloseTrace();
     }
+    if (call_stats_enabled) WriteCallStats();
+    if (trace_enabled) FlushTrace();
 ''',
 'vkEnumeratePhysicalDevices': '''
     VkResult result_code = VK_SUCCESS;
     if (pPhysicalDevices) {
-        const auto return_count = (std::min)(*pPhysicalDeviceCount, icd_physical_device_count);
-        for (uint32_t i = 0; i < return_count; ++i) pPhysicalDevices[i] = physical_device_map.at(instance)[i];
-        if (return_count < icd_physical_device_count) result_code = VK_INCOMPLETE;
+        unique_lock_t lock(global_lock);
+        const auto& physical_devices = physical_device_map.at(instance);
+        const auto physical_device_count = (uint32_t)physical_devices.size();
+        const auto return_count = (std::min)(*pPhysicalDeviceCount, physical_device_count);
+        for (uint32_t i = 0; i < return_count; ++i) pPhysicalDevices[i] = physical_devices[i];
+        if (return_count < physical_device_count) result_code = VK_INCOMPLETE;
         *pPhysicalDeviceCount = return_count;
     } else {
-        *pPhysicalDeviceCount = icd_physical_device_count;
+        *pPhysicalDeviceCount = GetPhysicalDeviceConfig().count;
     }
     return result_code;
 ''',
+'vkEnumeratePhysicalDeviceGroupsKHR': '''
+    // Consecutive physical devices are grouped, the last group may be smaller than the others
+    unique_lock_t lock(global_lock);
+    const auto& physical_devices = physical_device_map.at(instance);
+    const auto physical_device_count = (uint32_t)physical_devices.size();
+    const uint32_t group_size = GetPhysicalDeviceConfig().group_size;
+    const uint32_t group_count = (physical_device_count + group_size - 1) / group_size;
+    if (!pPhysicalDeviceGroupProperties) {
+        *pPhysicalDeviceGroupCount = group_count;
+        return VK_SUCCESS;
+    }
+    const auto return_count = (std::min)(*pPhysicalDeviceGroupCount, group_count);
+    for (uint32_t group = 0; group < return_count; ++group) {
+        auto& properties = pPhysicalDeviceGroupProperties[group];
+        const uint32_t first = group * group_size;
+        properties.physicalDeviceCount = (std::min)(group_size, physical_device_count - first);
+        std::copy_n(physical_devices.begin() + first, properties.physicalDeviceCount, properties.physicalDevices);
+        properties.subsetAllocation = VK_TRUE;
+    }
+    *pPhysicalDeviceGroupCount = return_count;
+    return return_count < group_count ? VK_INCOMPLETE : VK_SUCCESS;
+''',
 'vkCreateDevice': '''
-    *pDevice = (VkDevice)CreateDispObjHandle();
-    // TODO: If emulating specific device caps, will need to add intelligence here
+    auto device_data = new DeviceData;
+    set_loader_magic_value(&device_data->loader_data);
+    // A device created from a device group spans all of its physical devices, which share one profile
+    const auto group_info = lvl_find_in_chain<VkDeviceGroupDeviceCreateInfo>(pCreateInfo->pNext);
+    const bool from_group = group_info && group_info->physicalDeviceCount;
+    const uint32_t physical_device_count = from_group ? group_info->physicalDeviceCount : 1;
+    device_data->device_mask = (uint32_t)((1ull << physical_device_count) - 1);
+    device_data->profile = GetDeviceProfile(physicalDevice);
+    for (uint32_t i = 0; i < physical_device_count; ++i) {
+        device_data->physical_devices[i] = GetPhysicalDeviceData(from_group ? group_info->pPhysicalDevices[i] : physicalDevice);
+    }
+    VkPhysicalDeviceProperties properties;
+    GetPhysicalDeviceProperties(physicalDevice, &properties);
+    device_data->max_allocation_count = properties.limits.maxMemoryAllocationCount;
+    uint32_t family_count = 0;
+    GetPhysicalDeviceQueueFamilyProperties(physicalDevice, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    GetPhysicalDeviceQueueFamilyProperties(physicalDevice, &family_count, families.data());
+    // Make room for every queue the application asked for, even past the queue counts of the families
+    for (uint32_t i = 0; i < pCreateInfo->queueCreateInfoCount; ++i) {
+        const auto& queue_info = pCreateInfo->pQueueCreateInfos[i];
+        if (queue_info.queueFamilyIndex >= family_count) {
+            family_count = queue_info.queueFamilyIndex + 1;
+            families.resize(family_count);
+        }
+        families[queue_info.queueFamilyIndex].queueCount =
+            (std::max)(families[queue_info.queueFamilyIndex].queueCount, queue_info.queueCount);
+    }
+    device_data->queue_family_offsets.push_back(0);
+    for (const auto& family : families) {
+        device_data->queue_family_offsets.push_back(device_data->queue_family_offsets.back() + family.queueCount);
+    }
+    device_data->queues.reset(new std::atomic<QueueData*>[device_data->queue_family_offsets.back()]());
+    *pDevice = reinterpret_cast<VkDevice>(device_data);
     return VK_SUCCESS;
 ''',
 'vkDestroyDevice': '''
-    unique_lock_t lock(global_lock);
-    // First destroy sub-device objects
-    // Destroy Queues
-    for (auto dev_queue_map_pair : queue_map) {
-        for (auto queue_family_map_pair : queue_map[dev_queue_map_pair.first]) {
-            for (auto index_queue_pair : queue_map[dev_queue_map_pair.first][queue_family_map_pair.first]) {
-                DestroyDispObjHandle((void*)index_queue_pair.second);
-            }
-        }
-    }
-    queue_map.clear();
-    buffer_map.erase(device);
-    image_memory_size_map.erase(device);
-    // Now destroy device
-    DestroyDispObjHandle((void*)device);
+    if (!device) return;
+    auto device_data = GetDeviceData(device);
+    // Objects the application didn't destroy are freed along with the tables and slabs that hold them
+    delete device_data;
     // TODO: If emulating specific device caps, will need to add intelligence here
 ''',
+'vkGetDeviceGroupPeerMemoryFeaturesKHR': '''
+    // All physical devices access the same host backing store of an allocation, so peers support every kind of access
+    *pPeerMemoryFeatures = VK_PEER_MEMORY_FEATURE_COPY_SRC_BIT | VK_PEER_MEMORY_FEATURE_COPY_DST_BIT |
+                           VK_PEER_MEMORY_FEATURE_GENERIC_SRC_BIT | VK_PEER_MEMORY_FEATURE_GENERIC_DST_BIT;
+''',
+'vkGetDeviceGroupPresentCapabilitiesKHR': '''
+    // Each physical device presents the images it renders itself
+    const uint32_t device_mask = GetDeviceData(device)->device_mask;
+    for (uint32_t i = 0; i < VK_MAX_DEVICE_GROUP_SIZE; ++i) {
+        pDeviceGroupPresentCapabilities->presentMask[i] = device_mask & (1u << i);
+    }
+    pDeviceGroupPresentCapabilities->modes = VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_BIT_KHR;
+    return VK_SUCCESS;
+''',
+'vkGetDeviceGroupSurfacePresentModesKHR': '''
+    *pModes = VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_BIT_KHR;
+    return VK_SUCCESS;
+''',
 'vkGetDeviceQueue': '''
-    unique_lock_t lock(global_lock);
-    auto queue = queue_map[device][queueFamilyIndex][queueIndex];
-    if (queue) {
-        *pQueue = queue;
-    } else {
-        *pQueue = queue_map[device][queueFamilyIndex][queueIndex] = (VkQueue)CreateDispObjHandle();
+    auto device_data = GetDeviceData(device);
+    const auto& offsets = device_data->queue_family_offsets;
+    *pQueue = VK_NULL_HANDLE;
+    if (queueFamilyIndex + 1 >= offsets.size() || queueIndex >= offsets[queueFamilyIndex + 1] - offsets[queueFamilyIndex]) return;
+    auto& queue = device_data->queues[offsets[queueFamilyIndex] + queueIndex];
+    auto queue_data = queue.load(std::memory_order_acquire);
+    if (!queue_data) {
+        lock_guard_t lock(device_data->lock);
+        queue_data = queue.load(std::memory_order_relaxed);
+        if (!queue_data) {
+            queue_data = device_data->queue_slab.Allocate();
+            queue_data->device = device_data;
+            queue.store(queue_data, std::memory_order_release);
+        }
     }
-    // TODO: If emulating specific device caps, will need to add intelligence here
-    return;
+    *pQueue = reinterpret_cast<VkQueue>(queue_data);
+''',
+'vkCreateCommandPool': '''
+    auto pool_data = GetDeviceData(device)->command_pool_slab.Allocate();
+    if (!pool_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    pool_data->arena.Init(pAllocator, (pCreateInfo->flags & VK_COMMAND_POOL_CREATE_TRANSIENT_BIT) != 0);
+    *pCommandPool = (VkCommandPool)(uintptr_t)pool_data;
+    return VK_SUCCESS;
+''',
+'vkDestroyCommandPool': '''
+    // Command buffers still allocated from the pool are freed implicitly
+    GetDeviceData(device)->command_pool_slab.Free(GetCommandPoolData(commandPool));
+''',
+'vkResetCommandPool': '''
+    // The arena takes back all chunks at once, command buffers notice the new reset count and drop their commands
+    // when they are next used
+    auto pool_data = GetCommandPoolData(commandPool);
+    ++pool_data->reset_count;
+    pool_data->arena.Reset();
+    if (flags & VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT) pool_data->arena.Trim();
+    return VK_SUCCESS;
+''',
+'vkTrimCommandPoolKHR': '''
+    GetCommandPoolData(commandPool)->arena.Trim();
+''',
+'vkAllocateCommandBuffers': '''
+    auto pool_data = GetCommandPoolData(pAllocateInfo->commandPool);
+    for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i) {
+        auto command_buffer_data = pool_data->command_buffers.Allocate();
+        command_buffer_data->pool = pool_data;
+        command_buffer_data->commands.SetArena(&pool_data->arena);
+        ResetCommandBufferData(command_buffer_data);
+        pCommandBuffers[i] = reinterpret_cast<VkCommandBuffer>(command_buffer_data);
+    }
+    return VK_SUCCESS;
+''',
+'vkFreeCommandBuffers': '''
+    auto& command_buffers = GetCommandPoolData(commandPool)->command_buffers;
+    for (uint32_t i = 0; i < commandBufferCount; ++i) {
+        if (!pCommandBuffers[i]) continue;
+        auto command_buffer_data = GetCommandBufferData(pCommandBuffers[i]);
+        ResetCommandBufferData(command_buffer_data);
+        command_buffers.Free(command_buffer_data);
+    }
+''',
+'vkBeginCommandBuffer': '''
+    // Beginning a command buffer implicitly resets it
+    auto command_buffer_data = GetCommandBufferData(commandBuffer);
+    ResetCommandBufferData(command_buffer_data);
+    const auto device_group_info = lvl_find_in_chain<VkDeviceGroupCommandBufferBeginInfo>(pBeginInfo->pNext);
+    command_buffer_data->device_mask = device_group_info ? device_group_info->deviceMask : UINT32_MAX;
+    return VK_SUCCESS;
+''',
+'vkEndCommandBuffer': '''
+    return GetCommandBufferData(commandBuffer)->commands.OutOfMemory() ? VK_ERROR_OUT_OF_HOST_MEMORY : VK_SUCCESS;
+''',
+'vkResetCommandBuffer': '''
+    ResetCommandBufferData(GetCommandBufferData(commandBuffer));
+    return VK_SUCCESS;
 ''',
 'vkGetDeviceQueue2': '''
     GetDeviceQueue(device, pQueueInfo->queueFamilyIndex, pQueueInfo->queueIndex, pQueue);
@@ -507,20 +4843,21 @@ CUSTOM_C_INTERCEPTS = {
 'vkEnumerateInstanceExtensionProperties': '''
     // If requesting number of extensions, return that
     if (!pLayerName) {
+        const uint32_t extension_count = TableSize(instance_extension_map);
         if (!pProperties) {
-            *pPropertyCount = (uint32_t)instance_extension_map.size();
+            *pPropertyCount = extension_count;
         } else {
             uint32_t i = 0;
-            for (const auto &name_ver_pair : instance_extension_map) {
+            for (const auto &extension : instance_extension_map) {
                 if (i == *pPropertyCount) {
                     break;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, extension.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
+                pProperties[i].specVersion = extension.spec_version;
                 ++i;
             }
-            if (i != instance_extension_map.size()) {
+            if (i != extension_count) {
                 return VK_INCOMPLETE;
             }
         }
@@ -531,20 +4868,21 @@ CUSTOM_C_INTERCEPTS = {
 'vkEnumerateDeviceExtensionProperties': '''
     // If requesting number of extensions, return that
     if (!pLayerName) {
+        const uint32_t extension_count = TableSize(device_extension_map);
         if (!pProperties) {
-            *pPropertyCount = (uint32_t)device_extension_map.size();
+            *pPropertyCount = extension_count;
         } else {
             uint32_t i = 0;
-            for (const auto &name_ver_pair : device_extension_map) {
+            for (const auto &extension : device_extension_map) {
                 if (i == *pPropertyCount) {
                     break;
                 }
-                std::strncpy(pProperties[i].extensionName, name_ver_pair.first.c_str(), sizeof(pProperties[i].extensionName));
+                std::strncpy(pProperties[i].extensionName, extension.name, sizeof(pProperties[i].extensionName));
                 pProperties[i].extensionName[sizeof(pProperties[i].extensionName) - 1] = 0;
-                pProperties[i].specVersion = name_ver_pair.second;
+                pProperties[i].specVersion = extension.spec_version;
                 ++i;
             }
-            if (i != device_extension_map.size()) {
+            if (i != extension_count) {
                 return VK_INCOMPLETE;
             }
         }
@@ -669,9 +5007,9 @@ CUSTOM_C_INTERCEPTS = {
     if (!negotiate_loader_icd_interface_called) {
         loader_interface_version = 0;
     }
-    const auto &item = name_to_funcptr_map.find(pName);
-    if (item != name_to_funcptr_map.end()) {
-        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    const auto item = FindFuncPtr(pName);
+    if (item) {
+        return reinterpret_cast<PFN_vkVoidFunction>(item->funcptr);
     }
     // Mock should intercept all functions so if we get here just return null
     return nullptr;
@@ -680,29 +5018,35 @@ CUSTOM_C_INTERCEPTS = {
     return GetInstanceProcAddr(nullptr, pName);
 ''',
 'vkGetPhysicalDeviceMemoryProperties': '''
-    pMemoryProperties->memoryTypeCount = 2;
-    pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[0].heapIndex = 0;
-    pMemoryProperties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    pMemoryProperties->memoryTypes[1].heapIndex = 1;
-    pMemoryProperties->memoryHeapCount = 2;
-    pMemoryProperties->memoryHeaps[0].flags = 0;
-    pMemoryProperties->memoryHeaps[0].size = 8000000000;
-    pMemoryProperties->memoryHeaps[1].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
-    pMemoryProperties->memoryHeaps[1].size = 8000000000;
+    *pMemoryProperties = GetPhysicalDeviceData(physicalDevice)->memory_properties;
 ''',
 'vkGetPhysicalDeviceMemoryProperties2KHR': '''
     GetPhysicalDeviceMemoryProperties(physicalDevice, &pMemoryProperties->memoryProperties);
+    const auto *budget_props = lvl_find_in_chain<VkPhysicalDeviceMemoryBudgetPropertiesEXT>(pMemoryProperties->pNext);
+    if (budget_props) {
+        // The budget is the heap limit, and the usage what all devices of this physical device have allocated
+        auto write_props = const_cast<VkPhysicalDeviceMemoryBudgetPropertiesEXT*>(budget_props);
+        const auto physical_device_data = GetPhysicalDeviceData(physicalDevice);
+        for (uint32_t i = 0; i < VK_MAX_MEMORY_HEAPS; ++i) {
+            const bool valid = i < physical_device_data->memory_properties.memoryHeapCount;
+            write_props->heapBudget[i] = valid ? physical_device_data->heap_limits[i] : 0;
+            write_props->heapUsage[i] = valid ? physical_device_data->heap_usage[i].load(std::memory_order_relaxed) : 0;
+        }
+    }
 ''',
 'vkGetPhysicalDeviceQueueFamilyProperties': '''
+    const DeviceProfile* profile = GetDeviceProfile(physicalDevice);
+    const uint32_t family_count = profile ? profile->queue_family_count : 1;
     if (!pQueueFamilyProperties) {
-        *pQueueFamilyPropertyCount = 1;
+        *pQueueFamilyPropertyCount = family_count;
     } else {
-        if (*pQueueFamilyPropertyCount) {
-            pQueueFamilyProperties[0].queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT | VK_QUEUE_SPARSE_BINDING_BIT;
-            pQueueFamilyProperties[0].queueCount = 1;
-            pQueueFamilyProperties[0].timestampValidBits = 0;
-            pQueueFamilyProperties[0].minImageTransferGranularity = {1,1,1};
+        *pQueueFamilyPropertyCount = std::min(*pQueueFamilyPropertyCount, family_count);
+        for (uint32_t i = 0; i < *pQueueFamilyPropertyCount; ++i) {
+            if (profile) {
+                pQueueFamilyProperties[i] = profile->queue_families[i];
+            } else {
+                SetQueueFamilyProperties(&pQueueFamilyProperties[i]);
+            }
         }
     }
 ''',
@@ -714,6 +5058,10 @@ CUSTOM_C_INTERCEPTS = {
     }
 ''',
 'vkGetPhysicalDeviceFeatures': '''
+    if (const DeviceProfile* profile = GetDeviceProfile(physicalDevice)) {
+        *pFeatures = profile->features;
+        return;
+    }
     uint32_t num_bools = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
     VkBool32 *bool_array = &pFeatures->robustBufferAccess;
     SetBoolArrayTrue(bool_array, num_bools);
@@ -736,11 +5084,16 @@ CUSTOM_C_INTERCEPTS = {
         feat_bools = (VkBool32*)&blendop_features->advancedBlendCoherentOperations;
         SetBoolArrayTrue(feat_bools, num_bools);
     }
+    const auto *timeline_features = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreFeatures>(pFeatures->pNext);
+    if (timeline_features) {
+        VkPhysicalDeviceTimelineSemaphoreFeatures* write_features = (VkPhysicalDeviceTimelineSemaphoreFeatures*)timeline_features;
+        write_features->timelineSemaphore = VK_TRUE;
+    }
 ''',
 'vkGetPhysicalDeviceFormatProperties': '''
     if (VK_FORMAT_UNDEFINED == format) {
         *pFormatProperties = { 0x0, 0x0, 0x0 };
-    } else {
+    } else if (!GetProfileFormatProperties(GetDeviceProfile(physicalDevice), format, pFormatProperties)) {
         // TODO: Just returning full support for everything initially
         *pFormatProperties = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
     }
@@ -753,6 +5106,13 @@ CUSTOM_C_INTERCEPTS = {
     if (format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) {
         return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
+    // Formats of the device profile are unsupported with tilings they have no features for
+    VkFormatProperties format_properties;
+    if (GetProfileFormatProperties(GetDeviceProfile(physicalDevice), format, &format_properties)) {
+        const VkFormatFeatureFlags features = VK_IMAGE_TILING_LINEAR == tiling ? format_properties.linearTilingFeatures
+                                                                              : format_properties.optimalTilingFeatures;
+        if (!features) return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
 
     // TODO: Just hard-coding some values for now
     // TODO: If tiling is linear, limit the mips, levels, & sample count
@@ -778,7 +5138,8 @@ CUSTOM_C_INTERCEPTS = {
     //std::string devName = "Vulkan Mock Device";
     strcpy(pProperties->deviceName, "Vulkan Mock Device");
     pProperties->pipelineCacheUUID[0] = 18;
-    pProperties->limits = SetLimits(&pProperties->limits);
+    const DeviceProfile* profile = GetDeviceProfile(physicalDevice);
+    pProperties->limits = profile ? profile->limits : SetLimits(&pProperties->limits);
     pProperties->sparseProperties = { VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE, VK_TRUE };
 ''',
 'vkGetPhysicalDeviceProperties2KHR': '''
@@ -817,6 +5178,12 @@ CUSTOM_C_INTERCEPTS = {
         write_props->maxPushDescriptors = 256;
     }
 
+    const auto *timeline_props = lvl_find_in_chain<VkPhysicalDeviceTimelineSemaphoreProperties>(pProperties->pNext);
+    if (timeline_props) {
+        VkPhysicalDeviceTimelineSemaphoreProperties* write_props = (VkPhysicalDeviceTimelineSemaphoreProperties*)timeline_props;
+        write_props->maxTimelineSemaphoreValueDifference = UINT64_MAX;
+    }
+
     const auto *depth_stencil_resolve_props = lvl_find_in_chain<VkPhysicalDeviceDepthStencilResolvePropertiesKHR>(pProperties->pNext);
     if (depth_stencil_resolve_props) {
         VkPhysicalDeviceDepthStencilResolvePropertiesKHR* write_props = (VkPhysicalDeviceDepthStencilResolvePropertiesKHR*)depth_stencil_resolve_props;
@@ -855,14 +5222,11 @@ CUSTOM_C_INTERCEPTS = {
     // TODO: Just hard-coding reqs for now
     pMemoryRequirements->size = 4096;
     pMemoryRequirements->alignment = 1;
-    pMemoryRequirements->memoryTypeBits = 0xFFFF;
+    pMemoryRequirements->memoryTypeBits = GetMemoryTypeBits(GetDeviceData(device)->profile);
     // Return a better size based on the buffer size from the create info.
-    auto d_iter = buffer_map.find(device);
-    if (d_iter != buffer_map.end()) {
-        auto iter = d_iter->second.find(buffer);
-        if (iter != d_iter->second.end()) {
-            pMemoryRequirements->size = ((iter->second.size + 4095) / 4096) * 4096;
-        }
+    BufferData buffer_data;
+    if (GetDeviceData(device)->buffers.find(buffer, &buffer_data)) {
+        pMemoryRequirements->size = ((buffer_data.size + 4095) / 4096) * 4096;
     }
 ''',
 'vkGetBufferMemoryRequirements2KHR': '''
@@ -872,62 +5236,157 @@ CUSTOM_C_INTERCEPTS = {
     pMemoryRequirements->size = 0;
     pMemoryRequirements->alignment = 1;
 
-    auto d_iter = image_memory_size_map.find(device);
-    if(d_iter != image_memory_size_map.end()){
-        auto iter = d_iter->second.find(image);
-        if (iter != d_iter->second.end()) {
-            pMemoryRequirements->size = iter->second;
-        }
-    }
-    // Here we hard-code that the memory type at index 3 doesn't support this image.
-    pMemoryRequirements->memoryTypeBits = 0xFFFF & ~(0x1 << 3);
+    ImageData image_data;
+    if (GetDeviceData(device)->images.find(image, &image_data)) pMemoryRequirements->size = image_data.memory_size;
+    // Here we hard-code that the memory type at index 3 doesn't support this image, unless a device profile
+    // describes the memory types.
+    const DeviceProfile* profile = GetDeviceData(device)->profile;
+    pMemoryRequirements->memoryTypeBits = profile ? GetMemoryTypeBits(profile) : 0xFFFF & ~(0x1 << 3);
 ''',
 'vkGetImageMemoryRequirements2KHR': '''
     GetImageMemoryRequirements(device, pInfo->image, &pMemoryRequirements->memoryRequirements);
 ''',
+'vkAllocateMemory': '''
+    auto device_data = GetDeviceData(device);
+    const uint32_t type_index = pAllocateInfo->memoryTypeIndex;
+    if (type_index >= device_data->physical_devices[0]->memory_properties.memoryTypeCount) {
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    uint32_t device_mask = device_data->device_mask;
+    const auto flags_info = lvl_find_in_chain<VkMemoryAllocateFlagsInfo>(pAllocateInfo->pNext);
+    if (flags_info && (flags_info->flags & VK_MEMORY_ALLOCATE_DEVICE_MASK_BIT)) device_mask &= flags_info->deviceMask;
+    const VkResult result = ChargeDeviceMemory(device_data, device_mask, type_index, pAllocateInfo->allocationSize);
+    if (result != VK_SUCCESS) return result;
+    auto memory_data = device_data->memory_slab.Allocate();
+    if (!memory_data) {
+        ReleaseDeviceMemory(device_data, device_mask, type_index, pAllocateInfo->allocationSize);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    // From here on freeing memory_data releases the charges
+    memory_data->size = pAllocateInfo->allocationSize;
+    memory_data->fd = -1;
+    memory_data->type_index = type_index;
+    memory_data->device_mask = device_mask;
+    memory_data->device = device_data;
+#ifdef MOCK_ICD_EXTERNAL_MEMORY_FD
+    const auto import_info = lvl_find_in_chain<VkImportMemoryFdInfoKHR>(pAllocateInfo->pNext);
+    const auto export_info = lvl_find_in_chain<VkExportMemoryAllocateInfo>(pAllocateInfo->pNext);
+    if (import_info && (import_info->handleType & kFdHandleTypes)) {
+        memory_data->data = MapSharedBackingStore(import_info->fd, memory_data->size);
+        if (!memory_data->data) {
+            device_data->memory_slab.Free(memory_data);
+            return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+        }
+        // A successful import transfers ownership of the fd to us
+        memory_data->fd = import_info->fd;
+    } else if (export_info && (export_info->handleTypes & kFdHandleTypes)) {
+        memory_data->data = AllocateExportableBackingStore(memory_data->size, &memory_data->fd);
+    } else
+#endif
+    {
+        memory_data->data = AllocateBackingStore(memory_data->size);
+    }
+    if (!memory_data->data) {
+        device_data->memory_slab.Free(memory_data);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    *pMemory = (VkDeviceMemory)(uintptr_t)memory_data;
+    return VK_SUCCESS;
+''',
+'vkFreeMemory': '''
+    GetDeviceData(device)->memory_slab.Free(GetDeviceMemoryData(memory));
+''',
+'vkGetMemoryFdKHR': '''
+#ifdef MOCK_ICD_EXTERNAL_MEMORY_FD
+    const auto memory_data = GetDeviceMemoryData(pGetFdInfo->memory);
+    if (memory_data->fd >= 0) {
+        // Each call hands out a new fd that the application owns
+        *pFd = fcntl(memory_data->fd, F_DUPFD_CLOEXEC, 0);
+        if (*pFd >= 0) return VK_SUCCESS;
+        return VK_ERROR_TOO_MANY_OBJECTS;
+    }
+#endif
+    // Memory wasn't allocated as exportable to an fd
+    *pFd = -1;
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkGetMemoryFdPropertiesKHR': '''
+    // Any fd we can mmap can be imported into any of the memory types
+    const DeviceProfile* profile = GetDeviceData(device)->profile;
+    pMemoryFdProperties->memoryTypeBits = profile ? GetMemoryTypeBits(profile) : 0x3;
+    return VK_SUCCESS;
+''',
 'vkMapMemory': '''
-    unique_lock_t lock(global_lock);
-    if (VK_WHOLE_SIZE == size) {
-        if (allocated_memory_size_map.count(memory) != 0)
-            size = allocated_memory_size_map[memory] - offset;
-        else
-            size = 0x10000;
-    }
-    void* map_addr = malloc((size_t)size);
-    mapped_memory_map[memory].push_back(map_addr);
-    *ppData = map_addr;
+    // Every map of an allocation points into the same backing store
+    *ppData = static_cast<char*>(GetDeviceMemoryData(memory)->data) + offset;
     return VK_SUCCESS;
 ''',
 'vkUnmapMemory': '''
-    unique_lock_t lock(global_lock);
-    for (auto map_addr : mapped_memory_map[memory]) {
-        free(map_addr);
-    }
-    mapped_memory_map.erase(memory);
+    // The backing store stays mapped until the memory is freed
 ''',
 'vkGetImageSubresourceLayout': '''
     // Need safe values. Callers are computing memory offsets from pLayout, with no return code to flag failure.
     *pLayout = VkSubresourceLayout(); // Default constructor zero values.
+    ImageData image_data;
+    if (GetDeviceData(device)->images.find(image, &image_data)) {
+        *pLayout = GetLinearSubresourceLayout(image_data, pSubresource->mipLevel, pSubresource->arrayLayer);
+    }
 ''',
 'vkCreateSwapchainKHR': '''
-    unique_lock_t lock(global_lock);
-    *pSwapchain = (VkSwapchainKHR)global_unique_handle++;
-    for(uint32_t i = 0; i < icd_swapchain_image_count; ++i){
-        swapchain_image_map[*pSwapchain][i] = (VkImage)global_unique_handle++;
+    SwapchainData swapchain_data = {};
+    for (uint32_t i = 0; i < icd_swapchain_image_count; ++i) {
+        if (!execute_graphics_shaders) {
+            swapchain_data.images[i] = (VkImage)NewHandle();
+            continue;
+        }
+        // Draws render into the images, so they get memory of their own
+        const VkImageCreateInfo image_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                              nullptr,
+                                              0,
+                                              VK_IMAGE_TYPE_2D,
+                                              pCreateInfo->imageFormat,
+                                              {pCreateInfo->imageExtent.width, pCreateInfo->imageExtent.height, 1},
+                                              1,
+                                              pCreateInfo->imageArrayLayers,
+                                              VK_SAMPLE_COUNT_1_BIT,
+                                              VK_IMAGE_TILING_LINEAR,
+                                              pCreateInfo->imageUsage,
+                                              VK_SHARING_MODE_EXCLUSIVE,
+                                              0,
+                                              nullptr,
+                                              VK_IMAGE_LAYOUT_UNDEFINED};
+        if (CreateImage(device, &image_info, nullptr, &swapchain_data.images[i]) != VK_SUCCESS) continue;
+        VkMemoryRequirements requirements;
+        GetImageMemoryRequirements(device, swapchain_data.images[i], &requirements);
+        uint32_t type_index = 0;
+        while (type_index < 31 && !(requirements.memoryTypeBits & (1u << type_index))) ++type_index;
+        const VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, requirements.size, type_index};
+        if (AllocateMemory(device, &allocate_info, nullptr, &swapchain_data.memories[i]) == VK_SUCCESS) {
+            BindImageMemory(device, swapchain_data.images[i], swapchain_data.memories[i], 0);
+        }
     }
-    return VK_SUCCESS;
+    *pSwapchain = GetDeviceData(device)->swapchains.insert(swapchain_data);
+    return *pSwapchain ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
 ''',
 'vkDestroySwapchainKHR': '''
-    unique_lock_t lock(global_lock);
-    swapchain_image_map.clear();
+    auto device_data = GetDeviceData(device);
+    SwapchainData swapchain_data;
+    if (execute_graphics_shaders && device_data->swapchains.find(swapchain, &swapchain_data)) {
+        for (uint32_t i = 0; i < icd_swapchain_image_count; ++i) {
+            DestroyImage(device, swapchain_data.images[i], nullptr);
+            if (swapchain_data.memories[i]) FreeMemory(device, swapchain_data.memories[i], nullptr);
+        }
+    }
+    device_data->swapchains.erase(swapchain);
 ''',
 'vkGetSwapchainImagesKHR': '''
     if (!pSwapchainImages) {
         *pSwapchainImageCount = icd_swapchain_image_count;
     } else {
-        unique_lock_t lock(global_lock);
+        SwapchainData swapchain_data = {};
+        GetDeviceData(device)->swapchains.find(swapchain, &swapchain_data);
         for (uint32_t img_i = 0; img_i < (std::min)(*pSwapchainImageCount, icd_swapchain_image_count); ++img_i){
-            pSwapchainImages[img_i] = swapchain_image_map.at(swapchain)[img_i];
+            pSwapchainImages[img_i] = swapchain_data.images[img_i];
         }
 
         if (*pSwapchainImageCount < icd_swapchain_image_count) return VK_INCOMPLETE;
@@ -937,28 +5396,221 @@ CUSTOM_C_INTERCEPTS = {
 ''',
 'vkAcquireNextImageKHR': '''
     *pImageIndex = 0;
+    // The image is never in use by the presentation engine, so signal right away
+    SignalNow(GetDeviceData(device), semaphore, fence);
     return VK_SUCCESS;
 ''',
 'vkAcquireNextImage2KHR': '''
     *pImageIndex = 0;
+    SignalNow(GetDeviceData(device), pAcquireInfo->semaphore, pAcquireInfo->fence);
     return VK_SUCCESS;
 ''',
-'vkCreateBuffer': '''
-    unique_lock_t lock(global_lock);
-    *pBuffer = (VkBuffer)global_unique_handle++;
-    buffer_map[device][*pBuffer] = *pCreateInfo;
+'vkBindBufferMemory': '''
+    GetDeviceData(device)->buffers.update(buffer, [=](BufferData& buffer_data) {
+        buffer_data.memory = GetDeviceMemoryData(memory);
+        buffer_data.memory_offset = memoryOffset;
+    });
+    return VK_SUCCESS;
+''',
+'vkBindBufferMemory2KHR': '''
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        BindBufferMemory(device, pBindInfos[i].buffer, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+    }
+    return VK_SUCCESS;
+''',
+'vkBindImageMemory': '''
+    GetDeviceData(device)->images.update(image, [=](ImageData& image_data) {
+        image_data.memory = GetDeviceMemoryData(memory);
+        image_data.memory_offset = memoryOffset;
+    });
+    return VK_SUCCESS;
+''',
+'vkBindImageMemory2KHR': '''
+    for (uint32_t i = 0; i < bindInfoCount; ++i) {
+        BindImageMemory(device, pBindInfos[i].image, pBindInfos[i].memory, pBindInfos[i].memoryOffset);
+    }
+    return VK_SUCCESS;
+''',
+'vkQueueSubmit': '''
+    // Each batch completes on the queue worker, the fence goes with the last one
+    auto queue_data = reinterpret_cast<QueueData*>(queue);
+    for (uint32_t submit = 0; submit < submitCount; ++submit) {
+        const auto& info = pSubmits[submit];
+        EnqueueSubmission(queue_data, NewSubmission(info.waitSemaphoreCount, info.pWaitSemaphores, info.commandBufferCount,
+                                                    info.pCommandBuffers, info.signalSemaphoreCount, info.pSignalSemaphores,
+                                                    lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(info.pNext),
+                                                    lvl_find_in_chain<VkDeviceGroupSubmitInfo>(info.pNext),
+                                                    submit + 1 == submitCount ? fence : VK_NULL_HANDLE));
+    }
+    if (submitCount == 0 && fence) {
+        EnqueueSubmission(queue_data, NewSubmission(0, nullptr, 0, nullptr, 0, nullptr, nullptr, nullptr, fence));
+    }
+    return VK_SUCCESS;
+''',
+'vkQueueBindSparse': '''
+    // Sparse binding is not emulated, but the batches still wait and signal in queue order
+    auto queue_data = reinterpret_cast<QueueData*>(queue);
+    for (uint32_t bind = 0; bind < bindInfoCount; ++bind) {
+        const auto& info = pBindInfo[bind];
+        EnqueueSubmission(queue_data, NewSubmission(info.waitSemaphoreCount, info.pWaitSemaphores, 0, nullptr,
+                                                    info.signalSemaphoreCount, info.pSignalSemaphores,
+                                                    lvl_find_in_chain<VkTimelineSemaphoreSubmitInfo>(info.pNext), nullptr,
+                                                    bind + 1 == bindInfoCount ? fence : VK_NULL_HANDLE));
+    }
+    if (bindInfoCount == 0 && fence) {
+        EnqueueSubmission(queue_data, NewSubmission(0, nullptr, 0, nullptr, 0, nullptr, nullptr, nullptr, fence));
+    }
+    return VK_SUCCESS;
+''',
+'vkQueuePresentKHR': '''
+    // Presentation consumes the wait semaphores in queue order
+    if (pPresentInfo->waitSemaphoreCount) {
+        EnqueueSubmission(reinterpret_cast<QueueData*>(queue),
+                          NewSubmission(pPresentInfo->waitSemaphoreCount, pPresentInfo->pWaitSemaphores, 0, nullptr, 0, nullptr,
+                                        nullptr, nullptr, VK_NULL_HANDLE));
+    }
+    if (pPresentInfo->pResults) {
+        for (uint32_t i = 0; i < pPresentInfo->swapchainCount; ++i) pPresentInfo->pResults[i] = VK_SUCCESS;
+    }
+    return VK_SUCCESS;
+''',
+'vkQueueWaitIdle': '''
+    WaitQueueIdle(reinterpret_cast<QueueData*>(queue));
+    return VK_SUCCESS;
+''',
+'vkDeviceWaitIdle': '''
+    auto device_data = GetDeviceData(device);
+    for (uint32_t i = 0; i < device_data->queue_family_offsets.back(); ++i) {
+        const auto queue_data = device_data->queues[i].load(std::memory_order_acquire);
+        if (queue_data) WaitQueueIdle(queue_data);
+    }
+    return VK_SUCCESS;
+''',
+'vkCreateFence': '''
+    auto fence_data = GetDeviceData(device)->fence_slab.Allocate();
+    if (!fence_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    fence_data->signaled = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0;
+    *pFence = (VkFence)(uintptr_t)fence_data;
     return VK_SUCCESS;
 ''',
+'vkDestroyFence': '''
+    GetDeviceData(device)->fence_slab.Free(GetFenceData(fence));
+''',
+'vkResetFences': '''
+    auto device_data = GetDeviceData(device);
+    lock_guard_t lock(device_data->sync_lock);
+    for (uint32_t i = 0; i < fenceCount; ++i) GetFenceData(pFences[i])->signaled = false;
+    return VK_SUCCESS;
+''',
+'vkGetFenceStatus': '''
+    auto device_data = GetDeviceData(device);
+    lock_guard_t lock(device_data->sync_lock);
+    return GetFenceData(fence)->signaled ? VK_SUCCESS : VK_NOT_READY;
+''',
+'vkWaitForFences': '''
+    return WaitForSync(GetDeviceData(device), timeout, [=]() {
+        for (uint32_t i = 0; i < fenceCount; ++i) {
+            const bool signaled = GetFenceData(pFences[i])->signaled;
+            if (waitAll && !signaled) return false;
+            if (!waitAll && signaled) return true;
+        }
+        return waitAll == VK_TRUE;
+    });
+''',
+'vkCreateSemaphore': '''
+    auto semaphore_data = GetDeviceData(device)->semaphore_slab.Allocate();
+    if (!semaphore_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    const auto *type_info = lvl_find_in_chain<VkSemaphoreTypeCreateInfo>(pCreateInfo->pNext);
+    semaphore_data->timeline = type_info && type_info->semaphoreType == VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphore_data->value = semaphore_data->timeline ? type_info->initialValue : 0;
+    *pSemaphore = (VkSemaphore)(uintptr_t)semaphore_data;
+    return VK_SUCCESS;
+''',
+'vkGetSemaphoreCounterValueKHR': '''
+    *pValue = GetSemaphoreData(semaphore)->value.load(std::memory_order_acquire);
+    return VK_SUCCESS;
+''',
+'vkWaitSemaphoresKHR': '''
+    std::vector<SemaphoreValue> waits(pWaitInfo->semaphoreCount);
+    for (uint32_t i = 0; i < pWaitInfo->semaphoreCount; ++i) waits[i] = {pWaitInfo->pSemaphores[i], pWaitInfo->pValues[i]};
+    std::condition_variable cv;
+    unique_lock_t lock(GetDeviceData(device)->sync_lock);
+    const bool reached = WaitSemaphoreValues(lock, cv, waits.data(), pWaitInfo->semaphoreCount,
+                                             (pWaitInfo->flags & VK_SEMAPHORE_WAIT_ANY_BIT) != 0, timeout, []() { return false; });
+    return reached ? VK_SUCCESS : VK_TIMEOUT;
+''',
+'vkSignalSemaphoreKHR': '''
+    lock_guard_t lock(GetDeviceData(device)->sync_lock);
+    SignalSemaphoreValue(GetSemaphoreData(pSignalInfo->semaphore), pSignalInfo->value);
+    return VK_SUCCESS;
+''',
+'vkDestroySemaphore': '''
+    GetDeviceData(device)->semaphore_slab.Free(GetSemaphoreData(semaphore));
+''',
+'vkRegisterDeviceEventEXT': '''
+    // Display events are never going to happen on the mock device, report them as having happened
+    auto fence_data = GetDeviceData(device)->fence_slab.Allocate();
+    if (!fence_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    fence_data->signaled = true;
+    *pFence = (VkFence)(uintptr_t)fence_data;
+    return VK_SUCCESS;
+''',
+'vkRegisterDisplayEventEXT': '''
+    auto fence_data = GetDeviceData(device)->fence_slab.Allocate();
+    if (!fence_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    fence_data->signaled = true;
+    *pFence = (VkFence)(uintptr_t)fence_data;
+    return VK_SUCCESS;
+''',
+'vkCreateQueryPool': '''
+    auto pool_data = GetDeviceData(device)->query_pool_slab.Allocate();
+    if (!pool_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    pool_data->type = pCreateInfo->queryType;
+    pool_data->statistics = pCreateInfo->pipelineStatistics;
+    pool_data->value_count = 1;
+    if (pCreateInfo->queryType == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        pool_data->value_count = 0;
+        for (uint32_t bits = pCreateInfo->pipelineStatistics; bits; bits &= bits - 1) ++pool_data->value_count;
+    } else if (pCreateInfo->queryType == VK_QUERY_TYPE_TRANSFORM_FEEDBACK_STREAM_EXT) {
+        pool_data->value_count = 2;
+    }
+    pool_data->values.resize((size_t)pCreateInfo->queryCount * pool_data->value_count);
+    pool_data->available.resize(pCreateInfo->queryCount);
+    *pQueryPool = (VkQueryPool)(uintptr_t)pool_data;
+    return VK_SUCCESS;
+''',
+'vkDestroyQueryPool': '''
+    GetDeviceData(device)->query_pool_slab.Free(GetQueryPoolData(queryPool));
+''',
+'vkGetQueryPoolResults': '''
+    auto device_data = GetDeviceData(device);
+    auto pool_data = GetQueryPoolData(queryPool);
+    unique_lock_t lock(device_data->sync_lock);
+    if (flags & VK_QUERY_RESULT_WAIT_BIT) {
+        const auto first = pool_data->available.begin() + firstQuery;
+        device_data->sync_cv.wait(lock, [=]() { return std::find(first, first + queryCount, 0) == first + queryCount; });
+    }
+    const bool available = WriteQueryResults(*pool_data, firstQuery, queryCount, static_cast<uint8_t*>(pData), stride, flags);
+    return available ? VK_SUCCESS : VK_NOT_READY;
+''',
+'vkResetQueryPool': '''
+    lock_guard_t lock(GetDeviceData(device)->sync_lock);
+    ResetQueries(GetQueryPoolData(queryPool), firstQuery, queryCount);
+''',
+'vkResetQueryPoolEXT': '''
+    ResetQueryPool(device, queryPool, firstQuery, queryCount);
+''',
+'vkCreateBuffer': '''
+    *pBuffer = GetDeviceData(device)->buffers.insert(BufferData{pCreateInfo->size, nullptr, 0});
+    return *pBuffer ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
 'vkDestroyBuffer': '''
-    unique_lock_t lock(global_lock);
-    buffer_map[device].erase(buffer);
+    GetDeviceData(device)->buffers.erase(buffer);
 ''',
 'vkCreateImage': '''
-    unique_lock_t lock(global_lock);
-    *pImage = (VkImage)global_unique_handle++;
     // TODO: A pixel size is 32 bytes. This accounts for the largest possible pixel size of any format. It could be changed to more accurate size if need be.
-    image_memory_size_map[device][*pImage] = pCreateInfo->extent.width * pCreateInfo->extent.height * pCreateInfo->extent.depth *
-                                             32 * pCreateInfo->arrayLayers * (pCreateInfo->mipLevels > 1 ? 2 : 1);
+    VkDeviceSize image_memory_size = pCreateInfo->extent.width * pCreateInfo->extent.height * pCreateInfo->extent.depth *
+                                     32 * pCreateInfo->arrayLayers * (pCreateInfo->mipLevels > 1 ? 2 : 1);
     // plane count
     switch (pCreateInfo->format) {
         case VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM:
@@ -973,7 +5625,7 @@ CUSTOM_C_INTERCEPTS = {
         case VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM:
         case VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM:
         case VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM:
-            image_memory_size_map[device][*pImage] *= 3;
+            image_memory_size *= 3;
             break;
         case VK_FORMAT_G8_B8R8_2PLANE_420_UNORM:
         case VK_FORMAT_G8_B8R8_2PLANE_422_UNORM:
@@ -983,19 +5635,218 @@ CUSTOM_C_INTERCEPTS = {
         case VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16:
         case VK_FORMAT_G16_B16R16_2PLANE_420_UNORM:
         case VK_FORMAT_G16_B16R16_2PLANE_422_UNORM:
-            image_memory_size_map[device][*pImage] *= 2;
+            image_memory_size *= 2;
             break;
         default:
             break;
     }
-    return VK_SUCCESS;
+    const ImageData image_data = {pCreateInfo->imageType,   pCreateInfo->format, pCreateInfo->extent, pCreateInfo->mipLevels,
+                                  pCreateInfo->arrayLayers, image_memory_size,   nullptr,             0};
+    *pImage = GetDeviceData(device)->images.insert(image_data);
+    return *pImage ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
 ''',
 'vkDestroyImage': '''
-    unique_lock_t lock(global_lock);
-    image_memory_size_map[device].erase(image);
+    GetDeviceData(device)->images.erase(image);
+''',
+'vkCreateImageView': '''
+    const ImageViewData view_data = {pCreateInfo->image, pCreateInfo->format, pCreateInfo->subresourceRange, pCreateInfo->components};
+    *pView = GetDeviceData(device)->image_views.insert(view_data);
+    return *pView ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkDestroyImageView': '''
+    GetDeviceData(device)->image_views.erase(imageView);
+''',
+'vkCreateShaderModule': '''
+    ShaderModuleData module_data;
+    if (execute_compute_shaders || execute_graphics_shaders) {
+        module_data.code.assign(pCreateInfo->pCode, pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t));
+    }
+    *pShaderModule = GetDeviceData(device)->shader_modules.insert(std::move(module_data));
+    return *pShaderModule ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkDestroyShaderModule': '''
+    GetDeviceData(device)->shader_modules.erase(shaderModule);
+''',
+'vkCreateComputePipelines': '''
+    DeviceData* device_data = GetDeviceData(device);
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        PipelineData pipeline_data;
+        if (execute_compute_shaders) pipeline_data.compute = CompileShaderStage(device_data, pCreateInfos[i].stage, kSpvExecutionModelGLCompute);
+        pPipelines[i] = device_data->pipelines.insert(std::move(pipeline_data));
+        if (!pPipelines[i]) result = VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    return result;
+''',
+'vkCreateGraphicsPipelines': '''
+    DeviceData* device_data = GetDeviceData(device);
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        PipelineData pipeline_data;
+        if (execute_graphics_shaders) pipeline_data.graphics = CreateGraphicsPipeline(device_data, pCreateInfos[i]);
+        pPipelines[i] = device_data->pipelines.insert(std::move(pipeline_data));
+        if (!pPipelines[i]) result = VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    return result;
+''',
+'vkDestroyPipeline': '''
+    // Ray tracing pipelines aren't in the table
+    GetDeviceData(device)->pipelines.erase(pipeline);
+''',
+'vkCreateSampler': '''
+    VkSamplerCreateInfo sampler_info = *pCreateInfo;
+    sampler_info.pNext = nullptr;
+    *pSampler = GetDeviceData(device)->samplers.insert(sampler_info);
+    return *pSampler ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkDestroySampler': '''
+    GetDeviceData(device)->samplers.erase(sampler);
+''',
+'vkCreateRenderPass': '''
+    *pRenderPass = GetDeviceData(device)->render_passes.insert(GetRenderPassData(*pCreateInfo));
+    return *pRenderPass ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkCreateRenderPass2KHR': '''
+    *pRenderPass = GetDeviceData(device)->render_passes.insert(GetRenderPassData(*pCreateInfo));
+    return *pRenderPass ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkDestroyRenderPass': '''
+    GetDeviceData(device)->render_passes.erase(renderPass);
+''',
+'vkCreateDescriptorSetLayout': '''
+    auto layout_data = GetDeviceData(device)->descriptor_set_layout_slab.Allocate();
+    if (!layout_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    InitDescriptorSetLayout(layout_data, pCreateInfo);
+    *pSetLayout = (VkDescriptorSetLayout)(uintptr_t)layout_data;
+    return VK_SUCCESS;
+''',
+'vkDestroyDescriptorSetLayout': '''
+    GetDeviceData(device)->descriptor_set_layout_slab.Free(GetDescriptorSetLayoutData(descriptorSetLayout));
+''',
+'vkCreateDescriptorPool': '''
+    auto device_data = GetDeviceData(device);
+    auto pool_data = device_data->descriptor_pool_slab.Allocate();
+    if (!pool_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    const VkResult result = InitDescriptorPool(pool_data, pCreateInfo);
+    if (result != VK_SUCCESS) {
+        device_data->descriptor_pool_slab.Free(pool_data);
+        return result;
+    }
+    *pDescriptorPool = (VkDescriptorPool)(uintptr_t)pool_data;
+    return VK_SUCCESS;
+''',
+'vkDestroyDescriptorPool': '''
+    GetDeviceData(device)->descriptor_pool_slab.Free(GetDescriptorPoolData(descriptorPool));
+''',
+'vkResetDescriptorPool': '''
+    // The sets are only blocks of the arena of the pool, rewinding it frees all of them
+    auto pool_data = GetDescriptorPoolData(descriptorPool);
+    pool_data->arena_used = 0;
+    pool_data->free_blocks.clear();
+    pool_data->set_count = 0;
+    std::fill_n(pool_data->type_counts, kDescriptorTypeCount, 0u);
+    return VK_SUCCESS;
+''',
+'vkAllocateDescriptorSets': '''
+    auto pool_data = GetDescriptorPoolData(pAllocateInfo->descriptorPool);
+    const auto variable_info = lvl_find_in_chain<VkDescriptorSetVariableDescriptorCountAllocateInfo>(pAllocateInfo->pNext);
+    for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; ++i) {
+        // Variable-sized bindings have no descriptors unless the application gives their count
+        const uint32_t variable_count =
+            variable_info && i < variable_info->descriptorSetCount ? variable_info->pDescriptorCounts[i] : 0;
+        DescriptorSetData* set_data;
+        const VkResult result = AllocateDescriptorSet(pool_data, GetDescriptorSetLayoutData(pAllocateInfo->pSetLayouts[i]),
+                                                      variable_count, &set_data);
+        if (result != VK_SUCCESS) {
+            // Either all of the sets are allocated or none of them, freeing in reverse rewinds the arena
+            while (i > 0) FreeDescriptorSet(pool_data, GetDescriptorSetData(pDescriptorSets[--i]));
+            std::fill_n(pDescriptorSets, pAllocateInfo->descriptorSetCount, (VkDescriptorSet)VK_NULL_HANDLE);
+            return result;
+        }
+        pDescriptorSets[i] = (VkDescriptorSet)(uintptr_t)set_data;
+    }
+    return VK_SUCCESS;
+''',
+'vkFreeDescriptorSets': '''
+    auto pool_data = GetDescriptorPoolData(descriptorPool);
+    for (uint32_t i = 0; i < descriptorSetCount; ++i) {
+        if (pDescriptorSets[i]) FreeDescriptorSet(pool_data, GetDescriptorSetData(pDescriptorSets[i]));
+    }
+    return VK_SUCCESS;
+''',
+'vkUpdateDescriptorSets': '''
+    for (uint32_t i = 0; i < descriptorWriteCount; ++i) {
+        const auto& write = pDescriptorWrites[i];
+        DescriptorCursor cursor(GetDescriptorSetData(write.dstSet), write.dstBinding, write.dstArrayElement);
+        if (write.descriptorType == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+            // The array element and count of inline uniform blocks are in bytes
+            const auto inline_info = lvl_find_in_chain<VkWriteDescriptorSetInlineUniformBlockEXT>(write.pNext);
+            if (inline_info && cursor.valid()) {
+                std::memcpy(cursor.inline_data(), inline_info->pData, (std::min)(inline_info->dataSize, cursor.inline_bytes()));
+            }
+            continue;
+        }
+        const auto acceleration_structure_info = lvl_find_in_chain<VkWriteDescriptorSetAccelerationStructureKHR>(write.pNext);
+        for (uint32_t j = 0; j < write.descriptorCount && cursor.valid(); ++j, cursor.Next()) {
+            WriteDescriptor(&cursor.descriptor(), write, j, acceleration_structure_info);
+        }
+    }
+    for (uint32_t i = 0; i < descriptorCopyCount; ++i) {
+        const auto& copy = pDescriptorCopies[i];
+        DescriptorCursor src(GetDescriptorSetData(copy.srcSet), copy.srcBinding, copy.srcArrayElement);
+        DescriptorCursor dst(GetDescriptorSetData(copy.dstSet), copy.dstBinding, copy.dstArrayElement);
+        if (src.valid() && dst.valid() && src.binding().type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+            const uint32_t size = (std::min)(copy.descriptorCount, (std::min)(src.inline_bytes(), dst.inline_bytes()));
+            std::memmove(dst.inline_data(), src.inline_data(), size);
+            continue;
+        }
+        for (uint32_t j = 0; j < copy.descriptorCount && src.valid() && dst.valid(); ++j, src.Next(), dst.Next()) {
+            dst.descriptor() = src.descriptor();
+        }
+    }
+''',
+'vkCreateDescriptorUpdateTemplateKHR': '''
+    auto template_data = GetDeviceData(device)->descriptor_update_template_slab.Allocate();
+    if (!template_data) return VK_ERROR_OUT_OF_HOST_MEMORY;
+    InitDescriptorUpdateTemplate(template_data, pCreateInfo);
+    *pDescriptorUpdateTemplate = (VkDescriptorUpdateTemplate)(uintptr_t)template_data;
+    return VK_SUCCESS;
+''',
+'vkDestroyDescriptorUpdateTemplateKHR': '''
+    GetDeviceData(device)->descriptor_update_template_slab.Free(GetDescriptorUpdateTemplateData(descriptorUpdateTemplate));
+''',
+'vkUpdateDescriptorSetWithTemplateKHR': '''
+    ApplyDescriptorUpdateTemplate(GetDescriptorSetData(descriptorSet), GetDescriptorUpdateTemplateData(descriptorUpdateTemplate),
+                                  static_cast<const uint8_t*>(pData));
+''',
+'vkCreateFramebuffer': '''
+    auto device_data = GetDeviceData(device);
+    FramebufferData framebuffer_data;
+    framebuffer_data.layers = pCreateInfo->layers;
+    // Imageless framebuffers don't know their attachments until the render pass begins, they cost nothing for now
+    if (!(pCreateInfo->flags & VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT)) {
+        for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i) {
+            ImageViewData view_data = {};
+            device_data->image_views.find(pCreateInfo->pAttachments[i], &view_data);
+            framebuffer_data.attachment_texel_sizes.push_back(GetTexelBlock(view_data.format).size);
+        }
+        framebuffer_data.attachments.assign(pCreateInfo->pAttachments, pCreateInfo->pAttachments + pCreateInfo->attachmentCount);
+    }
+    *pFramebuffer = device_data->framebuffers.insert(std::move(framebuffer_data));
+    return *pFramebuffer ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+''',
+'vkDestroyFramebuffer': '''
+    GetDeviceData(device)->framebuffers.erase(framebuffer);
 ''',
 }
 
+# 32-bit FNV-1a hash of an API name, must match HashName() in the generated code
+def hash_name(name):
+    hash = 2166136261
+    for byte in bytearray(name, 'ascii'):
+        hash = ((hash ^ byte) * 16777619) & 0xFFFFFFFF
+    return hash
+
 # MockICDGeneratorOptions - subclass of GeneratorOptions.
 #
 # Adds options used by MockICDOutputGenerator objects during Mock
@@ -1117,6 +5968,8 @@ class MockICDOutputGenerator(OutputGenerator):
         # Internal state - accumulators for different inner block text
         self.sections = dict([(section, []) for section in self.ALL_SECTIONS])
         self.intercepts = []
+        self.profile_fields = {}
+        self.trace_params = {}
 
     # Check if the parameter passed in is a pointer to an array
     def paramIsArray(self, param):
@@ -1165,16 +6018,38 @@ class MockICDOutputGenerator(OutputGenerator):
                 write(s, file=self.outFile)
         if self.header:
             write('#include <unordered_map>', file=self.outFile)
+            write('#include <atomic>', file=self.outFile)
             write('#include <mutex>', file=self.outFile)
-            write('#include <string>', file=self.outFile)
+            write('#include <algorithm>', file=self.outFile)
+            write('#include <chrono>', file=self.outFile)
+            write('#include <cstdlib>', file=self.outFile)
             write('#include <cstring>', file=self.outFile)
+            write('#include <cstddef>', file=self.outFile)
             write('#include "vulkan/vk_icd.h"', file=self.outFile)
         else:
             write('#include "mock_icd.h"', file=self.outFile)
+            write('#include "mock_icd_shader.h"', file=self.outFile)
             write('#include <stdlib.h>', file=self.outFile)
+            write('#include <sys/stat.h>', file=self.outFile)
             write('#include <algorithm>', file=self.outFile)
             write('#include <array>', file=self.outFile)
+            write('#include <chrono>', file=self.outFile)
+            write('#include <cmath>', file=self.outFile)
+            write('#include <condition_variable>', file=self.outFile)
+            write('#include <functional>', file=self.outFile)
+            write('#include <map>', file=self.outFile)
+            write('#include <memory>', file=self.outFile)
+            write('#include <string>', file=self.outFile)
+            write('#include <thread>', file=self.outFile)
+            write('#include <type_traits>', file=self.outFile)
             write('#include <vector>', file=self.outFile)
+            write('#ifdef _WIN32', file=self.outFile)
+            write('#include <windows.h>', file=self.outFile)
+            write('#else', file=self.outFile)
+            write('#include <fcntl.h>', file=self.outFile)
+            write('#include <sys/mman.h>', file=self.outFile)
+            write('#include <unistd.h>', file=self.outFile)
+            write('#endif', file=self.outFile)
             write('#include "vk_typemap_helper.h"', file=self.outFile)
 
         write('namespace vkmock {', file=self.outFile)
@@ -1191,16 +6066,17 @@ class MockICDOutputGenerator(OutputGenerator):
                     if (ext.attrib['name'] in ignore_exts):
                         pass
                     elif (ext.attrib.get('type') and 'instance' == ext.attrib['type']):
-                        instance_exts.append('    {"%s", %s},' % (ext.attrib['name'], ext[0][0].attrib['value']))
+                        instance_exts.append((ext.attrib['name'], ext[0][0].attrib['value']))
                     else:
-                        device_exts.append('    {"%s", %s},' % (ext.attrib['name'], ext[0][0].attrib['value']))
-            write('// Map of instance extension name to version', file=self.outFile)
-            write('static const std::unordered_map<std::string, uint32_t> instance_extension_map = {', file=self.outFile)
-            write('\n'.join(instance_exts), file=self.outFile)
+                        device_exts.append((ext.attrib['name'], ext[0][0].attrib['value']))
+            # Sort the tables so that FindByName() can binary search them
+            write('// Map of instance extension name to version, sorted by name', file=self.outFile)
+            write('static const ExtensionNameToVersion instance_extension_map[] = {', file=self.outFile)
+            write('\n'.join('    {"%s", %s},' % ext for ext in sorted(instance_exts)), file=self.outFile)
             write('};', file=self.outFile)
-            write('// Map of device extension name to version', file=self.outFile)
-            write('static const std::unordered_map<std::string, uint32_t> device_extension_map = {', file=self.outFile)
-            write('\n'.join(device_exts), file=self.outFile)
+            write('// Map of device extension name to version, sorted by name', file=self.outFile)
+            write('static const ExtensionNameToVersion device_extension_map[] = {', file=self.outFile)
+            write('\n'.join('    {"%s", %s},' % ext for ext in sorted(device_exts)), file=self.outFile)
             write('};', file=self.outFile)
 
         else:
@@ -1212,10 +6088,68 @@ class MockICDOutputGenerator(OutputGenerator):
         # Finish C++ namespace and multiple inclusion protection
         self.newline()
         if self.header:
+            # Identifiers of recorded commands. They don't depend on which platforms are enabled, so that
+            # recordings mean the same in every build.
+            write('// Identifiers of the vkCmd* commands recorded into command buffers', file=self.outFile)
+            write('enum class CommandId : uint32_t {', file=self.outFile)
+            commands = sorted(set(name for name, protect in self.intercepts if name.startswith('vkCmd')))
+            for name in commands:
+                write('    %s,' % name[2:], file=self.outFile)
+            write('};', file=self.outFile)
+            write('static const char* const command_names[] = {', file=self.outFile)
+            for name in commands:
+                write('    "%s",' % name, file=self.outFile)
+            write('};\n', file=self.outFile)
+            # Members of the structs device profiles can set, sorted by name so that FindByName() can search them
+            for struct_name, table_name in sorted(PROFILE_STRUCTS.items()):
+                write('// Members of %s that device profiles can set, sorted by name' % struct_name, file=self.outFile)
+                write('static const ProfileField %s[] = {' % table_name, file=self.outFile)
+                for name, field_type, count in sorted(self.profile_fields[struct_name]):
+                    write('    {"%s", offsetof(%s, %s), ProfileFieldType::%s, %s},' % (name, struct_name, name, field_type, count),
+                          file=self.outFile)
+                write('};\n', file=self.outFile)
             # record intercepted procedures
-            write('// Map of all APIs to be intercepted by this layer', file=self.outFile)
-            write('static const std::unordered_map<std::string, void*> name_to_funcptr_map = {', file=self.outFile)
-            write('\n'.join(self.intercepts), file=self.outFile)
+            intercepts = sorted(self.intercepts)
+            # Identifiers of the intercepts for the call statistics, in the order of name_to_funcptr_map so that it
+            # also maps them to their names
+            write('// Identifiers of all intercepts, in the order of name_to_funcptr_map', file=self.outFile)
+            write('enum class EntryPoint : uint32_t {', file=self.outFile)
+            for name, protect in intercepts:
+                write('    %s,' % name[2:], file=self.outFile)
+            write('};', file=self.outFile)
+            write('static constexpr uint32_t kEntryPointCount = %d;' % len(intercepts), file=self.outFile)
+            write('// Names of the parameters of each intercept that API traces record', file=self.outFile)
+            write('static const char* const entry_point_trace_args[] = {', file=self.outFile)
+            for name, protect in intercepts:
+                write('    "%s",' % ','.join(self.trace_params[name]), file=self.outFile)
+            write('};\n', file=self.outFile)
+            write('// Map of all APIs to be intercepted by this layer, sorted by name. Entries of functions that', file=self.outFile)
+            write('// are compiled out keep their index with an empty name so that the hash table below stays valid.', file=self.outFile)
+            write('static const NameToFuncPtr name_to_funcptr_map[] = {', file=self.outFile)
+            for name, protect in intercepts:
+                if protect is not None:
+                    write('#ifdef %s' % protect, file=self.outFile)
+                write('    {"%s", (void*)%s},' % (name, name[2:]), file=self.outFile)
+                if protect is not None:
+                    write('#else', file=self.outFile)
+                    write('    {"", nullptr},', file=self.outFile)
+                    write('#endif', file=self.outFile)
+            write('};', file=self.outFile)
+            # Open addressing hash table of indices into name_to_funcptr_map, at most half full so probe
+            # sequences stay short. The probing here must match FindFuncPtr().
+            table_size = 1
+            while table_size < 2 * len(intercepts):
+                table_size *= 2
+            slots = ['kEmptySlot'] * table_size
+            for index, (name, protect) in enumerate(intercepts):
+                slot = hash_name(name) & (table_size - 1)
+                while slots[slot] != 'kEmptySlot':
+                    slot = (slot + 1) & (table_size - 1)
+                slots[slot] = str(index)
+            write('// Hash table of name_to_funcptr_map indices, keyed by HashName()', file=self.outFile)
+            write('static const uint16_t name_to_funcptr_hash_table[%d] = {' % table_size, file=self.outFile)
+            for row in range(0, table_size, 16):
+                write('    %s,' % ', '.join(slots[row:row + 16]), file=self.outFile)
             write('};\n', file=self.outFile)
             self.newline()
             write('} // namespace vkmock', file=self.outFile)
@@ -1294,6 +6228,14 @@ class MockICDOutputGenerator(OutputGenerator):
             body += ';\n'
         body += '} ' + typeName + ';\n'
         self.appendSection('struct', body)
+        if self.header and typeName in PROFILE_STRUCTS:
+            fields = []
+            for member in typeinfo.elem.findall('.//member'):
+                name = member.find('name')
+                # Array sizes follow the name, as in maxComputeWorkGroupCount[3]
+                count = re.search(r'\[(\d+)\]', name.tail or '')
+                fields.append((name.text, PROFILE_FIELD_TYPES[member.find('type').text], count.group(1) if count else '1'))
+            self.profile_fields[typeName] = fields
     #
     # Group (e.g. C "enum" type) generation.
     # These are concatenated together with other types.
@@ -1305,17 +6247,27 @@ class MockICDOutputGenerator(OutputGenerator):
     def genEnum(self, enuminfo, name, alias):
         pass
     #
+    # Parameters recorded in API traces: the first kMaxTraceArgs handles and scalars, pointers aren't followed
+    def getTraceParams(self, cmdinfo):
+        params = []
+        for param in cmdinfo.elem.findall('param'):
+            decl = ''.join(param.itertext())
+            if '*' not in decl and '[' not in decl:
+                params.append(param.find('name').text)
+        return params[:8]
+    #
+    # Every intercept starts by timing itself for the opt-in call statistics and API trace
+    def makeCallTimer(self, name, cmdinfo):
+        return '    CallTimer call_timer(%s);' % ', '.join(['EntryPoint::' + name[2:]] + self.getTraceParams(cmdinfo))
+    #
     # Command generation
     def genCmd(self, cmdinfo, name, alias):
         decls = self.makeCDecls(cmdinfo.elem)
         if self.header: # In the header declare all intercepts
             self.appendSection('command', '')
             self.appendSection('command', 'static %s' % (decls[0]))
-            if (self.featureExtraProtect != None):
-                self.intercepts += [ '#ifdef %s' % self.featureExtraProtect ]
-            self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
-            if (self.featureExtraProtect != None):
-                self.intercepts += [ '#endif' ]
+            self.intercepts += [ (name, self.featureExtraProtect) ]
+            self.trace_params[name] = self.getTraceParams(cmdinfo)
             return
 
         manual_functions = [
@@ -1342,22 +6294,18 @@ class MockICDOutputGenerator(OutputGenerator):
                 self.appendSection('command', '// TODO: Implement custom intercept body')
             else:
                 self.appendSection('command', 'static %s' % (decls[0][:-1]))
-                self.appendSection('command', '{\n%s}' % (CUSTOM_C_INTERCEPTS[name]))
-            self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
+                self.appendSection('command', '{\n%s%s}' % (self.makeCallTimer(name, cmdinfo), CUSTOM_C_INTERCEPTS[name]))
+            self.intercepts += [ (name, None) ]
             return
         # record that the function will be intercepted
-        if (self.featureExtraProtect != None):
-            self.intercepts += [ '#ifdef %s' % self.featureExtraProtect ]
-        self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
-        if (self.featureExtraProtect != None):
-            self.intercepts += [ '#endif' ]
+        self.intercepts += [ (name, self.featureExtraProtect) ]
 
         OutputGenerator.genCmd(self, cmdinfo, name, alias)
         #
         self.appendSection('command', '')
         self.appendSection('command', 'static %s' % (decls[0][:-1]))
         if name in CUSTOM_C_INTERCEPTS:
-            self.appendSection('command', '{%s}' % (CUSTOM_C_INTERCEPTS[name]))
+            self.appendSection('command', '{\n%s%s}' % (self.makeCallTimer(name, cmdinfo), CUSTOM_C_INTERCEPTS[name]))
             return
 
         # Declare result variable, if any.
@@ -1375,13 +6323,19 @@ class MockICDOutputGenerator(OutputGenerator):
             param_names = []
             for param in params:
                 param_names.append(param.text)
-            self.appendSection('command', '{\n    %s%s(%s);\n}' % (return_string, khr_name[2:], ", ".join(param_names)))
+            self.appendSection('command', '{\n%s\n    %s%s(%s);\n}' % (self.makeCallTimer(name, cmdinfo), return_string, khr_name[2:],
+                                                                      ", ".join(param_names)))
             return
         self.appendSection('command', '{')
+        self.appendSection('command', self.makeCallTimer(name, cmdinfo))
 
         api_function_name = cmdinfo.elem.attrib.get('name')
         # GET THE TYPE OF FUNCTION
-        if True in [ftxt in api_function_name for ftxt in ['Create', 'Allocate']]:
+        if api_function_name.startswith('vkCmd'):
+            # Record the command into the command buffer's command stream
+            record_args = ['commandBuffer', 'CommandId::%s' % api_function_name[2:]] + self.makeRecordArgs(cmdinfo)
+            self.appendSection('command', '    RecordCommand(%s);' % ', '.join(record_args))
+        elif True in [ftxt in api_function_name for ftxt in ['Create', 'Allocate']]:
             # Get last param
             last_param = cmdinfo.elem.findall('param')[-1]
             lp_txt = last_param.find('name').text
@@ -1394,9 +6348,8 @@ class MockICDOutputGenerator(OutputGenerator):
             allocator_txt = 'CreateDispObjHandle()';
             if (self.isHandleTypeNonDispatchable(lp_type)):
                 handle_type = 'non-' + handle_type
-                allocator_txt = 'global_unique_handle++';
-            # Need to lock in both cases
-            self.appendSection('command', '    unique_lock_t lock(global_lock);')
+                allocator_txt = 'NewHandle()';
+            # Handle allocation doesn't need a lock, objects without state of their own only need a unique handle
             if (lp_len != None):
                 #print("%s last params (%s) has len %s" % (handle_type, lp_txt, lp_len))
                 self.appendSection('command', '    for (uint32_t i = 0; i < %s; ++i) {' % (lp_len))
@@ -1404,15 +6357,9 @@ class MockICDOutputGenerator(OutputGenerator):
                 self.appendSection('command', '    }')
             else:
                 #print("Single %s last param is '%s' w/ type '%s'" % (handle_type, lp_txt, lp_type))
-                if 'AllocateMemory' in api_function_name:
-                    # Store allocation size in case it's mapped
-                    self.appendSection('command', '    allocated_memory_size_map[(VkDeviceMemory)global_unique_handle] = pAllocateInfo->allocationSize;')
                 self.appendSection('command', '    *%s = (%s)%s;' % (lp_txt, lp_type, allocator_txt))
         elif True in [ftxt in api_function_name for ftxt in ['Destroy', 'Free']]:
             self.appendSection('command', '//Destroy object')
-            if 'FreeMemory' in api_function_name:
-                # Remove from allocation map
-                self.appendSection('command', '    allocated_memory_size_map.erase(memory);')
         else:
             self.appendSection('command', '//Not a CREATE or DESTROY function')
 
@@ -1424,6 +6371,34 @@ class MockICDOutputGenerator(OutputGenerator):
                 self.appendSection('command', '    return VK_SUCCESS;')
         self.appendSection('command', '}')
     #
+    # Build the arguments that record the parameters (other than the command buffer) of a vkCmd* command.
+    # Pointer parameters are recorded as arrays of their len, or of one element if they have none.
+    def makeRecordArgs(self, cmdinfo):
+        record_args = []
+        for param in cmdinfo.elem.findall('param')[1:]:
+            param_name = param.find('name').text
+            param_type = param.find('type').text
+            type_tail = param.find('type').tail or ''
+            name_tail = (param.find('name').tail or '').strip()
+            if name_tail.startswith('['):
+                # Fixed size array such as blendConstants[4]
+                record_args.append('RecordArray(%s, %s)' % (param_name, name_tail[1:-1]))
+            elif '*' in type_tail:
+                count = param.attrib['len'].split(',')[0] if 'len' in param.attrib else None
+                if param_type == 'void':
+                    if count is None:
+                        # Opaque pointer such as a checkpoint marker, only the pointer value means something
+                        record_args.append(param_name)
+                    else:
+                        record_args.append('RecordArray(static_cast<const uint8_t*>(%s), %s)' % (param_name, count))
+                else:
+                    record_args.append('RecordArray(%s, %s)' % (param_name, count if count is not None else '1'))
+                    for member, member_count in RECORDED_MEMBER_ARRAYS.get(param_type, []):
+                        record_args.append('RecordArray(%s->%s, %s->%s)' % (param_name, member, param_name, member_count))
+            else:
+                record_args.append(param_name)
+        return record_args
+    #
     # override makeProtoName to drop the "vk" prefix
     def makeProtoName(self, name, tail):
         return self.genOpts.apientry + name[2:] + tail
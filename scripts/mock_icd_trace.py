@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2015-2020 The Khronos Group Inc.
+# Copyright (c) 2015-2020 Valve Corporation
+# Copyright (c) 2015-2020 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Decodes the API traces the mock ICD writes to the file VK_MOCK_ICD_TRACE names. Prints the calls in order of time,
+# or converts them to the Chrome trace event format that chrome://tracing and Perfetto load.
+
+import argparse
+import json
+import struct
+import sys
+
+# Layouts of TraceFileHeader and TraceRecord in the mock ICD
+HEADER = struct.Struct('<8sIIII')
+RECORD_HEADER = struct.Struct('<QQIHHII')
+MAGIC = b'VKMOCKTR'
+VERSION = 1
+
+# TraceArgKind
+ARG_UNSIGNED, ARG_SIGNED, ARG_FLOAT, ARG_ENUM, ARG_HANDLE = range(5)
+
+def read_trace(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, version, record_size, entry_point_count, max_args = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit('%s: not a version %d mock ICD trace' % (path, VERSION))
+    offset = HEADER.size
+    entry_points = []
+    for i in range(entry_point_count):
+        strings = []
+        for j in range(2):
+            end = data.index(b'\0', offset)
+            strings.append(data[offset:end].decode())
+            offset = end + 1
+        entry_points.append((strings[0], strings[1].split(',') if strings[1] else []))
+    records = []
+    args_format = struct.Struct('<%dQ' % max_args)
+    while offset + record_size <= len(data):
+        timestamp, duration, thread, entry_point, arg_count, arg_kinds, _ = RECORD_HEADER.unpack_from(data, offset)
+        args = args_format.unpack_from(data, offset + RECORD_HEADER.size)
+        values = [decode_arg((arg_kinds >> (4 * i)) & 0xf, args[i]) for i in range(arg_count)]
+        records.append((timestamp, duration, thread, entry_point, values))
+        offset += record_size
+    records.sort()
+    return entry_points, records
+
+def decode_arg(kind, value):
+    if kind == ARG_SIGNED or kind == ARG_ENUM:
+        return value - (1 << 64) if value >= 1 << 63 else value
+    if kind == ARG_FLOAT:
+        return struct.unpack('<f', struct.pack('<I', value))[0]
+    if kind == ARG_HANDLE:
+        return '0x%x' % value
+    return value
+
+def describe(entry_points, entry_point, values):
+    if entry_point == len(entry_points):
+        return 'dropped %d calls' % values[0], {}
+    name, arg_names = entry_points[entry_point]
+    args = dict(zip(arg_names, values))
+    return name, args
+
+def print_trace(entry_points, records, out):
+    start = records[0][0] if records else 0
+    for timestamp, duration, thread, entry_point, values in records:
+        name, args = describe(entry_points, entry_point, values)
+        out.write('%14.3f us  thread %-3d ' % ((timestamp - start) / 1000.0, thread))
+        if entry_point == len(entry_points):
+            out.write('%s\n' % name)
+        else:
+            args_text = ', '.join('%s=%s' % item for item in args.items())
+            out.write('%s(%s)  %.3f us\n' % (name, args_text, duration / 1000.0))
+
+def chrome_trace(entry_points, records, out):
+    start = records[0][0] if records else 0
+    events = []
+    for timestamp, duration, thread, entry_point, values in records:
+        name, args = describe(entry_points, entry_point, values)
+        event = {'name': name, 'pid': 1, 'tid': thread, 'ts': (timestamp - start) / 1000.0, 'args': args}
+        if entry_point == len(entry_points):
+            event.update({'ph': 'i', 's': 't'})
+        else:
+            event.update({'ph': 'X', 'dur': duration / 1000.0})
+        events.append(event)
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, out)
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Decode a mock ICD API trace')
+    parser.add_argument('trace', help='trace file written by the mock ICD')
+    parser.add_argument('-c', '--chrome', metavar='JSON_PATH', help='write the trace in the Chrome trace event format')
+    args = parser.parse_args(argv)
+    entry_points, records = read_trace(args.trace)
+    if args.chrome:
+        with open(args.chrome, 'w') as out:
+            chrome_trace(entry_points, records, out)
+    else:
+        print_trace(entry_points, records, sys.stdout)
+
+if __name__ == '__main__':
+    main(sys.argv[1:])